@@ -11,11 +11,32 @@
 #include <algorithm>
 #include <QString>
 #include <QMap>
+#include <QSet>
 
 namespace Mtoc {
 
 const QString DatabaseManager::DB_CONNECTION_NAME = "MtocMusicLibrary";
 
+// Sort key for the "All Songs" listing, evaluated against a row of the tracks table.
+// Mirrors ORDER BY album artist, album title, disc, track, title (all NOCASE) with the
+// track id appended so every key is unique. Fields are joined with char(31), which
+// sorts below any printable character, so string order matches tuple order.
+// Tracks hidden from the listing get NULL: those with no title, and those whose
+// artist_id points at an artist that is missing or has no name.
+static const char* const TRACK_SORT_KEY_EXPR =
+    "CASE WHEN tracks.title IS NULL OR tracks.title = '' "
+    "  OR (tracks.artist_id IS NOT NULL AND NOT EXISTS (SELECT 1 FROM artists a "
+    "      WHERE a.id = tracks.artist_id AND a.name IS NOT NULL AND a.name != '')) "
+    "THEN NULL ELSE "
+    "  COALESCE((SELECT lower(aa.name) FROM albums al "
+    "            JOIN album_artists aa ON al.album_artist_id = aa.id "
+    "            WHERE al.id = tracks.album_id), '') "
+    "  || char(31) || COALESCE((SELECT lower(al.title) FROM albums al WHERE al.id = tracks.album_id), '') "
+    "  || char(31) || printf('%05d.%05d', COALESCE(tracks.disc_number, 0), COALESCE(tracks.track_number, 0)) "
+    "  || char(31) || lower(tracks.title) "
+    "  || char(31) || printf('%010d', tracks.id) "
+    "END";
+
 DatabaseManager::DatabaseManager(QObject *parent)
     : QObject(parent)
 {
@@ -70,16 +91,8 @@ bool DatabaseManager::initializeDatabase(const QString& dbPath)
     query.exec("PRAGMA mmap_size = 268435456"); // 256MB memory-mapped I/O
     query.exec("PRAGMA page_size = 4096"); // 4KB page size
 
-    // Check database integrity on startup
-    query.exec("PRAGMA quick_check");
-    if (query.next()) {
-        QString result = query.value(0).toString();
-        if (result != "ok") {
-            qCritical() << "Database integrity check failed:" << result;
-            emit databaseError("Database integrity check failed: " + result);
-            // Continue anyway - let the user decide what to do
-        }
-    }
+    // The integrity check reads the whole file, so it runs after startup
+    // (see checkIntegrity)
     
     if (!createTables()) {
         return false;
@@ -93,6 +106,25 @@ bool DatabaseManager::initializeDatabase(const QString& dbPath)
     return true;
 }
 
+bool DatabaseManager::checkIntegrity(QSqlDatabase& db)
+{
+    QSqlQuery query(db);
+    if (!query.exec("PRAGMA quick_check")) {
+        logError("Integrity check", query);
+        return false;
+    }
+    if (query.next()) {
+        QString result = query.value(0).toString();
+        if (result != "ok") {
+            qCritical() << "Database integrity check failed:" << result;
+            emit databaseError("Database integrity check failed: " + result);
+            // Continue anyway - let the user decide what to do
+            return false;
+        }
+    }
+    return true;
+}
+
 bool DatabaseManager::isOpen() const
 {
     return m_db.isOpen();
@@ -491,6 +523,739 @@ bool DatabaseManager::applyMigrations(int currentVersion)
         }
     }
 
+    // Migration 6: Add album_summary table maintained by triggers
+    if (currentVersion < 6) {
+        qDebug() << "Applying migration 6: Creating album_summary table";
+
+        if (!m_db.transaction()) {
+            qCritical() << "Failed to start transaction for migration 6";
+            return false;
+        }
+
+        bool migrationSuccess = true;
+
+        // One row per album with the aggregates getAllAlbums() used to compute on every call.
+        // Rows are kept current by the triggers below, so every connection (including the
+        // scanner's thread connection) updates it without any extra bookkeeping.
+        if (!query.exec(
+            "CREATE TABLE IF NOT EXISTS album_summary ("
+            "album_id INTEGER PRIMARY KEY,"
+            "title TEXT NOT NULL,"
+            "album_artist_name TEXT,"
+            "year INTEGER,"
+            "track_count INTEGER NOT NULL DEFAULT 0,"
+            "total_duration INTEGER NOT NULL DEFAULT 0,"
+            "has_art INTEGER NOT NULL DEFAULT 0,"
+            "FOREIGN KEY (album_id) REFERENCES albums(id) ON DELETE CASCADE"
+            ")")) {
+            logError("Create album_summary table", query);
+            migrationSuccess = false;
+        }
+
+        if (migrationSuccess) {
+            migrationSuccess = query.exec("CREATE INDEX IF NOT EXISTS idx_album_summary_title "
+                                          "ON album_summary(title COLLATE NOCASE)");
+            if (!migrationSuccess) logError("Create idx_album_summary_title", query);
+        }
+        if (migrationSuccess) {
+            migrationSuccess = query.exec("CREATE INDEX IF NOT EXISTS idx_album_summary_artist "
+                                          "ON album_summary(album_artist_name COLLATE NOCASE, year)");
+            if (!migrationSuccess) logError("Create idx_album_summary_artist", query);
+        }
+
+        if (migrationSuccess) {
+            migrationSuccess = createAlbumSummaryTriggers(m_db);
+        }
+
+        if (migrationSuccess) {
+            migrationSuccess = populateAlbumSummary(m_db);
+        }
+
+        if (migrationSuccess) {
+            query.prepare("INSERT INTO schema_version (version) VALUES (:version)");
+            query.bindValue(":version", 6);
+            if (!query.exec()) {
+                logError("Record migration 6", query);
+                migrationSuccess = false;
+            }
+        }
+
+        if (migrationSuccess) {
+            if (!m_db.commit()) {
+                qCritical() << "Failed to commit migration 6";
+                m_db.rollback();
+                return false;
+            }
+            qDebug() << "Migration 6 completed: album_summary table created";
+        } else {
+            qCritical() << "Migration 6 failed, rolling back";
+            m_db.rollback();
+            return false;
+        }
+    }
+
+    // Migration 7: Add indexed sort keys for keyset pagination of track listings
+    if (currentVersion < 7) {
+        qDebug() << "Applying migration 7: Adding track sort keys";
+
+        if (!m_db.transaction()) {
+            qCritical() << "Failed to start transaction for migration 7";
+            return false;
+        }
+
+        bool migrationSuccess = true;
+
+        // Check if column already exists
+        query.exec("PRAGMA table_info(tracks)");
+        bool hasSortKeyColumn = false;
+        while (query.next()) {
+            if (query.value(1).toString() == "sort_key") {
+                hasSortKeyColumn = true;
+                break;
+            }
+        }
+
+        if (!hasSortKeyColumn && !query.exec("ALTER TABLE tracks ADD COLUMN sort_key TEXT")) {
+            logError("Add sort_key column", query);
+            migrationSuccess = false;
+        }
+
+        if (migrationSuccess) {
+            migrationSuccess = createTrackSortKeyTriggers();
+        }
+
+        // Backfill existing rows
+        if (migrationSuccess) {
+            migrationSuccess = query.exec(QString("UPDATE tracks SET sort_key = ") + TRACK_SORT_KEY_EXPR);
+            if (!migrationSuccess) logError("Backfill sort_key", query);
+        }
+
+        if (migrationSuccess) {
+            migrationSuccess = query.exec("CREATE INDEX IF NOT EXISTS idx_tracks_sort_key ON tracks(sort_key)");
+            if (!migrationSuccess) logError("Create idx_tracks_sort_key", query);
+        }
+
+        // Favorites are listed in favorited order; rowid is implicitly the last index column
+        if (migrationSuccess) {
+            migrationSuccess = query.exec("CREATE INDEX IF NOT EXISTS idx_tracks_favorited "
+                                          "ON tracks(is_favorite, favorited_at)");
+            if (!migrationSuccess) logError("Create idx_tracks_favorited", query);
+        }
+
+        if (migrationSuccess) {
+            query.prepare("INSERT INTO schema_version (version) VALUES (:version)");
+            query.bindValue(":version", 7);
+            if (!query.exec()) {
+                logError("Record migration 7", query);
+                migrationSuccess = false;
+            }
+        }
+
+        if (migrationSuccess) {
+            if (!m_db.commit()) {
+                qCritical() << "Failed to commit migration 7";
+                m_db.rollback();
+                return false;
+            }
+            qDebug() << "Migration 7 completed: track sort keys added";
+        } else {
+            qCritical() << "Migration 7 failed, rolling back";
+            m_db.rollback();
+            return false;
+        }
+    }
+
+    if (currentVersion < 8) {
+        qDebug() << "Applying migration 8: Adding library generation counter";
+
+        if (!m_db.transaction()) {
+            qCritical() << "Failed to start transaction for migration 8";
+            return false;
+        }
+
+        bool migrationSuccess = query.exec(
+            "CREATE TABLE IF NOT EXISTS library_generation ("
+            "id INTEGER PRIMARY KEY CHECK (id = 1),"
+            "value INTEGER NOT NULL DEFAULT 0"
+            ")");
+        if (!migrationSuccess) logError("Create library_generation table", query);
+
+        if (migrationSuccess) {
+            migrationSuccess = query.exec("INSERT OR IGNORE INTO library_generation (id, value) VALUES (1, 0)");
+            if (!migrationSuccess) logError("Seed library_generation", query);
+        }
+
+        if (migrationSuccess) {
+            migrationSuccess = createLibraryGenerationTriggers();
+        }
+
+        if (migrationSuccess) {
+            query.prepare("INSERT INTO schema_version (version) VALUES (:version)");
+            query.bindValue(":version", 8);
+            if (!query.exec()) {
+                logError("Record migration 8", query);
+                migrationSuccess = false;
+            }
+        }
+
+        if (migrationSuccess) {
+            if (!m_db.commit()) {
+                qCritical() << "Failed to commit migration 8";
+                m_db.rollback();
+                return false;
+            }
+            qDebug() << "Migration 8 completed: library generation counter added";
+        } else {
+            qCritical() << "Migration 8 failed, rolling back";
+            m_db.rollback();
+            return false;
+        }
+    }
+
+    if (currentVersion < 9) {
+        qDebug() << "Applying migration 9: Adding loudness analysis status";
+
+        if (!m_db.transaction()) {
+            qCritical() << "Failed to start transaction for migration 9";
+            return false;
+        }
+
+        // NULL: not analysed, 1: replaygain_* measured by LoudnessAnalyzer, 0: could not be measured
+        bool migrationSuccess = query.exec("ALTER TABLE tracks ADD COLUMN loudness_analysis INTEGER");
+        if (!migrationSuccess) logError("Add loudness_analysis column", query);
+
+        if (migrationSuccess) {
+            query.prepare("INSERT INTO schema_version (version) VALUES (:version)");
+            query.bindValue(":version", 9);
+            if (!query.exec()) {
+                logError("Record migration 9", query);
+                migrationSuccess = false;
+            }
+        }
+
+        if (migrationSuccess) {
+            if (!m_db.commit()) {
+                qCritical() << "Failed to commit migration 9";
+                m_db.rollback();
+                return false;
+            }
+            qDebug() << "Migration 9 completed: loudness analysis status added";
+        } else {
+            qCritical() << "Migration 9 failed, rolling back";
+            m_db.rollback();
+            return false;
+        }
+    }
+
+    if (currentVersion < 10) {
+        qDebug() << "Applying migration 10: Creating waveforms table";
+
+        if (!m_db.transaction()) {
+            qCritical() << "Failed to start transaction for migration 10";
+            return false;
+        }
+
+        // Seek bar peaks: min/max pairs of int8 per bucket, written by WaveformService
+        bool migrationSuccess = query.exec(
+            "CREATE TABLE IF NOT EXISTS waveforms ("
+            "track_id INTEGER PRIMARY KEY,"
+            "peaks BLOB NOT NULL,"
+            "FOREIGN KEY (track_id) REFERENCES tracks(id) ON DELETE CASCADE"
+            ")");
+        if (!migrationSuccess) logError("Create waveforms table", query);
+
+        if (migrationSuccess) {
+            query.prepare("INSERT INTO schema_version (version) VALUES (:version)");
+            query.bindValue(":version", 10);
+            if (!query.exec()) {
+                logError("Record migration 10", query);
+                migrationSuccess = false;
+            }
+        }
+
+        if (migrationSuccess) {
+            if (!m_db.commit()) {
+                qCritical() << "Failed to commit migration 10";
+                m_db.rollback();
+                return false;
+            }
+            qDebug() << "Migration 10 completed: waveforms table created";
+        } else {
+            qCritical() << "Migration 10 failed, rolling back";
+            m_db.rollback();
+            return false;
+        }
+    }
+
+    // Migration 11: Hide tracks of missing or unnamed artists in the sort keys again
+    if (currentVersion < 11) {
+        qDebug() << "Applying migration 11: Restoring the hidden track rule in sort keys";
+
+        if (!m_db.transaction()) {
+            qCritical() << "Failed to start transaction for migration 11";
+            return false;
+        }
+
+        // Tracks of a missing artist are hidden again and artist renames now
+        // reach sort_key, so the triggers are replaced and every key recomputed
+        bool migrationSuccess = true;
+        static const char* const oldTriggers[] = {
+            "trg_tracks_sort_key_insert", "trg_tracks_sort_key_update",
+            "trg_tracks_sort_key_album_update", "trg_tracks_sort_key_artist_rename"
+        };
+        for (const char* trigger : oldTriggers) {
+            if (migrationSuccess && !query.exec(QString("DROP TRIGGER IF EXISTS %1").arg(trigger))) {
+                logError("Drop sort_key trigger", query);
+                migrationSuccess = false;
+            }
+        }
+
+        if (migrationSuccess) {
+            migrationSuccess = createTrackSortKeyTriggers();
+        }
+
+        if (migrationSuccess) {
+            migrationSuccess = query.exec(QString("UPDATE tracks SET sort_key = ") + TRACK_SORT_KEY_EXPR);
+            if (!migrationSuccess) logError("Recompute sort_key", query);
+        }
+
+        if (migrationSuccess) {
+            query.prepare("INSERT INTO schema_version (version) VALUES (:version)");
+            query.bindValue(":version", 11);
+            if (!query.exec()) {
+                logError("Record migration 11", query);
+                migrationSuccess = false;
+            }
+        }
+
+        if (migrationSuccess) {
+            if (!m_db.commit()) {
+                qCritical() << "Failed to commit migration 11";
+                m_db.rollback();
+                return false;
+            }
+            qDebug() << "Migration 11 completed: track sort keys recomputed";
+        } else {
+            qCritical() << "Migration 11 failed, rolling back";
+            m_db.rollback();
+            return false;
+        }
+    }
+
+    if (currentVersion < 12) {
+        qDebug() << "Applying migration 12: Adding loudness analysis attempts";
+
+        if (!m_db.transaction()) {
+            qCritical() << "Failed to start transaction for migration 12";
+            return false;
+        }
+
+        // Failed decodes leave loudness_analysis NULL and are retried until
+        // they reach MAX_LOUDNESS_ATTEMPTS. Earlier versions stored them as 0,
+        // which is now kept for silence, so those are retried once more.
+        bool migrationSuccess = query.exec(
+            "ALTER TABLE tracks ADD COLUMN loudness_attempts INTEGER NOT NULL DEFAULT 0");
+        if (!migrationSuccess) logError("Add loudness_attempts column", query);
+
+        if (migrationSuccess) {
+            migrationSuccess = query.exec(
+                "UPDATE tracks SET loudness_analysis = NULL, loudness_attempts = 1 "
+                "WHERE loudness_analysis = 0");
+            if (!migrationSuccess) logError("Reset unmeasured tracks", query);
+        }
+
+        if (migrationSuccess) {
+            query.prepare("INSERT INTO schema_version (version) VALUES (:version)");
+            query.bindValue(":version", 12);
+            if (!query.exec()) {
+                logError("Record migration 12", query);
+                migrationSuccess = false;
+            }
+        }
+
+        if (migrationSuccess) {
+            if (!m_db.commit()) {
+                qCritical() << "Failed to commit migration 12";
+                m_db.rollback();
+                return false;
+            }
+            qDebug() << "Migration 12 completed: loudness analysis attempts added";
+        } else {
+            qCritical() << "Migration 12 failed, rolling back";
+            m_db.rollback();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool DatabaseManager::createLibraryGenerationTriggers()
+{
+    QSqlQuery query(m_db);
+
+    // Everything the album and artist browse lists are built from. album_summary
+    // is itself trigger-maintained, so track and art changes reach it too.
+    static const char* const tables[] = {
+        "album_summary", "album_artists", "album_album_artists"
+    };
+    static const char* const events[] = { "INSERT", "UPDATE", "DELETE" };
+
+    for (const char* table : tables) {
+        for (const char* event : events) {
+            QString sql = QString("CREATE TRIGGER IF NOT EXISTS trg_library_generation_%1_%2 "
+                                  "AFTER %3 ON %1 BEGIN "
+                                  "  UPDATE library_generation SET value = value + 1 WHERE id = 1; "
+                                  "END")
+                              .arg(QString::fromLatin1(table), QString::fromLatin1(event).toLower(),
+                                   QString::fromLatin1(event));
+            if (!query.exec(sql)) {
+                logError("Create library_generation trigger", query);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+qint64 DatabaseManager::libraryGeneration()
+{
+    QMutexLocker locker(&m_databaseMutex);
+    if (!m_db.isOpen()) return -1;
+
+    QSqlQuery query(m_db);
+    if (query.exec("SELECT value FROM library_generation WHERE id = 1") && query.next()) {
+        return query.value(0).toLongLong();
+    }
+    logError("Read library generation", query);
+    return -1;
+}
+
+QList<LoudnessAnalysisTrack> DatabaseManager::getTracksForLoudnessAnalysis()
+{
+    QMutexLocker locker(&m_databaseMutex);
+    QList<LoudnessAnalysisTrack> tracks;
+    if (!m_db.isOpen()) return tracks;
+
+    // Every untagged track of an album with anything new in it, including the
+    // ones measured before, so the album gain covers the whole album again.
+    // Tracks that failed to decode count as new until they run out of attempts.
+    const QString pending = QString("replaygain_track_gain IS NULL AND loudness_analysis IS NULL "
+                                    "AND loudness_attempts < %1").arg(MAX_LOUDNESS_ATTEMPTS);
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    if (!query.exec(QString(
+            "SELECT id, file_path, album_id FROM tracks "
+            "WHERE (loudness_analysis = 1 OR (%1)) "
+            "AND (album_id IN (SELECT album_id FROM tracks WHERE %1 AND album_id IS NOT NULL) "
+            "     OR (album_id IS NULL AND %1)) "
+            "ORDER BY album_id, disc_number, track_number").arg(pending))) {
+        logError("Get tracks for loudness analysis", query);
+        return tracks;
+    }
+
+    while (query.next()) {
+        LoudnessAnalysisTrack track;
+        track.id = query.value(0).toInt();
+        track.filePath = query.value(1).toString();
+        track.albumId = query.value(2).toInt();
+        tracks.append(track);
+    }
+    return tracks;
+}
+
+bool DatabaseManager::storeLoudnessResults(const QList<LoudnessResult>& results)
+{
+    QMutexLocker locker(&m_databaseMutex);
+    if (!m_db.isOpen()) return false;
+    if (results.isEmpty()) return true;
+
+    // Fails harmlessly if a transaction is already open; the updates then join it
+    bool ownTransaction = m_db.transaction();
+
+    // A track that was tagged in the meantime keeps its tags
+    QSqlQuery query(m_db);
+    query.prepare(
+        "UPDATE tracks SET "
+        "replaygain_track_gain = :track_gain, replaygain_track_peak = :track_peak, "
+        "replaygain_album_gain = :album_gain, replaygain_album_peak = :album_peak, "
+        "loudness_analysis = :status "
+        "WHERE id = :id AND (loudness_analysis IS NOT NULL OR replaygain_track_gain IS NULL)");
+    // A failed decode keeps whatever the track had and only counts the attempt
+    QSqlQuery failedQuery(m_db);
+    failedQuery.prepare("UPDATE tracks SET loudness_attempts = loudness_attempts + 1 WHERE id = :id");
+
+    bool success = true;
+    for (const LoudnessResult& result : results) {
+        if (result.failed) {
+            failedQuery.bindValue(":id", result.trackId);
+            if (!failedQuery.exec()) {
+                logError("Store loudness attempt", failedQuery);
+                success = false;
+                break;
+            }
+            continue;
+        }
+        query.bindValue(":track_gain", result.analysed ? QVariant(result.trackGain) : QVariant());
+        query.bindValue(":track_peak", result.analysed ? QVariant(result.trackPeak) : QVariant());
+        query.bindValue(":album_gain", result.analysed ? QVariant(result.albumGain) : QVariant());
+        query.bindValue(":album_peak", result.analysed ? QVariant(result.albumPeak) : QVariant());
+        query.bindValue(":status", result.analysed ? 1 : 0);
+        query.bindValue(":id", result.trackId);
+        if (!query.exec()) {
+            logError("Store loudness result", query);
+            success = false;
+            break;
+        }
+    }
+
+    if (ownTransaction) {
+        if (success) {
+            success = m_db.commit();
+        } else {
+            m_db.rollback();
+        }
+    }
+    return success;
+}
+
+QByteArray DatabaseManager::getWaveform(const QString& filePath)
+{
+    // Off the main thread this doesn't wait behind scans holding the mutex
+    const bool mainThread = QThread::currentThread() == thread();
+    QMutexLocker locker(mainThread ? &m_databaseMutex : nullptr);
+    QSqlDatabase db = mainThread ? m_db : connectionForCurrentThread();
+    if (!db.isOpen()) return QByteArray();
+
+    QSqlQuery query(db);
+    query.prepare("SELECT w.peaks FROM waveforms w JOIN tracks t ON t.id = w.track_id "
+                  "WHERE t.file_path = :path");
+    query.bindValue(":path", filePath);
+    if (query.exec() && query.next()) {
+        return query.value(0).toByteArray();
+    }
+    return QByteArray();
+}
+
+bool DatabaseManager::hasWaveform(const QString& filePath)
+{
+    const bool mainThread = QThread::currentThread() == thread();
+    QMutexLocker locker(mainThread ? &m_databaseMutex : nullptr);
+    QSqlDatabase db = mainThread ? m_db : connectionForCurrentThread();
+    if (!db.isOpen()) return false;
+
+    QSqlQuery query(db);
+    query.prepare("SELECT EXISTS (SELECT 1 FROM waveforms w JOIN tracks t ON t.id = w.track_id "
+                  "WHERE t.file_path = :path)");
+    query.bindValue(":path", filePath);
+    return query.exec() && query.next() && query.value(0).toBool();
+}
+
+bool DatabaseManager::storeWaveform(const QString& filePath, const QByteArray& peaks)
+{
+    QMutexLocker locker(&m_databaseMutex);
+    if (!m_db.isOpen()) return false;
+
+    // Files outside the library have no track row and are only kept in memory
+    QSqlQuery query(m_db);
+    query.prepare("INSERT OR REPLACE INTO waveforms (track_id, peaks) "
+                  "SELECT id, :peaks FROM tracks WHERE file_path = :path");
+    query.bindValue(":peaks", peaks);
+    query.bindValue(":path", filePath);
+    if (!query.exec()) {
+        logError("Store waveform", query);
+        return false;
+    }
+    return true;
+}
+
+QStringList DatabaseManager::getTrackPathsWithoutWaveform()
+{
+    QMutexLocker locker(&m_databaseMutex);
+    QStringList paths;
+    if (!m_db.isOpen()) return paths;
+
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT t.file_path FROM tracks t "
+                    "LEFT JOIN waveforms w ON w.track_id = t.id "
+                    "WHERE w.track_id IS NULL ORDER BY t.sort_key")) {
+        logError("Get tracks without waveform", query);
+        return paths;
+    }
+    while (query.next()) {
+        paths.append(query.value(0).toString());
+    }
+    return paths;
+}
+
+bool DatabaseManager::getAnalysedReplayGain(const QString& filePath, double* trackGain, double* albumGain)
+{
+    QMutexLocker locker(&m_databaseMutex);
+    if (!m_db.isOpen()) return false;
+
+    QSqlQuery query(m_db);
+    query.prepare("SELECT replaygain_track_gain, replaygain_album_gain FROM tracks "
+                  "WHERE file_path = :path AND loudness_analysis = 1");
+    query.bindValue(":path", filePath);
+    if (!query.exec() || !query.next()) {
+        return false;
+    }
+
+    if (trackGain) *trackGain = query.value(0).toDouble();
+    if (albumGain) *albumGain = query.value(1).toDouble();
+    return true;
+}
+
+bool DatabaseManager::createTrackSortKeyTriggers()
+{
+    QSqlQuery query(m_db);
+
+    // Built by concatenation rather than QString::arg() because the expression contains printf() markers
+    const QString setSortKey = QString("UPDATE tracks SET sort_key = ") + TRACK_SORT_KEY_EXPR + " ";
+
+    const QStringList triggers = {
+        "CREATE TRIGGER IF NOT EXISTS trg_tracks_sort_key_insert "
+        "AFTER INSERT ON tracks BEGIN " + setSortKey + "WHERE id = NEW.id; END",
+
+        // sort_key itself is not in the column list, so the inner UPDATE does not recurse
+        "CREATE TRIGGER IF NOT EXISTS trg_tracks_sort_key_update "
+        "AFTER UPDATE OF title, artist_id, album_id, disc_number, track_number ON tracks BEGIN "
+        + setSortKey + "WHERE id = NEW.id; END",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_tracks_sort_key_album_update "
+        "AFTER UPDATE OF title, album_artist_id ON albums BEGIN "
+        + setSortKey + "WHERE album_id = NEW.id; END",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_tracks_sort_key_artist_rename "
+        "AFTER UPDATE OF name ON album_artists BEGIN "
+        + setSortKey + "WHERE album_id IN (SELECT id FROM albums WHERE album_artist_id = NEW.id); END",
+
+        // The track artist only decides whether a track is hidden
+        "CREATE TRIGGER IF NOT EXISTS trg_tracks_sort_key_track_artist_rename "
+        "AFTER UPDATE OF name ON artists BEGIN "
+        + setSortKey + "WHERE artist_id = NEW.id; END",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_tracks_sort_key_track_artist_delete "
+        "AFTER DELETE ON artists BEGIN "
+        + setSortKey + "WHERE artist_id = OLD.id; END"
+    };
+
+    for (const QString& sql : triggers) {
+        if (!query.exec(sql)) {
+            logError("Create sort_key trigger", query);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool DatabaseManager::createAlbumSummaryTriggers(QSqlDatabase& db)
+{
+    QSqlQuery query(db);
+
+    static const char* const triggers[] = {
+        // Album rows
+        "CREATE TRIGGER IF NOT EXISTS trg_album_summary_album_insert "
+        "AFTER INSERT ON albums BEGIN "
+        "  INSERT OR REPLACE INTO album_summary (album_id, title, album_artist_name, year, "
+        "    track_count, total_duration, has_art) "
+        "  VALUES (NEW.id, NEW.title, "
+        "    (SELECT name FROM album_artists WHERE id = NEW.album_artist_id), NEW.year, 0, 0, "
+        "    EXISTS (SELECT 1 FROM album_art WHERE album_id = NEW.id)); "
+        "END",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_album_summary_album_update "
+        "AFTER UPDATE OF title, album_artist_id, year ON albums BEGIN "
+        "  UPDATE album_summary SET title = NEW.title, year = NEW.year, "
+        "    album_artist_name = (SELECT name FROM album_artists WHERE id = NEW.album_artist_id) "
+        "  WHERE album_id = NEW.id; "
+        "END",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_album_summary_album_delete "
+        "AFTER DELETE ON albums BEGIN "
+        "  DELETE FROM album_summary WHERE album_id = OLD.id; "
+        "END",
+
+        // Album artist renames
+        "CREATE TRIGGER IF NOT EXISTS trg_album_summary_artist_rename "
+        "AFTER UPDATE OF name ON album_artists BEGIN "
+        "  UPDATE album_summary SET album_artist_name = NEW.name "
+        "  WHERE album_id IN (SELECT id FROM albums WHERE album_artist_id = NEW.id); "
+        "END",
+
+        // Track rows
+        "CREATE TRIGGER IF NOT EXISTS trg_album_summary_track_insert "
+        "AFTER INSERT ON tracks WHEN NEW.album_id IS NOT NULL BEGIN "
+        "  UPDATE album_summary SET track_count = track_count + 1, "
+        "    total_duration = total_duration + COALESCE(NEW.duration, 0) "
+        "  WHERE album_id = NEW.album_id; "
+        "END",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_album_summary_track_delete "
+        "AFTER DELETE ON tracks WHEN OLD.album_id IS NOT NULL BEGIN "
+        "  UPDATE album_summary SET track_count = track_count - 1, "
+        "    total_duration = total_duration - COALESCE(OLD.duration, 0) "
+        "  WHERE album_id = OLD.album_id; "
+        "END",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_album_summary_track_update "
+        "AFTER UPDATE OF album_id, duration ON tracks BEGIN "
+        "  UPDATE album_summary SET track_count = track_count - 1, "
+        "    total_duration = total_duration - COALESCE(OLD.duration, 0) "
+        "  WHERE album_id = OLD.album_id; "
+        "  UPDATE album_summary SET track_count = track_count + 1, "
+        "    total_duration = total_duration + COALESCE(NEW.duration, 0) "
+        "  WHERE album_id = NEW.album_id; "
+        "END",
+
+        // Album art
+        "CREATE TRIGGER IF NOT EXISTS trg_album_summary_art_insert "
+        "AFTER INSERT ON album_art BEGIN "
+        "  UPDATE album_summary SET has_art = 1 WHERE album_id = NEW.album_id; "
+        "END",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_album_summary_art_delete "
+        "AFTER DELETE ON album_art BEGIN "
+        "  UPDATE album_summary SET has_art = 0 WHERE album_id = OLD.album_id; "
+        "END"
+    };
+
+    for (const char* sql : triggers) {
+        if (!query.exec(QString::fromLatin1(sql))) {
+            logError("Create album_summary trigger", query);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool DatabaseManager::populateAlbumSummary(QSqlDatabase& db)
+{
+    QSqlQuery query(db);
+
+    if (!query.exec("DELETE FROM album_summary")) {
+        logError("Clear album_summary", query);
+        return false;
+    }
+
+    if (!query.exec(
+        "INSERT INTO album_summary (album_id, title, album_artist_name, year, "
+        "track_count, total_duration, has_art) "
+        "SELECT al.id, al.title, aa.name, al.year, "
+        "COUNT(t.id), COALESCE(SUM(t.duration), 0), "
+        "EXISTS (SELECT 1 FROM album_art art WHERE art.album_id = al.id) "
+        "FROM albums al "
+        "LEFT JOIN album_artists aa ON al.album_artist_id = aa.id "
+        "LEFT JOIN tracks t ON al.id = t.album_id "
+        "GROUP BY al.id")) {
+        logError("Populate album_summary", query);
+        return false;
+    }
+
     return true;
 }
 
@@ -679,6 +1444,8 @@ bool DatabaseManager::updateTrack(int trackId, const QVariantMap& trackData)
     if (trackData.contains("replayGainTrackGain")) {
         setClauses << "replaygain_track_gain = :replaygain_track_gain";
         bindValues[":replaygain_track_gain"] = trackData.value("replayGainTrackGain");
+        // Gain from tags replaces a measured one
+        setClauses << "loudness_analysis = NULL";
     }
     
     if (trackData.contains("replayGainTrackPeak")) {
@@ -964,10 +1731,8 @@ QVariantList DatabaseManager::getAllTracks(int limit, int offset)
         "LEFT JOIN artists a ON t.artist_id = a.id "
         "LEFT JOIN albums al ON t.album_id = al.id "
         "LEFT JOIN album_artists aa ON al.album_artist_id = aa.id "
-        "WHERE t.title IS NOT NULL AND t.title != '' "
-        "AND (a.name IS NOT NULL AND a.name != '' OR t.artist_id IS NULL) "
-        "ORDER BY aa.name COLLATE NOCASE, al.title COLLATE NOCASE, "
-        "t.disc_number, t.track_number, t.title COLLATE NOCASE";
+        "WHERE t.sort_key IS NOT NULL "
+        "ORDER BY t.sort_key";
     
     if (limit > 0) {
         queryStr += " LIMIT :limit";
@@ -1023,13 +1788,8 @@ int DatabaseManager::getTrackCount()
     }
     
     QSqlQuery query(m_db);
-    // Match the filtering criteria used in getAllTracks
-    query.prepare(
-        "SELECT COUNT(*) FROM tracks t "
-        "LEFT JOIN artists a ON t.artist_id = a.id "
-        "WHERE t.title IS NOT NULL AND t.title != '' "
-        "AND (a.name IS NOT NULL AND a.name != '' OR t.artist_id IS NULL)"
-    );
+    // Match the filtering criteria used in getAllTracks (hidden tracks have no sort key)
+    query.prepare("SELECT COUNT(*) FROM tracks WHERE sort_key IS NOT NULL");
     
     if (query.exec() && query.next()) {
         return query.value(0).toInt();
@@ -1039,6 +1799,171 @@ int DatabaseManager::getTrackCount()
     return 0;
 }
 
+int DatabaseManager::countTracksBefore(const QString& sortKey)
+{
+    if (!m_db.isOpen() || sortKey.isEmpty()) return 0;
+
+    // Range count over idx_tracks_sort_key: the row index of sortKey in getAllTracks() order
+    QSqlQuery query(m_db);
+    query.prepare("SELECT COUNT(*) FROM tracks WHERE sort_key < :key");
+    query.bindValue(":key", sortKey);
+
+    if (query.exec() && query.next()) {
+        return query.value(0).toInt();
+    }
+
+    logError("Count tracks before key", query);
+    return 0;
+}
+
+int DatabaseManager::getTrackRow(int trackId)
+{
+    if (!m_db.isOpen()) return -1;
+
+    QSqlQuery query(m_db);
+    query.prepare("SELECT sort_key FROM tracks WHERE id = :id AND sort_key IS NOT NULL");
+    query.bindValue(":id", trackId);
+
+    if (!query.exec()) {
+        logError("Get track row", query);
+        return -1;
+    }
+    if (!query.next()) {
+        return -1;
+    }
+
+    QString sortKey = query.value(0).toString();
+    query.finish();
+    return countTracksBefore(sortKey);
+}
+
+QSqlDatabase DatabaseManager::connectionForCurrentThread()
+{
+    // Same pattern as getAllTracks: main thread uses the shared connection,
+    // worker threads get (and reuse) a connection of their own
+    if (QThread::currentThread() == this->thread()) {
+        QMutexLocker locker(&m_databaseMutex);
+        return m_db;
+    }
+
+    QString connectionName = QString("MtocThread_%1").arg(quintptr(QThread::currentThreadId()));
+    if (QSqlDatabase::contains(connectionName)) {
+        return QSqlDatabase::database(connectionName);
+    }
+    return createThreadConnection(connectionName);
+}
+
+QVector<TrackKeyAnchor> DatabaseManager::getTrackKeyAnchors(int interval, bool favoritesOnly, const QString& fromKey)
+{
+    QVector<TrackKeyAnchor> anchors;
+    if (interval <= 0) return anchors;
+
+    QSqlDatabase db = connectionForCurrentThread();
+    if (!db.isOpen()) {
+        qWarning() << "[DatabaseManager::getTrackKeyAnchors] Database is not open!";
+        return anchors;
+    }
+
+    // Walks only the covering index, keeping every interval-th key
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if (favoritesOnly) {
+        query.prepare("SELECT favorited_at, id FROM tracks WHERE is_favorite = 1 ORDER BY favorited_at, id");
+    } else if (!fromKey.isEmpty()) {
+        // Resample only the tail, starting at (and including) an anchor that is still valid
+        query.prepare("SELECT sort_key, id FROM tracks WHERE sort_key >= :key ORDER BY sort_key");
+        query.bindValue(":key", fromKey);
+    } else {
+        query.prepare("SELECT sort_key, id FROM tracks WHERE sort_key IS NOT NULL ORDER BY sort_key");
+    }
+
+    if (!query.exec()) {
+        logError("Get track key anchors", query);
+        return anchors;
+    }
+
+    int row = 0;
+    while (query.next()) {
+        if (row % interval == 0) {
+            TrackKeyAnchor anchor;
+            anchor.sortKey = query.value(0).toString();
+            anchor.id = query.value(1).toInt();
+            anchors.append(anchor);
+        }
+        ++row;
+    }
+
+    return anchors;
+}
+
+QVariantList DatabaseManager::getTracksFromAnchor(const TrackKeyAnchor& anchor, int skip, int limit, bool favoritesOnly)
+{
+    QVariantList tracks;
+    if (limit <= 0) return tracks;
+
+    QSqlDatabase db = connectionForCurrentThread();
+    if (!db.isOpen()) {
+        qWarning() << "[DatabaseManager::getTracksFromAnchor] Database is not open!";
+        return tracks;
+    }
+
+    QString queryStr =
+        "SELECT t.id, t.file_path, t.title, a.name as artist_name, al.title as album_title, "
+        "aa.name as album_artist_name, t.genre, t.year, t.track_number, t.disc_number, "
+        "t.duration, t.file_size, t.last_played, t.play_count, t.rating, t.is_favorite "
+        "FROM tracks t "
+        "LEFT JOIN artists a ON t.artist_id = a.id "
+        "LEFT JOIN albums al ON t.album_id = al.id "
+        "LEFT JOIN album_artists aa ON al.album_artist_id = aa.id ";
+
+    // The anchor seeks straight into the index; skip is bounded by the anchor interval
+    if (favoritesOnly) {
+        queryStr += "WHERE t.is_favorite = 1 AND (t.favorited_at, t.id) >= (:key, :id) "
+                    "ORDER BY t.favorited_at, t.id ";
+    } else {
+        queryStr += "WHERE t.sort_key >= :key ORDER BY t.sort_key ";
+    }
+    queryStr += "LIMIT :limit OFFSET :skip";
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    query.prepare(queryStr);
+    query.bindValue(":key", anchor.sortKey);
+    if (favoritesOnly) {
+        query.bindValue(":id", anchor.id);
+    }
+    query.bindValue(":limit", limit);
+    query.bindValue(":skip", qMax(0, skip));
+
+    if (!query.exec()) {
+        logError("Get tracks from anchor", query);
+        return tracks;
+    }
+
+    while (query.next()) {
+        QVariantMap track;
+        track["id"] = query.value("id");
+        track["filePath"] = query.value("file_path");
+        track["title"] = query.value("title");
+        track["artist"] = query.value("artist_name");
+        track["album"] = query.value("album_title");
+        track["albumArtist"] = query.value("album_artist_name");
+        track["genre"] = query.value("genre");
+        track["year"] = query.value("year");
+        track["trackNumber"] = query.value("track_number");
+        track["discNumber"] = query.value("disc_number");
+        track["duration"] = query.value("duration");
+        track["fileSize"] = query.value("file_size");
+        track["lastPlayed"] = query.value("last_played");
+        track["playCount"] = query.value("play_count");
+        track["rating"] = query.value("rating");
+        track["isFavorite"] = query.value("is_favorite").toBool();
+        tracks.append(track);
+    }
+
+    return tracks;
+}
+
 int DatabaseManager::insertOrGetArtist(const QString& artistName)
 {
     if (!m_db.isOpen() || artistName.isEmpty()) return 0;
@@ -1223,6 +2148,127 @@ int DatabaseManager::getTrackIdByPath(const QString& filePath)
     return 0;
 }
 
+QVariantMap ResolvedTrack::toVariantMap() const
+{
+    QVariantMap track;
+    track["id"] = id;
+    track["filePath"] = filePath;
+    track["title"] = title;
+    track["artist"] = artist;
+    track["album"] = album;
+    track["albumArtist"] = albumArtist;
+    track["genre"] = genre;
+    track["year"] = year;
+    track["trackNumber"] = trackNumber;
+    track["discNumber"] = discNumber;
+    track["duration"] = duration;
+    track["fileSize"] = fileSize;
+    track["isFavorite"] = isFavorite;
+    return track;
+}
+
+QList<ResolvedTrack> DatabaseManager::resolveTracksById(const QList<int>& trackIds)
+{
+    QVariantList keys;
+    keys.reserve(trackIds.size());
+    for (int trackId : trackIds) {
+        keys.append(trackId);
+    }
+    return resolveTracks(keys, "id");
+}
+
+QList<ResolvedTrack> DatabaseManager::resolveTracksByPath(const QStringList& filePaths)
+{
+    QVariantList keys;
+    keys.reserve(filePaths.size());
+    for (const QString& filePath : filePaths) {
+        keys.append(filePath);
+    }
+    return resolveTracks(keys, "file_path");
+}
+
+QList<ResolvedTrack> DatabaseManager::resolveTracks(const QVariantList& keys, const QString& keyColumn)
+{
+    QMutexLocker locker(&m_databaseMutex);
+    QList<ResolvedTrack> tracks(keys.size());
+    if (!m_db.isOpen() || keys.isEmpty()) return tracks;
+
+    // The keys go into a temp table and are joined against tracks, so a list of
+    // any length is a single statement instead of one lookup per track
+    QSqlQuery query(m_db);
+    if (!query.exec("CREATE TEMP TABLE IF NOT EXISTS resolve_keys (pos INTEGER PRIMARY KEY, track_key)")) {
+        logError("Create resolve_keys", query);
+        return tracks;
+    }
+
+    // Fails harmlessly if a transaction is already open; the inserts then join it
+    bool ownTransaction = m_db.transaction();
+
+    query.exec("DELETE FROM resolve_keys");
+
+    QVariantList positions;
+    positions.reserve(keys.size());
+    for (int i = 0; i < keys.size(); ++i) {
+        positions.append(i);
+    }
+    query.prepare("INSERT INTO resolve_keys (pos, track_key) VALUES (?, ?)");
+    query.addBindValue(positions);
+    query.addBindValue(keys);
+    if (!query.execBatch()) {
+        logError("Fill resolve_keys", query);
+        if (ownTransaction) {
+            m_db.rollback();
+        }
+        return tracks;
+    }
+
+    QSqlQuery select(m_db);
+    select.setForwardOnly(true);
+    select.prepare(
+        "SELECT k.pos, t.id, t.file_path, t.title, a.name, al.title, aa.name, t.genre, t.year, "
+        "t.track_number, t.disc_number, t.duration, t.file_size, t.is_favorite "
+        "FROM resolve_keys k "
+        "JOIN tracks t ON t." + keyColumn + " = k.track_key "
+        "LEFT JOIN artists a ON t.artist_id = a.id "
+        "LEFT JOIN albums al ON t.album_id = al.id "
+        "LEFT JOIN album_artists aa ON al.album_artist_id = aa.id "
+        "ORDER BY k.pos"
+    );
+
+    if (!select.exec()) {
+        logError("Resolve tracks", select);
+    } else {
+        while (select.next()) {
+            int pos = select.value(0).toInt();
+            if (pos < 0 || pos >= tracks.size()) {
+                continue;
+            }
+            ResolvedTrack& track = tracks[pos];
+            track.id = select.value(1).toInt();
+            track.filePath = select.value(2).toString();
+            track.title = select.value(3).toString();
+            track.artist = select.value(4).toString();
+            track.album = select.value(5).toString();
+            track.albumArtist = select.value(6).toString();
+            track.genre = select.value(7).toString();
+            track.year = select.value(8).toInt();
+            track.trackNumber = select.value(9).toInt();
+            track.discNumber = select.value(10).toInt();
+            track.duration = select.value(11).toInt();
+            track.fileSize = select.value(12).toLongLong();
+            track.isFavorite = select.value(13).toBool();
+        }
+    }
+    select.finish();
+
+    query.exec("DELETE FROM resolve_keys");
+    if (ownTransaction) {
+        m_db.commit();
+    }
+
+    return tracks;
+}
+
 QStringList DatabaseManager::getAllTracksFilePaths()
 {
     QStringList filePaths;
@@ -1539,6 +2585,7 @@ bool DatabaseManager::clearDatabase()
     query.exec("DELETE FROM playlists");
     query.exec("DELETE FROM tracks");
     query.exec("DELETE FROM albums");
+    query.exec("DELETE FROM album_summary");
     query.exec("DELETE FROM album_artists");
     query.exec("DELETE FROM artists");
     
@@ -1645,22 +2692,25 @@ qint64 DatabaseManager::getTotalDuration()
 }
 
 QVariantList DatabaseManager::getAllAlbums()
+{
+    return getAllAlbums(m_db);
+}
+
+QVariantList DatabaseManager::getAllAlbums(QSqlDatabase& db)
 {
     QVariantList albums;
-    if (!m_db.isOpen()) return albums;
+    if (!db.isOpen()) return albums;
     
-    QSqlQuery query(m_db);
+    // album_summary is maintained by triggers, so this is a plain indexed read
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
     query.prepare(
-        "SELECT al.id, al.title, al.year, aa.name as album_artist_name, "
-        "COUNT(t.id) as track_count, SUM(t.duration) as total_duration, "
-        "CASE WHEN art.id IS NOT NULL THEN 1 ELSE 0 END as has_art "
-        "FROM albums al "
-        "LEFT JOIN album_artists aa ON al.album_artist_id = aa.id "
-        "INNER JOIN tracks t ON al.id = t.album_id "
-        "LEFT JOIN album_art art ON al.id = art.album_id "
-        "GROUP BY al.id, al.title, al.year, aa.name, art.id "
-        "HAVING COUNT(t.id) > 0 "
-        "ORDER BY al.title COLLATE NOCASE"
+        "SELECT s.album_id, s.title, s.year, s.album_artist_name, s.track_count, s.total_duration, s.has_art, "
+        "al.created_at "
+        "FROM album_summary s "
+        "JOIN albums al ON al.id = s.album_id "
+        "WHERE s.track_count > 0 "
+        "ORDER BY s.title COLLATE NOCASE"
     );
     
     if (!query.exec()) {
@@ -1670,36 +2720,193 @@ QVariantList DatabaseManager::getAllAlbums()
     
     while (query.next()) {
         QVariantMap album;
-        album["id"] = query.value("id");
-        album["title"] = query.value("title");
-        album["albumArtist"] = query.value("album_artist_name");
-        album["year"] = query.value("year");
-        album["trackCount"] = query.value("track_count");
-        album["duration"] = query.value("total_duration");
-        album["hasArt"] = query.value("has_art").toBool();
+        album["id"] = query.value(0);
+        album["title"] = query.value(1);
+        album["albumArtist"] = query.value(3);
+        album["year"] = query.value(2);
+        album["trackCount"] = query.value(4);
+        album["duration"] = query.value(5);
+        album["hasArt"] = query.value(6).toBool();
+        album["dateAdded"] = query.value(7);
         albums.append(album);
     }
     
     return albums;
 }
 
+QVariantList DatabaseManager::getAlbumsByIds(const QList<int>& albumIds)
+{
+    QVariantList albums;
+    if (!m_db.isOpen() || albumIds.isEmpty()) return albums;
+
+    // Same rows as getAllAlbums(), restricted to the given ids
+    QStringList placeholders;
+    for (int i = 0; i < albumIds.size(); ++i) {
+        placeholders.append("?");
+    }
+
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    query.prepare(
+        "SELECT s.album_id, s.title, s.year, s.album_artist_name, s.track_count, s.total_duration, s.has_art, "
+        "al.created_at "
+        "FROM album_summary s "
+        "JOIN albums al ON al.id = s.album_id "
+        "WHERE s.track_count > 0 AND s.album_id IN (" + placeholders.join(",") + ")"
+    );
+    for (int albumId : albumIds) {
+        query.addBindValue(albumId);
+    }
+
+    if (!query.exec()) {
+        logError("Get albums by ids", query);
+        return albums;
+    }
+
+    while (query.next()) {
+        QVariantMap album;
+        album["id"] = query.value(0);
+        album["title"] = query.value(1);
+        album["albumArtist"] = query.value(3);
+        album["year"] = query.value(2);
+        album["trackCount"] = query.value(4);
+        album["duration"] = query.value(5);
+        album["hasArt"] = query.value(6).toBool();
+        album["dateAdded"] = query.value(7);
+        albums.append(album);
+    }
+
+    return albums;
+}
+
+int DatabaseManager::checkAlbumSummaryConsistency(QSqlDatabase& db)
+{
+    if (!db.isOpen()) return -1;
+
+    // Compare every summary row against a fresh aggregate, and catch albums
+    // that are missing from (or stale in) the summary table entirely
+    QSqlQuery query(db);
+    if (!query.exec(
+        "SELECT COUNT(*) FROM ("
+        "  SELECT al.id AS album_id, al.title, aa.name AS album_artist_name, al.year, "
+        "  COUNT(t.id) AS track_count, COALESCE(SUM(t.duration), 0) AS total_duration, "
+        "  EXISTS (SELECT 1 FROM album_art art WHERE art.album_id = al.id) AS has_art "
+        "  FROM albums al "
+        "  LEFT JOIN album_artists aa ON al.album_artist_id = aa.id "
+        "  LEFT JOIN tracks t ON al.id = t.album_id "
+        "  GROUP BY al.id "
+        "  EXCEPT "
+        "  SELECT album_id, title, album_artist_name, year, track_count, total_duration, has_art "
+        "  FROM album_summary"
+        ") "
+        "UNION ALL "
+        "SELECT COUNT(*) FROM album_summary s "
+        "WHERE NOT EXISTS (SELECT 1 FROM albums al WHERE al.id = s.album_id)")) {
+        logError("Check album_summary consistency", query);
+        return -1;
+    }
+
+    int mismatches = 0;
+    while (query.next()) {
+        mismatches += query.value(0).toInt();
+    }
+
+    if (mismatches > 0) {
+        qWarning() << "DatabaseManager: album_summary has" << mismatches << "inconsistent rows";
+    }
+    return mismatches;
+}
+
+bool DatabaseManager::rebuildAlbumSummary()
+{
+    QMutexLocker locker(&m_databaseMutex);
+    return rebuildAlbumSummary(m_db);
+}
+
+bool DatabaseManager::rebuildAlbumSummary(QSqlDatabase& db)
+{
+    if (!db.isOpen()) return false;
+
+    if (!db.transaction()) {
+        qWarning() << "Failed to start transaction for rebuildAlbumSummary";
+        return false;
+    }
+
+    // Recreate triggers too in case they were dropped by an external tool
+    if (!createAlbumSummaryTriggers(db) || !populateAlbumSummary(db)) {
+        db.rollback();
+        return false;
+    }
+
+    if (!db.commit()) {
+        qWarning() << "Failed to commit album_summary rebuild";
+        db.rollback();
+        return false;
+    }
+
+    qDebug() << "DatabaseManager: album_summary rebuilt";
+    return true;
+}
+
 QVariantList DatabaseManager::getAllArtists()
+{
+    return queryArtists(m_db, QStringList());
+}
+
+QVariantList DatabaseManager::getAllArtists(QSqlDatabase& db)
+{
+    return queryArtists(db, QStringList());
+}
+
+QVariantList DatabaseManager::getArtistsByNames(const QStringList& names)
+{
+    if (names.isEmpty()) return QVariantList();
+    return queryArtists(m_db, names);
+}
+
+QVariantList DatabaseManager::queryArtists(QSqlDatabase& db, const QStringList& names)
 {
     QVariantList artists;
-    if (!m_db.isOpen()) return artists;
+    if (!db.isOpen()) return artists;
 
     // Check if junction table exists - if not, ensure migration runs
-    QSqlQuery checkQuery(m_db);
+    QSqlQuery checkQuery(db);
     checkQuery.exec("SELECT name FROM sqlite_master WHERE type='table' AND name='album_album_artists'");
     bool junctionTableExists = checkQuery.next();
 
-    QSqlQuery query(m_db);
+    // Optional filter for incremental updates. SQLite's lower() only folds ASCII, so
+    // both spellings are offered and the exact grouping is redone below with toLower().
+    QString nameFilter;
+    QStringList filterValues;
+    if (!names.isEmpty()) {
+        QSet<QString> lowered;
+        for (const QString& name : names) {
+            lowered.insert(name.toLower());
+            lowered.insert(name);
+        }
+        filterValues = QStringList(lowered.begin(), lowered.end());
+        QStringList placeholders;
+        for (int i = 0; i < filterValues.size(); ++i) {
+            placeholders.append("?");
+        }
+        nameFilter = "WHERE lower(aa.name) IN (" + placeholders.join(",") + ") ";
+    }
+
+    auto execArtistQuery = [&](QSqlQuery& query, const QString& sql) {
+        query.prepare(sql);
+        for (const QString& value : std::as_const(filterValues)) {
+            query.addBindValue(value);
+        }
+        return query.exec();
+    };
+
+    QSqlQuery query(db);
 
     if (junctionTableExists) {
         // Get album artists using junction table - includes artists from collab albums
         // Uses LEFT JOIN for backward compatibility with databases that haven't been scanned yet
         // Note: We fetch without ORDER BY and sort in C++ for locale-aware sorting
-        if (!query.exec(
+        if (!execArtistQuery(query,
             "SELECT aa.id, aa.name, aa.created_at, "
             "COUNT(DISTINCT COALESCE(aaa.album_id, al_direct.id)) as album_count, "
             "COUNT(DISTINCT t.id) as track_count "
@@ -1708,6 +2915,7 @@ QVariantList DatabaseManager::getAllArtists()
             "LEFT JOIN albums al_direct ON aa.id = al_direct.album_artist_id "
             "LEFT JOIN albums al ON (aaa.album_id = al.id OR al_direct.id = al.id) "
             "LEFT JOIN tracks t ON al.id = t.album_id "
+            + nameFilter +
             "GROUP BY aa.id, aa.name, aa.created_at "
             "HAVING COUNT(t.id) > 0"
         )) {
@@ -1718,12 +2926,13 @@ QVariantList DatabaseManager::getAllArtists()
         // Fallback to old query without junction table for backward compatibility
         qWarning() << "Junction table 'album_album_artists' does not exist, using fallback query. "
                    << "Please restart the application to apply database migrations.";
-        if (!query.exec(
+        if (!execArtistQuery(query,
             "SELECT aa.*, COUNT(DISTINCT al.id) as album_count, "
             "COUNT(DISTINCT t.id) as track_count "
             "FROM album_artists aa "
             "INNER JOIN albums al ON aa.id = al.album_artist_id "
             "INNER JOIN tracks t ON al.id = t.album_id "
+            + nameFilter +
             "GROUP BY aa.id "
             "HAVING COUNT(t.id) > 0"
         )) {
@@ -1768,34 +2977,33 @@ QVariantList DatabaseManager::getAllArtists()
         artists.append(artist);
     }
 
-    // Sort using locale-aware comparison to match JavaScript's localeCompare
     std::sort(artists.begin(), artists.end(), [](const QVariant& a, const QVariant& b) {
-        QVariantMap artistA = a.toMap();
-        QVariantMap artistB = b.toMap();
-        QString nameA = artistA["name"].toString().toLower();
-        QString nameB = artistB["name"].toString().toLower();
-
-        // Remove "the " prefix for sorting (case-insensitive)
-        if (nameA.startsWith("the ")) {
-            nameA = nameA.mid(4);
-        }
-        if (nameB.startsWith("the ")) {
-            nameB = nameB.mid(4);
-        }
+        return artistNameLessThan(a.toMap().value("name").toString(), b.toMap().value("name").toString());
+    });
 
-        // First, separate letters from non-letters (numbers/symbols go last)
-        bool aStartsWithLetter = !nameA.isEmpty() && nameA[0].isLetter();
-        bool bStartsWithLetter = !nameB.isEmpty() && nameB[0].isLetter();
+    return artists;
+}
 
-        if (aStartsWithLetter != bStartsWithLetter) {
-            return aStartsWithLetter; // Letters come before non-letters
-        }
+bool DatabaseManager::artistNameLessThan(const QString& a, const QString& b)
+{
+    // Locale-aware to match JavaScript's localeCompare, ignoring a leading "the "
+    QString nameA = a.toLower();
+    QString nameB = b.toLower();
+    if (nameA.startsWith("the ")) {
+        nameA = nameA.mid(4);
+    }
+    if (nameB.startsWith("the ")) {
+        nameB = nameB.mid(4);
+    }
 
-        // Use locale-aware comparison for consistent sorting with accented characters
-        return nameA.localeAwareCompare(nameB) < 0;
-    });
+    // Letters come before numbers and symbols
+    bool aStartsWithLetter = !nameA.isEmpty() && nameA[0].isLetter();
+    bool bStartsWithLetter = !nameB.isEmpty() && nameB[0].isLetter();
+    if (aStartsWithLetter != bStartsWithLetter) {
+        return aStartsWithLetter;
+    }
 
-    return artists;
+    return nameA.localeAwareCompare(nameB) < 0;
 }
 
 QVariantList DatabaseManager::getAlbumsByAlbumArtist(int albumArtistId)
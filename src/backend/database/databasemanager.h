@@ -7,10 +7,59 @@
 #include <QString>
 #include <QVariantMap>
 #include <QMutex>
+#include <QVector>
 #include <memory>
 
 namespace Mtoc {
 
+// Position in a keyset-ordered track listing. For "All Songs" sortKey is the
+// tracks.sort_key column; for favorites it is favorited_at, paired with the id.
+struct TrackKeyAnchor {
+    QString sortKey;
+    int id = 0;
+};
+
+// A track row looked up by id or path with resolveTracksById()/resolveTracksByPath().
+// Rows for keys that matched nothing are left invalid.
+struct ResolvedTrack {
+    int id = 0;
+    QString filePath;
+    QString title;
+    QString artist;
+    QString album;
+    QString albumArtist;
+    QString genre;
+    int year = 0;
+    int trackNumber = 0;
+    int discNumber = 0;
+    int duration = 0;  // in seconds
+    qint64 fileSize = 0;
+    bool isFavorite = false;
+
+    bool isValid() const { return id > 0; }
+    QVariantMap toVariantMap() const;  // Same keys as getTrack(), without lyrics and play stats
+};
+
+// A track without ReplayGain tags, queued for LoudnessAnalyzer
+struct LoudnessAnalysisTrack {
+    int id = 0;
+    QString filePath;
+    int albumId = 0;  // 0 if the track has no album
+};
+
+// Gains in dB, peaks linear. Tracks with nothing to measure are stored with
+// analysed unset so later runs skip them; ones that failed to decode are
+// counted as an attempt and tried again by later runs.
+struct LoudnessResult {
+    int trackId = 0;
+    bool analysed = false;
+    bool failed = false;
+    double trackGain = 0.0;
+    double trackPeak = 0.0;
+    double albumGain = 0.0;
+    double albumPeak = 0.0;
+};
+
 class DatabaseManager : public QObject
 {
     Q_OBJECT
@@ -34,6 +83,14 @@ public:
     QVariantList getTracksByAlbumAndArtist(const QString& albumTitle, const QString& albumArtistName);
     QVariantList getAllTracks(int limit = -1, int offset = 0);
     int getTrackCount();
+    int countTracksBefore(const QString& sortKey);  // Row of sortKey in getAllTracks() order
+    int getTrackRow(int trackId);                   // -1 if the track is gone or hidden
+    
+    // Keyset pagination: sample every interval-th key once, then seek from the
+    // nearest anchor instead of walking OFFSET rows from the start
+    QVector<TrackKeyAnchor> getTrackKeyAnchors(int interval, bool favoritesOnly = false,
+                                               const QString& fromKey = QString());
+    QVariantList getTracksFromAnchor(const TrackKeyAnchor& anchor, int skip, int limit, bool favoritesOnly = false);
 
     // Favorites operations
     bool setTrackFavorite(int trackId, bool favorite);
@@ -49,6 +106,8 @@ public:
     QVariantMap getAlbum(int albumId);
     QVariantMap getAlbumByTitleAndArtist(const QString& albumTitle, const QString& albumArtist);
     QVariantList getAllAlbums();
+    QVariantList getAllAlbums(QSqlDatabase& db);
+    QVariantList getAlbumsByIds(const QList<int>& albumIds);
     QVariantList getAlbumsByAlbumArtist(int albumArtistId);
     QVariantList getAlbumsByAlbumArtistName(const QString& albumArtistName);
     int getAlbumIdByArtistAndTitle(const QString& albumArtist, const QString& albumTitle);
@@ -58,6 +117,9 @@ public:
     int insertOrGetAlbumArtist(const QString& albumArtistName);
     QVariantMap getArtist(int artistId);
     QVariantList getAllArtists();
+    QVariantList getAllArtists(QSqlDatabase& db);
+    QVariantList getArtistsByNames(const QStringList& names);  // Merged like getAllArtists()
+    static bool artistNameLessThan(const QString& a, const QString& b);  // getAllArtists() order
     int getAlbumArtistIdByName(const QString& albumArtistName);
     
     // Search operations
@@ -76,9 +138,44 @@ public:
     int getTotalArtists();
     qint64 getTotalDuration(); // Total duration in seconds
     
+    // Album summary maintenance (album_summary is kept current by triggers).
+    // The db overloads run on the caller's own connection, e.g. the scanner's.
+    int checkAlbumSummaryConsistency(QSqlDatabase& db);  // Returns number of stale rows, -1 on error
+    bool rebuildAlbumSummary();
+    bool rebuildAlbumSummary(QSqlDatabase& db);
+    
+    // Bumped by triggers whenever browse data (albums, album artists) changes;
+    // -1 if unavailable
+    qint64 libraryGeneration();
+    
+    // Measured loudness for tracks without ReplayGain tags. It is stored in the
+    // replaygain_* columns with loudness_analysis set; tags found by a later
+    // scan replace it. A track that fails to decode is tried again by later
+    // runs until it has failed this many times.
+    static constexpr int MAX_LOUDNESS_ATTEMPTS = 3;
+    QList<LoudnessAnalysisTrack> getTracksForLoudnessAnalysis();
+    bool storeLoudnessResults(const QList<LoudnessResult>& results);
+    bool getAnalysedReplayGain(const QString& filePath, double* trackGain, double* albumGain);
+    
+    // Seek bar waveforms, keyed by track and dropped with it. The reads are
+    // meant for a worker thread, where they use its own connection.
+    QByteArray getWaveform(const QString& filePath);
+    bool hasWaveform(const QString& filePath);
+    bool storeWaveform(const QString& filePath, const QByteArray& peaks);
+    QStringList getTrackPathsWithoutWaveform();
+    
+    // PRAGMA quick_check on the given connection; safe to call from a worker
+    // thread. Emits databaseError if the database is damaged.
+    bool checkIntegrity(QSqlDatabase& db);
+    
     // Check if file already exists in database
     bool trackExists(const QString& filePath);
     int getTrackIdByPath(const QString& filePath);
+    
+    // Batch lookups for queues and playlists: one query for the whole list,
+    // returning exactly one row per key in the order given
+    QList<ResolvedTrack> resolveTracksById(const QList<int>& trackIds);
+    QList<ResolvedTrack> resolveTracksByPath(const QStringList& filePaths);
     QStringList getAllTracksFilePaths();
     
     // Batch operations
@@ -89,6 +186,7 @@ public:
     // Thread-safe operations
     static QSqlDatabase createThreadConnection(const QString& connectionName);
     static void removeThreadConnection(const QString& connectionName);
+    QSqlDatabase connectionForCurrentThread();  // Shared connection on the main thread
     
     // Helper for accent-insensitive search
     static QString normalizeForSearch(const QString& text);
@@ -127,8 +225,14 @@ private:
     bool createTables();
     bool createIndexes();
     bool applyMigrations(int currentVersion);
+    bool createAlbumSummaryTriggers(QSqlDatabase& db);
+    bool createTrackSortKeyTriggers();
+    bool createLibraryGenerationTriggers();
+    bool populateAlbumSummary(QSqlDatabase& db);
     QString getDatabasePath() const;
     void logError(const QString& operation, const QSqlQuery& query);
+    QVariantList queryArtists(QSqlDatabase& db, const QStringList& names);
+    QList<ResolvedTrack> resolveTracks(const QVariantList& keys, const QString& keyColumn);
     
     QSqlDatabase m_db;
     QMutex m_databaseMutex;
@@ -109,7 +109,7 @@ void AlbumArtImageResponse::loadImage()
             }
             
             // Look up album ID from artist and album name
-            albumId = databaseManager->getAlbumIdByArtistAndTitle(artist, album);
+            albumId = m_libraryManager->albumIdForArtistAndTitle(artist, album);
             if (albumId <= 0) {
                 qWarning() << "AlbumArtImageProvider: Album not found:" << artist << "-" << album;
                 m_image = QImage(1, 1, QImage::Format_ARGB32);
@@ -0,0 +1,188 @@
+#include "albumlistmodel.h"
+#include <QDateTime>
+
+namespace Mtoc {
+
+AlbumListModel::AlbumListModel(QObject *parent)
+    : LibraryListModel(parent)
+{
+}
+
+QVariant AlbumListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || !isValidRow(index.row()))
+        return QVariant();
+
+    const int row = index.row();
+    switch (role) {
+    case AlbumIdRole:
+        return m_ids[row];
+    case Qt::DisplayRole:
+    case TitleRole:
+        return m_rows.titles[row];
+    case AlbumArtistRole:
+        return m_rows.albumArtists[row];
+    case YearRole:
+        return m_rows.years[row];
+    case TrackCountRole:
+        return m_rows.trackCounts[row];
+    case DurationRole:
+        return m_rows.durations[row];
+    case HasArtRole:
+        return m_rows.hasArt[row];
+    case DateAddedRole:
+        return m_rows.dateAdded[row];
+    }
+
+    return QVariant();
+}
+
+QHash<int, QByteArray> AlbumListModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[AlbumIdRole] = "albumId";
+    roles[TitleRole] = "title";
+    roles[AlbumArtistRole] = "albumArtist";
+    roles[YearRole] = "year";
+    roles[TrackCountRole] = "trackCount";
+    roles[DurationRole] = "duration";
+    roles[HasArtRole] = "hasArt";
+    roles[DateAddedRole] = "dateAdded";
+    return roles;
+}
+
+QVariantMap AlbumListModel::get(int row) const
+{
+    QVariantMap album;
+    if (!isValidRow(row))
+        return album;
+
+    album["id"] = m_ids[row];
+    album["title"] = m_rows.titles[row];
+    album["albumArtist"] = m_rows.albumArtists[row];
+    album["year"] = m_rows.years[row];
+    album["trackCount"] = m_rows.trackCounts[row];
+    album["duration"] = m_rows.durations[row];
+    album["hasArt"] = m_rows.hasArt[row];
+    album["dateAdded"] = m_rows.dateAdded[row];
+    return album;
+}
+
+void AlbumListModel::setAlbums(const QVariantList &albums)
+{
+    applyIncoming(stageIncoming(albums));
+    m_incoming.clear();
+}
+
+void AlbumListModel::applyAlbumChanges(const QSet<int> &removedIds, const QVariantList &albums)
+{
+    applyDelta(removedIds, stageIncoming(albums));
+    m_incoming.clear();
+}
+
+QVector<int> AlbumListModel::stageIncoming(const QVariantList &albums)
+{
+    QVector<int> ids;
+    ids.reserve(albums.size());
+    m_incoming.clear();
+    m_incoming.titles.reserve(albums.size());
+    m_incoming.albumArtists.reserve(albums.size());
+    m_incoming.years.reserve(albums.size());
+    m_incoming.trackCounts.reserve(albums.size());
+    m_incoming.durations.reserve(albums.size());
+    m_incoming.hasArt.reserve(albums.size());
+    m_incoming.dateAdded.reserve(albums.size());
+
+    for (const QVariant &value : albums) {
+        const QVariantMap album = value.toMap();
+        ids.append(album.value("id").toInt());
+        m_incoming.titles.append(album.value("title").toString());
+        m_incoming.albumArtists.append(album.value("albumArtist").toString());
+        m_incoming.years.append(album.value("year").toInt());
+        m_incoming.trackCounts.append(album.value("trackCount").toInt());
+        m_incoming.durations.append(album.value("duration").toInt());
+        m_incoming.hasArt.append(album.value("hasArt").toBool());
+        // SQLite CURRENT_TIMESTAMP text uses a space rather than ISO's 'T'
+        QDateTime added = album.value("dateAdded").toDateTime();
+        if (!added.isValid())
+            added = QDateTime::fromString(album.value("dateAdded").toString(), "yyyy-MM-dd HH:mm:ss");
+        m_incoming.dateAdded.append(added.isValid() ? added.toSecsSinceEpoch() : 0);
+    }
+
+    return ids;
+}
+
+void AlbumListModel::removeStoredRows(int row, int count)
+{
+    m_rows.titles.remove(row, count);
+    m_rows.albumArtists.remove(row, count);
+    m_rows.years.remove(row, count);
+    m_rows.trackCounts.remove(row, count);
+    m_rows.durations.remove(row, count);
+    m_rows.hasArt.remove(row, count);
+    m_rows.dateAdded.remove(row, count);
+}
+
+void AlbumListModel::insertStoredRows(int row, int incomingRow, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        m_rows.titles.insert(row + i, m_incoming.titles[incomingRow + i]);
+        m_rows.albumArtists.insert(row + i, m_incoming.albumArtists[incomingRow + i]);
+        m_rows.years.insert(row + i, m_incoming.years[incomingRow + i]);
+        m_rows.trackCounts.insert(row + i, m_incoming.trackCounts[incomingRow + i]);
+        m_rows.durations.insert(row + i, m_incoming.durations[incomingRow + i]);
+        m_rows.hasArt.insert(row + i, m_incoming.hasArt[incomingRow + i]);
+        m_rows.dateAdded.insert(row + i, m_incoming.dateAdded[incomingRow + i]);
+    }
+}
+
+bool AlbumListModel::storedRowDiffers(int row, int incomingRow) const
+{
+    return m_rows.titles[row] != m_incoming.titles[incomingRow]
+        || m_rows.albumArtists[row] != m_incoming.albumArtists[incomingRow]
+        || m_rows.years[row] != m_incoming.years[incomingRow]
+        || m_rows.trackCounts[row] != m_incoming.trackCounts[incomingRow]
+        || m_rows.durations[row] != m_incoming.durations[incomingRow]
+        || m_rows.hasArt[row] != m_incoming.hasArt[incomingRow]
+        || m_rows.dateAdded[row] != m_incoming.dateAdded[incomingRow];
+}
+
+void AlbumListModel::copyStoredRow(int row, int incomingRow)
+{
+    m_rows.titles[row] = m_incoming.titles[incomingRow];
+    m_rows.albumArtists[row] = m_incoming.albumArtists[incomingRow];
+    m_rows.years[row] = m_incoming.years[incomingRow];
+    m_rows.trackCounts[row] = m_incoming.trackCounts[incomingRow];
+    m_rows.durations[row] = m_incoming.durations[incomingRow];
+    m_rows.hasArt[row] = m_incoming.hasArt[incomingRow];
+    m_rows.dateAdded[row] = m_incoming.dateAdded[incomingRow];
+}
+
+void AlbumListModel::adoptIncoming()
+{
+    std::swap(m_rows, m_incoming);
+}
+
+void AlbumListModel::clearStored()
+{
+    m_rows.clear();
+}
+
+int AlbumListModel::compareIncoming(int incomingRow, int row) const
+{
+    // Approximates the ORDER BY title COLLATE NOCASE used by getAllAlbums()
+    return QString::compare(m_incoming.titles[incomingRow], m_rows.titles[row], Qt::CaseInsensitive);
+}
+
+void AlbumListModel::Columns::clear()
+{
+    titles.clear();
+    albumArtists.clear();
+    years.clear();
+    trackCounts.clear();
+    durations.clear();
+    hasArt.clear();
+    dateAdded.clear();
+}
+
+} // namespace Mtoc
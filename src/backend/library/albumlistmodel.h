@@ -0,0 +1,68 @@
+#ifndef ALBUMLISTMODEL_H
+#define ALBUMLISTMODEL_H
+
+#include "librarylistmodel.h"
+
+namespace Mtoc {
+
+// All albums in library order, backed by DatabaseManager::getAllAlbums()
+class AlbumListModel : public LibraryListModel
+{
+    Q_OBJECT
+
+public:
+    enum AlbumRoles {
+        AlbumIdRole = Qt::UserRole + 1,
+        TitleRole,
+        AlbumArtistRole,
+        YearRole,
+        TrackCountRole,
+        DurationRole,
+        HasArtRole,
+        DateAddedRole
+    };
+    Q_ENUM(AlbumRoles)
+
+    explicit AlbumListModel(QObject *parent = nullptr);
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    // Same keys as the maps returned by DatabaseManager::getAllAlbums()
+    Q_INVOKABLE QVariantMap get(int row) const override;
+
+    void setAlbums(const QVariantList &albums);
+    // Incremental update from a library change journal; albums are full rows as above
+    void applyAlbumChanges(const QSet<int> &removedIds, const QVariantList &albums);
+
+protected:
+    void removeStoredRows(int row, int count) override;
+    void insertStoredRows(int row, int incomingRow, int count) override;
+    bool storedRowDiffers(int row, int incomingRow) const override;
+    void copyStoredRow(int row, int incomingRow) override;
+    void adoptIncoming() override;
+    void clearStored() override;
+    int compareIncoming(int incomingRow, int row) const override;
+
+private:
+    struct Columns {
+        QVector<QString> titles;
+        QVector<QString> albumArtists;
+        QVector<int> years;
+        QVector<int> trackCounts;
+        QVector<int> durations;
+        QVector<bool> hasArt;
+        QVector<qint64> dateAdded;  // Seconds since epoch
+
+        void clear();
+    };
+
+    QVector<int> stageIncoming(const QVariantList &albums);
+
+    Columns m_rows;
+    Columns m_incoming;
+};
+
+} // namespace Mtoc
+
+#endif // ALBUMLISTMODEL_H
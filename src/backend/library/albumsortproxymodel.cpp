@@ -0,0 +1,244 @@
+#include "albumsortproxymodel.h"
+#include "albumlistmodel.h"
+#include <QDebug>
+#include <QElapsedTimer>
+
+namespace Mtoc {
+
+AlbumSortProxyModel::AlbumSortProxyModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+{
+    m_collator.setCaseSensitivity(Qt::CaseInsensitive);
+    m_collator.setNumericMode(true);
+    m_collator.setIgnorePunctuation(false);
+
+    setDynamicSortFilter(true);
+
+    // Any change in proxy rows invalidates the id -> row index
+    auto markDirty = [this]() { m_rowIndexDirty = true; };
+    connect(this, &QAbstractItemModel::modelReset, this, markDirty);
+    connect(this, &QAbstractItemModel::layoutChanged, this, markDirty);
+    connect(this, &QAbstractItemModel::rowsInserted, this, markDirty);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, markDirty);
+    connect(this, &QAbstractItemModel::rowsMoved, this, markDirty);
+
+    connect(this, &QAbstractItemModel::modelReset, this, &AlbumSortProxyModel::countChanged);
+    connect(this, &QAbstractItemModel::rowsInserted, this, &AlbumSortProxyModel::countChanged);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, &AlbumSortProxyModel::countChanged);
+}
+
+void AlbumSortProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    if (m_albums) {
+        disconnect(m_albums, nullptr, this, nullptr);
+    }
+
+    m_albums = qobject_cast<AlbumListModel*>(sourceModel);
+    rebuildAllKeys();
+
+    if (m_albums) {
+        // Connected before the base class hooks up its own handlers, so the keys
+        // are current by the time the proxy sorts new or changed rows
+        connect(m_albums, &QAbstractItemModel::rowsInserted, this,
+                [this](const QModelIndex &, int first, int last) { buildKeys(first, last); });
+        connect(m_albums, &QAbstractItemModel::dataChanged, this, &AlbumSortProxyModel::rebuildChangedKeys);
+        connect(m_albums, &QAbstractItemModel::rowsAboutToBeRemoved, this, &AlbumSortProxyModel::dropKeys);
+        connect(m_albums, &QAbstractItemModel::modelAboutToBeReset, this, [this]() { m_keys.clear(); });
+        connect(m_albums, &QAbstractItemModel::modelReset, this, &AlbumSortProxyModel::rebuildAllKeys);
+    }
+
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+    sort(0);
+}
+
+void AlbumSortProxyModel::setSortOrder(SortOrder order)
+{
+    if (m_sortOrder == order)
+        return;
+
+    m_sortOrder = order;
+
+    QElapsedTimer timer;
+    timer.start();
+    invalidate();
+    sort(0);
+    qDebug() << "[AlbumSortProxyModel::setSortOrder] Sorted" << rowCount() << "albums in" << timer.elapsed() << "ms";
+
+    emit sortOrderChanged();
+}
+
+void AlbumSortProxyModel::setFilterText(const QString &text)
+{
+    if (m_filterText == text)
+        return;
+
+    m_filterText = text;
+    invalidateFilter();
+    emit filterTextChanged();
+    emit countChanged();
+}
+
+int AlbumSortProxyModel::sourceRowAt(int row) const
+{
+    if (row < 0 || row >= rowCount())
+        return -1;
+    return mapToSource(index(row, 0)).row();
+}
+
+int AlbumSortProxyModel::rowOfId(int albumId) const
+{
+    if (m_rowIndexDirty)
+        rebuildRowIndex();
+    return m_rowById.value(albumId, -1);
+}
+
+int AlbumSortProxyModel::idAt(int row) const
+{
+    return m_albums ? m_albums->idAt(sourceRowAt(row)) : -1;
+}
+
+QVariantMap AlbumSortProxyModel::get(int row) const
+{
+    return m_albums ? m_albums->get(sourceRowAt(row)) : QVariantMap();
+}
+
+bool AlbumSortProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    if (!m_albums)
+        return QSortFilterProxyModel::lessThan(left, right);
+
+    const int l = left.row();
+    const int r = right.row();
+    const SortKeys *lkp = keysFor(l);
+    const SortKeys *rkp = keysFor(r);
+    if (!lkp || !rkp) {
+        qWarning() << "[AlbumSortProxyModel::lessThan] Missing collation keys for source rows" << l << r;
+        return l < r;
+    }
+    const SortKeys &lk = *lkp;
+    const SortKeys &rk = *rkp;
+
+    auto byArtist = [&]() -> int {
+        // Names starting with digits or symbols go after letters, like the artist list
+        if (lk.artistStartsWithLetter != rk.artistStartsWithLetter)
+            return lk.artistStartsWithLetter ? -1 : 1;
+        return lk.artist.compare(rk.artist);
+    };
+    auto byYearDesc = [&]() -> int {
+        int ly = m_albums->data(left, AlbumListModel::YearRole).toInt();
+        int ry = m_albums->data(right, AlbumListModel::YearRole).toInt();
+        return ly == ry ? 0 : (ly > ry ? -1 : 1);
+    };
+    auto byTitle = [&]() -> int {
+        return lk.title.compare(rk.title);
+    };
+
+    int result = 0;
+    switch (m_sortOrder) {
+    case ByArtist:
+        if ((result = byArtist()) == 0 && (result = byYearDesc()) == 0)
+            result = byTitle();
+        break;
+    case ByTitle:
+        if ((result = byTitle()) == 0)
+            result = byArtist();
+        break;
+    case ByYear:
+        if ((result = byYearDesc()) == 0 && (result = byArtist()) == 0)
+            result = byTitle();
+        break;
+    case ByDateAdded: {
+        qint64 la = m_albums->data(left, AlbumListModel::DateAddedRole).toLongLong();
+        qint64 ra = m_albums->data(right, AlbumListModel::DateAddedRole).toLongLong();
+        result = la == ra ? 0 : (la > ra ? -1 : 1);
+        if (result == 0 && (result = byArtist()) == 0)
+            result = byTitle();
+        break;
+    }
+    }
+
+    // Stable tie-break so equal keys never swap places between sorts
+    return result != 0 ? result < 0 : l < r;
+}
+
+bool AlbumSortProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    if (m_filterText.isEmpty() || !m_albums)
+        return true;
+
+    const QModelIndex idx = m_albums->index(sourceRow, 0, sourceParent);
+    return m_albums->data(idx, AlbumListModel::TitleRole).toString().contains(m_filterText, Qt::CaseInsensitive)
+        || m_albums->data(idx, AlbumListModel::AlbumArtistRole).toString().contains(m_filterText, Qt::CaseInsensitive);
+}
+
+const AlbumSortProxyModel::SortKeys *AlbumSortProxyModel::keysFor(int sourceRow) const
+{
+    auto it = m_keys.find(m_albums->idAt(sourceRow));
+    return it != m_keys.end() ? &it->second : nullptr;
+}
+
+void AlbumSortProxyModel::buildKeys(int first, int last)
+{
+    for (int row = first; row <= last; ++row) {
+        const QModelIndex idx = m_albums->index(row, 0);
+        const QString artist = stripArticle(m_albums->data(idx, AlbumListModel::AlbumArtistRole).toString());
+        const QString title = stripArticle(m_albums->data(idx, AlbumListModel::TitleRole).toString());
+
+        SortKeys keys{m_collator.sortKey(artist), m_collator.sortKey(title),
+                      !artist.isEmpty() && artist.at(0).isLetter()};
+        m_keys.insert_or_assign(m_albums->idAt(row), std::move(keys));
+    }
+}
+
+void AlbumSortProxyModel::rebuildAllKeys()
+{
+    m_keys.clear();
+    if (!m_albums)
+        return;
+
+    QElapsedTimer timer;
+    timer.start();
+    const int rows = m_albums->rowCount();
+    m_keys.reserve(rows);
+    buildKeys(0, rows - 1);
+    qDebug() << "[AlbumSortProxyModel::rebuildAllKeys] Collated" << rows << "albums in" << timer.elapsed() << "ms";
+}
+
+void AlbumSortProxyModel::rebuildChangedKeys(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    buildKeys(topLeft.row(), bottomRight.row());
+}
+
+void AlbumSortProxyModel::dropKeys(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent)
+    for (int row = first; row <= last; ++row) {
+        m_keys.erase(m_albums->idAt(row));
+    }
+}
+
+QString AlbumSortProxyModel::stripArticle(const QString &text) const
+{
+    static const QStringList articles = { QStringLiteral("the "), QStringLiteral("a "), QStringLiteral("an ") };
+
+    const QString trimmed = text.trimmed();
+    for (const QString &article : articles) {
+        if (trimmed.size() > article.size() && trimmed.startsWith(article, Qt::CaseInsensitive)) {
+            return trimmed.mid(article.size());
+        }
+    }
+    return trimmed;
+}
+
+void AlbumSortProxyModel::rebuildRowIndex() const
+{
+    m_rowById.clear();
+    const int rows = rowCount();
+    m_rowById.reserve(rows);
+    for (int row = 0; row < rows; ++row) {
+        m_rowById.insert(m_albums->idAt(mapToSource(index(row, 0)).row()), row);
+    }
+    m_rowIndexDirty = false;
+}
+
+} // namespace Mtoc
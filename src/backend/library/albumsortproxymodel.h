@@ -0,0 +1,85 @@
+#ifndef ALBUMSORTPROXYMODEL_H
+#define ALBUMSORTPROXYMODEL_H
+
+#include <QSortFilterProxyModel>
+#include <QCollator>
+#include <QCollatorSortKey>
+#include <QHash>
+#include <unordered_map>
+
+namespace Mtoc {
+
+class AlbumListModel;
+
+// Sorted, filterable view over AlbumListModel for the album carousel. Collation
+// keys (locale-aware, case-insensitive, leading articles stripped) are computed
+// once per album when it enters the source model, so a re-sort only compares
+// precomputed keys instead of re-collating strings.
+class AlbumSortProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(SortOrder sortOrder READ sortOrder WRITE setSortOrder NOTIFY sortOrderChanged)
+    Q_PROPERTY(QString filterText READ filterText WRITE setFilterText NOTIFY filterTextChanged)
+
+public:
+    enum SortOrder {
+        ByArtist = 0,   // Album artist, then newest year first
+        ByTitle,
+        ByYear,         // Newest year first, then album artist
+        ByDateAdded     // Most recently added first
+    };
+    Q_ENUM(SortOrder)
+
+    explicit AlbumSortProxyModel(QObject *parent = nullptr);
+
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
+    int count() const { return rowCount(); }
+    SortOrder sortOrder() const { return m_sortOrder; }
+    void setSortOrder(SortOrder order);
+    QString filterText() const { return m_filterText; }
+    void setFilterText(const QString &text);
+
+    Q_INVOKABLE int sourceRowAt(int row) const;
+    Q_INVOKABLE int rowOfId(int albumId) const;
+    Q_INVOKABLE int idAt(int row) const;
+    Q_INVOKABLE QVariantMap get(int row) const;
+
+signals:
+    void countChanged();
+    void sortOrderChanged();
+    void filterTextChanged();
+
+protected:
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    struct SortKeys {
+        QCollatorSortKey artist;
+        QCollatorSortKey title;
+        bool artistStartsWithLetter;
+    };
+
+    const SortKeys *keysFor(int sourceRow) const;
+    void buildKeys(int first, int last);
+    void rebuildAllKeys();
+    void rebuildChangedKeys(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void dropKeys(const QModelIndex &parent, int first, int last);
+    QString stripArticle(const QString &text) const;
+    void rebuildRowIndex() const;
+
+    AlbumListModel *m_albums = nullptr;
+    SortOrder m_sortOrder = ByArtist;
+    QString m_filterText;
+    QCollator m_collator;
+
+    std::unordered_map<int, SortKeys> m_keys;          // Album id -> collation keys
+    mutable QHash<int, int> m_rowById;                 // Album id -> proxy row
+    mutable bool m_rowIndexDirty = true;
+};
+
+} // namespace Mtoc
+
+#endif // ALBUMSORTPROXYMODEL_H
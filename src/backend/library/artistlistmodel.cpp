@@ -0,0 +1,189 @@
+#include "artistlistmodel.h"
+#include "../database/databasemanager.h"
+
+namespace Mtoc {
+
+ArtistListModel::ArtistListModel(QObject *parent)
+    : LibraryListModel(parent)
+{
+    auto markDirty = [this]() { m_nameIndexDirty = true; };
+    connect(this, &QAbstractItemModel::modelReset, this, markDirty);
+    connect(this, &QAbstractItemModel::rowsInserted, this, markDirty);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, markDirty);
+    connect(this, &QAbstractItemModel::dataChanged, this, markDirty);
+}
+
+QVariant ArtistListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || !isValidRow(index.row()))
+        return QVariant();
+
+    const int row = index.row();
+    switch (role) {
+    case ArtistIdRole:
+        return m_ids[row];
+    case Qt::DisplayRole:
+    case NameRole:
+        return m_rows.names[row];
+    case AlbumCountRole:
+        return m_rows.albumCounts[row];
+    case TrackCountRole:
+        return m_rows.trackCounts[row];
+    }
+
+    return QVariant();
+}
+
+QHash<int, QByteArray> ArtistListModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[ArtistIdRole] = "artistId";
+    roles[NameRole] = "name";
+    roles[AlbumCountRole] = "albumCount";
+    roles[TrackCountRole] = "trackCount";
+    return roles;
+}
+
+QVariantMap ArtistListModel::get(int row) const
+{
+    QVariantMap artist;
+    if (!isValidRow(row))
+        return artist;
+
+    artist["id"] = m_ids[row];
+    artist["name"] = m_rows.names[row];
+    artist["albumCount"] = m_rows.albumCounts[row];
+    artist["trackCount"] = m_rows.trackCounts[row];
+    return artist;
+}
+
+QString ArtistListModel::nameAt(int row) const
+{
+    return isValidRow(row) ? m_rows.names[row] : QString();
+}
+
+int ArtistListModel::indexOfName(const QString &name, bool caseSensitive) const
+{
+    if (m_nameIndexDirty)
+        rebuildNameIndex();
+
+    if (caseSensitive)
+        return m_rowByName.value(name, -1);
+    return m_rowByFoldedName.value(name.toCaseFolded(), -1);
+}
+
+void ArtistListModel::rebuildNameIndex() const
+{
+    m_rowByName.clear();
+    m_rowByFoldedName.clear();
+    m_rowByName.reserve(m_rows.names.size());
+    m_rowByFoldedName.reserve(m_rows.names.size());
+    for (int row = 0; row < m_rows.names.size(); ++row) {
+        m_rowByName.insert(m_rows.names[row], row);
+        // First row wins for names that only differ by case
+        if (!m_rowByFoldedName.contains(m_rows.names[row].toCaseFolded()))
+            m_rowByFoldedName.insert(m_rows.names[row].toCaseFolded(), row);
+    }
+    m_nameIndexDirty = false;
+}
+
+void ArtistListModel::setArtists(const QVariantList &artists)
+{
+    applyIncoming(stageIncoming(artists));
+    m_incoming.clear();
+}
+
+void ArtistListModel::applyArtistChanges(const QStringList &affectedNames, const QVariantList &artists)
+{
+    QVector<int> ids = stageIncoming(artists);
+
+    // Artists are merged case-insensitively, so the representative id of a name
+    // can change; any stale row for an affected name is dropped
+    QSet<int> removedIds;
+    for (const QString &name : affectedNames) {
+        int row = indexOfName(name, false);
+        if (row >= 0 && !ids.contains(m_ids[row]))
+            removedIds.insert(m_ids[row]);
+    }
+
+    applyDelta(removedIds, ids);
+    m_incoming.clear();
+}
+
+QVector<int> ArtistListModel::stageIncoming(const QVariantList &artists)
+{
+    QVector<int> ids;
+    ids.reserve(artists.size());
+    m_incoming.clear();
+    m_incoming.names.reserve(artists.size());
+    m_incoming.albumCounts.reserve(artists.size());
+    m_incoming.trackCounts.reserve(artists.size());
+
+    for (const QVariant &value : artists) {
+        const QVariantMap artist = value.toMap();
+        ids.append(artist.value("id").toInt());
+        m_incoming.names.append(artist.value("name").toString());
+        m_incoming.albumCounts.append(artist.value("albumCount").toInt());
+        m_incoming.trackCounts.append(artist.value("trackCount").toInt());
+    }
+
+    return ids;
+}
+
+void ArtistListModel::removeStoredRows(int row, int count)
+{
+    m_rows.names.remove(row, count);
+    m_rows.albumCounts.remove(row, count);
+    m_rows.trackCounts.remove(row, count);
+}
+
+void ArtistListModel::insertStoredRows(int row, int incomingRow, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        m_rows.names.insert(row + i, m_incoming.names[incomingRow + i]);
+        m_rows.albumCounts.insert(row + i, m_incoming.albumCounts[incomingRow + i]);
+        m_rows.trackCounts.insert(row + i, m_incoming.trackCounts[incomingRow + i]);
+    }
+}
+
+bool ArtistListModel::storedRowDiffers(int row, int incomingRow) const
+{
+    return m_rows.names[row] != m_incoming.names[incomingRow]
+        || m_rows.albumCounts[row] != m_incoming.albumCounts[incomingRow]
+        || m_rows.trackCounts[row] != m_incoming.trackCounts[incomingRow];
+}
+
+void ArtistListModel::copyStoredRow(int row, int incomingRow)
+{
+    m_rows.names[row] = m_incoming.names[incomingRow];
+    m_rows.albumCounts[row] = m_incoming.albumCounts[incomingRow];
+    m_rows.trackCounts[row] = m_incoming.trackCounts[incomingRow];
+}
+
+void ArtistListModel::adoptIncoming()
+{
+    std::swap(m_rows, m_incoming);
+}
+
+void ArtistListModel::clearStored()
+{
+    m_rows.clear();
+}
+
+int ArtistListModel::compareIncoming(int incomingRow, int row) const
+{
+    const QString &incoming = m_incoming.names[incomingRow];
+    const QString &stored = m_rows.names[row];
+    if (DatabaseManager::artistNameLessThan(incoming, stored))
+        return -1;
+    return DatabaseManager::artistNameLessThan(stored, incoming) ? 1 : 0;
+}
+
+void ArtistListModel::Columns::clear()
+{
+    names.clear();
+    albumCounts.clear();
+    trackCounts.clear();
+}
+
+} // namespace Mtoc
@@ -0,0 +1,69 @@
+#ifndef ARTISTLISTMODEL_H
+#define ARTISTLISTMODEL_H
+
+#include "librarylistmodel.h"
+
+namespace Mtoc {
+
+// Album artists in display order, backed by DatabaseManager::getAllArtists()
+class ArtistListModel : public LibraryListModel
+{
+    Q_OBJECT
+
+public:
+    enum ArtistRoles {
+        ArtistIdRole = Qt::UserRole + 1,
+        NameRole,
+        AlbumCountRole,
+        TrackCountRole
+    };
+    Q_ENUM(ArtistRoles)
+
+    explicit ArtistListModel(QObject *parent = nullptr);
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    // Same keys as the maps returned by DatabaseManager::getAllArtists()
+    Q_INVOKABLE QVariantMap get(int row) const override;
+    Q_INVOKABLE QString nameAt(int row) const;
+    Q_INVOKABLE int indexOfName(const QString &name, bool caseSensitive = true) const;
+
+    void setArtists(const QVariantList &artists);
+    // Incremental update: every row whose name matches one of affectedNames
+    // (case-insensitively) is replaced by the matching entry in artists, if any
+    void applyArtistChanges(const QStringList &affectedNames, const QVariantList &artists);
+
+protected:
+    void removeStoredRows(int row, int count) override;
+    void insertStoredRows(int row, int incomingRow, int count) override;
+    bool storedRowDiffers(int row, int incomingRow) const override;
+    void copyStoredRow(int row, int incomingRow) override;
+    void adoptIncoming() override;
+    void clearStored() override;
+    int compareIncoming(int incomingRow, int row) const override;
+
+private:
+    struct Columns {
+        QVector<QString> names;
+        QVector<int> albumCounts;
+        QVector<int> trackCounts;
+
+        void clear();
+    };
+
+    QVector<int> stageIncoming(const QVariantList &artists);
+    void rebuildNameIndex() const;
+
+    Columns m_rows;
+    Columns m_incoming;
+
+    // Name lookups, rebuilt lazily after any row change
+    mutable QHash<QString, int> m_rowByName;
+    mutable QHash<QString, int> m_rowByFoldedName;
+    mutable bool m_nameIndexDirty = true;
+};
+
+} // namespace Mtoc
+
+#endif // ARTISTLISTMODEL_H
@@ -0,0 +1,278 @@
+#include "browsecache.h"
+
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QDir>
+#include <QFileInfo>
+#include <QVector>
+#include <QDateTime>
+#include <QHash>
+#include <QDebug>
+
+namespace Mtoc {
+
+namespace {
+
+const quint32 MAGIC = 0x4342544d;  // "MTBC"
+const quint32 BYTE_ORDER_MARK = 0x01020304;
+
+qint64 align8(qint64 offset)
+{
+    return (offset + 7) & ~qint64(7);
+}
+
+} // namespace
+
+struct BrowseCache::Header {
+    quint32 magic;
+    quint32 byteOrderMark;
+    quint32 version;
+    quint32 artistCount;
+    quint32 albumCount;
+    quint32 stringLength;  // In UTF-16 code units
+    qint64 generation;
+};
+
+struct BrowseCache::ArtistRecord {
+    qint32 id;
+    quint32 nameOffset;
+    quint32 nameLength;
+    qint32 albumCount;
+    qint32 trackCount;
+};
+
+struct BrowseCache::AlbumRecord {
+    qint64 dateAdded;  // Seconds since epoch
+    qint32 id;
+    quint32 titleOffset;
+    quint32 titleLength;
+    quint32 artistOffset;
+    quint32 artistLength;
+    qint32 year;
+    qint32 trackCount;
+    qint32 duration;
+    quint32 hasArt;
+    quint32 reserved;
+};
+
+BrowseCache::~BrowseCache()
+{
+    close();
+}
+
+QString BrowseCache::defaultPath()
+{
+    QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return QDir(dataPath).filePath("mtoc_browse.cache");
+}
+
+bool BrowseCache::open(const QString &path)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    m_size = m_file.size();
+    if (m_size < qint64(sizeof(Header))) {
+        close();
+        return false;
+    }
+
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        qWarning() << "[BrowseCache::open] Failed to map" << path << "-" << m_file.errorString();
+        close();
+        return false;
+    }
+
+    m_header = reinterpret_cast<const Header *>(m_data);
+    if (m_header->magic != MAGIC || m_header->byteOrderMark != BYTE_ORDER_MARK
+        || m_header->version != FORMAT_VERSION) {
+        qDebug() << "[BrowseCache::open] Ignoring cache with unknown format:" << path;
+        close();
+        return false;
+    }
+
+    qint64 albumsOffset = align8(sizeof(Header) + qint64(m_header->artistCount) * sizeof(ArtistRecord));
+    qint64 stringsOffset = albumsOffset + qint64(m_header->albumCount) * sizeof(AlbumRecord);
+    if (stringsOffset + qint64(m_header->stringLength) * qint64(sizeof(QChar)) != m_size) {
+        qWarning() << "[BrowseCache::open] Truncated or oversized cache:" << path;
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void BrowseCache::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar *>(m_data));
+    }
+    m_file.close();
+    m_data = nullptr;
+    m_header = nullptr;
+    m_size = 0;
+}
+
+qint64 BrowseCache::generation() const
+{
+    return m_header ? m_header->generation : -1;
+}
+
+int BrowseCache::artistCount() const
+{
+    return m_header ? int(m_header->artistCount) : 0;
+}
+
+int BrowseCache::albumCount() const
+{
+    return m_header ? int(m_header->albumCount) : 0;
+}
+
+QString BrowseCache::stringAt(quint32 offset, quint32 length) const
+{
+    if (!m_header || quint64(offset) + length > m_header->stringLength) {
+        return QString();
+    }
+    qint64 stringsOffset = m_size - qint64(m_header->stringLength) * qint64(sizeof(QChar));
+    const QChar *pool = reinterpret_cast<const QChar *>(m_data + stringsOffset);
+    return QString(pool + offset, length);
+}
+
+QVariantList BrowseCache::artists() const
+{
+    QVariantList artists;
+    if (!m_header) {
+        return artists;
+    }
+
+    const ArtistRecord *records = reinterpret_cast<const ArtistRecord *>(m_data + sizeof(Header));
+    artists.reserve(m_header->artistCount);
+    for (quint32 i = 0; i < m_header->artistCount; ++i) {
+        const ArtistRecord &record = records[i];
+        QVariantMap artist;
+        artist["id"] = record.id;
+        artist["name"] = stringAt(record.nameOffset, record.nameLength);
+        artist["albumCount"] = record.albumCount;
+        artist["trackCount"] = record.trackCount;
+        artists.append(artist);
+    }
+    return artists;
+}
+
+QVariantList BrowseCache::albums() const
+{
+    QVariantList albums;
+    if (!m_header) {
+        return albums;
+    }
+
+    qint64 albumsOffset = align8(sizeof(Header) + qint64(m_header->artistCount) * sizeof(ArtistRecord));
+    const AlbumRecord *records = reinterpret_cast<const AlbumRecord *>(m_data + albumsOffset);
+    albums.reserve(m_header->albumCount);
+    for (quint32 i = 0; i < m_header->albumCount; ++i) {
+        const AlbumRecord &record = records[i];
+        QVariantMap album;
+        album["id"] = record.id;
+        album["title"] = stringAt(record.titleOffset, record.titleLength);
+        album["albumArtist"] = stringAt(record.artistOffset, record.artistLength);
+        album["year"] = record.year;
+        album["trackCount"] = record.trackCount;
+        album["duration"] = record.duration;
+        album["hasArt"] = record.hasArt != 0;
+        album["dateAdded"] = record.dateAdded > 0 ? QDateTime::fromSecsSinceEpoch(record.dateAdded) : QDateTime();
+        albums.append(album);
+    }
+    return albums;
+}
+
+bool BrowseCache::write(const QString &path, qint64 generation,
+                        const QVariantList &artists, const QVariantList &albums)
+{
+    // Artist names and album artists repeat a lot, so the pool is deduplicated
+    QString pool;
+    QHash<QString, quint32> poolOffsets;
+    auto addString = [&pool, &poolOffsets](const QString &string) -> quint32 {
+        auto it = poolOffsets.constFind(string);
+        if (it != poolOffsets.constEnd()) {
+            return it.value();
+        }
+        quint32 offset = quint32(pool.size());
+        pool.append(string);
+        poolOffsets.insert(string, offset);
+        return offset;
+    };
+
+    QVector<ArtistRecord> artistRecords;
+    artistRecords.reserve(artists.size());
+    for (const QVariant &value : artists) {
+        const QVariantMap artist = value.toMap();
+        const QString name = artist.value("name").toString();
+        ArtistRecord record = {};
+        record.id = artist.value("id").toInt();
+        record.nameOffset = addString(name);
+        record.nameLength = quint32(name.size());
+        record.albumCount = artist.value("albumCount").toInt();
+        record.trackCount = artist.value("trackCount").toInt();
+        artistRecords.append(record);
+    }
+
+    QVector<AlbumRecord> albumRecords;
+    albumRecords.reserve(albums.size());
+    for (const QVariant &value : albums) {
+        const QVariantMap album = value.toMap();
+        const QString title = album.value("title").toString();
+        const QString albumArtist = album.value("albumArtist").toString();
+        AlbumRecord record = {};
+        record.dateAdded = album.value("dateAdded").toLongLong();
+        record.id = album.value("id").toInt();
+        record.titleOffset = addString(title);
+        record.titleLength = quint32(title.size());
+        record.artistOffset = addString(albumArtist);
+        record.artistLength = quint32(albumArtist.size());
+        record.year = album.value("year").toInt();
+        record.trackCount = album.value("trackCount").toInt();
+        record.duration = album.value("duration").toInt();
+        record.hasArt = album.value("hasArt").toBool() ? 1 : 0;
+        albumRecords.append(record);
+    }
+
+    Header header = {};
+    header.magic = MAGIC;
+    header.byteOrderMark = BYTE_ORDER_MARK;
+    header.version = FORMAT_VERSION;
+    header.artistCount = quint32(artistRecords.size());
+    header.albumCount = quint32(albumRecords.size());
+    header.stringLength = quint32(pool.size());
+    header.generation = generation;
+
+    qint64 artistsEnd = sizeof(Header) + qint64(artistRecords.size()) * sizeof(ArtistRecord);
+    qint64 albumsOffset = align8(artistsEnd);
+
+    QByteArray buffer;
+    buffer.reserve(albumsOffset + albumRecords.size() * sizeof(AlbumRecord) + pool.size() * sizeof(QChar));
+    buffer.append(reinterpret_cast<const char *>(&header), sizeof(Header));
+    buffer.append(reinterpret_cast<const char *>(artistRecords.constData()),
+                  artistRecords.size() * sizeof(ArtistRecord));
+    buffer.append(QByteArray(albumsOffset - artistsEnd, '\0'));
+    buffer.append(reinterpret_cast<const char *>(albumRecords.constData()),
+                  albumRecords.size() * sizeof(AlbumRecord));
+    buffer.append(reinterpret_cast<const char *>(pool.constData()), pool.size() * sizeof(QChar));
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(buffer) != buffer.size() || !file.commit()) {
+        qWarning() << "[BrowseCache::write] Failed to write" << path << "-" << file.errorString();
+        return false;
+    }
+
+    qDebug() << "[BrowseCache::write]" << artistRecords.size() << "artists," << albumRecords.size()
+             << "albums at generation" << generation << "-" << buffer.size() / 1024 << "KB";
+    return true;
+}
+
+} // namespace Mtoc
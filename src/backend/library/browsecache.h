@@ -0,0 +1,61 @@
+#ifndef BROWSECACHE_H
+#define BROWSECACHE_H
+
+#include <QString>
+#include <QVariantList>
+#include <QFile>
+
+namespace Mtoc {
+
+// On-disk copy of the album and artist browse lists, written in model order so
+// the library can render at launch without querying SQLite. The file is
+// memory-mapped and read in place; it records the DatabaseManager library
+// generation it was written at, which callers compare to decide whether the
+// rows still need a refresh.
+//
+// Layout (native byte order, guarded by the header's byte-order mark):
+//   Header | ArtistRecord[artistCount] | AlbumRecord[albumCount] | UTF-16 string pool
+class BrowseCache
+{
+public:
+    static const quint32 FORMAT_VERSION = 1;
+
+    BrowseCache() = default;
+    ~BrowseCache();
+    BrowseCache(const BrowseCache &) = delete;
+    BrowseCache &operator=(const BrowseCache &) = delete;
+
+    static QString defaultPath();
+
+    // Maps the file and validates its header and bounds; false if missing or unusable
+    bool open(const QString &path);
+    void close();
+
+    qint64 generation() const;
+    int artistCount() const;
+    int albumCount() const;
+
+    // Same keys as DatabaseManager::getAllArtists()/getAllAlbums()
+    QVariantList artists() const;
+    QVariantList albums() const;
+
+    // Writes atomically (temporary file + rename); safe to call from any thread
+    static bool write(const QString &path, qint64 generation,
+                      const QVariantList &artists, const QVariantList &albums);
+
+private:
+    struct Header;
+    struct ArtistRecord;
+    struct AlbumRecord;
+
+    QString stringAt(quint32 offset, quint32 length) const;
+
+    QFile m_file;
+    const uchar *m_data = nullptr;
+    qint64 m_size = 0;
+    const Header *m_header = nullptr;
+};
+
+} // namespace Mtoc
+
+#endif // BROWSECACHE_H
@@ -0,0 +1,80 @@
+#include "librarychangeset.h"
+#include <QVariantList>
+
+namespace Mtoc {
+
+namespace {
+
+QVariantList toList(const QSet<int>& ids)
+{
+    QVariantList list;
+    list.reserve(ids.size());
+    for (int id : ids) {
+        list.append(id);
+    }
+    return list;
+}
+
+QStringList toList(const QSet<QString>& names)
+{
+    return QStringList(names.begin(), names.end());
+}
+
+} // namespace
+
+bool LibraryChangeSet::isEmpty() const
+{
+    return !fullReset && !hasTrackMoves() && changedTracks.isEmpty()
+        && !hasAlbumChanges() && !hasArtistChanges();
+}
+
+bool LibraryChangeSet::hasAlbumChanges() const
+{
+    return !addedAlbums.isEmpty() || !removedAlbums.isEmpty() || !changedAlbums.isEmpty();
+}
+
+bool LibraryChangeSet::hasArtistChanges() const
+{
+    return !addedArtists.isEmpty() || !removedArtists.isEmpty() || !changedArtists.isEmpty();
+}
+
+void LibraryChangeSet::noteSortKey(const QString& sortKey)
+{
+    if (!sortKey.isEmpty() && (firstSortKey.isEmpty() || sortKey < firstSortKey)) {
+        firstSortKey = sortKey;
+    }
+}
+
+void LibraryChangeSet::merge(const LibraryChangeSet& other)
+{
+    addedTracks.unite(other.addedTracks);
+    removedTracks.unite(other.removedTracks);
+    changedTracks.unite(other.changedTracks);
+    addedAlbums.unite(other.addedAlbums);
+    removedAlbums.unite(other.removedAlbums);
+    changedAlbums.unite(other.changedAlbums);
+    addedArtists.unite(other.addedArtists);
+    removedArtists.unite(other.removedArtists);
+    changedArtists.unite(other.changedArtists);
+    removedTrackPaths.append(other.removedTrackPaths);
+    noteSortKey(other.firstSortKey);
+    fullReset = fullReset || other.fullReset;
+}
+
+QVariantMap LibraryChangeSet::toVariantMap() const
+{
+    QVariantMap map;
+    map["addedTracks"] = toList(addedTracks);
+    map["removedTracks"] = toList(removedTracks);
+    map["changedTracks"] = toList(changedTracks);
+    map["addedAlbums"] = toList(addedAlbums);
+    map["removedAlbums"] = toList(removedAlbums);
+    map["changedAlbums"] = toList(changedAlbums);
+    map["addedArtists"] = toList(addedArtists);
+    map["removedArtists"] = toList(removedArtists);
+    map["changedArtists"] = toList(changedArtists);
+    map["fullReset"] = fullReset;
+    return map;
+}
+
+} // namespace Mtoc
@@ -0,0 +1,46 @@
+#ifndef LIBRARYCHANGESET_H
+#define LIBRARYCHANGESET_H
+
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+
+namespace Mtoc {
+
+// Structured delta produced by ingest, deletion and metadata updates. Collectors
+// record touched albums and album artists under changed*; LibraryManager resolves
+// them into added/removed/changed against the database before applying the set.
+struct LibraryChangeSet
+{
+    QSet<int> addedTracks;
+    QSet<int> removedTracks;
+    QSet<int> changedTracks;
+
+    QSet<int> addedAlbums;
+    QSet<int> removedAlbums;
+    QSet<int> changedAlbums;
+
+    // Album artists are keyed by name, matching ArtistListModel
+    QSet<QString> addedArtists;
+    QSet<QString> removedArtists;
+    QSet<QString> changedArtists;
+
+    QStringList removedTrackPaths;  // For evicting cached Track objects
+    QString firstSortKey;           // Lowest sort key among added/removed tracks
+    bool fullReset = false;         // Too broad to apply incrementally (e.g. forced rescan)
+
+    bool isEmpty() const;
+    bool hasTrackMoves() const { return !addedTracks.isEmpty() || !removedTracks.isEmpty(); }
+    bool hasAlbumChanges() const;
+    bool hasArtistChanges() const;
+
+    void noteSortKey(const QString& sortKey);
+    void merge(const LibraryChangeSet& other);
+
+    QVariantMap toVariantMap() const;  // For QML listeners of LibraryManager::libraryUpdated
+};
+
+} // namespace Mtoc
+
+#endif // LIBRARYCHANGESET_H
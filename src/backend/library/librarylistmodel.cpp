@@ -0,0 +1,243 @@
+#include "librarylistmodel.h"
+#include <QDebug>
+#include <algorithm>
+
+namespace Mtoc {
+
+LibraryListModel::LibraryListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int LibraryListModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    return m_ids.size();
+}
+
+int LibraryListModel::idAt(int row) const
+{
+    return isValidRow(row) ? m_ids[row] : -1;
+}
+
+int LibraryListModel::indexOfId(int id) const
+{
+    if (m_indexDirty)
+        rebuildIndex();
+    return m_rowById.value(id, -1);
+}
+
+QVariantList LibraryListModel::toVariantList() const
+{
+    QVariantList list;
+    list.reserve(m_ids.size());
+    for (int row = 0; row < m_ids.size(); ++row) {
+        list.append(get(row));
+    }
+    return list;
+}
+
+void LibraryListModel::clear()
+{
+    if (m_ids.isEmpty())
+        return;
+
+    beginResetModel();
+    m_ids.clear();
+    m_rowById.clear();
+    m_indexDirty = false;
+    clearStored();
+    endResetModel();
+
+    emit countChanged();
+}
+
+void LibraryListModel::applyIncoming(const QVector<int> &incomingIds)
+{
+    const int oldCount = m_ids.size();
+    if (m_indexDirty)
+        rebuildIndex();
+
+    QHash<int, int> incomingRowById;
+    incomingRowById.reserve(incomingIds.size());
+    for (int i = 0; i < incomingIds.size(); ++i) {
+        incomingRowById.insert(incomingIds[i], i);
+    }
+
+    // Incremental updates need the surviving rows to keep their relative order.
+    // A re-sort (e.g. a renamed album) falls back to a reset.
+    QVector<int> survivingOld;
+    QVector<int> survivingNew;
+    for (int id : std::as_const(m_ids)) {
+        if (incomingRowById.contains(id))
+            survivingOld.append(id);
+    }
+    for (int id : incomingIds) {
+        if (m_rowById.contains(id))
+            survivingNew.append(id);
+    }
+
+    if (m_ids.isEmpty() || survivingOld != survivingNew
+        || incomingRowById.size() != incomingIds.size()) {
+        beginResetModel();
+        m_ids = incomingIds;
+        adoptIncoming();
+        rebuildIndex();
+        endResetModel();
+        if (oldCount != m_ids.size())
+            emit countChanged();
+        return;
+    }
+
+    // Removals, back to front in contiguous runs
+    for (int row = m_ids.size() - 1; row >= 0; --row) {
+        if (incomingRowById.contains(m_ids[row]))
+            continue;
+
+        int last = row;
+        while (row > 0 && !incomingRowById.contains(m_ids[row - 1]))
+            --row;
+
+        beginRemoveRows(QModelIndex(), row, last);
+        m_ids.remove(row, last - row + 1);
+        removeStoredRows(row, last - row + 1);
+        endRemoveRows();
+    }
+
+    // Insertions, front to back; stored rows now line up with incoming rows
+    for (int row = 0; row < incomingIds.size();) {
+        if (row < m_ids.size() && m_ids[row] == incomingIds[row]) {
+            ++row;
+            continue;
+        }
+
+        int first = row;
+        while (row < incomingIds.size() && !m_rowById.contains(incomingIds[row]))
+            ++row;
+
+        beginInsertRows(QModelIndex(), first, row - 1);
+        m_ids.insert(first, row - first, 0);
+        for (int i = first; i < row; ++i) {
+            m_ids[i] = incomingIds[i];
+        }
+        insertStoredRows(first, first, row - first);
+        endInsertRows();
+    }
+
+    rebuildIndex();
+
+    // Changed values on surviving rows
+    int runStart = -1;
+    for (int row = 0; row <= m_ids.size(); ++row) {
+        bool changed = row < m_ids.size() && storedRowDiffers(row, row);
+        if (changed) {
+            copyStoredRow(row, row);
+            if (runStart < 0)
+                runStart = row;
+        } else if (runStart >= 0) {
+            emit dataChanged(index(runStart), index(row - 1));
+            runStart = -1;
+        }
+    }
+
+    if (oldCount != m_ids.size())
+        emit countChanged();
+}
+
+void LibraryListModel::applyDelta(const QSet<int> &removedIds, const QVector<int> &incomingIds)
+{
+    const int oldCount = m_ids.size();
+
+    // Rows to drop: removed ids, plus staged rows whose sort position moved
+    // (those are re-inserted at their new place below)
+    QVector<int> rowsToRemove;
+    for (int id : removedIds) {
+        int row = indexOfId(id);
+        if (row >= 0)
+            rowsToRemove.append(row);
+    }
+    for (int i = 0; i < incomingIds.size(); ++i) {
+        int row = indexOfId(incomingIds[i]);
+        if (row >= 0 && !removedIds.contains(incomingIds[i]) && !incomingFitsAt(row, i))
+            rowsToRemove.append(row);
+    }
+    std::sort(rowsToRemove.begin(), rowsToRemove.end());
+
+    // Back to front in contiguous runs, so earlier rows keep their positions
+    for (int i = rowsToRemove.size() - 1; i >= 0; --i) {
+        int last = rowsToRemove[i];
+        int first = last;
+        while (i > 0 && rowsToRemove[i - 1] == first - 1) {
+            --first;
+            --i;
+        }
+
+        beginRemoveRows(QModelIndex(), first, last);
+        m_ids.remove(first, last - first + 1);
+        removeStoredRows(first, last - first + 1);
+        endRemoveRows();
+    }
+    if (!rowsToRemove.isEmpty())
+        rebuildIndex();
+
+    // Updates in place, then inserts at the sorted position
+    QVector<int> toInsert;
+    for (int i = 0; i < incomingIds.size(); ++i) {
+        if (removedIds.contains(incomingIds[i]))
+            continue;
+
+        int row = indexOfId(incomingIds[i]);
+        if (row < 0) {
+            toInsert.append(i);
+        } else if (storedRowDiffers(row, i)) {
+            copyStoredRow(row, i);
+            emit dataChanged(index(row), index(row));
+        }
+    }
+
+    for (int i : std::as_const(toInsert)) {
+        // Upper bound, so equal keys keep their arrival order
+        int low = 0;
+        int high = m_ids.size();
+        while (low < high) {
+            int mid = (low + high) / 2;
+            if (compareIncoming(i, mid) < 0)
+                high = mid;
+            else
+                low = mid + 1;
+        }
+
+        beginInsertRows(QModelIndex(), low, low);
+        m_ids.insert(low, incomingIds[i]);
+        insertStoredRows(low, i, 1);
+        endInsertRows();
+    }
+    if (!toInsert.isEmpty())
+        m_indexDirty = true;
+
+    if (oldCount != m_ids.size())
+        emit countChanged();
+}
+
+bool LibraryListModel::incomingFitsAt(int row, int incomingRow) const
+{
+    if (row > 0 && compareIncoming(incomingRow, row - 1) < 0)
+        return false;
+    if (row < m_ids.size() - 1 && compareIncoming(incomingRow, row + 1) > 0)
+        return false;
+    return true;
+}
+
+void LibraryListModel::rebuildIndex() const
+{
+    m_rowById.clear();
+    m_rowById.reserve(m_ids.size());
+    for (int row = 0; row < m_ids.size(); ++row) {
+        m_rowById.insert(m_ids[row], row);
+    }
+    m_indexDirty = false;
+}
+
+} // namespace Mtoc
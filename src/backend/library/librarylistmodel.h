@@ -0,0 +1,71 @@
+#ifndef LIBRARYLISTMODEL_H
+#define LIBRARYLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QVariantMap>
+
+namespace Mtoc {
+
+// Base for the album and artist list models. Rows are keyed by database id and
+// the derived classes keep their columns as parallel vectors (struct of arrays).
+// Reloading stages the new rows and applies them as the minimal set of
+// remove/insert/dataChanged notifications, so views keep their delegates and
+// scroll position across scans instead of seeing a full reset. Library change
+// journals are applied with applyDelta(), which only touches the affected rows.
+class LibraryListModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    explicit LibraryListModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    int count() const { return m_ids.size(); }
+    Q_INVOKABLE int idAt(int row) const;
+    Q_INVOKABLE int indexOfId(int id) const;
+    Q_INVOKABLE virtual QVariantMap get(int row) const = 0;
+    QVariantList toVariantList() const;
+
+    void clear();
+
+signals:
+    void countChanged();
+
+protected:
+    // Applies the rows staged by the derived class; incomingIds[i] is the id of staged row i
+    void applyIncoming(const QVector<int> &incomingIds);
+
+    // Partial update: drops removedIds, then updates each staged row in place or
+    // inserts it at its sorted position. Rows not mentioned are left alone.
+    void applyDelta(const QSet<int> &removedIds, const QVector<int> &incomingIds);
+
+    // Column maintenance, implemented over the derived class's stored/staged columns
+    virtual void removeStoredRows(int row, int count) = 0;
+    virtual void insertStoredRows(int row, int incomingRow, int count) = 0;
+    virtual bool storedRowDiffers(int row, int incomingRow) const = 0;
+    virtual void copyStoredRow(int row, int incomingRow) = 0;
+    virtual void adoptIncoming() = 0;
+    virtual void clearStored() = 0;
+    // Model sort order for applyDelta(); negative when the staged row sorts first
+    virtual int compareIncoming(int incomingRow, int row) const = 0;
+
+    bool isValidRow(int row) const { return row >= 0 && row < m_ids.size(); }
+
+    QVector<int> m_ids;
+
+private:
+    void rebuildIndex() const;
+    bool incomingFitsAt(int row, int incomingRow) const;
+
+    mutable QHash<int, int> m_rowById;
+    mutable bool m_indexDirty = false;
+};
+
+} // namespace Mtoc
+
+#endif // LIBRARYLISTMODEL_H
@@ -1,4 +1,5 @@
 #include "librarymanager.h"
+#include "browsecache.h"
 #include <QDebug>
 #include <QDirIterator>
 #include <QStandardPaths>
@@ -14,6 +15,7 @@
 #include <QThreadPool>
 #include <QCoreApplication>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <exception>
 
 #ifdef Q_OS_LINUX
@@ -70,6 +72,52 @@ LibraryManager::LibraryManager(QObject *parent)
 {
     qDebug() << "LibraryManager: Constructor started";
     
+    m_albumListModel = new AlbumListModel(this);
+    m_artistListModel = new ArtistListModel(this);
+    m_sortedAlbums = new AlbumSortProxyModel(this);
+    m_sortedAlbums->setSourceModel(m_albumListModel);
+    
+    // Connected before any QML handler, so list models are current by the time
+    // libraryChanged listeners run
+    connect(this, &LibraryManager::libraryChanged, this, [this]() {
+        if (m_listModelsInUse) {
+            refreshListModels();
+        }
+        rebuildSnapshot();
+    });
+    
+    connect(&m_snapshotWatcher, &QFutureWatcher<void>::finished, this, [this]() {
+        if (m_snapshotRebuildQueued) {
+            m_snapshotRebuildQueued = false;
+            rebuildSnapshot();
+        }
+    });
+    
+    connect(&m_browseRefreshWatcher, &QFutureWatcher<BrowseRows>::finished, this, [this]() {
+        // The library changed while the rows were read; read them again
+        if (m_browseRefreshQueued) {
+            m_browseRefreshQueued = false;
+            refreshListModelsInBackground();
+            return;
+        }
+        // Invalidated since, e.g. the library was cleared; the next use reloads
+        if (!m_artistModelCacheValid || !m_albumModelCacheValid) {
+            return;
+        }
+        const BrowseRows rows = m_browseRefreshWatcher.result();
+        if (!rows.ok) {
+            // Keep showing the cached rows; the next use of the models refreshes them
+            m_artistModelCacheValid = false;
+            m_albumModelCacheValid = false;
+            return;
+        }
+        m_artistListModel->setArtists(rows.artists);
+        m_albumListModel->setAlbums(rows.albums);
+        scheduleBrowseCacheWrite();
+        qDebug() << "LibraryManager: Browse cache refreshed with" << rows.artists.size() << "artists and"
+                 << rows.albums.size() << "albums";
+    });
+    
     // Initialize database
     initializeDatabase();
     
@@ -109,8 +157,14 @@ LibraryManager::LibraryManager(QObject *parent)
     
     connect(m_databaseManager, &DatabaseManager::trackAdded,
             this, [this](int trackId) {
-        // Refresh models when tracks are added
-        QTimer::singleShot(0, this, &LibraryManager::libraryChanged);
+        // Apply the single track as a delta once the current insert has settled
+        QTimer::singleShot(0, this, [this, trackId]() {
+            LibraryChangeSet changes;
+            QSqlDatabase db = m_databaseManager->connectionForCurrentThread();
+            collectTrackRefs(db, {trackId}, changes);
+            changes.addedTracks.insert(trackId);
+            applyLibraryChanges(changes);
+        });
     });
     
     connect(m_databaseManager, &DatabaseManager::trackDeleted,
@@ -119,7 +173,6 @@ LibraryManager::LibraryManager(QObject *parent)
         m_albumModelCacheValid = false;
         m_albumCountCacheValid = false;
         m_artistModelCacheValid = false;
-        m_albumsByArtistCache.clear();
         QTimer::singleShot(0, this, &LibraryManager::libraryChanged);
     });
     
@@ -127,12 +180,27 @@ LibraryManager::LibraryManager(QObject *parent)
     // This should speed up startup
     m_albumModelCacheValid = false;
     
+    rebuildSnapshot();
+    
+    // Persist the browse lists a few seconds after they settle
+    m_browseCacheTimer = new QTimer(this);
+    m_browseCacheTimer->setSingleShot(true);
+    m_browseCacheTimer->setInterval(BROWSE_CACHE_WRITE_DELAY_MS);
+    connect(m_browseCacheTimer, &QTimer::timeout, this, &LibraryManager::writeBrowseCache);
+    
     // Connect scan watcher
     connect(&m_scanWatcher, &QFutureWatcher<void>::finished,
             this, &LibraryManager::onScanFinished);
+    connect(this, &LibraryManager::albumSummaryChecked, this, [](int staleRows, bool repaired) {
+        if (staleRows != 0) {
+            qWarning() << "[LibraryManager] Album summary check after rescan:"
+                       << (staleRows < 0 ? QString("failed") : QString("%1 stale rows").arg(staleRows))
+                       << (repaired ? "- rebuilt" : "- not rebuilt");
+        }
+    });
 
-    // Setup file watcher
-    setupFileWatcher();
+    // The file watcher and integrity check are started after the first frame
+    // (startFileWatcher, checkDatabaseIntegrity)
 
     // Initialize favorites manager
     m_favoritesManager = new FavoritesManager(m_databaseManager, this);
@@ -146,6 +214,9 @@ LibraryManager::LibraryManager(QObject *parent)
         emit favoriteCountChanged();
     });
 
+    m_loudnessAnalyzer = new LoudnessAnalyzer(m_databaseManager, this);
+    m_waveformService = new WaveformService(m_databaseManager, this);
+
     // Perform auto-refresh if enabled
     if (m_autoRefreshOnStartup && !m_musicFolders.isEmpty()) {
         qDebug() << "Auto-refresh on startup enabled, scheduling refresh";
@@ -172,6 +243,27 @@ LibraryManager::~LibraryManager()
         m_scanFuture.waitForFinished();
     }
     
+    if (m_snapshotFuture.isRunning()) {
+        m_snapshotFuture.waitForFinished();
+    }
+    
+    if (m_browseRefreshFuture.isRunning()) {
+        m_browseRefreshFuture.waitForFinished();
+    }
+    
+    if (m_integrityCheckFuture.isRunning()) {
+        m_integrityCheckFuture.waitForFinished();
+    }
+    
+    // Flush a pending browse cache write so the next launch starts current
+    if (m_browseCacheTimer && m_browseCacheTimer->isActive()) {
+        m_browseCacheTimer->stop();
+        writeBrowseCache();
+    }
+    if (m_browseCacheWriteFuture.isRunning()) {
+        m_browseCacheWriteFuture.waitForFinished();
+    }
+    
     // Cancel album art processing if running
     if (m_processingAlbumArt) {
         qDebug() << "LibraryManager: Album art processing still running, waiting...";
@@ -198,9 +290,7 @@ LibraryManager::~LibraryManager()
     
     // Clear the album model cache
     m_albumModelCacheValid = false;
-    m_cachedAlbumModel.clear();
     m_artistModelCacheValid = false;
-    m_cachedArtistModel.clear();
     
     // Database is automatically closed by DatabaseManager destructor
     
@@ -550,7 +640,6 @@ bool LibraryManager::removeMusicFolder(const QString &path)
             m_albumModelCacheValid = false;
             m_albumCountCacheValid = false;
             m_artistModelCacheValid = false;
-            m_albumsByArtistCache.clear();
             //qDebug() << "LibraryManager::removeMusicFolder() - cache invalidated, emitting libraryChanged";
             emit libraryChanged();
         }
@@ -591,6 +680,10 @@ void LibraryManager::startScan()
     m_scanProgress = 0;
     m_filesScanned = 0;
     m_cancelRequested = false;
+    {
+        QMutexLocker changesLocker(&m_scanChangesMutex);
+        m_scanChanges = LibraryChangeSet();
+    }
     
     qDebug() << "Emitting scan state change signals...";
     emit scanningChanged();
@@ -718,6 +811,25 @@ void LibraryManager::scanInBackground()
         
         if (!filesToDelete.isEmpty()) {
             qDebug() << "Found" << filesToDelete.size() << "deleted files to remove from database";
+            
+            // Record what the deletion touches while the rows still exist
+            LibraryChangeSet deleteChanges;
+            {
+                QList<int> deletedIds;
+                QSqlQuery idQuery(db);
+                idQuery.prepare("SELECT id FROM tracks WHERE file_path = :path");
+                for (const QString &deletedFile : filesToDelete) {
+                    idQuery.bindValue(":path", deletedFile);
+                    if (idQuery.exec() && idQuery.next()) {
+                        deletedIds.append(idQuery.value(0).toInt());
+                    }
+                }
+                idQuery.finish();
+                collectTrackRefs(db, deletedIds, deleteChanges);
+                deleteChanges.removedTracks = QSet<int>(deletedIds.begin(), deletedIds.end());
+                deleteChanges.removedTrackPaths = filesToDelete;
+            }
+            
             for (const QString &deletedFile : filesToDelete) {
                 if (m_cancelRequested) break;
                 
@@ -771,6 +883,13 @@ void LibraryManager::scanInBackground()
                     qDebug() << "Deleted" << deletedArtists << "orphaned artists";
                 }
             }
+            
+            // A cancelled pass may have deleted only some of the recorded tracks
+            if (m_cancelRequested) {
+                deleteChanges.fullReset = true;
+            }
+            QMutexLocker changesLocker(&m_scanChangesMutex);
+            m_scanChanges.merge(deleteChanges);
         }
         
         // Create a single metadata extractor for this thread
@@ -885,14 +1004,6 @@ void LibraryManager::scanInBackground()
             
             // Periodically clear caches to prevent memory accumulation
             if (i % 500 == 0 && i > 0) {
-                // Clear the artist cache if it's getting too large
-                if (m_albumsByArtistCache.size() > 200) {
-                    QMetaObject::invokeMethod(this, [this]() {
-                        m_albumsByArtistCache.clear();
-                        qDebug() << "Cleared albumsByArtistCache during scan to free memory";
-                    }, Qt::QueuedConnection);
-                }
-                
                 // Clear QPixmapCache periodically
                 if (i % 1000 == 0) {
                     QMetaObject::invokeMethod(this, []() {
@@ -976,6 +1087,13 @@ void LibraryManager::scanInBackground()
 
             cleanupQuery.finish();
             qDebug() << "Force metadata update cleanup complete";
+
+            // A forced rescan deletes and re-inserts every track, so verify the
+            // trigger-maintained album summary and repair it if anything drifted.
+            // Done here so the aggregate queries stay off the GUI thread.
+            const int staleRows = m_databaseManager->checkAlbumSummaryConsistency(db);
+            const bool repaired = staleRows != 0 && m_databaseManager->rebuildAlbumSummary(db);
+            emit albumSummaryChecked(staleRows, repaired);
         }
 
         // No longer using transactions - each operation auto-commits
@@ -1027,70 +1145,74 @@ void LibraryManager::onScanFinished()
     m_scanning = false;
     m_scanProgress = 100;
 
+    LibraryChangeSet changes;
+    {
+        QMutexLocker changesLocker(&m_scanChangesMutex);
+        changes = m_scanChanges;
+        m_scanChanges = LibraryChangeSet();
+    }
+
     // Reset force metadata update flag
     if (m_forceMetadataUpdate) {
+        changes.fullReset = true;
         qDebug() << "Resetting force metadata update flag";
         m_forceMetadataUpdate = false;
     }
 
     // Transaction is now handled in the background thread
     
-    // Invalidate cache after scan and clear it to free memory
-    m_albumModelCacheValid = false;
-    m_albumCountCacheValid = false;
-    m_artistModelCacheValid = false;
-    
-    // Use swap idiom to ensure memory is actually released
-    {
-        QVariantList emptyList;
-        m_cachedAlbumModel.swap(emptyList);
-    }
-    {
-        QVariantList emptyList;
-        m_cachedArtistModel.swap(emptyList);
-    }
-    {
-        QHash<QString, QVariantList> emptyCache;
-        m_albumsByArtistCache.swap(emptyCache);
-    }
+    if (changes.fullReset) {
+        // Invalidate cache after scan and clear it to free memory
+        m_albumModelCacheValid = false;
+        m_albumCountCacheValid = false;
+        m_artistModelCacheValid = false;
 
-    // Notify MediaPlayer and other listeners that library is about to be invalidated
-    // This allows them to stop playback and clear references BEFORE we clear the data
-    emit aboutToInvalidateLibrary();
+        // Notify MediaPlayer and other listeners that library is about to be invalidated
+        // This allows them to stop playback and clear references BEFORE we clear the data
+        emit aboutToInvalidateLibrary();
 
-    // Clear and reload virtual playlist if it exists
-    if (m_allSongsPlaylist) {
-        qDebug() << "Clearing VirtualPlaylist to release old track data";
-        m_allSongsPlaylist->clear();
-        // Reload tracks asynchronously with updated library data
-        m_allSongsPlaylist->loadAllTracks();
-    }
-
-    // Clear and reload favorites playlist if it exists
-    if (m_favoritesPlaylist) {
-        qDebug() << "Clearing FavoritesPlaylist to release old track data";
-        m_favoritesPlaylist->clear();
-    }
+        // Clear and reload virtual playlist if it exists
+        if (m_allSongsPlaylist) {
+            qDebug() << "Clearing VirtualPlaylist to release old track data";
+            m_allSongsPlaylist->clear();
+            // Reload tracks asynchronously with updated library data
+            m_allSongsPlaylist->loadAllTracks();
+        }
 
-    // Restore favorites from backup database after scan
-    if (m_favoritesManager) {
-        qDebug() << "Restoring favorites from backup after scan";
-        m_favoritesManager->restoreFromBackup();
-        // Reload favorites playlist with restored data
+        // Clear and reload favorites playlist if it exists
         if (m_favoritesPlaylist) {
-            m_favoritesPlaylist->loadAllTracks();
+            qDebug() << "Clearing FavoritesPlaylist to release old track data";
+            m_favoritesPlaylist->clear();
         }
-    }
 
-    // Clear track cache to release stale Track objects
-    {
-        QMutexLocker locker(&m_trackCacheMutex);
-        qDebug() << "Clearing track cache with" << m_trackCache.size() << "entries";
-        qDeleteAll(m_trackCache);
-        m_trackCache.clear();
-    }
+        // Restore favorites from backup database after scan
+        if (m_favoritesManager) {
+            qDebug() << "Restoring favorites from backup after scan";
+            m_favoritesManager->restoreFromBackup();
+            // Reload favorites playlist with restored data
+            if (m_favoritesPlaylist) {
+                m_favoritesPlaylist->loadAllTracks();
+            }
+        }
+
+        // Clear track cache to release stale Track objects
+        {
+            QMutexLocker locker(&m_trackCacheMutex);
+            qDebug() << "Clearing track cache with" << m_trackCache.size() << "entries";
+            qDeleteAll(m_trackCache);
+            m_trackCache.clear();
+        }
 
-    qDebug() << "Album and artist model cache invalidated and cleared after scan";
+        qDebug() << "Album and artist model cache invalidated and cleared after scan";
+    } else {
+        qDebug() << "Applying incremental scan changes:" << changes.addedTracks.size() << "added,"
+                 << changes.removedTracks.size() << "removed tracks";
+
+        if (m_favoritesManager) {
+            m_favoritesManager->restoreFromBackup();
+        }
+        applyLibraryChanges(changes);
+    }
     
     // Force garbage collection in QPixmapCache after scan
     QPixmapCache::clear();
@@ -1123,8 +1245,11 @@ void LibraryManager::onScanFinished()
         });
     }
     
-    // Refresh all counts and models - ensure these are from main thread
-    QMetaObject::invokeMethod(this, "libraryChanged", Qt::QueuedConnection);
+    // Refresh all counts and models - ensure these are from main thread.
+    // Incremental scans have already updated the models in applyLibraryChanges().
+    if (changes.fullReset) {
+        QMetaObject::invokeMethod(this, "libraryChanged", Qt::QueuedConnection);
+    }
     QMetaObject::invokeMethod(this, "trackCountChanged", Qt::QueuedConnection);
     QMetaObject::invokeMethod(this, "albumCountChanged", Qt::QueuedConnection);
     QMetaObject::invokeMethod(this, "albumArtistCountChanged", Qt::QueuedConnection);
@@ -1162,9 +1287,9 @@ void LibraryManager::resetLibrary()
     m_albumModelCacheValid = false;
     m_albumCountCacheValid = false;
     m_artistModelCacheValid = false;
-    m_cachedAlbumModel.clear();
-    m_cachedArtistModel.clear();
-    m_albumsByArtistCache.clear();
+    m_albumListModel->clear();
+    m_artistListModel->clear();
+    m_snapshot.clear();
 
     // Notify MediaPlayer and other listeners that library is about to be invalidated
     emit aboutToInvalidateLibrary();
@@ -1253,6 +1378,22 @@ void LibraryManager::rebuildAllThumbnails()
     m_rebuildWatcher.setFuture(m_rebuildFuture);
 }
 
+bool LibraryManager::rebuildAlbumSummary()
+{
+    if (!m_databaseManager || !m_databaseManager->isOpen()) {
+        return false;
+    }
+
+    if (!m_databaseManager->rebuildAlbumSummary()) {
+        qWarning() << "LibraryManager: Failed to rebuild album summary";
+        return false;
+    }
+
+    m_albumModelCacheValid = false;
+    emit libraryChanged();
+    return true;
+}
+
 // Utility methods
 QStringList LibraryManager::findMusicFiles(const QString &dir)
 {
@@ -1368,48 +1509,71 @@ QStringList LibraryManager::allArtists() const
     return artists;
 }
 
-QVariantList LibraryManager::artistModel() const
+ArtistListModel* LibraryManager::artists() const
 {
-    if (!m_databaseManager || !m_databaseManager->isOpen()) {
-        qDebug() << "LibraryManager::artistModel() - database not ready, returning empty list";
-        return QVariantList();
+    LibraryManager* self = const_cast<LibraryManager*>(this);
+    self->m_listModelsInUse = true;
+    if (!m_artistModelCacheValid) {
+        self->refreshListModels();
     }
-    
-    // Use cached data if valid
-    if (m_artistModelCacheValid) {
-        return m_cachedArtistModel;
+    return m_artistListModel;
+}
+
+AlbumListModel* LibraryManager::albums() const
+{
+    LibraryManager* self = const_cast<LibraryManager*>(this);
+    self->m_listModelsInUse = true;
+    if (!m_albumModelCacheValid) {
+        self->refreshListModels();
     }
-    
-    // Clear previous cache to free memory before allocating new data
-    m_cachedArtistModel.clear();
-    
-    QVariantList newArtistModel = m_databaseManager->getAllArtists();
-    
-    m_cachedArtistModel = std::move(newArtistModel);
-    m_artistModelCacheValid = true;
-    return m_cachedArtistModel;
+    return m_albumListModel;
+}
+
+AlbumSortProxyModel* LibraryManager::sortedAlbums() const
+{
+    // Goes through albums() so the source model is loaded on first use
+    albums();
+    return m_sortedAlbums;
 }
 
-QVariantList LibraryManager::albumModel() const
+void LibraryManager::refreshListModels()
 {
     if (!m_databaseManager || !m_databaseManager->isOpen()) {
-        qDebug() << "LibraryManager::albumModel() - database not ready, returning empty list";
-        return QVariantList();
+        qDebug() << "LibraryManager::refreshListModels() - database not ready";
+        return;
+    }
+    
+    // Rows read on the GUI thread now are newer than a background refresh in flight
+    if (m_browseRefreshFuture.isRunning()) {
+        m_browseRefreshQueued = true;
+    }
+    
+    // First use: show the browse cache instead of running the full queries
+    if (!m_browseCacheChecked) {
+        m_browseCacheChecked = true;
+        if (loadBrowseCache()) {
+            return;
+        }
+    }
+    
+    if (!m_artistModelCacheValid) {
+        m_artistListModel->setArtists(m_databaseManager->getAllArtists());
+        m_artistModelCacheValid = true;
+        scheduleBrowseCacheWrite();
     }
     
-    // Use cached data if valid
     if (m_albumModelCacheValid) {
-        return m_cachedAlbumModel;
+        return;
     }
     
     // Get total album count for monitoring
     int totalAlbums = albumCount();
     
-    // Clear previous cache to free memory before allocating new data
-    m_cachedAlbumModel.clear();
-    
-    // Load albums from database
-    QVariantList newAlbumModel = m_databaseManager->getAllAlbums();
+    // Rows are diffed against what the model already holds, so views only see
+    // the albums that were actually added, removed or changed
+    m_albumListModel->setAlbums(m_databaseManager->getAllAlbums());
+    m_albumModelCacheValid = true;
+    scheduleBrowseCacheWrite();
     
     // Monitor memory usage for large libraries and provide informational warnings
     if (totalAlbums >= 5000) {
@@ -1417,10 +1581,6 @@ QVariantList LibraryManager::albumModel() const
         int estimatedMemoryMB = (totalAlbums * 1024) / (1024 * 1024);
         qInfo() << "Large library loaded:" << totalAlbums << "albums (estimated" << estimatedMemoryMB << "MB for album metadata)";
         
-        // Force garbage collection to clean up any unused memory
-        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
-        QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-        
         #ifdef Q_OS_LINUX
         // On Linux, we can try to give memory back to the OS
         malloc_trim(0);
@@ -1428,36 +1588,291 @@ QVariantList LibraryManager::albumModel() const
     } else if (totalAlbums >= 1000) {
         qDebug() << "Medium-sized library loaded:" << totalAlbums << "albums";
     }
+}
+
+bool LibraryManager::loadBrowseCache()
+{
+    QElapsedTimer timer;
+    timer.start();
+    
+    BrowseCache cache;
+    if (!cache.open(BrowseCache::defaultPath())) {
+        return false;
+    }
     
-    m_cachedAlbumModel = std::move(newAlbumModel);
+    m_artistListModel->setArtists(cache.artists());
+    m_albumListModel->setAlbums(cache.albums());
+    m_artistModelCacheValid = true;
     m_albumModelCacheValid = true;
-    return m_cachedAlbumModel;
+    
+    qint64 generation = m_databaseManager->libraryGeneration();
+    bool stale = generation < 0 || cache.generation() != generation;
+    qDebug() << "LibraryManager: Loaded browse cache with" << cache.artistCount() << "artists and"
+             << cache.albumCount() << "albums in" << timer.elapsed() << "ms"
+             << (stale ? "(stale, refreshing)" : "");
+    
+    if (stale) {
+        // Render the cached rows now; the refresh is diffed in once the worker has read them
+        refreshListModelsInBackground();
+    }
+    return true;
 }
 
-QVariantList LibraryManager::getAlbumsForArtist(const QString &artistName) const
+void LibraryManager::refreshListModelsInBackground()
 {
-    if (!m_databaseManager || !m_databaseManager->isOpen()) {
-        return QVariantList();
+    if (m_browseRefreshFuture.isRunning()) {
+        m_browseRefreshQueued = true;
+        return;
     }
     
-    // Check cache first
-    if (m_albumsByArtistCache.contains(artistName)) {
-        return m_albumsByArtistCache[artistName];
+    m_browseRefreshFuture = QtConcurrent::run([this]() {
+        BrowseRows rows;
+        QString connectionName = QString("BrowseRefreshThread_%1").arg(quintptr(QThread::currentThreadId()));
+        {
+            QSqlDatabase db = DatabaseManager::createThreadConnection(connectionName);
+            if (db.isOpen()) {
+                rows.artists = m_databaseManager->getAllArtists(db);
+                rows.albums = m_databaseManager->getAllAlbums(db);
+                rows.ok = true;
+            } else {
+                qWarning() << "[LibraryManager::refreshListModelsInBackground] Failed to open thread connection";
+            }
+        }
+        DatabaseManager::removeThreadConnection(connectionName);
+        return rows;
+    });
+    m_browseRefreshWatcher.setFuture(m_browseRefreshFuture);
+}
+
+void LibraryManager::scheduleBrowseCacheWrite()
+{
+    if (m_browseCacheTimer) {
+        m_browseCacheTimer->start();
+    }
+}
+
+void LibraryManager::writeBrowseCache()
+{
+    if (!m_albumModelCacheValid || !m_artistModelCacheValid || !m_databaseManager->isOpen()) {
+        return;
+    }
+    // Mid-scan the database is ahead of the models; wait until they settle
+    if (m_scanning || m_processingAlbumArt || m_browseCacheWriteFuture.isRunning()) {
+        scheduleBrowseCacheWrite();
+        return;
+    }
+    
+    qint64 generation = m_databaseManager->libraryGeneration();
+    if (generation < 0) {
+        return;
     }
     
-    // Fetch from database and cache
-    QVariantList albums = m_databaseManager->getAlbumsByAlbumArtistName(artistName);
+    QVariantList artists = m_artistListModel->toVariantList();
+    QVariantList albums = m_albumListModel->toVariantList();
+    m_browseCacheWriteFuture = QtConcurrent::run([generation, artists, albums]() {
+        BrowseCache::write(BrowseCache::defaultPath(), generation, artists, albums);
+    });
+}
+
+void LibraryManager::applyLibraryChanges(LibraryChangeSet changes)
+{
+    if (changes.isEmpty()) {
+        return;
+    }
+
+    // A stale-cache refresh in flight may have read the database before this change
+    if (m_browseRefreshFuture.isRunning()) {
+        m_browseRefreshQueued = true;
+    }
+
+    if (changes.fullReset) {
+        m_albumModelCacheValid = false;
+        m_albumCountCacheValid = false;
+        m_artistModelCacheValid = false;
+        emit libraryChanged();
+        return;
+    }
+
+    resolveAlbumChanges(changes);
+    resolveArtistChanges(changes);
+
+    // A rebuild already in flight may have read the database before this change
+    if (m_snapshotFuture.isRunning()) {
+        m_snapshotRebuildQueued = true;
+    } else {
+        QSqlDatabase db = m_databaseManager->connectionForCurrentThread();
+        m_snapshot.applyChanges(db, changes);
+    }
+
+    if (!changes.removedTrackPaths.isEmpty()) {
+        QMutexLocker locker(&m_trackCacheMutex);
+        for (const QString &path : changes.removedTrackPaths) {
+            if (Track *track = m_trackCache.take(path)) {
+                track->deleteLater();
+            }
+        }
+    }
+
+    if (changes.hasTrackMoves()) {
+        if (m_allSongsPlaylist) {
+            m_allSongsPlaylist->applyTrackChanges(changes.firstSortKey);
+        }
+        // Favorites are a small filtered list; reload it the next time it is shown
+        if (m_favoritesPlaylistModel && !changes.removedTracks.isEmpty()) {
+            m_favoritesPlaylistModel->markNeedsReload();
+        }
+        emit trackCountChanged();
+    }
+
+    if (!changes.addedAlbums.isEmpty() || !changes.removedAlbums.isEmpty()) {
+        m_albumCountCacheValid = false;
+        emit albumCountChanged();
+    }
+    if (!changes.addedArtists.isEmpty() || !changes.removedArtists.isEmpty()) {
+        emit albumArtistCountChanged();
+        emit artistCountChanged();
+    }
+
+    if (changes.hasAlbumChanges() || changes.hasArtistChanges()) {
+        scheduleBrowseCacheWrite();
+    }
+
+    qDebug() << "[LibraryManager::applyLibraryChanges]" << changes.addedTracks.size() << "tracks added,"
+             << changes.removedTracks.size() << "removed;" << changes.addedAlbums.size() << "albums added,"
+             << changes.removedAlbums.size() << "removed," << changes.changedAlbums.size() << "changed";
+
+    emit libraryUpdated(changes.toVariantMap());
+}
+
+void LibraryManager::rebuildSnapshot()
+{
+    if (!m_databaseManager || !m_databaseManager->isOpen()) {
+        return;
+    }
+    if (m_snapshotFuture.isRunning()) {
+        m_snapshotRebuildQueued = true;
+        return;
+    }
     
-    // Only cache if the result is reasonably small and cache isn't too large
-    if (albums.size() < 100 && m_albumsByArtistCache.size() < 1000) {
-        // If cache is getting full, remove oldest entries (simple FIFO)
-        while (m_albumsByArtistCache.size() >= 1000) {
-            m_albumsByArtistCache.erase(m_albumsByArtistCache.begin());
+    m_snapshotFuture = QtConcurrent::run([this]() {
+        QString connectionName = QString("SnapshotThread_%1").arg(quintptr(QThread::currentThreadId()));
+        {
+            QSqlDatabase db = DatabaseManager::createThreadConnection(connectionName);
+            if (db.isOpen()) {
+                m_snapshot.rebuild(db);
+            } else {
+                qWarning() << "[LibraryManager::rebuildSnapshot] Failed to open thread connection";
+            }
+        }
+        DatabaseManager::removeThreadConnection(connectionName);
+    });
+    m_snapshotWatcher.setFuture(m_snapshotFuture);
+}
+
+void LibraryManager::resolveAlbumChanges(LibraryChangeSet &changes)
+{
+    if (!changes.hasAlbumChanges()) {
+        return;
+    }
+
+    QSet<int> touched = changes.changedAlbums + changes.addedAlbums + changes.removedAlbums;
+    changes.addedAlbums.clear();
+    changes.removedAlbums.clear();
+    changes.changedAlbums.clear();
+
+    QVariantList albums = m_databaseManager->getAlbumsByIds(QList<int>(touched.begin(), touched.end()));
+    QSet<int> present;
+    for (const QVariant &album : albums) {
+        int id = album.toMap().value("id").toInt();
+        present.insert(id);
+        if (m_albumListModel->indexOfId(id) >= 0) {
+            changes.changedAlbums.insert(id);
+        } else {
+            changes.addedAlbums.insert(id);
+        }
+    }
+    changes.removedAlbums = touched - present;
+
+    // A stale model is rebuilt wholesale by refreshListModels() when next used
+    if (m_listModelsInUse && m_albumModelCacheValid) {
+        m_albumListModel->applyAlbumChanges(changes.removedAlbums, albums);
+    }
+}
+
+void LibraryManager::resolveArtistChanges(LibraryChangeSet &changes)
+{
+    if (!changes.hasArtistChanges()) {
+        return;
+    }
+
+    QSet<QString> touched = changes.changedArtists + changes.addedArtists + changes.removedArtists;
+    changes.addedArtists.clear();
+    changes.removedArtists.clear();
+    changes.changedArtists.clear();
+
+    QStringList names(touched.begin(), touched.end());
+    QVariantList artists = m_databaseManager->getArtistsByNames(names);
+    QSet<QString> present;
+    for (const QVariant &artist : artists) {
+        present.insert(artist.toMap().value("name").toString().toLower());
+    }
+    for (const QString &name : names) {
+        if (!present.contains(name.toLower())) {
+            changes.removedArtists.insert(name);
+        } else if (m_artistListModel->indexOfName(name, false) >= 0) {
+            changes.changedArtists.insert(name);
+        } else {
+            changes.addedArtists.insert(name);
+        }
+    }
+
+    if (m_listModelsInUse && m_artistModelCacheValid) {
+        m_artistListModel->applyArtistChanges(names, artists);
+    }
+}
+
+void LibraryManager::collectTrackRefs(QSqlDatabase &db, const QList<int> &trackIds, LibraryChangeSet &changes)
+{
+    // Ids are inlined rather than bound to stay clear of SQLite's variable limit
+    const int chunkSize = 500;
+    for (int start = 0; start < trackIds.size(); start += chunkSize) {
+        QStringList idList;
+        for (int id : trackIds.mid(start, chunkSize)) {
+            idList << QString::number(id);
+        }
+
+        QSqlQuery query(db);
+        if (!query.exec("SELECT t.album_id, t.sort_key, aa.name FROM tracks t "
+                        "LEFT JOIN albums al ON al.id = t.album_id "
+                        "LEFT JOIN album_album_artists aaa ON aaa.album_id = t.album_id "
+                        "LEFT JOIN album_artists aa ON aa.id = COALESCE(aaa.album_artist_id, al.album_artist_id) "
+                        "WHERE t.id IN (" + idList.join(",") + ")")) {
+            qWarning() << "[LibraryManager::collectTrackRefs] Query failed:" << query.lastError().text();
+            changes.fullReset = true;
+            return;
+        }
+        while (query.next()) {
+            if (!query.value(0).isNull()) {
+                changes.changedAlbums.insert(query.value(0).toInt());
+            }
+            changes.noteSortKey(query.value(1).toString());
+            if (!query.value(2).isNull()) {
+                changes.changedArtists.insert(query.value(2).toString());
+            }
         }
-        m_albumsByArtistCache[artistName] = albums;
+    }
+}
+
+QVariantList LibraryManager::getAlbumsForArtist(const QString &artistName) const
+{
+    if (!m_databaseManager || !m_databaseManager->isOpen()) {
+        return QVariantList();
     }
     
-    return albums;
+    if (m_snapshot.isReady()) {
+        return m_snapshot.albumsByAlbumArtist(artistName);
+    }
+    return m_databaseManager->getAlbumsByAlbumArtistName(artistName);
 }
 
 TrackModel* LibraryManager::searchTracks(const QString &query) const
@@ -1575,16 +1990,9 @@ void LibraryManager::preloadAlbumsForArtists(const QStringList &artistNames) con
         return;
     }
     
-    // Preload albums for multiple artists in a batch to improve performance
-    for (const QString &artistName : artistNames) {
-        // Skip if already cached
-        if (m_albumsByArtistCache.contains(artistName)) {
-            continue;
-        }
-        
-        // This will cache the albums
-        getAlbumsForArtist(artistName);
-    }
+    // Every artist's albums are resident in the snapshot once it is built;
+    // until then there is nothing worth warming
+    Q_UNUSED(artistNames);
 }
 
 QVariantList LibraryManager::getLightweightAlbumModel() const
@@ -1597,7 +2005,7 @@ QVariantList LibraryManager::getLightweightAlbumModel() const
     
     if (totalAlbums < 1000) {
         // For small libraries, use the full model
-        return albumModel();
+        return albums()->toVariantList();
     } else {
         qWarning() << "Large library (" << totalAlbums << " albums) - lightweight model not yet implemented";
         return QVariantList();
@@ -1619,85 +2027,6 @@ int LibraryManager::loadCarouselPosition() const
     return albumId;
 }
 
-void LibraryManager::savePlaybackState(const QString &filePath, qint64 position, 
-                                       const QString &albumArtist, const QString &albumTitle, 
-                                       int trackIndex, qint64 duration,
-                                       bool queueModified, const QVariantList &queue,
-                                       const QVariantMap &virtualPlaylistInfo,
-                                       const QVariantMap &playlistInfo)
-{
-    QSettings settings;
-    settings.beginGroup("playbackState");
-    
-    // Save track info
-    settings.setValue("filePath", filePath);
-    settings.setValue("position", position);
-    settings.setValue("duration", duration);
-    settings.setValue("albumArtist", albumArtist);
-    settings.setValue("albumTitle", albumTitle);
-    settings.setValue("trackIndex", trackIndex);
-    settings.setValue("savedTime", QDateTime::currentDateTime());
-    
-    // Save virtual playlist info if present
-    if (!virtualPlaylistInfo.isEmpty() && virtualPlaylistInfo.value("isVirtualPlaylist", false).toBool()) {
-        settings.setValue("isVirtualPlaylist", true);
-        settings.setValue("virtualPlaylistType", virtualPlaylistInfo.value("virtualPlaylistType"));
-        settings.setValue("virtualTrackIndex", virtualPlaylistInfo.value("virtualTrackIndex"));
-        settings.setValue("virtualShuffleIndex", virtualPlaylistInfo.value("virtualShuffleIndex"));
-        settings.setValue("shuffleEnabled", virtualPlaylistInfo.value("shuffleEnabled"));
-        
-        // Save track metadata
-        settings.setValue("trackTitle", virtualPlaylistInfo.value("trackTitle"));
-        settings.setValue("trackArtist", virtualPlaylistInfo.value("trackArtist"));
-        settings.setValue("trackAlbum", virtualPlaylistInfo.value("trackAlbum"));
-        settings.setValue("trackAlbumArtist", virtualPlaylistInfo.value("trackAlbumArtist"));
-    } else {
-        settings.setValue("isVirtualPlaylist", false);
-    }
-    
-    // Save playlist info if present
-    if (!playlistInfo.isEmpty() && playlistInfo.contains("playlistName")) {
-        settings.setValue("playlistName", playlistInfo.value("playlistName"));
-    } else {
-        settings.remove("playlistName");
-    }
-    
-    // Save queue info if modified
-    settings.setValue("queueModified", queueModified);
-    if (queueModified && !queue.isEmpty()) {
-        settings.beginWriteArray("queue");
-        for (int i = 0; i < queue.size(); ++i) {
-            settings.setArrayIndex(i);
-            QVariantMap trackData = queue[i].toMap();
-            settings.setValue("filePath", trackData["filePath"]);
-            settings.setValue("title", trackData["title"]);
-            settings.setValue("artist", trackData["artist"]);
-            settings.setValue("album", trackData["album"]);
-            settings.setValue("albumArtist", trackData["albumArtist"]);
-            settings.setValue("trackNumber", trackData["trackNumber"]);
-            settings.setValue("duration", trackData["duration"]);
-            settings.setValue("id", trackData["id"]);
-            settings.setValue("lyrics", trackData["lyrics"]);
-            settings.setValue("isFavorite", trackData["isFavorite"]);
-        }
-        settings.endArray();
-    } else {
-        // Clear any existing queue data if queue is not modified
-        settings.remove("queue");
-    }
-    
-    settings.endGroup();
-    settings.sync(); // Force immediate write to disk
-    
-    // qDebug() << "LibraryManager: Saved playback state - file:" << filePath 
-    //          << "position:" << position << "ms"
-    //          << "duration:" << duration << "ms"
-    //          << "album:" << albumArtist << "-" << albumTitle 
-    //          << "track:" << trackIndex
-    //          << "queueModified:" << queueModified
-    //          << "queueSize:" << queue.size();
-}
-
 QVariantMap LibraryManager::loadPlaybackState() const
 {
     QSettings settings;
@@ -1725,6 +2054,8 @@ QVariantMap LibraryManager::loadPlaybackState() const
                 state["virtualTrackIndex"] = settings.value("virtualTrackIndex").toInt();
                 state["virtualShuffleIndex"] = settings.value("virtualShuffleIndex").toInt();
                 state["shuffleEnabled"] = settings.value("shuffleEnabled").toBool();
+                state["virtualShuffleSeed"] = settings.value("virtualShuffleSeed").toString();
+                state["virtualShuffleFirst"] = settings.value("virtualShuffleFirst", -1).toInt();
                 
                 // Load track metadata
                 state["trackTitle"] = settings.value("trackTitle").toString();
@@ -1988,6 +2319,7 @@ void LibraryManager::insertBatchTracksInThread(QSqlDatabase& db, const QList<QVa
     qDebug() << "[insertBatchTracksInThread] Starting to insert batch of" << batchMetadata.size() << "tracks (forceUpdate:" << forceUpdate << ")";
     int successCount = 0;
     int failCount = 0;
+    QList<int> insertedIds;
     
     // Use maps to cache artist/album lookups within this batch
     QHash<QString, int> artistCache;
@@ -2206,6 +2538,7 @@ void LibraryManager::insertBatchTracksInThread(QSqlDatabase& db, const QList<QVa
             failCount++;
         } else {
             successCount++;
+            insertedIds.append(trackInsert.lastInsertId().toInt());
 
             // Create junction table links for all album artists
             if (albumId > 0 && albumArtists.size() > 0) {
@@ -2257,6 +2590,19 @@ void LibraryManager::insertBatchTracksInThread(QSqlDatabase& db, const QList<QVa
     // Finish the prepared query to release resources
     trackInsert.finish();
     
+    // Forced updates delete and re-insert every track, so ids are not stable
+    LibraryChangeSet batchChanges;
+    if (forceUpdate) {
+        batchChanges.fullReset = true;
+    } else if (!insertedIds.isEmpty()) {
+        collectTrackRefs(db, insertedIds, batchChanges);
+        batchChanges.addedTracks = QSet<int>(insertedIds.begin(), insertedIds.end());
+    }
+    if (!batchChanges.isEmpty()) {
+        QMutexLocker changesLocker(&m_scanChangesMutex);
+        m_scanChanges.merge(batchChanges);
+    }
+    
     qDebug() << "[insertBatchTracksInThread] Batch complete - Successfully inserted" << successCount 
              << "tracks, failed" << failCount << "tracks";
 }
@@ -2350,6 +2696,16 @@ void LibraryManager::processAlbumArtInBackground()
 
         int processedCount = 0;
         const int BATCH_SIZE = 20; // Process albums in batches to manage memory
+        QSet<int> pendingArtAlbums;  // Processed since the last model update
+
+        // Albums whose art changed only need their rows refreshed
+        auto postArtChanges = [this](const QSet<int> &albumIds) {
+            LibraryChangeSet changes;
+            changes.changedAlbums = albumIds;
+            QMetaObject::invokeMethod(this, [this, changes]() {
+                applyLibraryChanges(changes);
+            }, Qt::QueuedConnection);
+        };
 
         // Process albums from the list
         for (int i = 0; i < albumsToProcess.size(); ++i) {
@@ -2415,6 +2771,7 @@ void LibraryManager::processAlbumArtInBackground()
                             } else {
                                 qDebug() << "Successfully processed album art for:" << albumTitle;
                                 processedCount++;
+                                pendingArtAlbums.insert(albumId);
                             }
                             artInsert.finish();
                         }
@@ -2456,11 +2813,11 @@ void LibraryManager::processAlbumArtInBackground()
                 qDebug() << "Memory after cleanup:" << afterCleanupMB << "MB (freed" << freedMB << "MB)";
                 #endif
 
-                // Emit update signal after each batch
-                QMetaObject::invokeMethod(this, [this]() {
-                    m_albumModelCacheValid = false;
-                    emit libraryChanged();
-                }, Qt::QueuedConnection);
+                // Update the processed albums after each batch
+                if (!pendingArtAlbums.isEmpty()) {
+                    postArtChanges(pendingArtAlbums);
+                    pendingArtAlbums.clear();
+                }
 
                 // Yield to other threads
                 QThread::yieldCurrentThread();
@@ -2545,6 +2902,7 @@ void LibraryManager::processAlbumArtInBackground()
 
                                     if (updateQuery.exec()) {
                                         albumsWithUpdatedArt.append(albumId);
+                                        pendingArtAlbums.insert(albumId);
                                         processedCount++;
                                         qDebug() << "Updated album art for:" << albumTitle;
                                     } else {
@@ -2590,14 +2948,9 @@ void LibraryManager::processAlbumArtInBackground()
             qWarning() << "Failed to query existing album art:" << existingArtQuery.lastError().text();
         }
 
-        // Emit final update if we processed any albums
-        if (processedCount > 0) {
-            QMetaObject::invokeMethod(this, [this]() {
-                m_albumModelCacheValid = false;
-                m_cachedAlbumModel.clear();
-                emit libraryChanged();
-                // qDebug() << "LibraryManager: Emitted final libraryChanged after album art processing";
-            }, Qt::QueuedConnection);
+        // Emit final update for albums not yet covered by a batch update
+        if (!pendingArtAlbums.isEmpty()) {
+            postArtChanges(pendingArtAlbums);
         }
 
         // Final memory cleanup after processing all albums
@@ -2690,8 +3043,25 @@ bool LibraryManager::isTrackInLibrary(const QString &filePath) const
         }
     }
 
-    // Check database
-    return m_databaseManager->trackExists(filePath);
+    return trackIdForPath(filePath) > 0;
+}
+
+int LibraryManager::trackIdForPath(const QString &filePath) const
+{
+    int trackId = m_snapshot.trackIdByPath(filePath);
+    if (trackId > 0) {
+        return trackId;
+    }
+    return m_databaseManager->getTrackIdByPath(filePath);
+}
+
+int LibraryManager::albumIdForArtistAndTitle(const QString &albumArtist, const QString &albumTitle) const
+{
+    int albumId = m_snapshot.albumIdByArtistAndTitle(albumArtist, albumTitle);
+    if (albumId > 0) {
+        return albumId;
+    }
+    return m_databaseManager->getAlbumIdByArtistAndTitle(albumArtist, albumTitle);
 }
 
 QVariantList LibraryManager::parseAndMatchTrackArtists(const QString &trackArtist, const QStringList &albumArtists) const
@@ -2818,7 +3188,7 @@ Track* LibraryManager::trackByPath(const QString &path) const
     }
     
     // Not in cache, load from database
-    int trackId = m_databaseManager->getTrackIdByPath(path);
+    int trackId = trackIdForPath(path);
     if (trackId <= 0) {
         return nullptr;
     }
@@ -2985,6 +3355,39 @@ void LibraryManager::rebuildThumbnailsInBackground()
 }
 
 // File watcher implementation
+void LibraryManager::startFileWatcher()
+{
+    if (m_fileWatcher) {
+        return;
+    }
+    setupFileWatcher();
+}
+
+void LibraryManager::checkDatabaseIntegrity()
+{
+    if (!m_databaseManager || !m_databaseManager->isOpen() || m_integrityCheckFuture.isRunning()) {
+        return;
+    }
+    
+    DatabaseManager *databaseManager = m_databaseManager;
+    m_integrityCheckFuture = QtConcurrent::run([databaseManager]() {
+        QString connectionName = QString("IntegrityCheck_%1").arg(quintptr(QThread::currentThreadId()));
+        {
+            QSqlDatabase db = DatabaseManager::createThreadConnection(connectionName);
+            if (db.isOpen()) {
+                QElapsedTimer timer;
+                timer.start();
+                bool ok = databaseManager->checkIntegrity(db);
+                qDebug() << "[LibraryManager::checkDatabaseIntegrity]" << (ok ? "ok" : "failed")
+                         << "in" << timer.elapsed() << "ms";
+            } else {
+                qWarning() << "[LibraryManager::checkDatabaseIntegrity] Failed to open thread connection";
+            }
+        }
+        DatabaseManager::removeThreadConnection(connectionName);
+    });
+}
+
 void LibraryManager::setupFileWatcher()
 {
     qDebug() << "LibraryManager::setupFileWatcher() - initializing file system watcher";
@@ -3120,11 +3523,13 @@ void LibraryManager::updateLyricsForTrack(const QString &audioFilePath)
         qDebug() << "Updated lyrics for track:" << audioFilePath;
 
         // Invalidate track cache for this file
-        QMutexLocker cacheLock(&m_trackCacheMutex);
-        if (m_trackCache.contains(audioFilePath)) {
-            Track* cachedTrack = m_trackCache.value(audioFilePath);
-            if (cachedTrack) {
-                cachedTrack->setLyrics(lyrics);
+        {
+            QMutexLocker cacheLock(&m_trackCacheMutex);
+            if (m_trackCache.contains(audioFilePath)) {
+                Track* cachedTrack = m_trackCache.value(audioFilePath);
+                if (cachedTrack) {
+                    cachedTrack->setLyrics(lyrics);
+                }
             }
         }
 
@@ -3133,8 +3538,10 @@ void LibraryManager::updateLyricsForTrack(const QString &audioFilePath)
         qDebug() << "LibraryManager: Emitting trackLyricsUpdated signal for:" << audioFilePath;
         emit trackLyricsUpdated(audioFilePath, lyrics);
 
-        // Emit general signal to notify UI that track data has changed
-        emit libraryChanged();
+        // Lyrics don't affect ordering or the album/artist lists
+        LibraryChangeSet changes;
+        changes.changedTracks.insert(trackId);
+        applyLibraryChanges(changes);
     }
 }
 
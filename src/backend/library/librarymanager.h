@@ -22,12 +22,19 @@
 #include "artist.h"
 #include "trackmodel.h"
 #include "albummodel.h"
+#include "albumlistmodel.h"
+#include "artistlistmodel.h"
+#include "albumsortproxymodel.h"
 #include "../utility/metadataextractor.h"
 #include "../database/databasemanager.h"
 #include "albumartmanager.h"
 #include "../playlist/VirtualPlaylist.h"
 #include "../playlist/VirtualPlaylistModel.h"
 #include "favoritesmanager.h"
+#include "loudnessanalyzer.h"
+#include "waveformservice.h"
+#include "librarychangeset.h"
+#include "librarysnapshot.h"
 
 namespace Mtoc {
 
@@ -43,8 +50,9 @@ class LibraryManager : public QObject
     Q_PROPERTY(int albumCount READ albumCount NOTIFY albumCountChanged)
     Q_PROPERTY(int albumArtistCount READ albumArtistCount NOTIFY albumArtistCountChanged)
     Q_PROPERTY(int artistCount READ artistCount NOTIFY artistCountChanged)
-    Q_PROPERTY(QVariantList artistModel READ artistModel NOTIFY libraryChanged)
-    Q_PROPERTY(QVariantList albumModel READ albumModel NOTIFY libraryChanged)
+    Q_PROPERTY(Mtoc::ArtistListModel* artists READ artists CONSTANT)
+    Q_PROPERTY(Mtoc::AlbumListModel* albums READ albums CONSTANT)
+    Q_PROPERTY(Mtoc::AlbumSortProxyModel* sortedAlbums READ sortedAlbums CONSTANT)
     Q_PROPERTY(bool processingAlbumArt READ isProcessingAlbumArt NOTIFY processingAlbumArtChanged)
     Q_PROPERTY(bool rebuildingThumbnails READ isRebuildingThumbnails NOTIFY rebuildingThumbnailsChanged)
     Q_PROPERTY(int rebuildProgress READ rebuildProgress NOTIFY rebuildProgressChanged)
@@ -67,8 +75,9 @@ public:
     int albumCount() const;
     int albumArtistCount() const;
     int artistCount() const;
-    QVariantList artistModel() const;
-    QVariantList albumModel() const;
+    ArtistListModel* artists() const;
+    AlbumListModel* albums() const;
+    AlbumSortProxyModel* sortedAlbums() const;
     bool isProcessingAlbumArt() const;
     bool isRebuildingThumbnails() const;
     int rebuildProgress() const;
@@ -92,6 +101,11 @@ public:
     Q_INVOKABLE void resetLibrary();    // Nuclear option - clears everything
     Q_INVOKABLE void clearLibrary();    // Deprecated - kept for compatibility
     Q_INVOKABLE void rebuildAllThumbnails();
+    Q_INVOKABLE bool rebuildAlbumSummary();  // Rebuild the album listing table from tracks
+    
+    // Deferred startup work, run once the first frame is on screen
+    void startFileWatcher();
+    void checkDatabaseIntegrity();  // PRAGMA quick_check on a worker thread
     
     // Data access methods
     Q_INVOKABLE TrackModel* allTracksModel() const;
@@ -122,9 +136,20 @@ public:
     Q_INVOKABLE VirtualPlaylistModel* getFavoritesPlaylist();
     Q_INVOKABLE bool isTrackInLibrary(const QString &filePath) const;
 
+    // Served from the in-memory snapshot; misses (and lookups before the
+    // snapshot is built) fall back to SQL. Both return 0 when not found.
+    int trackIdForPath(const QString &filePath) const;
+    int albumIdForArtistAndTitle(const QString &albumArtist, const QString &albumTitle) const;
+
     // Favorites support
     FavoritesManager* favoritesManager() const { return m_favoritesManager; }
 
+    // Fills in replay gain for untagged tracks
+    LoudnessAnalyzer* loudnessAnalyzer() const { return m_loudnessAnalyzer; }
+
+    // Seek bar waveforms
+    WaveformService* waveformService() const { return m_waveformService; }
+
     // Artist parsing utility
     Q_INVOKABLE QVariantList parseAndMatchTrackArtists(const QString &trackArtist, const QStringList &albumArtists) const;
     
@@ -135,15 +160,10 @@ public:
     Q_INVOKABLE void saveCarouselPosition(int albumId);
     Q_INVOKABLE int loadCarouselPosition() const;
     
-    // Playback state persistence methods
-    Q_INVOKABLE void savePlaybackState(const QString &filePath, qint64 position, 
-                                       const QString &albumArtist, const QString &albumTitle, 
-                                       int trackIndex, qint64 duration,
-                                       bool queueModified = false, const QVariantList &queue = QVariantList(),
-                                       const QVariantMap &virtualPlaylistInfo = QVariantMap(),
-                                       const QVariantMap &playlistInfo = QVariantMap());
-    Q_INVOKABLE QVariantMap loadPlaybackState() const;
-    Q_INVOKABLE void clearPlaybackState();
+    // Playback state from the QSettings group older versions saved to; it is now
+    // kept by MediaPlayer's state journal and these only serve the migration
+    QVariantMap loadPlaybackState() const;
+    void clearPlaybackState();
 
 signals:
     void scanningChanged();
@@ -151,12 +171,15 @@ signals:
     void scanProgressTextChanged();
     void scanCompleted();
     void scanCancelled();
+    // After a forced rescan, from the scan thread; staleRows is -1 if the check failed
+    void albumSummaryChecked(int staleRows, bool repaired);
     void musicFoldersChanged();
     void trackCountChanged();
     void albumCountChanged();
     void albumArtistCountChanged();
     void artistCountChanged();
     void libraryChanged();
+    void libraryUpdated(const QVariantMap &changes);  // Incremental delta; see LibraryChangeSet::toVariantMap
     void processingAlbumArtChanged();
     void rebuildingThumbnailsChanged();
     void rebuildProgressChanged();
@@ -191,6 +214,16 @@ private:
     void setupFileWatcher();
     void updateFileWatcher();
     QStringList getAllSubdirectories(const QString &rootPath) const;
+    void refreshListModels();
+    void applyLibraryChanges(LibraryChangeSet changes);
+    void rebuildSnapshot();
+    bool loadBrowseCache();
+    void refreshListModelsInBackground();
+    void scheduleBrowseCacheWrite();
+    void writeBrowseCache();
+    void resolveAlbumChanges(LibraryChangeSet &changes);
+    void resolveArtistChanges(LibraryChangeSet &changes);
+    static void collectTrackRefs(QSqlDatabase &db, const QList<int> &trackIds, LibraryChangeSet &changes);
     void updateLyricsForTrack(const QString &audioFilePath);
     void processLrcFileChanges(const QString &directoryPath);
     QStringList findAudioFilesForLrc(const QString &lrcFilePath, const QStringList &audioFiles) const;
@@ -202,13 +235,11 @@ private:
     QMap<QString, QString> m_folderDisplayPaths;  // canonical path -> display path
     mutable QMutex m_databaseMutex;     // Protect database access
     
-    // Cache for performance
-    mutable QVariantList m_cachedAlbumModel;
+    // Cache for performance. The cache-valid flags say whether the album/artist
+    // list models match the database; refreshListModels() brings them up to date.
     mutable bool m_albumModelCacheValid;
-    mutable QHash<QString, QVariantList> m_albumsByArtistCache;  // Artist name -> albums
     mutable int m_cachedAlbumCount;  // Cache the total album count
     mutable bool m_albumCountCacheValid;
-    mutable QVariantList m_cachedArtistModel;  // Cache for artist model
     mutable bool m_artistModelCacheValid;
     
     // Track cache for efficiency
@@ -216,6 +247,29 @@ private:
     mutable QMutex m_trackCacheMutex;
     static const int MAX_TRACK_CACHE_SIZE = 10000;  // Limit cache size
     
+    // In-memory copy of the library for lookups that would otherwise hit SQLite
+    LibrarySnapshot m_snapshot;
+    QFuture<void> m_snapshotFuture;
+    QFutureWatcher<void> m_snapshotWatcher;
+    bool m_snapshotRebuildQueued = false;
+    
+    QFuture<void> m_integrityCheckFuture;
+    
+    // Memory-mapped copy of the list models used to render at launch
+    QTimer* m_browseCacheTimer = nullptr;
+    QFuture<void> m_browseCacheWriteFuture;
+    bool m_browseCacheChecked = false;
+    // Artists and albums read on a worker when the cache was stale
+    struct BrowseRows {
+        QVariantList artists;
+        QVariantList albums;
+        bool ok = false;
+    };
+    QFuture<BrowseRows> m_browseRefreshFuture;
+    QFutureWatcher<BrowseRows> m_browseRefreshWatcher;
+    bool m_browseRefreshQueued = false;
+    static const int BROWSE_CACHE_WRITE_DELAY_MS = 3000;
+    
     // Virtual playlist support
     VirtualPlaylist* m_allSongsPlaylist = nullptr;
     VirtualPlaylistModel* m_allSongsPlaylistModel = nullptr;
@@ -224,10 +278,16 @@ private:
 
     // Favorites manager
     FavoritesManager* m_favoritesManager = nullptr;
+    LoudnessAnalyzer* m_loudnessAnalyzer = nullptr;
+    WaveformService* m_waveformService = nullptr;
     
     // Models for UI
     TrackModel *m_allTracksModel;
     AlbumModel *m_allAlbumsModel;
+    AlbumListModel *m_albumListModel = nullptr;
+    ArtistListModel *m_artistListModel = nullptr;
+    AlbumSortProxyModel *m_sortedAlbums = nullptr;
+    bool m_listModelsInUse = false;  // Refresh eagerly only once QML has asked for them
     
     // Scanning state
     bool m_scanning;
@@ -238,6 +298,8 @@ private:
     QFutureWatcher<void> m_scanWatcher;
     bool m_cancelRequested;
     bool m_forceMetadataUpdate;  // Force re-extraction of metadata for existing files
+    LibraryChangeSet m_scanChanges;  // Accumulated by scan threads, applied in onScanFinished
+    QMutex m_scanChangesMutex;
     int m_originalPixmapCacheLimit;  // Store original cache limit to restore after scan
     bool m_processingAlbumArt;  // Track album art processing status
     
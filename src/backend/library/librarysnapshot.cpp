@@ -0,0 +1,494 @@
+#include "librarysnapshot.h"
+#include "librarychangeset.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QRegularExpression>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+
+namespace Mtoc {
+
+namespace {
+
+// Rough per-allocation overheads used by memoryUsage()
+const qint64 STRING_OVERHEAD = 32;
+const qint64 HASH_NODE_OVERHEAD = 48;
+
+qint64 stringBytes(const QString &string)
+{
+    return STRING_OVERHEAD + string.capacity() * qint64(sizeof(QChar));
+}
+
+template <typename T>
+qint64 vectorBytes(const QVector<T> &vector)
+{
+    return vector.capacity() * qint64(sizeof(T));
+}
+
+// Ids are inlined into the query; callers keep lists to a few hundred entries
+QString joinIds(const QList<int> &ids)
+{
+    QStringList parts;
+    parts.reserve(ids.size());
+    for (int id : ids) {
+        parts << QString::number(id);
+    }
+    return parts.join(",");
+}
+
+QList<QList<int>> chunked(const QSet<int> &ids)
+{
+    const int chunkSize = 500;
+    QList<int> all(ids.begin(), ids.end());
+    QList<QList<int>> chunks;
+    for (int start = 0; start < all.size(); start += chunkSize) {
+        chunks.append(all.mid(start, chunkSize));
+    }
+    return chunks;
+}
+
+} // namespace
+
+SnapshotStringPool::SnapshotStringPool()
+{
+    intern(QString());
+}
+
+int SnapshotStringPool::intern(const QString &string)
+{
+    auto it = m_ids.constFind(string);
+    if (it != m_ids.constEnd()) {
+        return it.value();
+    }
+    int id = m_strings.size();
+    m_strings.append(string);
+    m_ids.insert(string, id);
+    return id;
+}
+
+int SnapshotStringPool::find(const QString &string) const
+{
+    return m_ids.value(string, -1);
+}
+
+qint64 SnapshotStringPool::memoryUsage() const
+{
+    // The hash keys share their data with m_strings
+    qint64 bytes = vectorBytes(m_strings) + m_ids.size() * HASH_NODE_OVERHEAD;
+    for (const QString &string : m_strings) {
+        bytes += stringBytes(string);
+    }
+    return bytes;
+}
+
+bool LibrarySnapshot::isReady() const
+{
+    QReadLocker locker(&m_lock);
+    return m_ready;
+}
+
+void LibrarySnapshot::rebuild(QSqlDatabase &db)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    Data data;
+    if (!loadTracks(db, QString(), data) || !loadAlbums(db, QString(), data)) {
+        qWarning() << "[LibrarySnapshot::rebuild] Failed to load library, snapshot disabled";
+        clear();
+        return;
+    }
+    data.trackIds.squeeze();
+    data.trackPaths.squeeze();
+    data.trackAlbumIds.squeeze();
+    data.trackTitles.squeeze();
+    data.trackArtists.squeeze();
+    data.trackGenres.squeeze();
+    data.trackDurations.squeeze();
+
+    int tracks = data.trackIds.size();
+    int albums = data.albumIds.size();
+    int strings = data.strings.size();
+    qint64 bytes = memoryUsage(data);
+    {
+        QWriteLocker locker(&m_lock);
+        std::swap(m_data, data);
+        m_ready = true;
+    }
+
+    qDebug() << "[LibrarySnapshot::rebuild]" << tracks << "tracks," << albums << "albums,"
+             << strings << "strings in" << timer.elapsed() << "ms;"
+             << bytes / 1024 << "KB"
+             << (tracks > 0 ? QString("(~%1 MB per 100k tracks)").arg(bytes * 100000 / tracks / (1024 * 1024)) : QString());
+}
+
+void LibrarySnapshot::applyChanges(QSqlDatabase &db, const LibraryChangeSet &changes)
+{
+    QWriteLocker locker(&m_lock);
+    if (!m_ready) {
+        return;
+    }
+
+    for (int trackId : changes.removedTracks) {
+        int row = m_data.trackRowById.value(trackId, -1);
+        if (row >= 0) {
+            removeTrackRow(m_data, row);
+        }
+    }
+    for (int albumId : changes.removedAlbums) {
+        int row = m_data.albumRowById.value(albumId, -1);
+        if (row >= 0) {
+            removeAlbumRow(m_data, row);
+        }
+    }
+
+    bool ok = true;
+    for (const QList<int> &ids : chunked(changes.addedTracks + changes.changedTracks)) {
+        ok = ok && loadTracks(db, joinIds(ids), m_data);
+    }
+    for (const QList<int> &ids : chunked(changes.addedAlbums + changes.changedAlbums)) {
+        ok = ok && loadAlbums(db, joinIds(ids), m_data);
+    }
+
+    if (!ok) {
+        // A partially applied delta can't be trusted; readers fall back to SQL
+        qWarning() << "[LibrarySnapshot::applyChanges] Failed to load changed rows, snapshot disabled";
+        m_data = Data();
+        m_ready = false;
+    }
+}
+
+void LibrarySnapshot::clear()
+{
+    QWriteLocker locker(&m_lock);
+    m_data = Data();
+    m_ready = false;
+}
+
+int LibrarySnapshot::trackIdByPath(const QString &path) const
+{
+    QReadLocker locker(&m_lock);
+    int row = m_data.trackRowByPath.value(path, -1);
+    return row >= 0 ? m_data.trackIds.at(row) : 0;
+}
+
+int LibrarySnapshot::albumIdByArtistAndTitle(const QString &albumArtist, const QString &title) const
+{
+    static const QRegularExpression separators("[;,]\\s*");
+
+    QReadLocker locker(&m_lock);
+    int titleId = m_data.strings.find(title);
+    if (titleId < 0) {
+        return 0;
+    }
+
+    // Same precedence as the SQL lookup: each credited artist in a joined
+    // "A; B" string, then the whole string for names containing separators
+    QStringList candidates = albumArtist.split(separators, Qt::SkipEmptyParts);
+    candidates.append(albumArtist);
+    for (const QString &candidate : candidates) {
+        int artistId = m_data.strings.find(candidate.trimmed().toLower());
+        if (artistId <= 0) {
+            continue;
+        }
+        int albumId = m_data.albumIdByArtistTitle.value(artistTitleKey(artistId, titleId), 0);
+        if (albumId > 0) {
+            return albumId;
+        }
+    }
+    return 0;
+}
+
+QVariantList LibrarySnapshot::albumsByAlbumArtist(const QString &albumArtistName) const
+{
+    QVariantList albums;
+
+    QReadLocker locker(&m_lock);
+    int artistId = m_data.strings.find(albumArtistName.toLower());
+    if (artistId <= 0) {
+        return albums;
+    }
+
+    QVector<int> rows;
+    for (int albumId : m_data.albumIdsByArtist.value(artistId)) {
+        int row = m_data.albumRowById.value(albumId, -1);
+        if (row >= 0 && m_data.albumTrackCounts.at(row) > 0) {
+            rows.append(row);
+        }
+    }
+
+    std::sort(rows.begin(), rows.end(), [this](int a, int b) {
+        if (m_data.albumYears.at(a) != m_data.albumYears.at(b)) {
+            return m_data.albumYears.at(a) > m_data.albumYears.at(b);
+        }
+        return QString::compare(m_data.strings.at(m_data.albumTitles.at(a)),
+                                m_data.strings.at(m_data.albumTitles.at(b)), Qt::CaseInsensitive) < 0;
+    });
+
+    albums.reserve(rows.size());
+    for (int row : rows) {
+        QStringList artistNames;
+        for (int nameId : m_data.albumArtists.at(row)) {
+            artistNames << m_data.strings.at(nameId);
+        }
+
+        QVariantMap album;
+        album["id"] = m_data.albumIds.at(row);
+        album["title"] = m_data.strings.at(m_data.albumTitles.at(row));
+        album["albumArtist"] = artistNames.join("; ");
+        album["year"] = m_data.albumYears.at(row);
+        album["trackCount"] = m_data.albumTrackCounts.at(row);
+        album["duration"] = m_data.albumDurations.at(row);
+        album["hasArt"] = m_data.albumHasArt.at(row);
+        albums.append(album);
+    }
+    return albums;
+}
+
+int LibrarySnapshot::trackCount() const
+{
+    QReadLocker locker(&m_lock);
+    return m_data.trackIds.size();
+}
+
+int LibrarySnapshot::albumCount() const
+{
+    QReadLocker locker(&m_lock);
+    return m_data.albumIds.size();
+}
+
+qint64 LibrarySnapshot::memoryUsage() const
+{
+    QReadLocker locker(&m_lock);
+    return memoryUsage(m_data);
+}
+
+bool LibrarySnapshot::loadTracks(QSqlDatabase &db, const QString &idFilter, Data &data)
+{
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    QString sql = "SELECT t.id, t.file_path, t.album_id, t.title, a.name, t.genre, t.duration "
+                  "FROM tracks t LEFT JOIN artists a ON a.id = t.artist_id";
+    if (!idFilter.isEmpty()) {
+        sql += " WHERE t.id IN (" + idFilter + ")";
+    }
+    if (!query.exec(sql)) {
+        qWarning() << "[LibrarySnapshot::loadTracks] Query failed:" << query.lastError().text();
+        return false;
+    }
+
+    while (query.next()) {
+        int id = query.value(0).toInt();
+        QString path = query.value(1).toString();
+
+        int row = data.trackRowById.value(id, -1);
+        if (row < 0) {
+            row = data.trackIds.size();
+            data.trackIds.append(id);
+            data.trackPaths.append(QString());
+            data.trackAlbumIds.append(0);
+            data.trackTitles.append(0);
+            data.trackArtists.append(0);
+            data.trackGenres.append(0);
+            data.trackDurations.append(0);
+            data.trackRowById.insert(id, row);
+        } else if (data.trackPaths.at(row) != path) {
+            data.trackRowByPath.remove(data.trackPaths.at(row));
+        }
+
+        data.trackPaths[row] = path;
+        data.trackAlbumIds[row] = query.value(2).toInt();
+        data.trackTitles[row] = data.strings.intern(query.value(3).toString());
+        data.trackArtists[row] = data.strings.intern(query.value(4).toString());
+        data.trackGenres[row] = data.strings.intern(query.value(5).toString());
+        data.trackDurations[row] = query.value(6).toInt();
+        data.trackRowByPath.insert(path, row);
+    }
+    return true;
+}
+
+bool LibrarySnapshot::loadAlbums(QSqlDatabase &db, const QString &idFilter, Data &data)
+{
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+
+    // album_summary is trigger-maintained and already carries counts and art state
+    QString sql = "SELECT s.album_id, s.title, s.year, s.track_count, s.total_duration, s.has_art "
+                  "FROM album_summary s";
+    if (!idFilter.isEmpty()) {
+        sql += " WHERE s.album_id IN (" + idFilter + ")";
+    }
+    if (!query.exec(sql)) {
+        qWarning() << "[LibrarySnapshot::loadAlbums] Summary query failed:" << query.lastError().text();
+        return false;
+    }
+
+    QVector<int> loadedIds;
+    while (query.next()) {
+        int id = query.value(0).toInt();
+        int row = data.albumRowById.value(id, -1);
+        if (row >= 0) {
+            // Unlink the old credits; they are re-read below
+            removeAlbumRow(data, row);
+        }
+        row = data.albumIds.size();
+        data.albumIds.append(id);
+        data.albumTitles.append(data.strings.intern(query.value(1).toString()));
+        data.albumArtists.append(QVector<int>());
+        data.albumYears.append(query.value(2).toInt());
+        data.albumTrackCounts.append(query.value(3).toInt());
+        data.albumDurations.append(query.value(4).toInt());
+        data.albumHasArt.append(query.value(5).toBool());
+        data.albumRowById.insert(id, row);
+        loadedIds.append(id);
+    }
+    query.finish();
+
+    // Credited album artists: the junction table, with albums.album_artist_id
+    // for rows written before it existed
+    QString junctionSql = "SELECT aaa.album_id, aa.name FROM album_album_artists aaa "
+                          "JOIN album_artists aa ON aa.id = aaa.album_artist_id";
+    QString legacySql = "SELECT al.id, aa.name FROM albums al "
+                        "JOIN album_artists aa ON aa.id = al.album_artist_id "
+                        "WHERE NOT EXISTS (SELECT 1 FROM album_album_artists x WHERE x.album_id = al.id)";
+    if (!idFilter.isEmpty()) {
+        junctionSql += " WHERE aaa.album_id IN (" + idFilter + ")";
+        legacySql += " AND al.id IN (" + idFilter + ")";
+    }
+    junctionSql += " ORDER BY aaa.album_id, aaa.position";
+
+    for (const QString &creditSql : {junctionSql, legacySql}) {
+        if (!query.exec(creditSql)) {
+            qWarning() << "[LibrarySnapshot::loadAlbums] Credit query failed:" << query.lastError().text();
+            return false;
+        }
+        while (query.next()) {
+            int row = data.albumRowById.value(query.value(0).toInt(), -1);
+            if (row >= 0) {
+                data.albumArtists[row].append(data.strings.intern(query.value(1).toString()));
+            }
+        }
+        query.finish();
+    }
+
+    // Rows can move while older copies are swap-removed, so resolve them last
+    for (int albumId : loadedIds) {
+        int row = data.albumRowById.value(albumId);
+        int title = data.albumTitles.at(row);
+        for (int nameId : data.albumArtists.at(row)) {
+            int lower = data.strings.intern(data.strings.at(nameId).toLower());
+            data.albumIdsByArtist[lower].append(albumId);
+            quint64 key = artistTitleKey(lower, title);
+            if (!data.albumIdByArtistTitle.contains(key)) {
+                data.albumIdByArtistTitle.insert(key, albumId);
+            }
+        }
+    }
+    return true;
+}
+
+void LibrarySnapshot::removeTrackRow(Data &data, int row)
+{
+    // Swap-remove: the last row moves into the hole and its indexes follow
+    int last = data.trackIds.size() - 1;
+    data.trackRowById.remove(data.trackIds.at(row));
+    data.trackRowByPath.remove(data.trackPaths.at(row));
+
+    if (row != last) {
+        data.trackIds[row] = data.trackIds.at(last);
+        data.trackPaths[row] = data.trackPaths.at(last);
+        data.trackAlbumIds[row] = data.trackAlbumIds.at(last);
+        data.trackTitles[row] = data.trackTitles.at(last);
+        data.trackArtists[row] = data.trackArtists.at(last);
+        data.trackGenres[row] = data.trackGenres.at(last);
+        data.trackDurations[row] = data.trackDurations.at(last);
+        data.trackRowById.insert(data.trackIds.at(row), row);
+        data.trackRowByPath.insert(data.trackPaths.at(row), row);
+    }
+
+    data.trackIds.removeLast();
+    data.trackPaths.removeLast();
+    data.trackAlbumIds.removeLast();
+    data.trackTitles.removeLast();
+    data.trackArtists.removeLast();
+    data.trackGenres.removeLast();
+    data.trackDurations.removeLast();
+}
+
+void LibrarySnapshot::removeAlbumRow(Data &data, int row)
+{
+    int albumId = data.albumIds.at(row);
+    int title = data.albumTitles.at(row);
+    for (int nameId : data.albumArtists.at(row)) {
+        int lower = data.strings.find(data.strings.at(nameId).toLower());
+        if (lower < 0) {
+            continue;
+        }
+        auto it = data.albumIdsByArtist.find(lower);
+        if (it != data.albumIdsByArtist.end()) {
+            it->removeAll(albumId);
+            if (it->isEmpty()) {
+                data.albumIdsByArtist.erase(it);
+            }
+        }
+        quint64 key = artistTitleKey(lower, title);
+        if (data.albumIdByArtistTitle.value(key) == albumId) {
+            data.albumIdByArtistTitle.remove(key);
+        }
+    }
+
+    int last = data.albumIds.size() - 1;
+    data.albumRowById.remove(albumId);
+    if (row != last) {
+        data.albumIds[row] = data.albumIds.at(last);
+        data.albumTitles[row] = data.albumTitles.at(last);
+        data.albumArtists[row] = data.albumArtists.at(last);
+        data.albumYears[row] = data.albumYears.at(last);
+        data.albumTrackCounts[row] = data.albumTrackCounts.at(last);
+        data.albumDurations[row] = data.albumDurations.at(last);
+        data.albumHasArt[row] = data.albumHasArt.at(last);
+        data.albumRowById.insert(data.albumIds.at(row), row);
+    }
+
+    data.albumIds.removeLast();
+    data.albumTitles.removeLast();
+    data.albumArtists.removeLast();
+    data.albumYears.removeLast();
+    data.albumTrackCounts.removeLast();
+    data.albumDurations.removeLast();
+    data.albumHasArt.removeLast();
+}
+
+quint64 LibrarySnapshot::artistTitleKey(int lowerArtist, int title)
+{
+    return (quint64(quint32(lowerArtist)) << 32) | quint32(title);
+}
+
+qint64 LibrarySnapshot::memoryUsage(const Data &data)
+{
+    qint64 bytes = data.strings.memoryUsage();
+
+    bytes += vectorBytes(data.trackIds) + vectorBytes(data.trackPaths) + vectorBytes(data.trackAlbumIds)
+           + vectorBytes(data.trackTitles) + vectorBytes(data.trackArtists) + vectorBytes(data.trackGenres)
+           + vectorBytes(data.trackDurations);
+    for (const QString &path : data.trackPaths) {
+        bytes += stringBytes(path);
+    }
+    bytes += (data.trackRowByPath.size() + data.trackRowById.size()) * HASH_NODE_OVERHEAD;
+
+    bytes += vectorBytes(data.albumIds) + vectorBytes(data.albumTitles) + vectorBytes(data.albumArtists)
+           + vectorBytes(data.albumYears) + vectorBytes(data.albumTrackCounts) + vectorBytes(data.albumDurations)
+           + vectorBytes(data.albumHasArt);
+    for (const QVector<int> &credits : data.albumArtists) {
+        bytes += vectorBytes(credits);
+    }
+    bytes += (data.albumRowById.size() + data.albumIdByArtistTitle.size()) * HASH_NODE_OVERHEAD;
+    for (auto it = data.albumIdsByArtist.constBegin(); it != data.albumIdsByArtist.constEnd(); ++it) {
+        bytes += HASH_NODE_OVERHEAD + vectorBytes(it.value());
+    }
+    return bytes;
+}
+
+} // namespace Mtoc
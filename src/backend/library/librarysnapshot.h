@@ -0,0 +1,101 @@
+#ifndef LIBRARYSNAPSHOT_H
+#define LIBRARYSNAPSHOT_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QVariantList>
+#include <QReadWriteLock>
+#include <QSqlDatabase>
+
+namespace Mtoc {
+
+struct LibraryChangeSet;
+
+// Deduplicating string table for the snapshot. Ids are stable for the
+// lifetime of the pool; id 0 is always the empty string.
+class SnapshotStringPool
+{
+public:
+    SnapshotStringPool();
+
+    int intern(const QString &string);
+    int find(const QString &string) const;  // -1 if never interned
+    const QString &at(int id) const { return m_strings.at(id); }
+    int size() const { return m_strings.size(); }
+    qint64 memoryUsage() const;
+
+private:
+    QVector<QString> m_strings;
+    QHash<QString, int> m_ids;
+};
+
+// Read-optimised in-memory copy of the tracks, albums and album artists that
+// hot paths (art lookups, MPRIS, trackByPath, artist album lists) would
+// otherwise query SQLite for. Rows are stored column-wise with interned
+// strings; hash indexes map paths, ids and (album artist, title) to rows.
+// Built once in the background and kept current from LibraryChangeSets.
+// Reads are safe from any thread.
+class LibrarySnapshot
+{
+public:
+    bool isReady() const;
+
+    // Replaces the contents with a fresh read of the database
+    void rebuild(QSqlDatabase &db);
+    // Reloads the rows named by an already-resolved change set
+    void applyChanges(QSqlDatabase &db, const LibraryChangeSet &changes);
+    void clear();
+
+    int trackIdByPath(const QString &path) const;  // 0 if unknown
+    int albumIdByArtistAndTitle(const QString &albumArtist, const QString &title) const;  // 0 if unknown
+    QVariantList albumsByAlbumArtist(const QString &albumArtistName) const;  // Newest first, like the SQL path
+
+    int trackCount() const;
+    int albumCount() const;
+    qint64 memoryUsage() const;
+
+private:
+    struct Data
+    {
+        SnapshotStringPool strings;
+
+        // Tracks
+        QVector<int> trackIds;
+        QVector<QString> trackPaths;
+        QVector<int> trackAlbumIds;
+        QVector<int> trackTitles;    // Interned
+        QVector<int> trackArtists;   // Interned
+        QVector<int> trackGenres;    // Interned
+        QVector<int> trackDurations;
+        QHash<QString, int> trackRowByPath;
+        QHash<int, int> trackRowById;
+
+        // Albums
+        QVector<int> albumIds;
+        QVector<int> albumTitles;           // Interned
+        QVector<QVector<int>> albumArtists; // Interned, in credit order
+        QVector<int> albumYears;
+        QVector<int> albumTrackCounts;
+        QVector<int> albumDurations;
+        QVector<bool> albumHasArt;
+        QHash<int, int> albumRowById;
+        QHash<quint64, int> albumIdByArtistTitle;  // (lowercase artist, title) -> album id
+        QHash<int, QVector<int>> albumIdsByArtist;  // Lowercase artist -> album ids
+    };
+
+    static bool loadTracks(QSqlDatabase &db, const QString &idFilter, Data &data);
+    static bool loadAlbums(QSqlDatabase &db, const QString &idFilter, Data &data);
+    static void removeTrackRow(Data &data, int row);
+    static void removeAlbumRow(Data &data, int row);
+    static quint64 artistTitleKey(int lowerArtist, int title);
+    static qint64 memoryUsage(const Data &data);
+
+    mutable QReadWriteLock m_lock;
+    Data m_data;
+    bool m_ready = false;
+};
+
+} // namespace Mtoc
+
+#endif // LIBRARYSNAPSHOT_H
@@ -0,0 +1,261 @@
+#include "loudnessanalyzer.h"
+#include "../utility/audiofiledecoder.h"
+#include "../utility/loudnessmeter.h"
+
+#include <QThread>
+#include <QFileInfo>
+#include <QDebug>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+
+namespace Mtoc {
+
+namespace {
+
+// ReplayGain 2.0 reference level
+const double REFERENCE_LOUDNESS_LUFS = -18.0;
+
+struct Measurement {
+    double loudness = -std::numeric_limits<double>::infinity();
+    double peak = 0.0;
+    QVector<double> blocks;
+};
+
+// False if the file could not be decoded. A decoded track can still have no
+// loudness: silence and clips under 400 ms leave it at -infinity.
+bool measureTrack(const QString &filePath, const std::function<bool()> &cancelled, Measurement &measurement)
+{
+    std::unique_ptr<LoudnessMeter> meter;
+    const bool decoded = AudioFileDecoder::decode(filePath, cancelled,
+        [&meter, &filePath](const float *samples, int frames, int sampleRate, int channels) {
+            if (!meter) {
+                meter = std::make_unique<LoudnessMeter>(sampleRate, channels);
+            } else if (meter->sampleRate() != sampleRate || meter->channels() != channels) {
+                qWarning() << "[LoudnessAnalyzer::measureTrack] Format changed mid-stream in"
+                           << QFileInfo(filePath).fileName();
+                return false;
+            }
+            meter->process(samples, frames);
+            return true;
+        });
+
+    if (!decoded) {
+        return false;
+    }
+    if (meter) {
+        measurement.loudness = meter->integratedLoudness();
+        measurement.peak = meter->truePeak();
+        measurement.blocks = meter->blockEnergies();
+    }
+    return true;
+}
+
+} // namespace
+
+LoudnessAnalyzer::LoudnessAnalyzer(DatabaseManager* dbManager, QObject *parent)
+    : QObject(parent)
+    , m_dbManager(dbManager)
+{
+    // Half the cores, and only time nothing else wants; IdlePriority is
+    // SCHED_IDLE on Linux, which also puts the reads in the idle I/O class
+    m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() / 2));
+    m_pool.setThreadPriority(QThread::IdlePriority);
+}
+
+LoudnessAnalyzer::~LoudnessAnalyzer()
+{
+    // Jobs read m_generation, so they must be done before it goes away
+    ++m_generation;
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+int LoudnessAnalyzer::progress() const
+{
+    return m_tracksTotal > 0 ? m_tracksDone * 100 / m_tracksTotal : 0;
+}
+
+QString LoudnessAnalyzer::progressText() const
+{
+    if (!m_running) {
+        return QString();
+    }
+    return QString("Analysed %1 of %2 tracks").arg(m_tracksDone).arg(m_tracksTotal);
+}
+
+void LoudnessAnalyzer::start()
+{
+    if (m_running) {
+        return;
+    }
+    if (!m_dbManager || !m_dbManager->isOpen()) {
+        qWarning() << "[LoudnessAnalyzer::start] Database is not open";
+        return;
+    }
+    const QList<LoudnessAnalysisTrack> tracks = m_dbManager->getTracksForLoudnessAnalysis();
+    m_tracksTotal = tracks.size();
+    m_tracksDone = 0;
+    m_analysed = 0;
+    m_failed = 0;
+    if (tracks.isEmpty()) {
+        qDebug() << "[LoudnessAnalyzer::start] Every track has replay gain";
+        emit progressChanged();
+        emit finished(0, 0);
+        return;
+    }
+
+    // Anything still running belongs to a cancelled run
+    const quint64 generation = ++m_generation;
+
+    // Tracks come sorted by album; those without one are measured on their own
+    int first = 0;
+    while (first < tracks.size()) {
+        int last = first + 1;
+        if (tracks[first].albumId > 0) {
+            while (last < tracks.size() && tracks[last].albumId == tracks[first].albumId) {
+                ++last;
+            }
+        }
+        const QList<LoudnessAnalysisTrack> album = tracks.mid(first, last - first);
+        first = last;
+
+        ++m_albumsPending;
+        m_pool.start([this, album, generation]() {
+            const QList<LoudnessResult> results = analyseAlbum(album, this, generation);
+            QStringList filePaths;
+            for (const LoudnessAnalysisTrack &track : album) {
+                filePaths.append(track.filePath);
+            }
+            QMetaObject::invokeMethod(this, [this, generation, results, filePaths]() {
+                onAlbumAnalysed(generation, results, filePaths);
+            }, Qt::QueuedConnection);
+        });
+    }
+
+    qDebug() << "[LoudnessAnalyzer::start] Analysing" << m_tracksTotal << "tracks in"
+             << m_albumsPending << "albums on" << m_pool.maxThreadCount() << "threads";
+    setRunning(true);
+    emit progressChanged();
+}
+
+void LoudnessAnalyzer::cancel()
+{
+    if (!m_running) {
+        return;
+    }
+    // Albums that were not complete are measured again by the next run
+    ++m_generation;
+    m_pool.clear();
+    m_albumsPending = 0;
+    qDebug() << "[LoudnessAnalyzer::cancel] Cancelled after" << m_tracksDone << "of" << m_tracksTotal << "tracks";
+    setRunning(false);
+    emit progressChanged();
+}
+
+bool LoudnessAnalyzer::isCancelled(quint64 jobGeneration) const
+{
+    return m_generation.load(std::memory_order_relaxed) != jobGeneration;
+}
+
+QList<LoudnessResult> LoudnessAnalyzer::analyseAlbum(const QList<LoudnessAnalysisTrack>& tracks,
+                                                     LoudnessAnalyzer* analyzer, quint64 jobGeneration)
+{
+    const auto cancelled = [analyzer, jobGeneration]() { return analyzer->isCancelled(jobGeneration); };
+
+    QList<LoudnessResult> results;
+    QVector<double> albumBlocks;
+    double albumPeak = 0.0;
+
+    for (const LoudnessAnalysisTrack &track : tracks) {
+        LoudnessResult result;
+        result.trackId = track.id;
+
+        Measurement measurement;
+        const bool decoded = measureTrack(track.filePath, cancelled, measurement);
+        // A track cut short by cancelling has not failed, it just isn't done
+        if (cancelled()) {
+            return {};
+        }
+        if (!decoded) {
+            // Possibly a file that is still being copied or on a drive that
+            // went away, so a later run tries again
+            result.failed = true;
+        } else if (std::isfinite(measurement.loudness)) {
+            result.analysed = true;
+            result.trackGain = REFERENCE_LOUDNESS_LUFS - measurement.loudness;
+            result.trackPeak = measurement.peak;
+            albumBlocks += measurement.blocks;
+            albumPeak = qMax(albumPeak, measurement.peak);
+        }
+        results.append(result);
+
+        QMetaObject::invokeMethod(analyzer, [analyzer, jobGeneration]() {
+            analyzer->onTrackMeasured(jobGeneration);
+        }, Qt::QueuedConnection);
+    }
+
+    // Album loudness gates the blocks of every track together, so quiet
+    // tracks count as quiet rather than being averaged in as equals
+    const double albumLoudness = LoudnessMeter::gatedLoudness(albumBlocks);
+    for (LoudnessResult &result : results) {
+        if (result.analysed) {
+            result.albumGain = REFERENCE_LOUDNESS_LUFS - albumLoudness;
+            result.albumPeak = albumPeak;
+        }
+    }
+    return results;
+}
+
+void LoudnessAnalyzer::onTrackMeasured(quint64 jobGeneration)
+{
+    if (jobGeneration != m_generation) {
+        return;
+    }
+    ++m_tracksDone;
+    emit progressChanged();
+}
+
+void LoudnessAnalyzer::onAlbumAnalysed(quint64 jobGeneration, const QList<LoudnessResult>& results,
+                                       const QStringList& filePaths)
+{
+    if (jobGeneration != m_generation) {
+        return;
+    }
+
+    if (!m_dbManager->storeLoudnessResults(results)) {
+        qWarning() << "[LoudnessAnalyzer::onAlbumAnalysed] Failed to store results, the album is analysed again next run";
+    } else {
+        QStringList analysedPaths;
+        for (int i = 0; i < results.size() && i < filePaths.size(); ++i) {
+            if (results[i].analysed) {
+                ++m_analysed;
+                analysedPaths.append(filePaths[i]);
+            } else {
+                ++m_failed;
+            }
+        }
+        if (!analysedPaths.isEmpty()) {
+            emit tracksAnalysed(analysedPaths);
+        }
+    }
+
+    if (--m_albumsPending == 0) {
+        qDebug() << "[LoudnessAnalyzer::onAlbumAnalysed] Finished:" << m_analysed << "tracks analysed,"
+                 << m_failed << "could not be measured";
+        setRunning(false);
+        emit progressChanged();
+        emit finished(m_analysed, m_failed);
+    }
+}
+
+void LoudnessAnalyzer::setRunning(bool running)
+{
+    if (m_running != running) {
+        m_running = running;
+        emit runningChanged();
+    }
+}
+
+} // namespace Mtoc
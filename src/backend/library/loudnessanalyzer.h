@@ -0,0 +1,69 @@
+#ifndef LOUDNESSANALYZER_H
+#define LOUDNESSANALYZER_H
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <atomic>
+
+#include "../database/databasemanager.h"
+
+namespace Mtoc {
+
+// Measures tracks that have no ReplayGain tags and stores the result as their
+// ReplayGain, so they stop playing at the fallback gain. Each album is one job
+// on a low priority thread pool: its tracks are decoded with GStreamer, track
+// gain and true peak come from each track and album gain from the gated blocks
+// of all of them, and the album is written once it is complete. Progress lives
+// in the database, so a cancelled or interrupted run resumes at the first
+// album that was not finished.
+class LoudnessAnalyzer : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool running READ isRunning NOTIFY runningChanged)
+    Q_PROPERTY(int progress READ progress NOTIFY progressChanged)
+    Q_PROPERTY(QString progressText READ progressText NOTIFY progressChanged)
+
+public:
+    explicit LoudnessAnalyzer(DatabaseManager* dbManager, QObject *parent = nullptr);
+    ~LoudnessAnalyzer();
+
+    bool isRunning() const { return m_running; }
+    int progress() const;  // 0-100
+    QString progressText() const;
+
+    Q_INVOKABLE void start();
+    Q_INVOKABLE void cancel();
+
+signals:
+    void runningChanged();
+    void progressChanged();
+    // New gains were stored for these files
+    void tracksAnalysed(const QStringList& filePaths);
+    void finished(int analysed, int failed);
+
+private:
+    static QList<LoudnessResult> analyseAlbum(const QList<LoudnessAnalysisTrack>& tracks,
+                                              LoudnessAnalyzer* analyzer, quint64 jobGeneration);
+    bool isCancelled(quint64 jobGeneration) const;
+    void onTrackMeasured(quint64 jobGeneration);
+    void onAlbumAnalysed(quint64 jobGeneration, const QList<LoudnessResult>& results,
+                         const QStringList& filePaths);
+    void setRunning(bool running);
+
+    DatabaseManager* m_dbManager;
+    QThreadPool m_pool;
+    std::atomic<quint64> m_generation{0};
+    bool m_running = false;
+    int m_albumsPending = 0;
+    int m_tracksTotal = 0;
+    int m_tracksDone = 0;
+    int m_analysed = 0;
+    int m_failed = 0;
+};
+
+} // namespace Mtoc
+
+#endif // LOUDNESSANALYZER_H
@@ -0,0 +1,232 @@
+#include "waveformitem.h"
+
+#include <QSGGeometryNode>
+#include <QSGVertexColorMaterial>
+#include <cmath>
+
+namespace Mtoc {
+
+namespace {
+
+const qreal COLUMN_PITCH = 3.0;     // px per column, bar plus gap
+const qreal COLUMN_FILL = 0.66;     // Share of the pitch the bar covers
+const int VERTICES_PER_COLUMN = 6;  // Two triangles
+
+void setColumnColor(QSGGeometry::ColoredPoint2D *vertices, int column, const QColor &color)
+{
+    // The vertex colour material expects premultiplied alpha
+    const uchar a = uchar(color.alpha());
+    const uchar r = uchar(color.red() * a / 255);
+    const uchar g = uchar(color.green() * a / 255);
+    const uchar b = uchar(color.blue() * a / 255);
+    QSGGeometry::ColoredPoint2D *v = vertices + column * VERTICES_PER_COLUMN;
+    for (int i = 0; i < VERTICES_PER_COLUMN; ++i) {
+        v[i].r = r;
+        v[i].g = g;
+        v[i].b = b;
+        v[i].a = a;
+    }
+}
+
+} // namespace
+
+WaveformItem::WaveformItem(QQuickItem *parent)
+    : QQuickItem(parent)
+{
+    setFlag(ItemHasContents, true);
+}
+
+void WaveformItem::setService(WaveformService* service)
+{
+    if (m_service == service) {
+        return;
+    }
+    if (m_service) {
+        disconnect(m_service.data(), nullptr, this, nullptr);
+    }
+    m_service = service;
+    if (m_service) {
+        connect(m_service, &WaveformService::waveformReady, this, &WaveformItem::onWaveformReady);
+    }
+    emit serviceChanged();
+    loadPeaks();
+}
+
+void WaveformItem::setFilePath(const QString& filePath)
+{
+    if (m_filePath == filePath) {
+        return;
+    }
+    m_filePath = filePath;
+    emit filePathChanged();
+    loadPeaks();
+}
+
+void WaveformItem::setProgress(qreal progress)
+{
+    progress = qBound(0.0, progress, 1.0);
+    if (qFuzzyCompare(m_progress, progress)) {
+        return;
+    }
+    const int before = playedColumns();
+    m_progress = progress;
+    emit progressChanged();
+    // Position ticks far more often than the playhead crosses a column
+    if (playedColumns() != before) {
+        update();
+    }
+}
+
+void WaveformItem::setColor(const QColor& color)
+{
+    if (m_color == color) {
+        return;
+    }
+    m_color = color;
+    m_geometryDirty = true;
+    emit colorChanged();
+    update();
+}
+
+void WaveformItem::setPlayedColor(const QColor& color)
+{
+    if (m_playedColor == color) {
+        return;
+    }
+    m_playedColor = color;
+    m_geometryDirty = true;
+    emit playedColorChanged();
+    update();
+}
+
+void WaveformItem::onWaveformReady(const QString& filePath)
+{
+    if (filePath == m_filePath && m_peaks.isEmpty()) {
+        loadPeaks();
+    }
+}
+
+void WaveformItem::loadPeaks()
+{
+    const bool wasReady = isReady();
+    m_peaks = m_service ? m_service->peaks(m_filePath) : QByteArray();
+    m_geometryDirty = true;
+    if (isReady() != wasReady) {
+        emit readyChanged();
+    }
+    update();
+}
+
+int WaveformItem::columnCount() const
+{
+    return qBound(1, int(width() / COLUMN_PITCH), int(WaveformService::BUCKETS));
+}
+
+int WaveformItem::playedColumns() const
+{
+    return qRound(m_progress * columnCount());
+}
+
+void WaveformItem::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size()) {
+        m_geometryDirty = true;
+        update();
+    }
+}
+
+QSGNode *WaveformItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data)
+    auto *node = static_cast<QSGGeometryNode*>(oldNode);
+
+    if (m_peaks.size() != WaveformService::BUCKETS * 2 || width() <= 0 || height() <= 0) {
+        delete node;
+        m_paintedPlayed = 0;
+        return nullptr;
+    }
+
+    if (!node) {
+        node = new QSGGeometryNode;
+        auto *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        node->setGeometry(geometry);
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setMaterial(new QSGVertexColorMaterial);
+        node->setFlag(QSGNode::OwnsMaterial);
+        m_geometryDirty = true;
+    }
+
+    QSGGeometry *geometry = node->geometry();
+    const int columns = columnCount();
+    const int played = playedColumns();
+
+    if (m_geometryDirty || geometry->vertexCount() != columns * VERTICES_PER_COLUMN) {
+        geometry->allocate(columns * VERTICES_PER_COLUMN);
+        QSGGeometry::ColoredPoint2D *vertices = geometry->vertexDataAsColoredPoint2D();
+
+        // Scale to the track's own peak so quiet recordings still show shape
+        const auto *peaks = reinterpret_cast<const qint8*>(m_peaks.constData());
+        int loudest = 1;
+        for (int i = 0; i < WaveformService::BUCKETS * 2; ++i) {
+            loudest = qMax(loudest, std::abs(int(peaks[i])));
+        }
+
+        const qreal w = width();
+        const qreal h = height();
+        const qreal pitch = w / columns;
+        const qreal centre = h / 2.0;
+        const qreal scale = centre / loudest;
+
+        for (int column = 0; column < columns; ++column) {
+            const int first = column * WaveformService::BUCKETS / columns;
+            const int last = qMax(first + 1, (column + 1) * WaveformService::BUCKETS / columns);
+            int low = 0;
+            int high = 0;
+            for (int bucket = first; bucket < last; ++bucket) {
+                low = qMin(low, int(peaks[bucket * 2]));
+                high = qMax(high, int(peaks[bucket * 2 + 1]));
+            }
+
+            float top = float(centre - high * scale);
+            float bottom = float(centre - low * scale);
+            // Silence still draws a hairline so the bar reads as a track
+            if (bottom - top < 1.0f) {
+                top = float(centre) - 0.5f;
+                bottom = float(centre) + 0.5f;
+            }
+            const float left = float(column * pitch);
+            const float right = float(column * pitch + pitch * COLUMN_FILL);
+
+            QSGGeometry::ColoredPoint2D *v = vertices + column * VERTICES_PER_COLUMN;
+            v[0].x = left;  v[0].y = top;
+            v[1].x = right; v[1].y = top;
+            v[2].x = left;  v[2].y = bottom;
+            v[3].x = right; v[3].y = top;
+            v[4].x = right; v[4].y = bottom;
+            v[5].x = left;  v[5].y = bottom;
+            setColumnColor(vertices, column, column < played ? m_playedColor : m_color);
+        }
+
+        m_geometryDirty = false;
+        m_paintedPlayed = played;
+        node->markDirty(QSGNode::DirtyGeometry);
+        return node;
+    }
+
+    if (played != m_paintedPlayed) {
+        // Only the columns between the old and new playhead change colour
+        QSGGeometry::ColoredPoint2D *vertices = geometry->vertexDataAsColoredPoint2D();
+        const bool forward = played > m_paintedPlayed;
+        const QColor &color = forward ? m_playedColor : m_color;
+        for (int column = qMin(played, m_paintedPlayed); column < qMax(played, m_paintedPlayed); ++column) {
+            setColumnColor(vertices, column, color);
+        }
+        m_paintedPlayed = played;
+        node->markDirty(QSGNode::DirtyGeometry);
+    }
+    return node;
+}
+
+} // namespace Mtoc
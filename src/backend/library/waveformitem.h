@@ -0,0 +1,72 @@
+#ifndef WAVEFORMITEM_H
+#define WAVEFORMITEM_H
+
+#include <QQuickItem>
+#include <QPointer>
+#include <QColor>
+#include <QByteArray>
+#include "waveformservice.h"
+
+namespace Mtoc {
+
+// Draws a track's waveform behind a seek bar as one scene graph node.
+// Moving the playhead only recolours the columns it passed, so playback
+// doesn't rebuild the geometry or re-read the peaks.
+class WaveformItem : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(Mtoc::WaveformService* service READ service WRITE setService NOTIFY serviceChanged)
+    Q_PROPERTY(QString filePath READ filePath WRITE setFilePath NOTIFY filePathChanged)
+    Q_PROPERTY(qreal progress READ progress WRITE setProgress NOTIFY progressChanged)
+    Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+    Q_PROPERTY(QColor playedColor READ playedColor WRITE setPlayedColor NOTIFY playedColorChanged)
+    Q_PROPERTY(bool ready READ isReady NOTIFY readyChanged)
+
+public:
+    explicit WaveformItem(QQuickItem *parent = nullptr);
+
+    WaveformService* service() const { return m_service; }
+    void setService(WaveformService* service);
+    QString filePath() const { return m_filePath; }
+    void setFilePath(const QString& filePath);
+    qreal progress() const { return m_progress; }
+    void setProgress(qreal progress);
+    QColor color() const { return m_color; }
+    void setColor(const QColor& color);
+    QColor playedColor() const { return m_playedColor; }
+    void setPlayedColor(const QColor& color);
+    bool isReady() const { return !m_peaks.isEmpty(); }
+
+signals:
+    void serviceChanged();
+    void filePathChanged();
+    void progressChanged();
+    void colorChanged();
+    void playedColorChanged();
+    void readyChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+
+private:
+    void onWaveformReady(const QString& filePath);
+    void loadPeaks();
+    int columnCount() const;
+    int playedColumns() const;
+
+    QPointer<WaveformService> m_service;
+    QString m_filePath;
+    QByteArray m_peaks;
+    qreal m_progress = 0.0;
+    QColor m_color = QColor(255, 255, 255, 90);
+    QColor m_playedColor = QColor(255, 255, 255, 220);
+
+    // Render thread state; which of it is stale is decided on the GUI thread
+    bool m_geometryDirty = true;
+    int m_paintedPlayed = 0;
+};
+
+} // namespace Mtoc
+
+#endif // WAVEFORMITEM_H
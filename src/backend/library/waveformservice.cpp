@@ -0,0 +1,440 @@
+#include "waveformservice.h"
+#include "../database/databasemanager.h"
+#include "../utility/audiofiledecoder.h"
+
+#include <QThread>
+#include <QVector>
+#include <QDebug>
+#include <algorithm>
+
+namespace Mtoc {
+
+namespace {
+
+// Decoding is CPU bound; past a few threads it only slows playback down
+const int MAX_DECODE_THREADS = 4;
+const int CACHE_ENTRIES = 256;
+// Min/max are first taken over short runs of frames, then merged into buckets
+// once the length is known
+const int GRANULE_FRAMES = 256;
+
+} // namespace
+
+WaveformService::PeakDecoder WaveformService::s_peakDecoder = nullptr;
+
+WaveformService::WaveformService(DatabaseManager* dbManager, QObject *parent)
+    : QObject(parent)
+    , m_dbManager(dbManager)
+{
+    m_cache.setMaxCost(CACHE_ENTRIES);
+    m_pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 2, MAX_DECODE_THREADS));
+    m_pool.setThreadPriority(QThread::IdlePriority);
+    // Kept alive, as each new thread would open another database connection
+    m_loadPool.setMaxThreadCount(1);
+    m_loadPool.setExpiryTimeout(-1);
+}
+
+WaveformService::~WaveformService()
+{
+    // Jobs read the members below, so they must be done before those go away
+    m_shuttingDown = true;
+    m_pool.clear();
+    m_loadPool.clear();
+    m_pool.waitForDone();
+    m_loadPool.waitForDone();
+}
+
+QByteArray WaveformService::peaks(const QString& filePath)
+{
+    if (filePath.isEmpty()) {
+        return QByteArray();
+    }
+    if (const QByteArray *cached = m_cache.object(filePath)) {
+        return *cached;
+    }
+    if (m_failed.contains(filePath)) {
+        return QByteArray();
+    }
+    auto it = m_queued.constFind(filePath);
+    if (it != m_queued.constEnd()) {
+        // Shown now, so it can't wait behind the rest of the library
+        if (*it == LibraryJob) {
+            queue(filePath, PlaybackJob);
+        }
+        return QByteArray();
+    }
+    if (m_loading.contains(filePath)) {
+        return QByteArray();
+    }
+
+    if (!m_dbManager) {
+        queue(filePath, PlaybackJob);
+        return QByteArray();
+    }
+    m_loading.insert(filePath);
+    m_loadPool.start([this, filePath]() {
+        const QByteArray stored = m_shuttingDown ? QByteArray() : m_dbManager->getWaveform(filePath);
+        QMetaObject::invokeMethod(this, [this, filePath, stored]() {
+            onWaveformLoaded(filePath, stored);
+        }, Qt::QueuedConnection);
+    });
+    return QByteArray();
+}
+
+void WaveformService::onWaveformLoaded(const QString& filePath, const QByteArray& stored)
+{
+    m_loading.remove(filePath);
+    if (m_cache.contains(filePath) || m_failed.contains(filePath) || m_queued.contains(filePath)) {
+        return;
+    }
+    if (stored.size() != BUCKETS * 2) {
+        queue(filePath, PlaybackJob);
+        return;
+    }
+    m_cache.insert(filePath, new QByteArray(stored));
+    emit waveformReady(filePath);
+}
+
+void WaveformService::prefetch(const QStringList& filePaths)
+{
+    QStringList unknown;
+    for (const QString &filePath : filePaths) {
+        if (filePath.isEmpty() || m_cache.contains(filePath) || m_failed.contains(filePath)
+            || m_loading.contains(filePath)) {
+            continue;
+        }
+        auto it = m_queued.constFind(filePath);
+        if (it != m_queued.constEnd()) {
+            if (*it == LibraryJob) {
+                queue(filePath, PlaybackJob);
+            }
+            continue;
+        }
+        unknown.append(filePath);
+    }
+    if (unknown.isEmpty()) {
+        return;
+    }
+    if (!m_dbManager) {
+        onPrefetchChecked(unknown);
+        return;
+    }
+
+    // Stored ones are only loaded when they are shown, so this only asks
+    // whether they exist
+    m_loadPool.start([this, unknown]() {
+        QStringList missing;
+        for (const QString &filePath : unknown) {
+            if (m_shuttingDown) {
+                return;
+            }
+            if (!m_dbManager->hasWaveform(filePath)) {
+                missing.append(filePath);
+            }
+        }
+        QMetaObject::invokeMethod(this, [this, missing]() {
+            onPrefetchChecked(missing);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void WaveformService::onPrefetchChecked(const QStringList& missing)
+{
+    for (const QString &filePath : missing) {
+        if (m_cache.contains(filePath) || m_failed.contains(filePath) || m_loading.contains(filePath)) {
+            continue;
+        }
+        auto it = m_queued.constFind(filePath);
+        if (it != m_queued.constEnd() && *it == PlaybackJob) {
+            continue;
+        }
+        queue(filePath, PlaybackJob);
+    }
+}
+
+void WaveformService::requeueForPlayback(const QString& filePath)
+{
+    m_queued.remove(filePath);
+    queue(filePath, PlaybackJob);
+}
+
+void WaveformService::queue(const QString& filePath, JobPriority priority)
+{
+    if (priority == PlaybackJob && m_queued.value(filePath, PlaybackJob) == LibraryJob) {
+        // The library job stands down if it hasn't started yet
+        QMutexLocker locker(&m_startedMutex);
+        if (!m_started.contains(filePath)) {
+            m_superseded.insert(filePath, LibraryJob);
+        }
+    }
+    m_queued.insert(filePath, priority);
+
+    const quint64 generation = m_libraryGeneration;
+    m_pool.start([this, filePath, priority, generation]() {
+        const auto cancelled = [this, priority, generation]() {
+            return m_shuttingDown || (priority == LibraryJob && m_libraryGeneration != generation);
+        };
+
+        QByteArray peaks;
+        JobOutcome outcome = Cancelled;
+        if (!claim(filePath, priority)) {
+            outcome = AlreadyStarted;
+        } else if (!cancelled()) {
+            peaks = s_peakDecoder ? s_peakDecoder(filePath, cancelled) : computePeaks(filePath, cancelled);
+            outcome = !peaks.isEmpty() ? Decoded : cancelled() ? Cancelled : Failed;
+        }
+        if (outcome == Cancelled) {
+            QMutexLocker locker(&m_startedMutex);
+            m_started.remove(filePath);
+        }
+
+        QMetaObject::invokeMethod(this, [this, filePath, peaks, priority, generation, outcome]() {
+            onJobFinished(filePath, peaks, priority, generation, outcome);
+        }, Qt::QueuedConnection);
+    }, priority);
+}
+
+bool WaveformService::claim(const QString& filePath, JobPriority priority)
+{
+    QMutexLocker locker(&m_startedMutex);
+    auto it = m_superseded.find(filePath);
+    if (it != m_superseded.end() && *it == priority) {
+        m_superseded.erase(it);
+        return false;
+    }
+    if (m_started.contains(filePath)) {
+        return false;
+    }
+    m_started.insert(filePath);
+    return true;
+}
+
+QByteArray WaveformService::computePeaks(const QString& filePath, const std::function<bool()>& cancelled)
+{
+    QVector<float> lows;
+    QVector<float> highs;
+    float low = 0.0f;
+    float high = 0.0f;
+    int inGranule = 0;
+
+    const bool decoded = AudioFileDecoder::decode(filePath, cancelled,
+        [&](const float *samples, int frames, int sampleRate, int channels) {
+            Q_UNUSED(sampleRate)
+            int offset = 0;
+            while (offset < frames) {
+                // Straight runs over interleaved samples, so the min/max vectorise
+                const int n = qMin(frames - offset, GRANULE_FRAMES - inGranule);
+                const float *run = samples + qsizetype(offset) * channels;
+                const qsizetype count = qsizetype(n) * channels;
+                for (qsizetype i = 0; i < count; ++i) {
+                    low = std::min(low, run[i]);
+                    high = std::max(high, run[i]);
+                }
+                inGranule += n;
+                offset += n;
+                if (inGranule == GRANULE_FRAMES) {
+                    lows.append(low);
+                    highs.append(high);
+                    low = high = 0.0f;
+                    inGranule = 0;
+                }
+            }
+            return true;
+        });
+
+    if (!decoded) {
+        return QByteArray();
+    }
+    if (inGranule > 0) {
+        lows.append(low);
+        highs.append(high);
+    }
+    if (lows.isEmpty()) {
+        return QByteArray();
+    }
+
+    const qint64 granules = lows.size();
+    QByteArray peaks(BUCKETS * 2, 0);
+    for (int bucket = 0; bucket < BUCKETS; ++bucket) {
+        const qint64 first = bucket * granules / BUCKETS;
+        const qint64 last = qMax(first + 1, (bucket + 1) * granules / BUCKETS);
+        float bucketLow = 0.0f;
+        float bucketHigh = 0.0f;
+        for (qint64 g = first; g < last; ++g) {
+            bucketLow = std::min(bucketLow, lows[g]);
+            bucketHigh = std::max(bucketHigh, highs[g]);
+        }
+        peaks[bucket * 2] = char(qRound(qBound(-1.0f, bucketLow, 1.0f) * 127.0f));
+        peaks[bucket * 2 + 1] = char(qRound(qBound(-1.0f, bucketHigh, 1.0f) * 127.0f));
+    }
+    return peaks;
+}
+
+void WaveformService::onJobFinished(const QString& filePath, const QByteArray& peaks, JobPriority priority,
+                                    quint64 jobGeneration, JobOutcome outcome)
+{
+    if (priority == LibraryJob && m_generating && jobGeneration == m_libraryGeneration) {
+        ++m_libraryDone;
+        --m_libraryInFlight;
+        feedLibrary();
+        emit progressChanged();
+    }
+
+    switch (outcome) {
+    case AlreadyStarted: {
+        // The job that claimed the path reports it, unless it has been
+        // cancelled since; then nothing else would decode it for playback
+        if (priority != PlaybackJob) {
+            return;
+        }
+        bool ownerRunning = false;
+        {
+            QMutexLocker locker(&m_startedMutex);
+            ownerRunning = m_started.contains(filePath);
+            // Meant for this job, which no longer needs telling
+            auto it = m_superseded.find(filePath);
+            if (it != m_superseded.end() && *it == PlaybackJob) {
+                m_superseded.erase(it);
+            }
+        }
+        if (ownerRunning) {
+            m_deferred.insert(filePath);
+        } else if (m_queued.value(filePath, LibraryJob) == PlaybackJob) {
+            requeueForPlayback(filePath);
+        }
+        return;
+    }
+    case Cancelled: {
+        auto it = m_queued.find(filePath);
+        if (it != m_queued.end() && *it == priority) {
+            m_queued.erase(it);
+        } else if (m_deferred.remove(filePath)) {
+            // A playback job gave way to this one and has already finished
+            requeueForPlayback(filePath);
+        }
+        return;
+    }
+    case Decoded:
+    case Failed:
+        break;
+    }
+
+    {
+        QMutexLocker locker(&m_startedMutex);
+        m_started.remove(filePath);
+        // A playback job that queued behind this one has nothing left to do
+        if (priority == LibraryJob && m_queued.value(filePath, LibraryJob) == PlaybackJob
+            && !m_deferred.contains(filePath)) {
+            m_superseded.insert(filePath, PlaybackJob);
+        }
+    }
+    m_queued.remove(filePath);
+    m_deferred.remove(filePath);
+
+    if (outcome == Failed) {
+        m_failed.insert(filePath);
+        return;
+    }
+
+    m_cache.insert(filePath, new QByteArray(peaks));
+    if (m_dbManager) {
+        m_dbManager->storeWaveform(filePath, peaks);
+    }
+    emit waveformReady(filePath);
+}
+
+int WaveformService::progress() const
+{
+    return m_libraryTotal > 0 ? m_libraryDone * 100 / m_libraryTotal : 0;
+}
+
+QString WaveformService::progressText() const
+{
+    if (!m_generating) {
+        return QString();
+    }
+    return QString("Generated %1 of %2 waveforms").arg(m_libraryDone).arg(m_libraryTotal);
+}
+
+void WaveformService::generateLibrary()
+{
+    if (m_generating || !m_dbManager) {
+        return;
+    }
+
+    generateLibrary(m_dbManager->getTrackPathsWithoutWaveform());
+}
+
+void WaveformService::generateLibrary(const QStringList& filePaths)
+{
+    if (m_generating) {
+        return;
+    }
+
+    // Anything left from a cancelled run is skipped by its job
+    ++m_libraryGeneration;
+    m_libraryBacklog.clear();
+    m_libraryNext = 0;
+    m_libraryInFlight = 0;
+    m_libraryDone = 0;
+    for (const QString &filePath : filePaths) {
+        if (!m_queued.contains(filePath) && !m_failed.contains(filePath)) {
+            m_libraryBacklog.append(filePath);
+        }
+    }
+    m_libraryTotal = m_libraryBacklog.size();
+
+    qDebug() << "[WaveformService::generateLibrary] Generating" << m_libraryTotal << "waveforms on"
+             << m_pool.maxThreadCount() << "threads";
+    setGenerating(m_libraryTotal > 0);
+    feedLibrary();
+    emit progressChanged();
+}
+
+void WaveformService::feedLibrary()
+{
+    // A thread's worth of jobs in the pool at a time, so a playback job never
+    // queues behind the whole library and cancelling has nothing to clear
+    while (m_libraryInFlight < m_pool.maxThreadCount() && m_libraryNext < m_libraryBacklog.size()) {
+        const QString filePath = m_libraryBacklog.at(m_libraryNext++);
+        // Picked up by playback since the run started
+        if (m_queued.contains(filePath) || m_failed.contains(filePath) || m_cache.contains(filePath)) {
+            ++m_libraryDone;
+            continue;
+        }
+        queue(filePath, LibraryJob);
+        ++m_libraryInFlight;
+    }
+
+    if (m_generating && m_libraryInFlight == 0) {
+        qDebug() << "[WaveformService::feedLibrary] Library waveforms done:" << m_libraryDone;
+        m_libraryBacklog.clear();
+        m_libraryNext = 0;
+        setGenerating(false);
+    }
+}
+
+void WaveformService::cancelGeneration()
+{
+    if (!m_generating) {
+        return;
+    }
+    // Library jobs in the pool see the new generation and finish without
+    // decoding; waveforms requested for playback carry on
+    ++m_libraryGeneration;
+    m_libraryBacklog.clear();
+    m_libraryNext = 0;
+    m_libraryInFlight = 0;
+    setGenerating(false);
+    emit progressChanged();
+}
+
+void WaveformService::setGenerating(bool generating)
+{
+    if (m_generating != generating) {
+        m_generating = generating;
+        emit generatingChanged();
+    }
+}
+
+} // namespace Mtoc
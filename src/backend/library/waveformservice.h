@@ -0,0 +1,120 @@
+#ifndef WAVEFORMSERVICE_H
+#define WAVEFORMSERVICE_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QCache>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <atomic>
+#include <functional>
+
+namespace Mtoc {
+
+class DatabaseManager;
+
+// Waveforms for the seek bars. A waveform is BUCKETS (min, max) pairs of
+// int8 covering the whole track, 2 KB, decoded once on a capped background
+// pool and kept in the waveforms table. Lookups are served from memory; a
+// miss reads the row on a loader thread, so nothing on the UI path waits for
+// the database or a decoder. Tracks about to play are decoded ahead of the
+// library-wide job, which only keeps one job per pool thread queued.
+class WaveformService : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool generating READ isGenerating NOTIFY generatingChanged)
+    Q_PROPERTY(int progress READ progress NOTIFY progressChanged)
+    Q_PROPERTY(QString progressText READ progressText NOTIFY progressChanged)
+
+public:
+    static const int BUCKETS = 1024;
+
+    explicit WaveformService(DatabaseManager* dbManager, QObject *parent = nullptr);
+    ~WaveformService();
+
+    // Empty unless the waveform is in memory; it is then loaded or decoded
+    // and waveformReady() follows
+    QByteArray peaks(const QString& filePath);
+    // Decode ahead of playback, before any library-wide work
+    void prefetch(const QStringList& filePaths);
+
+    bool isGenerating() const { return m_generating; }
+    int progress() const;  // 0-100
+    QString progressText() const;
+
+    // Decodes every library track that has no waveform yet, at idle priority
+    Q_INVOKABLE void generateLibrary();
+    // The same for the given tracks rather than the database's list
+    void generateLibrary(const QStringList& filePaths);
+    Q_INVOKABLE void cancelGeneration();
+
+    // Replaces the decoder, for tests; nullptr restores it
+    using PeakDecoder = QByteArray (*)(const QString& filePath, const std::function<bool()>& cancelled);
+    static void setPeakDecoder(PeakDecoder decoder) { s_peakDecoder = decoder; }
+
+signals:
+    void waveformReady(const QString& filePath);
+    void generatingChanged();
+    void progressChanged();
+
+private:
+    enum JobPriority {
+        LibraryJob = 0,
+        PlaybackJob = 1
+    };
+
+    enum JobOutcome {
+        Decoded,
+        Failed,
+        AlreadyStarted,   // The other job for the same path has it
+        Cancelled
+    };
+
+    void queue(const QString& filePath, JobPriority priority);
+    void requeueForPlayback(const QString& filePath);
+    bool claim(const QString& filePath, JobPriority priority);
+    void onWaveformLoaded(const QString& filePath, const QByteArray& stored);
+    void onPrefetchChecked(const QStringList& missing);
+    static QByteArray computePeaks(const QString& filePath, const std::function<bool()>& cancelled);
+    void onJobFinished(const QString& filePath, const QByteArray& peaks, JobPriority priority,
+                       quint64 jobGeneration, JobOutcome outcome);
+    void feedLibrary();
+    void setGenerating(bool generating);
+
+    static PeakDecoder s_peakDecoder;
+
+    DatabaseManager* m_dbManager;
+    QThreadPool m_pool;
+    QThreadPool m_loadPool;                // Database reads, one thread with its own connection
+    QCache<QString, QByteArray> m_cache;
+    QSet<QString> m_loading;
+    QHash<QString, JobPriority> m_queued;
+    QSet<QString> m_failed;                // Not retried until the next session
+    // Playback jobs that left their path to a library job already decoding it
+    QSet<QString> m_deferred;
+
+    // A path is queued twice when playback overtakes the library job. The
+    // playback job decodes it unless the library job had already started.
+    // Jobs that are to stand down are kept with the priority they were queued at.
+    QMutex m_startedMutex;
+    QSet<QString> m_started;
+    QHash<QString, JobPriority> m_superseded;
+
+    std::atomic<quint64> m_libraryGeneration{0};
+    std::atomic<bool> m_shuttingDown{false};
+    bool m_generating = false;
+    // Library paths not yet handed to the pool, fed as jobs finish
+    QStringList m_libraryBacklog;
+    int m_libraryNext = 0;
+    int m_libraryInFlight = 0;
+    int m_libraryTotal = 0;
+    int m_libraryDone = 0;
+};
+
+} // namespace Mtoc
+
+#endif // WAVEFORMSERVICE_H
@@ -1,14 +1,19 @@
 #include "audioengine.h"
+#include "playbackdiagnostics.h"
+#include "backend/utility/parametricequalizer.h"
 #include <QTimer>
 #include <QDebug>
 #include <QUrl>
 #include <QPointer>
 #include <QFileInfo>
+#include <utility>
 
 bool AudioEngine::s_gstInitialized = false;
+AudioEngine::AudioSinkFactory AudioEngine::s_audioSinkFactory = nullptr;
 
 AudioEngine::AudioEngine(QObject *parent)
     : QObject(parent)
+    , m_diagnostics(new Mtoc::PlaybackDiagnostics(this))
 {
     if (!s_gstInitialized) {
         GError *error = nullptr;
@@ -22,39 +27,9 @@ AudioEngine::AudioEngine(QObject *parent)
     
     initializePipeline();
     
+    // Only runs while playing and while a poll interval is set
     m_positionTimer = new QTimer(this);
-    m_positionTimer->setInterval(250);
     connect(m_positionTimer, &QTimer::timeout, this, &AudioEngine::updatePosition);
-    
-    // Initialize gapless playback timers
-    // m_transitionTimer is created on-demand in queueNextTrack for monitoring transitions
-    m_transitionTimer = nullptr;
-    
-    // Fallback timer ensures transitions are handled even if monitoring fails
-    m_transitionFallbackTimer = new QTimer(this);
-    m_transitionFallbackTimer->setSingleShot(true);
-    m_transitionFallbackTimer->setInterval(5000); // 5 seconds fallback
-    connect(m_transitionFallbackTimer, &QTimer::timeout, this, [this]() {
-        if (m_hasQueuedTrack && !m_trackTransitionDetected) {
-            qDebug() << "[AudioEngine] Warning: Using fallback transition detection (monitoring timeout)";
-            
-            // Clean up any active monitoring
-            if (m_transitionTimer && m_transitionTimer->isActive()) {
-                m_transitionTimer->stop();
-            }
-            
-            // Reset state and emit transition
-            m_hasQueuedTrack = false;
-            m_trackTransitionDetected = false;
-            emit trackTransitioned();
-            
-            // Update duration for the new track
-            gint64 duration;
-            if (gst_element_query_duration(m_pipeline, GST_FORMAT_TIME, &duration)) {
-                emit durationChanged(duration / GST_MSECOND);
-            }
-        }
-    });
 }
 
 AudioEngine::~AudioEngine()
@@ -68,18 +43,6 @@ AudioEngine::~AudioEngine()
         m_positionTimer = nullptr;
     }
     
-    if (m_transitionTimer) {
-        m_transitionTimer->stop();
-        delete m_transitionTimer;
-        m_transitionTimer = nullptr;
-    }
-    
-    if (m_transitionFallbackTimer) {
-        m_transitionFallbackTimer->stop();
-        delete m_transitionFallbackTimer;
-        m_transitionFallbackTimer = nullptr;
-    }
-    
     // Stop playback before cleanup
     if (m_pipeline) {
         gst_element_set_state(m_pipeline, GST_STATE_NULL);
@@ -97,34 +60,69 @@ AudioEngine::~AudioEngine()
 
 void AudioEngine::initializePipeline()
 {
-    m_playbin = gst_element_factory_make("playbin3", "playbin");
+    m_equalizer = std::make_unique<Mtoc::ParametricEqualizer>();
+    m_playbin = createPlaybin(&m_rgvolume, &m_audioFilterBin, m_equalizer.get());
     if (!m_playbin) {
-        qCritical() << "Failed to create playbin3 element";
         return;
     }
     
     m_pipeline = m_playbin;
     
+    g_signal_connect(m_playbin, "about-to-finish", G_CALLBACK(aboutToFinishCallback), this);
+    
+    m_bus = gst_element_get_bus(m_pipeline);
+    m_busWatchId = gst_bus_add_watch(m_bus, busCallback, this);
+}
+
+GstElement *AudioEngine::createPlaybin(GstElement **rgvolumeOut, GstElement **audioFilterBinOut,
+                                      Mtoc::ParametricEqualizer *equalizer)
+{
+    *rgvolumeOut = nullptr;
+    *audioFilterBinOut = nullptr;
+    
+    GstElement *playbin = gst_element_factory_make("playbin3", "playbin");
+    if (!playbin) {
+        qCritical() << "Failed to create playbin3 element";
+        return nullptr;
+    }
+    
     // Standard buffer sizes (AAC will use non-gapless playback)
-    g_object_set(m_playbin, "buffer-size", 512 * 1024, nullptr);
-    g_object_set(m_playbin, "buffer-duration", 2 * GST_SECOND, nullptr);
+    g_object_set(playbin, "buffer-size", 512 * 1024, nullptr);
+    g_object_set(playbin, "buffer-duration", 2 * GST_SECOND, nullptr);
+    
+    g_signal_connect(playbin, "source-setup", G_CALLBACK(sourceSetupCallback), this);
+    
+    if (s_audioSinkFactory) {
+        if (GstElement *sink = s_audioSinkFactory()) {
+            g_object_set(playbin, "audio-sink", sink, nullptr);
+        }
+    }
     
     // Create and configure replay gain element with audioconvert for format compatibility
-    m_rgvolume = gst_element_factory_make("rgvolume", "rgvolume");
-    if (m_rgvolume) {
+    GstElement *rgvolume = gst_element_factory_make("rgvolume", "rgvolume");
+    GstElement *audioFilterBin = nullptr;
+    if (rgvolume) {
         // Create audioconvert elements for format conversion
         GstElement* audioconvert1 = gst_element_factory_make("audioconvert", "audioconvert1");
         GstElement* audioconvert2 = gst_element_factory_make("audioconvert", "audioconvert2");
         
         if (audioconvert1 && audioconvert2) {
             // Create a bin to contain the audio filter pipeline
-            m_audioFilterBin = gst_bin_new("audio-filter-bin");
+            audioFilterBin = gst_bin_new("audio-filter-bin");
             
             // Add elements to the bin
-            gst_bin_add_many(GST_BIN(m_audioFilterBin), audioconvert1, m_rgvolume, audioconvert2, nullptr);
+            gst_bin_add_many(GST_BIN(audioFilterBin), audioconvert1, rgvolume, audioconvert2, nullptr);
             
-            // Link the elements: audioconvert1 -> rgvolume -> audioconvert2
-            if (gst_element_link_many(audioconvert1, m_rgvolume, audioconvert2, nullptr)) {
+            // Link the elements: audioconvert1 -> rgvolume -> audioconvert2. rgvolume
+            // is held to native float so the equalizer can work on its output in place.
+            GstCaps *floatCaps = gst_caps_new_simple("audio/x-raw",
+                "format", G_TYPE_STRING, G_BYTE_ORDER == G_LITTLE_ENDIAN ? "F32LE" : "F32BE",
+                "layout", G_TYPE_STRING, "interleaved",
+                nullptr);
+            const bool linked = gst_element_link_filtered(audioconvert1, rgvolume, floatCaps)
+                && gst_element_link(rgvolume, audioconvert2);
+            gst_caps_unref(floatCaps);
+            if (linked) {
                 // Create ghost pads to expose the bin's sink and src
                 GstPad* sinkPad = gst_element_get_static_pad(audioconvert1, "sink");
                 GstPad* srcPad = gst_element_get_static_pad(audioconvert2, "src");
@@ -135,14 +133,22 @@ void AudioEngine::initializePipeline()
                 gst_pad_set_active(ghostSink, TRUE);
                 gst_pad_set_active(ghostSrc, TRUE);
                 
-                gst_element_add_pad(m_audioFilterBin, ghostSink);
-                gst_element_add_pad(m_audioFilterBin, ghostSrc);
+                gst_element_add_pad(audioFilterBin, ghostSink);
+                gst_element_add_pad(audioFilterBin, ghostSrc);
                 
                 gst_object_unref(sinkPad);
                 gst_object_unref(srcPad);
                 
+                GstPad *rgSinkPad = gst_element_get_static_pad(rgvolume, "sink");
+                gst_pad_add_probe(rgSinkPad, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM, replayGainTagProbe, this, nullptr);
+                gst_object_unref(rgSinkPad);
+                GstPad *rgSrcPad = gst_element_get_static_pad(rgvolume, "src");
+                gst_pad_add_probe(rgSrcPad, GstPadProbeType(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM),
+                                  equalizerProbe, equalizer, nullptr);
+                gst_object_unref(rgSrcPad);
+                
                 // Set default replay gain properties
-                g_object_set(m_rgvolume, 
+                g_object_set(rgvolume, 
                     "album-mode", FALSE,        // Start with track mode
                     "pre-amp", 0.0,            // No pre-amplification by default
                     "fallback-gain", 0.0,       // 0 dB fallback gain
@@ -150,33 +156,32 @@ void AudioEngine::initializePipeline()
                     nullptr);
                 
                 // Add a reference to keep the bin alive
-                gst_object_ref(m_audioFilterBin);
+                gst_object_ref(audioFilterBin);
                 
                 // Set the bin as the audio filter for playbin
-                g_object_set(m_playbin, "audio-filter", m_audioFilterBin, nullptr);
+                g_object_set(playbin, "audio-filter", audioFilterBin, nullptr);
                 //qDebug() << "[ReplayGain] GStreamer replay gain pipeline created successfully (audioconvert -> rgvolume -> audioconvert)";
             } else {
                 qWarning() << "[ReplayGain] Failed to link audio filter elements";
-                gst_object_unref(m_audioFilterBin);
-                m_audioFilterBin = nullptr;
-                m_rgvolume = nullptr;
+                gst_object_unref(audioFilterBin);
+                audioFilterBin = nullptr;
+                rgvolume = nullptr;
             }
         } else {
             qWarning() << "[ReplayGain] Failed to create audioconvert elements for replay gain";
             if (audioconvert1) gst_object_unref(audioconvert1);
             if (audioconvert2) gst_object_unref(audioconvert2);
-            gst_object_unref(m_rgvolume);
-            m_rgvolume = nullptr;
+            gst_object_unref(rgvolume);
+            rgvolume = nullptr;
         }
     } else {
         qWarning() << "[ReplayGain] Failed to create rgvolume element - replay gain will not be available";
         qWarning() << "[ReplayGain] Make sure gstreamer1.0-plugins-good is installed";
     }
     
-    g_signal_connect(m_playbin, "about-to-finish", G_CALLBACK(aboutToFinishCallback), this);
-    
-    m_bus = gst_element_get_bus(m_pipeline);
-    m_busWatchId = gst_bus_add_watch(m_bus, busCallback, this);
+    *rgvolumeOut = rgvolume;
+    *audioFilterBinOut = audioFilterBin;
+    return playbin;
 }
 
 void AudioEngine::cleanupPipeline()
@@ -185,6 +190,8 @@ void AudioEngine::cleanupPipeline()
         m_positionTimer->stop();
     }
     
+    destroyStandby();
+    
     if (m_pipeline) {
         gst_element_set_state(m_pipeline, GST_STATE_NULL);
     }
@@ -222,20 +229,17 @@ void AudioEngine::loadTrack(const QString &filePath)
     
     stop();
     
+    const bool fromStandby = hasStandby(filePath);
+    if (fromStandby) {
+        activateStandby();
+    }
+    
     m_currentTrack = filePath;
-    m_hasQueuedTrack = false;  // Reset gapless tracking
-    m_trackTransitionDetected = false;
+    applyFallbackGain(m_rgvolume, filePath);
+    // Loading replaces any queued track, so its stream start must not count as a transition
+    m_queuedTracks.clear();
+    updateQueuedGain();
     m_lastKnownDuration = 0;  // Reset duration
-
-    // Stop transition monitoring when loading a new track manually
-    // This prevents spurious transition signals after queue changes
-    if (m_transitionTimer && m_transitionTimer->isActive()) {
-        m_transitionTimer->stop();
-    }
-
-    if (m_transitionFallbackTimer) {
-        m_transitionFallbackTimer->stop();
-    }
     
     // Log replay gain status when loading a track
     if (m_rgvolume) {
@@ -265,6 +269,14 @@ void AudioEngine::loadTrack(const QString &filePath)
         //          << "| Fallback=" << fallbackGain << "dB";
     }
     
+    if (fromStandby) {
+        // Already prerolled (or still prerolling); play() only has to start it.
+        // If the duration isn't known yet it comes with DURATION_CHANGED.
+        setState(State::Ready);
+        updateDuration();
+        return;
+    }
+    
     QUrl url = QUrl::fromLocalFile(filePath);
     g_object_set(m_playbin, "uri", url.toString().toUtf8().constData(), nullptr);
     
@@ -287,9 +299,16 @@ void AudioEngine::play()
         return;
     }
     
+    // Resuming from pause is not a start
+    if (m_state == State::Ready || m_state == State::Stopped) {
+        m_decodeStartTimer.start();
+    }
+    
     if (gst_element_set_state(m_pipeline, GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE) {
         setState(State::Playing);
-        m_positionTimer->start();
+        if (m_positionPollInterval > 0) {
+            m_positionTimer->start();
+        }
         // Clear any pending seek state when resuming playback
         m_seekPending = false;
     }
@@ -330,6 +349,7 @@ void AudioEngine::seek(qint64 position)
     // Track that we're seeking
     m_seekPending = true;
     m_seekTarget = position;
+    m_seekTimer.start();
     
     gst_element_seek_simple(m_pipeline, GST_FORMAT_TIME, 
                            static_cast<GstSeekFlags>(GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT),
@@ -387,6 +407,22 @@ qint64 AudioEngine::duration() const
     return 0;
 }
 
+void AudioEngine::setPositionPollInterval(int msec)
+{
+    m_positionPollInterval = qMax(0, msec);
+    if (!m_positionTimer) {
+        return;
+    }
+    if (m_positionPollInterval == 0) {
+        m_positionTimer->stop();
+        return;
+    }
+    m_positionTimer->setInterval(m_positionPollInterval);
+    if (m_state == State::Playing && !m_positionTimer->isActive()) {
+        m_positionTimer->start();
+    }
+}
+
 float AudioEngine::volume() const
 {
     return m_volume;
@@ -399,6 +435,9 @@ void AudioEngine::setVolume(float volume)
     if (m_playbin) {
         g_object_set(m_playbin, "volume", static_cast<double>(m_volume), nullptr);
     }
+    if (m_standby.playbin) {
+        g_object_set(m_standby.playbin, "volume", static_cast<double>(m_volume), nullptr);
+    }
 }
 
 void AudioEngine::setState(State state)
@@ -414,35 +453,76 @@ void AudioEngine::updatePosition()
     emit positionChanged(position());
 }
 
-gboolean AudioEngine::busCallback(GstBus *bus, GstMessage *message, gpointer data)
+void AudioEngine::updateDuration()
+{
+    gint64 duration;
+    if (!gst_element_query_duration(m_pipeline, GST_FORMAT_TIME, &duration)) {
+        return;
+    }
+    qint64 durationMs = duration / GST_MSECOND;
+    if (durationMs != m_lastKnownDuration) {
+        m_lastKnownDuration = durationMs;
+        emit durationChanged(durationMs);
+    }
+}
+
+void AudioEngine::handleStreamStart()
 {
-    Q_UNUSED(bus)
+    // Posted once every sink has received the new stream's first data, so this
+    // is the gapless switch itself rather than the earlier preroll of the next URI
+    m_currentTrack = m_queuedTracks.takeFirst();
+    qDebug() << "[AudioEngine] Gapless transition to" << QFileInfo(m_currentTrack).fileName();
+    
+    // How much of the new track had played by the time the switch got here
+    m_diagnostics->record(Mtoc::PlaybackDiagnostics::GaplessLag, qMax<qint64>(0, position()), m_currentTrack);
+    
+    // The sink probe already switched the gain in-band. This arms it for the
+    // track queued after this one, if any, and catches a replay gain setting
+    // that changed while the switch was on its way here.
+    updateQueuedGain();
+    applyFallbackGain(m_rgvolume, m_currentTrack);
     
+    emit trackTransitioned();
+    
+    // The position is now relative to the new track; its duration may only be
+    // known later, in which case DURATION_CHANGED follows
+    emit positionChanged(position());
+    updateDuration();
+}
+
+gboolean AudioEngine::busCallback(GstBus *bus, GstMessage *message, gpointer data)
+{
     AudioEngine *engine = static_cast<AudioEngine*>(data);
     
+    // Both pipelines share this callback; after a swap, messages the old
+    // pipeline had already posted arrive here from the standby bus
+    if (bus != engine->m_bus) {
+        engine->handleStandbyMessage(message);
+        return TRUE;
+    }
+    
+    engine->recordBusDiagnostics(message);
+    
     switch (GST_MESSAGE_TYPE(message)) {
     case GST_MESSAGE_EOS:
         engine->stop();
         emit engine->trackFinished();
         break;
     
-    case GST_MESSAGE_TAG: {
-        // TAG messages are now only used for debugging since we have proactive monitoring
-        // The proactive system in queueNextTrack handles all transition detection
-        if (engine->m_hasQueuedTrack) {
-            GstTagList *tags = nullptr;
-            gst_message_parse_tag(message, &tags);
-            if (tags) {
-                gchar *title = nullptr;
-                if (gst_tag_list_get_string(tags, GST_TAG_TITLE, &title)) {
-                    //qDebug() << "[AudioEngine] TAG message - new track metadata:" << title;
-                    g_free(title);
-                }
-                gst_tag_list_unref(tags);
-            }
+    case GST_MESSAGE_STREAM_START:
+        // Every stream posts this, including the first one after loadTrack();
+        // only a stream start with a track queued is a gapless transition
+        if (!engine->m_queuedTracks.isEmpty()) {
+            engine->handleStreamStart();
+        }
+        break;
+    
+    case GST_MESSAGE_DURATION_CHANGED:
+        // The outgoing track's duration stays until the switch has happened
+        if (engine->m_queuedTracks.isEmpty()) {
+            engine->updateDuration();
         }
         break;
-    }
         
     case GST_MESSAGE_ERROR: {
         GError *error;
@@ -467,11 +547,21 @@ gboolean AudioEngine::busCallback(GstBus *bus, GstMessage *message, gpointer dat
             gst_message_parse_state_changed(message, &oldState, &newState, &pending);
             
             if (newState == GST_STATE_PLAYING && oldState != GST_STATE_PLAYING) {
+                if (engine->m_decodeStartTimer.isValid()) {
+                    engine->m_diagnostics->record(Mtoc::PlaybackDiagnostics::DecodeStart,
+                                                  engine->m_decodeStartTimer.elapsed(), engine->m_currentTrack);
+                    engine->m_decodeStartTimer.invalidate();
+                }
+                
+                // Audio is actually running from here, which can be a little after play()
+                emit engine->positionChanged(engine->position());
+                emit engine->playbackStarted();
+                
                 gint64 duration;
                 if (gst_element_query_duration(engine->m_pipeline, GST_FORMAT_TIME, &duration)) {
                     qint64 durationMs = duration / GST_MSECOND;
                     // Only update duration if we're not in a gapless transition
-                    if (!engine->m_hasQueuedTrack) {
+                    if (engine->m_queuedTracks.isEmpty()) {
                         engine->m_lastKnownDuration = durationMs;
                         emit engine->durationChanged(durationMs);
                     }
@@ -499,6 +589,11 @@ gboolean AudioEngine::busCallback(GstBus *bus, GstMessage *message, gpointer dat
     
     case GST_MESSAGE_ASYNC_DONE:
         // Async operation (like seek) completed
+        if (engine->m_seekTimer.isValid()) {
+            engine->m_diagnostics->record(Mtoc::PlaybackDiagnostics::SeekLatency,
+                                          engine->m_seekTimer.elapsed(), engine->m_currentTrack);
+            engine->m_seekTimer.invalidate();
+        }
         if (engine->m_seekPending) {
             engine->m_seekPending = false;
             // Query and emit the actual position after seek completes
@@ -513,14 +608,206 @@ gboolean AudioEngine::busCallback(GstBus *bus, GstMessage *message, gpointer dat
     return TRUE;
 }
 
-void AudioEngine::aboutToFinishCallback(GstElement *playbin, gpointer data)
+void AudioEngine::recordBusDiagnostics(GstMessage *message)
+{
+    const QString source = GST_MESSAGE_SRC(message) ? QString::fromUtf8(GST_OBJECT_NAME(GST_MESSAGE_SRC(message))) : QString();
+    
+    switch (GST_MESSAGE_TYPE(message)) {
+    case GST_MESSAGE_BUFFERING: {
+        // Only network sources buffer; files on a mounted share read straight through
+        gint percent = 100;
+        gst_message_parse_buffering(message, &percent);
+        m_diagnostics->recordBuffering(percent);
+        break;
+    }
+    
+    case GST_MESSAGE_QOS: {
+        // Sinks post these when data arrives late and they have to drop or
+        // resync, which is how an underrun shows up on the bus
+        gint64 jitter = 0;
+        gdouble proportion = 1.0;
+        gint quality = 0;
+        GstFormat format = GST_FORMAT_UNDEFINED;
+        guint64 processed = 0;
+        guint64 dropped = 0;
+        gst_message_parse_qos_values(message, &jitter, &proportion, &quality);
+        gst_message_parse_qos_stats(message, &format, &processed, &dropped);
+        // These come in bursts, so they go to the event log rather than the console
+        m_diagnostics->recordQos(source, jitter / GST_MSECOND, processed, dropped);
+        break;
+    }
+    
+    case GST_MESSAGE_WARNING: {
+        GError *error = nullptr;
+        gchar *debug = nullptr;
+        gst_message_parse_warning(message, &error, &debug);
+        qWarning() << "[AudioEngine::recordBusDiagnostics] Warning from" << source << ":" << error->message;
+        m_diagnostics->recordEvent("warning", source + ": " + QString::fromUtf8(error->message));
+        g_error_free(error);
+        g_free(debug);
+        break;
+    }
+    
+    case GST_MESSAGE_ERROR: {
+        GError *error = nullptr;
+        gst_message_parse_error(message, &error, nullptr);
+        m_diagnostics->recordEvent("error", source + ": " + QString::fromUtf8(error->message));
+        g_error_free(error);
+        break;
+    }
+    
+    case GST_MESSAGE_CLOCK_LOST:
+        m_diagnostics->recordEvent("clockLost", source);
+        break;
+    
+    default:
+        break;
+    }
+}
+
+namespace {
+
+// Carried from a source's creation to its first buffer
+struct SourceOpen {
+    AudioEngine *engine;
+    gint64 created;  // Monotonic, microseconds
+    QString filePath;
+};
+
+} // namespace
+
+void AudioEngine::sourceSetupCallback(GstElement *playbin, GstElement *source, gpointer data)
 {
     Q_UNUSED(playbin)
+    // Called on a streaming thread as the source is created, before it opens
+    // anything; its first buffer marks the file opened and the first read done
+    GstPad *pad = gst_element_get_static_pad(source, "src");
+    if (!pad) {
+        return;
+    }
+    
+    auto *open = new SourceOpen{ static_cast<AudioEngine*>(data), g_get_monotonic_time(), QString() };
+    if (GST_IS_URI_HANDLER(source)) {
+        gchar *uri = gst_uri_handler_get_uri(GST_URI_HANDLER(source));
+        open->filePath = QUrl(QString::fromUtf8(uri)).toLocalFile();
+        g_free(uri);
+    }
+    
+    gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, sourceFirstBufferProbe, open,
+                      [](gpointer open) { delete static_cast<SourceOpen*>(open); });
+    gst_object_unref(pad);
+}
+
+GstPadProbeReturn AudioEngine::sourceFirstBufferProbe(GstPad *pad, GstPadProbeInfo *info, gpointer data)
+{
+    Q_UNUSED(pad)
+    Q_UNUSED(info)
+    const SourceOpen *open = static_cast<const SourceOpen*>(data);
+    const qint64 msec = (g_get_monotonic_time() - open->created) / 1000;
+    AudioEngine *engine = open->engine;
+    const QString filePath = open->filePath;
+    QMetaObject::invokeMethod(engine, [engine, msec, filePath]() {
+        engine->m_diagnostics->record(Mtoc::PlaybackDiagnostics::FileOpen, msec, filePath);
+    }, Qt::QueuedConnection);
+    return GST_PAD_PROBE_REMOVE;
+}
+
+GstPadProbeReturn AudioEngine::replayGainTagProbe(GstPad *pad, GstPadProbeInfo *info, gpointer data)
+{
+    AudioEngine *engine = static_cast<AudioEngine*>(data);
+    GstEvent *event = GST_PAD_PROBE_INFO_EVENT(info);
+    
+    if (GST_EVENT_TYPE(event) == GST_EVENT_STREAM_START) {
+        // A gapless switch: the queued track's gain goes in before any of its
+        // buffers reach rgvolume. Only the pipeline the track was queued on matches.
+        GstElement *rgvolume = GST_ELEMENT(GST_PAD_PARENT(pad));
+        GstElement *expected = rgvolume;
+        if (engine->m_queuedGainTarget.compare_exchange_strong(expected, nullptr)) {
+            g_object_set(rgvolume, "fallback-gain", engine->m_queuedGain.load(), nullptr);
+        }
+        return GST_PAD_PROBE_OK;
+    }
+    
+    if (GST_EVENT_TYPE(event) != GST_EVENT_TAG || engine->m_replayGainEnabled.load(std::memory_order_relaxed)) {
+        return GST_PAD_PROBE_OK;
+    }
     
+    static const char *const replayGainTags[] = {
+        GST_TAG_TRACK_GAIN, GST_TAG_TRACK_PEAK, GST_TAG_ALBUM_GAIN, GST_TAG_ALBUM_PEAK, GST_TAG_REFERENCE_LEVEL
+    };
+    GstTagList *tags = nullptr;
+    gst_event_parse_tag(event, &tags);
+    bool hasReplayGain = false;
+    for (const char *tag : replayGainTags) {
+        hasReplayGain = hasReplayGain || gst_tag_list_get_tag_size(tags, tag) > 0;
+    }
+    if (!hasReplayGain) {
+        return GST_PAD_PROBE_OK;
+    }
+    
+    // With no tags and a zero fallback gain rgvolume passes audio through untouched
+    GstTagList *stripped = gst_tag_list_copy(tags);
+    for (const char *tag : replayGainTags) {
+        gst_tag_list_remove_tag(stripped, tag);
+    }
+    GST_PAD_PROBE_INFO_DATA(info) = gst_event_new_tag(stripped);
+    gst_event_unref(event);
+    return GST_PAD_PROBE_OK;
+}
+
+GstPadProbeReturn AudioEngine::equalizerProbe(GstPad *pad, GstPadProbeInfo *info, gpointer data)
+{
+    Q_UNUSED(pad)
+    Mtoc::ParametricEqualizer *equalizer = static_cast<Mtoc::ParametricEqualizer*>(data);
+    
+    if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM) {
+        GstEvent *event = GST_PAD_PROBE_INFO_EVENT(info);
+        if (GST_EVENT_TYPE(event) == GST_EVENT_CAPS) {
+            GstCaps *caps = nullptr;
+            gst_event_parse_caps(event, &caps);
+            int rate = 0;
+            int channels = 0;
+            const GstStructure *structure = gst_caps_get_structure(caps, 0);
+            gst_structure_get_int(structure, "rate", &rate);
+            gst_structure_get_int(structure, "channels", &channels);
+            equalizer->setFormat(rate, channels);
+        } else if (GST_EVENT_TYPE(event) == GST_EVENT_FLUSH_STOP) {
+            // After a seek; across a gapless switch the audio is continuous, so the state stays
+            equalizer->reset();
+        }
+        return GST_PAD_PROBE_OK;
+    }
+    
+    // Flat: the buffer goes through without being touched or copied
+    if (!equalizer->isActive()) {
+        return GST_PAD_PROBE_OK;
+    }
+    
+    GstBuffer *buffer = gst_buffer_make_writable(GST_PAD_PROBE_INFO_BUFFER(info));
+    GST_PAD_PROBE_INFO_DATA(info) = buffer;
+    GstMapInfo map;
+    if (gst_buffer_map(buffer, &map, GST_MAP_READWRITE)) {
+        const int frames = int(map.size / (sizeof(float) * equalizer->channels()));
+        equalizer->process(reinterpret_cast<float*>(map.data), frames);
+        gst_buffer_unmap(buffer, &map);
+    }
+    return GST_PAD_PROBE_OK;
+}
+
+void AudioEngine::aboutToFinishCallback(GstElement *playbin, gpointer data)
+{
+    // Runs on a streaming thread, while activateStandby() swaps m_playbin on
+    // the main thread, so the pipeline is only compared once back there. A
+    // request from a pipeline swapped out in the meantime is stale anyway.
     AudioEngine *engine = static_cast<AudioEngine*>(data);
-    emit engine->aboutToFinish();
-    // Request the next track from the MediaPlayer
-    emit engine->requestNextTrack();
+    QMetaObject::invokeMethod(engine, [engine, playbin]() {
+        if (playbin != engine->m_playbin) {
+            return;  // The standby pipeline never plays through
+        }
+        emit engine->aboutToFinish();
+        // Request the next track from the MediaPlayer
+        emit engine->requestNextTrack();
+    }, Qt::QueuedConnection);
 }
 
 void AudioEngine::setReplayGainEnabled(bool enabled)
@@ -535,22 +822,43 @@ void AudioEngine::setReplayGainEnabled(bool enabled)
         return;
     }
     
+    m_replayGainEnabled = enabled;
+    applyFallbackGain(m_rgvolume, m_currentTrack);
+    applyFallbackGain(m_standby.rgvolume, m_standby.track);
+    updateQueuedGain();
+    updateAudioFilter();
+}
+
+void AudioEngine::updateAudioFilter()
+{
+    // Like any audio-filter change, taking the bin in or out applies from the next track
+    const bool enabled = m_replayGainEnabled || m_equalizerEnabled;
+    if (m_playbin && m_audioFilterBin) {
+        applyAudioFilter(m_playbin, m_audioFilterBin, enabled);
+    }
+    if (m_standby.playbin && m_standby.audioFilterBin) {
+        applyAudioFilter(m_standby.playbin, m_standby.audioFilterBin, enabled);
+    }
+}
+
+void AudioEngine::applyAudioFilter(GstElement *playbin, GstElement *audioFilterBin, bool enabled)
+{
     if (enabled) {
         // Add reference before setting to prevent it from being freed
-        gst_object_ref(m_audioFilterBin);
+        gst_object_ref(audioFilterBin);
         // Re-add audio filter bin to enable replay gain
-        g_object_set(m_playbin, "audio-filter", m_audioFilterBin, nullptr);
+        g_object_set(playbin, "audio-filter", audioFilterBin, nullptr);
     } else {
         // Remove audio filter to disable replay gain
         // First check if it's currently set
         GstElement* currentFilter = nullptr;
-        g_object_get(m_playbin, "audio-filter", &currentFilter, nullptr);
+        g_object_get(playbin, "audio-filter", &currentFilter, nullptr);
         if (currentFilter) {
             // Add reference to keep it alive after removal
-            if (currentFilter == m_audioFilterBin) {
-                gst_object_ref(m_audioFilterBin);
+            if (currentFilter == audioFilterBin) {
+                gst_object_ref(audioFilterBin);
             }
-            g_object_set(m_playbin, "audio-filter", nullptr, nullptr);
+            g_object_set(playbin, "audio-filter", nullptr, nullptr);
             gst_object_unref(currentFilter);
         }
     }
@@ -563,7 +871,14 @@ void AudioEngine::setReplayGainMode(bool albumMode)
         return;
     }
     
+    m_replayGainAlbumMode = albumMode;
     g_object_set(m_rgvolume, "album-mode", albumMode ? TRUE : FALSE, nullptr);
+    applyFallbackGain(m_rgvolume, m_currentTrack);
+    updateQueuedGain();
+    if (m_standby.rgvolume) {
+        g_object_set(m_standby.rgvolume, "album-mode", albumMode ? TRUE : FALSE, nullptr);
+        applyFallbackGain(m_standby.rgvolume, m_standby.track);
+    }
 }
 
 void AudioEngine::setReplayGainPreAmp(double preAmp)
@@ -575,7 +890,14 @@ void AudioEngine::setReplayGainPreAmp(double preAmp)
     
     // Clamp pre-amp to reasonable range (-15 to +15 dB)
     preAmp = qBound(-15.0, preAmp, 15.0);
+    m_replayGainPreAmp = preAmp;
     g_object_set(m_rgvolume, "pre-amp", preAmp, nullptr);
+    applyFallbackGain(m_rgvolume, m_currentTrack);
+    updateQueuedGain();
+    if (m_standby.rgvolume) {
+        g_object_set(m_standby.rgvolume, "pre-amp", preAmp, nullptr);
+        applyFallbackGain(m_standby.rgvolume, m_standby.track);
+    }
 }
 
 void AudioEngine::setReplayGainFallbackGain(double fallbackGain)
@@ -586,8 +908,105 @@ void AudioEngine::setReplayGainFallbackGain(double fallbackGain)
     }
     
     // Clamp fallback gain to reasonable range (-15 to +15 dB)
-    fallbackGain = qBound(-15.0, fallbackGain, 15.0);
-    g_object_set(m_rgvolume, "fallback-gain", fallbackGain, nullptr);
+    m_replayGainFallbackGain = qBound(-15.0, fallbackGain, 15.0);
+    applyFallbackGain(m_rgvolume, m_currentTrack);
+    applyFallbackGain(m_standby.rgvolume, m_standby.track);
+    updateQueuedGain();
+}
+
+void AudioEngine::setAnalysedGain(const QString &filePath, double trackGain, double albumGain)
+{
+    if (filePath.isEmpty()) {
+        return;
+    }
+    
+    // Only the loaded, queued and standby tracks can still need theirs
+    const int maxAnalysedGains = 32;
+    if (m_analysedGains.size() >= maxAnalysedGains) {
+        for (auto it = m_analysedGains.begin(); it != m_analysedGains.end();) {
+            if (it.key() == m_currentTrack || m_queuedTracks.contains(it.key()) || it.key() == m_standby.track) {
+                ++it;
+            } else {
+                it = m_analysedGains.erase(it);
+            }
+        }
+    }
+    m_analysedGains.insert(filePath, {trackGain, albumGain});
+    
+    if (filePath == m_currentTrack) {
+        applyFallbackGain(m_rgvolume, filePath);
+    }
+    if (filePath == m_standby.track) {
+        applyFallbackGain(m_standby.rgvolume, filePath);
+    }
+    if (filePath == m_queuedTracks.value(0)) {
+        updateQueuedGain();
+    }
+}
+
+double AudioEngine::fallbackGainFor(const QString &filePath) const
+{
+    double gain = m_replayGainFallbackGain;
+    auto it = m_analysedGains.constFind(filePath);
+    if (!m_replayGainEnabled) {
+        // The bin is only in for the equalizer
+        gain = 0.0;
+    } else if (it != m_analysedGains.constEnd()) {
+        gain = (m_replayGainAlbumMode ? it->album : it->track) + m_replayGainPreAmp;
+    }
+    // The range rgvolume accepts
+    return qBound(-60.0, gain, 60.0);
+}
+
+void AudioEngine::applyFallbackGain(GstElement *rgvolume, const QString &filePath)
+{
+    if (!rgvolume) {
+        return;
+    }
+    g_object_set(rgvolume, "fallback-gain", fallbackGainFor(filePath), nullptr);
+}
+
+void AudioEngine::updateQueuedGain()
+{
+    if (m_queuedTracks.isEmpty() || !m_rgvolume) {
+        m_queuedGainTarget.store(nullptr);
+        return;
+    }
+    // Only the next stream start is armed; handleStreamStart() re-arms for the
+    // one after. The gain is stored before the target that arms the probe.
+    m_queuedGain.store(fallbackGainFor(m_queuedTracks.first()));
+    m_queuedGainTarget.store(m_rgvolume);
+}
+
+void AudioEngine::setEqualizerEnabled(bool enabled)
+{
+    if (m_equalizerEnabled == enabled) {
+        return;
+    }
+    m_equalizerEnabled = enabled;
+    applyEqualizerBands();
+    updateAudioFilter();
+}
+
+void AudioEngine::setEqualizerGains(const QVector<double> &gains)
+{
+    m_equalizerGains = gains;
+    if (m_equalizerEnabled) {
+        applyEqualizerBands();
+    }
+}
+
+void AudioEngine::applyEqualizerBands()
+{
+    // Disabling ramps every band to flat, after which the equalizer is bypassed
+    const QVector<Mtoc::ParametricEqualizer::Band> bands =
+        Mtoc::ParametricEqualizer::graphicBands(m_equalizerEnabled ? m_equalizerGains : QVector<double>());
+    if (m_equalizer) {
+        m_equalizer->setBands(bands);
+    }
+    if (m_standby.equalizer) {
+        m_standby.equalizer->setBands(bands);
+    }
 }
 
 bool AudioEngine::isAACFile(const QString &filePath) const
@@ -603,16 +1022,11 @@ void AudioEngine::queueNextTrack(const QString &filePath)
 {
     /* Gapless Playback Implementation:
      * 
-     * This method queues the next track for seamless playback and starts proactive
-     * monitoring to detect the exact moment of transition. The system works by:
-     * 
-     * 1. Setting the new URI on playbin3 (which preloads metadata)
-     * 2. Starting a monitoring timer that checks position/duration every 100ms
-     * 3. Detecting transition when position resets from high to low value
-     * 4. Delaying duration update by 150ms to prevent progress bar jumps
-     * 
-     * This approach ensures track info updates are synchronized with actual audio
-     * playback, preventing premature UI updates that were causing visual glitches.
+     * Setting the next URI on playbin3 during about-to-finish makes it preroll
+     * that track and play it straight after the current one. When its first
+     * data reaches the sinks the pipeline posts GST_MESSAGE_STREAM_START, which
+     * busCallback turns into trackTransitioned, so track info updates with the
+     * audio itself and nothing polls while waiting for the switch.
      * 
      * NOTE: Gapless playback is disabled for AAC/M4A files which do not work properly. 
      * Instead, they will load normally when EOS is received.
@@ -644,143 +1058,169 @@ void AudioEngine::queueNextTrack(const QString &filePath)
     QUrl url = QUrl::fromLocalFile(filePath);
     qDebug() << "[AudioEngine::queueNextTrack] Queuing next track for gapless playback:" << QFileInfo(filePath).fileName();
     
-    // Mark that we have a queued track for gapless transition detection
-    m_hasQueuedTrack = true;
-    m_trackTransitionDetected = false;
+    // This track's STREAM_START follows those of any tracks still queued
+    // ahead of it, which happens when they are shorter than the read-ahead
+    m_queuedTracks.append(filePath);
+    updateQueuedGain();
     
-    // Store current duration and position before transition
-    gint64 duration;
-    if (gst_element_query_duration(m_pipeline, GST_FORMAT_TIME, &duration)) {
-        m_lastKnownDuration = duration / GST_MSECOND;
-        qDebug() << "[AudioEngine::queueNextTrack] Current track duration:" << m_lastKnownDuration << "ms";
+    // Set the next URI for gapless playback
+    g_object_set(m_playbin, "uri", url.toString().toUtf8().constData(), nullptr);
+}
+
+void AudioEngine::setStandbyEnabled(bool enabled)
+{
+    if (m_standbyEnabled == enabled) {
+        return;
+    }
+    m_standbyEnabled = enabled;
+    if (!enabled) {
+        destroyStandby();
+    }
+}
+
+bool AudioEngine::hasStandby(const QString &filePath) const
+{
+    return m_standbyEnabled && m_standby.playbin && !filePath.isEmpty() && m_standby.track == filePath;
+}
+
+void AudioEngine::prepareStandby(const QString &filePath)
+{
+    if (!m_standbyEnabled || !m_playbin) {
+        return;
+    }
+    if (filePath.isEmpty()) {
+        clearStandby();
+        return;
+    }
+    if (filePath == m_standby.track) {
+        return;
     }
     
-    // Get current position to know when we're near the end
-    qint64 currentPos = position();
-    qint64 timeRemaining = m_lastKnownDuration - currentPos;
-    qDebug() << "[AudioEngine::queueNextTrack] Time remaining in current track:" << timeRemaining << "ms";
-    
-    // Start proactive monitoring for transition
-    // We'll check both duration changes and position resets
-    if (!m_transitionTimer) {
-        m_transitionTimer = new QTimer(this);
-        m_transitionTimer->setInterval(100); // Check every 100ms
+    if (!m_standby.playbin) {
+        m_standby.equalizer = std::make_unique<Mtoc::ParametricEqualizer>();
+        m_standby.playbin = createPlaybin(&m_standby.rgvolume, &m_standby.audioFilterBin, m_standby.equalizer.get());
+        if (!m_standby.playbin) {
+            m_standby.equalizer.reset();
+            return;
+        }
+        applyEqualizerBands();
+        g_signal_connect(m_standby.playbin, "about-to-finish", G_CALLBACK(aboutToFinishCallback), this);
+        m_standby.bus = gst_element_get_bus(m_standby.playbin);
+        m_standby.busWatchId = gst_bus_add_watch(m_standby.bus, busCallback, this);
     }
     
-    // Reset monitoring state for new track
-    m_transitionCheckCount = 0;
-    m_transitionLastPos = 0;
-    m_transitionPeakPos = 0;
-    m_transitionDurationChangedFlag = false;
+    // Match the active pipeline's output settings
+    g_object_set(m_standby.playbin, "volume", static_cast<double>(m_volume), nullptr);
+    if (m_rgvolume && m_standby.rgvolume) {
+        gboolean albumMode = FALSE;
+        gdouble preAmp = 0.0;
+        gdouble fallbackGain = 0.0;
+        g_object_get(m_rgvolume,
+            "album-mode", &albumMode,
+            "pre-amp", &preAmp,
+            "fallback-gain", &fallbackGain,
+            nullptr);
+        g_object_set(m_standby.rgvolume,
+            "album-mode", albumMode,
+            "pre-amp", preAmp,
+            "fallback-gain", fallbackGain,
+            nullptr);
+    }
+    if (m_standby.audioFilterBin) {
+        applyAudioFilter(m_standby.playbin, m_standby.audioFilterBin, m_replayGainEnabled || m_equalizerEnabled);
+    }
+    applyFallbackGain(m_standby.rgvolume, filePath);
     
-    // Disconnect any existing connections
-    QObject::disconnect(m_transitionTimer, nullptr, nullptr, nullptr);
+    // The URI can only change below PAUSED
+    gst_element_set_state(m_standby.playbin, GST_STATE_READY);
+    QUrl url = QUrl::fromLocalFile(filePath);
+    g_object_set(m_standby.playbin, "uri", url.toString().toUtf8().constData(), nullptr);
     
-    // Set up new monitoring
-    QObject::connect(m_transitionTimer, &QTimer::timeout, this, [this]() {
-        m_transitionCheckCount++;
-        
-        qint64 currentPos = this->position();
-        qint64 currentDuration = this->duration();
-        
-        // Track peak position
-        if (currentPos > m_transitionPeakPos) {
-            m_transitionPeakPos = currentPos;
-        }
-        
-        // Check for duration change
-        if (!m_transitionDurationChangedFlag && m_lastKnownDuration > 0 && 
-            abs(currentDuration - m_lastKnownDuration) > 1000) {
-            qDebug() << "[AudioEngine] Duration changed from" << m_lastKnownDuration 
-                     << "to" << currentDuration << "- new track metadata loaded";
-            m_transitionDurationChangedFlag = true;
-            m_lastKnownDuration = currentDuration;
-        }
-        
-        // Check for position reset (the actual transition)
-        bool transitionDetected = false;
-        
-        // Method 1: Position drops significantly from peak
-        if (m_transitionPeakPos > 100000 && currentPos < 5000) {
-            qDebug() << "[AudioEngine] Transition detected: position reset from" << m_transitionPeakPos << "to" << currentPos;
-            transitionDetected = true;
-        }
-        // Method 2: Position was near end and suddenly resets
-        else if (m_transitionLastPos > m_lastKnownDuration - 5000 && currentPos < 5000) {
-            qDebug() << "[AudioEngine] Transition detected: position reset from near-end to" << currentPos;
-            transitionDetected = true;
-        }
-        // Method 3: Duration changed AND position is low (for quick skips)
-        else if (m_transitionDurationChangedFlag && currentPos < 5000 && m_transitionCheckCount > 5) {
-            qDebug() << "[AudioEngine] Transition detected: duration changed and position is low";
-            transitionDetected = true;
-        }
-        
-        // Log periodically
-        // if (m_transitionCheckCount % 10 == 0) {
-        //     qDebug() << "[AudioEngine] Transition check #" << m_transitionCheckCount 
-        //              << "- pos:" << currentPos << "duration:" << currentDuration 
-        //              << "peak:" << m_transitionPeakPos;
-        // }
-        
-        if (transitionDetected) {
-            m_transitionTimer->stop();
-            m_transitionFallbackTimer->stop();
-            m_trackTransitionDetected = true;
-            
-            // Reset monitoring variables
-            m_transitionCheckCount = 0;
-            m_transitionLastPos = 0;
-            m_transitionPeakPos = 0;
-            m_transitionDurationChangedFlag = false;
-            
-            // Store the new duration for delayed emission
-            qint64 newDuration = currentDuration;
-            
-            // Update state
-            m_hasQueuedTrack = false;
-            m_trackTransitionDetected = false;
-            
-            // Emit track transition immediately for UI updates (title, artist, etc)
-            emit this->trackTransitioned();
-            
-            // Delay duration change slightly to ensure position has stabilized
-            // This prevents the progress bar from jumping
-            // Use QPointer to guard against object destruction
-            QPointer<AudioEngine> safeThis(this);
-            QTimer::singleShot(150, this, [safeThis, newDuration]() {
-                if (!safeThis) {
-                    return; // Object was destroyed, don't access it
-                }
-                // Emit a position update first to ensure UI is synchronized
-                emit safeThis->positionChanged(safeThis->position());
-                // Then update the duration
-                emit safeThis->durationChanged(newDuration);
-            });
-        }
-        // Timeout after 10 seconds
-        else if (m_transitionCheckCount > 100) {
-            qDebug() << "[AudioEngine] Transition monitoring timeout";
-            m_transitionTimer->stop();
-            
-            // Reset monitoring variables
-            m_transitionCheckCount = 0;
-            m_transitionLastPos = 0;
-            m_transitionPeakPos = 0;
-            m_transitionDurationChangedFlag = false;
-        }
-        
-        m_transitionLastPos = currentPos;
-    });
+    m_standby.track = filePath;
+    m_standby.prerolled = false;
+    if (gst_element_set_state(m_standby.playbin, GST_STATE_PAUSED) == GST_STATE_CHANGE_FAILURE) {
+        qWarning() << "[AudioEngine::prepareStandby] Failed to preroll" << QFileInfo(filePath).fileName();
+        clearStandby();
+        return;
+    }
+    qDebug() << "[AudioEngine::prepareStandby] Prerolling" << QFileInfo(filePath).fileName();
+}
+
+void AudioEngine::clearStandby()
+{
+    if (!m_standby.playbin) {
+        return;
+    }
+    // Keep the elements for the next preroll, but let go of the file and the audio device
+    gst_element_set_state(m_standby.playbin, GST_STATE_NULL);
+    m_standby.track.clear();
+    m_standby.prerolled = false;
+}
+
+void AudioEngine::activateStandby()
+{
+    qDebug() << "[AudioEngine::activateStandby] Swapping in standby pipeline for"
+             << QFileInfo(m_standby.track).fileName()
+             << (m_standby.prerolled ? "(prerolled)" : "(still prerolling)");
+    
+    // The outgoing pipeline becomes the idle standby
+    gst_element_set_state(m_pipeline, GST_STATE_NULL);
+    
+    std::swap(m_playbin, m_standby.playbin);
+    std::swap(m_rgvolume, m_standby.rgvolume);
+    std::swap(m_audioFilterBin, m_standby.audioFilterBin);
+    std::swap(m_equalizer, m_standby.equalizer);
+    std::swap(m_bus, m_standby.bus);
+    std::swap(m_busWatchId, m_standby.busWatchId);
+    m_pipeline = m_playbin;
     
-    m_transitionTimer->start();
+    m_standby.track.clear();
+    m_standby.prerolled = false;
+}
+
+void AudioEngine::destroyStandby()
+{
+    if (!m_standby.playbin) {
+        return;
+    }
     
-    // Keep fallback timer as last resort (but extend timeout)
-    m_transitionFallbackTimer->setInterval(5000); // 5 seconds
-    m_transitionFallbackTimer->start();
+    gst_element_set_state(m_standby.playbin, GST_STATE_NULL);
+    if (m_standby.busWatchId) {
+        g_source_remove(m_standby.busWatchId);
+    }
+    if (m_standby.bus) {
+        gst_object_unref(m_standby.bus);
+    }
+    if (m_standby.audioFilterBin) {
+        gst_object_unref(m_standby.audioFilterBin);
+    }
+    gst_object_unref(m_standby.playbin);
+    m_standby = Standby();
+}
+
+void AudioEngine::handleStandbyMessage(GstMessage *message)
+{
+    switch (GST_MESSAGE_TYPE(message)) {
+    case GST_MESSAGE_ASYNC_DONE:
+        if (!m_standby.track.isEmpty() && !m_standby.prerolled) {
+            m_standby.prerolled = true;
+            qDebug() << "[AudioEngine::handleStandbyMessage] Standby prerolled" << QFileInfo(m_standby.track).fileName();
+        }
+        break;
     
-    qDebug() << "[AudioEngine::queueNextTrack] Started proactive transition monitoring";
+    case GST_MESSAGE_ERROR: {
+        // A standby that fails to preroll is dropped; the skip then loads normally
+        GError *error;
+        gchar *debug;
+        gst_message_parse_error(message, &error, &debug);
+        qWarning() << "[AudioEngine::handleStandbyMessage] Standby pipeline error:" << error->message;
+        g_error_free(error);
+        g_free(debug);
+        clearStandby();
+        break;
+    }
     
-    // Set the next URI for gapless playback
-    g_object_set(m_playbin, "uri", url.toString().toUtf8().constData(), nullptr);
-}
\ No newline at end of file
+    default:
+        break;
+    }
+}
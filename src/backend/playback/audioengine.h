@@ -3,10 +3,20 @@
 
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <QTimer>
+#include <QHash>
+#include <QVector>
+#include <QElapsedTimer>
 #include <gst/gst.h>
+#include <atomic>
 #include <memory>
 
+namespace Mtoc {
+class ParametricEqualizer;
+class PlaybackDiagnostics;
+}
+
 class AudioEngine : public QObject
 {
     Q_OBJECT
@@ -32,6 +42,10 @@ public:
     
     qint64 position() const;
     qint64 duration() const;
+    
+    // positionChanged is always emitted on seeks, stops and track changes; this
+    // adds a periodic reading while playing. 0 (the default) turns it off.
+    void setPositionPollInterval(int msec);
     float volume() const;
     void setVolume(float volume);
     
@@ -43,9 +57,34 @@ public:
     void setReplayGainMode(bool albumMode);
     void setReplayGainPreAmp(double preAmp);
     void setReplayGainFallbackGain(double fallbackGain);
+    // Gain measured for a file without ReplayGain tags. While it plays it is
+    // used (plus pre-amp) instead of the fallback gain; tags still win.
+    void setAnalysedGain(const QString &filePath, double trackGain, double albumGain);
+    
+    // Ten-band equalizer (31 Hz to 16 kHz, dB). It runs in the same filter bin
+    // as replay gain and is skipped entirely while every band is flat.
+    void setEqualizerEnabled(bool enabled);
+    void setEqualizerGains(const QVector<double> &gains);
     
     // Gapless playback support
     void queueNextTrack(const QString &filePath);
+    
+    // Warm standby: a second pipeline held PAUSED on the likely next track, so
+    // a manual skip to it swaps pipelines instead of loading from scratch.
+    // loadTrack() uses it whenever the path matches, otherwise it is ignored.
+    void setStandbyEnabled(bool enabled);
+    void prepareStandby(const QString &filePath);  // Empty path clears it
+    void clearStandby();
+    bool hasStandby(const QString &filePath) const;
+    
+    // Timings and bus reports from both pipelines
+    Mtoc::PlaybackDiagnostics* diagnostics() const { return m_diagnostics; }
+    
+    // Makes the audio sink for each pipeline created from then on. Unset,
+    // playbin picks the system default; tests and benchmarks render into a
+    // fakesink instead.
+    using AudioSinkFactory = GstElement *(*)();
+    static void setAudioSinkFactory(AudioSinkFactory factory) { s_audioSinkFactory = factory; }
 
 signals:
     void stateChanged(AudioEngine::State state);
@@ -56,21 +95,41 @@ signals:
     void aboutToFinish();
     void requestNextTrack();
     void trackTransitioned();  // Emitted when gapless transition actually occurs
+    void playbackStarted();    // The pipeline reached PLAYING and audio is running
 
 private:
     void initializePipeline();
     void cleanupPipeline();
     void setState(State state);
     void updatePosition();
+    void updateDuration();
+    void handleStreamStart();
     bool isAACFile(const QString &filePath) const;
     
+    GstElement *createPlaybin(GstElement **rgvolume, GstElement **audioFilterBin, Mtoc::ParametricEqualizer *equalizer);
+    static void applyAudioFilter(GstElement *playbin, GstElement *audioFilterBin, bool enabled);
+    void updateAudioFilter();
+    void applyEqualizerBands();
+    double fallbackGainFor(const QString &filePath) const;
+    void applyFallbackGain(GstElement *rgvolume, const QString &filePath);
+    void updateQueuedGain();
+    void activateStandby();
+    void destroyStandby();
+    void handleStandbyMessage(GstMessage *message);
+    void recordBusDiagnostics(GstMessage *message);
+    
     static gboolean busCallback(GstBus *bus, GstMessage *message, gpointer data);
     static void aboutToFinishCallback(GstElement *playbin, gpointer data);
+    static void sourceSetupCallback(GstElement *playbin, GstElement *source, gpointer data);
+    static GstPadProbeReturn sourceFirstBufferProbe(GstPad *pad, GstPadProbeInfo *info, gpointer data);
+    static GstPadProbeReturn replayGainTagProbe(GstPad *pad, GstPadProbeInfo *info, gpointer data);
+    static GstPadProbeReturn equalizerProbe(GstPad *pad, GstPadProbeInfo *info, gpointer data);
     
     GstElement *m_pipeline = nullptr;
     GstElement *m_playbin = nullptr;
     GstElement *m_rgvolume = nullptr;
     GstElement *m_audioFilterBin = nullptr;
+    std::unique_ptr<Mtoc::ParametricEqualizer> m_equalizer;
     GstBus *m_bus = nullptr;
     guint m_busWatchId = 0;
     
@@ -78,26 +137,61 @@ private:
     QString m_currentTrack;
     float m_volume = 1.0f;
     
+    // rgvolume only adds pre-amp to tagged gain, so it is kept here to add to
+    // analysed gain, which goes in through fallback-gain
+    struct AnalysedGain {
+        double track = 0.0;
+        double album = 0.0;
+    };
+    QHash<QString, AnalysedGain> m_analysedGains;
+    // The filter bin also stays in for the equalizer, so with replay gain off
+    // its tags are stripped before rgvolume sees them (streaming thread reads this)
+    std::atomic<bool> m_replayGainEnabled{false};
+    bool m_replayGainAlbumMode = false;
+    double m_replayGainPreAmp = 0.0;
+    double m_replayGainFallbackGain = 0.0;
+    
+    bool m_equalizerEnabled = false;
+    QVector<double> m_equalizerGains;
+    
     QTimer *m_positionTimer = nullptr;
+    int m_positionPollInterval = 0;
     
     // Seek tracking
     bool m_seekPending = false;
     qint64 m_seekTarget = 0;
     
-    // Gapless playback tracking
-    bool m_hasQueuedTrack = false;
-    bool m_trackTransitionDetected = false;
-    QTimer *m_transitionTimer = nullptr;
-    QTimer *m_transitionFallbackTimer = nullptr;
+    Mtoc::PlaybackDiagnostics *m_diagnostics = nullptr;
+    QElapsedTimer m_decodeStartTimer;  // play() on a loaded track until PLAYING
+    QElapsedTimer m_seekTimer;
+    
+    // Gapless playback tracking. The switch to the queued track is reported by
+    // the STREAM_START bus message once the sinks have started on it.
+    // Tracks handed to playbin that have not started yet, in play order
+    QStringList m_queuedTracks;
+    // The queued track's fallback gain, set on this rgvolume by its sink probe
+    // when the track's STREAM_START reaches it, ahead of the first buffer
+    std::atomic<double> m_queuedGain{0.0};
+    std::atomic<GstElement*> m_queuedGainTarget{nullptr};
     qint64 m_lastKnownDuration = 0;
     
-    // Transition monitoring state (moved from static variables in lambda)
-    int m_transitionCheckCount = 0;
-    qint64 m_transitionLastPos = 0;
-    qint64 m_transitionPeakPos = 0;
-    bool m_transitionDurationChangedFlag = false;
+    // The standby pipeline. After a swap the previous pipeline takes its place
+    // and is reused for the next preroll.
+    struct Standby {
+        GstElement *playbin = nullptr;
+        GstElement *rgvolume = nullptr;
+        GstElement *audioFilterBin = nullptr;
+        std::unique_ptr<Mtoc::ParametricEqualizer> equalizer;
+        GstBus *bus = nullptr;
+        guint busWatchId = 0;
+        QString track;
+        bool prerolled = false;
+    };
+    Standby m_standby;
+    bool m_standbyEnabled = false;
     
     static bool s_gstInitialized;
+    static AudioSinkFactory s_audioSinkFactory;
 };
 
 #endif // AUDIOENGINE_H
\ No newline at end of file
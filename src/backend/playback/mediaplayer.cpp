@@ -34,9 +34,62 @@ QString MediaPlayer::getDebugLogPath()
 MediaPlayer::MediaPlayer(QObject *parent)
     : QObject(parent)
     , m_audioEngine(std::make_unique<AudioEngine>(this))
+    , m_queueModel(new Mtoc::QueueListModel(this))
+    , m_clock(new Mtoc::PlaybackClock(this))
     , m_saveStateTimer(new QTimer(this))
+    , m_stateJournal(std::make_unique<Mtoc::PlaybackStateJournal>())
+    , m_prefetcher(new Mtoc::TrackPrefetcher(this))
+    , m_prefetchTimer(new QTimer(this))
 {
     setupConnections();
+
+    // Keep the model's current row in step with m_currentQueueIndex
+    connect(this, &MediaPlayer::playbackQueueChanged, this, [this]() {
+        m_queueModel->setCurrentIndex(m_currentQueueIndex);
+    });
+    
+    // Mirror every queue change into the state journal as it happens
+    auto journalEntries = [this](int first, int last) {
+        QList<Mtoc::PlaybackStateJournal::Entry> entries;
+        entries.reserve(last - first + 1);
+        for (int i = first; i <= last; ++i) {
+            const Mtoc::QueueEntry& entry = m_queueModel->at(i);
+            entries.append({entry.id, entry.filePath});
+        }
+        return entries;
+    };
+    connect(m_queueModel, &QAbstractItemModel::rowsInserted, this,
+            [this, journalEntries](const QModelIndex&, int first, int last) {
+        m_stateJournal->insertEntries(first, journalEntries(first, last));
+    });
+    connect(m_queueModel, &QAbstractItemModel::rowsRemoved, this,
+            [this](const QModelIndex&, int first, int last) {
+        m_stateJournal->removeEntries(first, last - first + 1);
+    });
+    connect(m_queueModel, &QAbstractItemModel::rowsMoved, this,
+            [this](const QModelIndex&, int start, int, const QModelIndex&, int row) {
+        // The model only moves single rows; row is the pre-move insertion point
+        m_stateJournal->moveEntry(start, row > start ? row - 1 : row);
+    });
+    connect(m_queueModel, &QAbstractItemModel::modelReset, this, [this, journalEntries]() {
+        m_stateJournal->resetEntries(journalEntries(0, m_queueModel->size() - 1));
+    });
+    
+    // Read ahead the next tracks once the queue and current track settle
+    m_prefetchTimer->setSingleShot(true);
+    m_prefetchTimer->setInterval(500);
+    connect(m_prefetchTimer, &QTimer::timeout, this, &MediaPlayer::updatePrefetch);
+    auto schedulePrefetch = [this]() { m_prefetchTimer->start(); };
+    connect(this, &MediaPlayer::currentTrackChanged, this, schedulePrefetch);
+    connect(this, &MediaPlayer::playbackQueueChanged, this, schedulePrefetch);
+    connect(this, &MediaPlayer::shuffleEnabledChanged, this, schedulePrefetch);
+    connect(this, &MediaPlayer::repeatEnabledChanged, this, schedulePrefetch);
+    connect(m_queueModel, &QAbstractItemModel::rowsInserted, this, schedulePrefetch);
+    connect(m_queueModel, &QAbstractItemModel::rowsRemoved, this, schedulePrefetch);
+    connect(m_queueModel, &QAbstractItemModel::rowsMoved, this, schedulePrefetch);
+    connect(m_queueModel, &QAbstractItemModel::modelReset, this, schedulePrefetch);
+    connect(m_prefetcher, &Mtoc::TrackPrefetcher::latencyStatsChanged,
+            this, &MediaPlayer::skipLatencyChanged);
     
     // Set up periodic state saving every 10 seconds while playing
     m_saveStateTimer->setInterval(10000); // 10 seconds
@@ -56,6 +109,9 @@ MediaPlayer::~MediaPlayer()
 {
     qDebug() << "[MediaPlayer::~MediaPlayer] Destructor called, cleaning up...";
     
+    // Clearing the queue below must not reach the saved state
+    disconnect(m_queueModel, nullptr, this, nullptr);
+    
     // Stop the save state timer
     if (m_saveStateTimer) {
         m_saveStateTimer->stop();
@@ -102,9 +158,12 @@ void MediaPlayer::setLibraryManager(Mtoc::LibraryManager* manager)
     if (m_libraryManager) {
         connect(m_libraryManager, &Mtoc::LibraryManager::trackLyricsUpdated,
                 this, [this](const QString& filePath, const QString& lyrics) {
-            Q_UNUSED(lyrics)
             // Check if the updated track is the currently playing track
             if (m_currentTrack && m_currentTrack->filePath() == filePath) {
+                // Tracks materialized from the queue hold their own copy of the lyrics
+                if (m_currentTrack->parent() == this) {
+                    m_currentTrack->setLyrics(lyrics);
+                }
                 qDebug() << "MediaPlayer: Lyrics updated for current track, emitting currentTrackLyricsChanged";
                 emit currentTrackLyricsChanged();
             }
@@ -123,6 +182,17 @@ void MediaPlayer::setLibraryManager(Mtoc::LibraryManager* manager)
             });
         }
 
+        // Measured gain for the playing track applies straight away
+        if (m_libraryManager->loudnessAnalyzer()) {
+            connect(m_libraryManager->loudnessAnalyzer(), &Mtoc::LoudnessAnalyzer::tracksAnalysed,
+                    this, [this](const QStringList &filePaths) {
+                const QString playing = m_audioEngine->currentTrack();
+                if (filePaths.contains(playing)) {
+                    loadAnalysedGain(playing);
+                }
+            });
+        }
+
         // Listen for library invalidation signal (before VirtualPlaylist is cleared)
         // This prevents crashes when library updates while playing from VirtualPlaylist
         connect(m_libraryManager, &Mtoc::LibraryManager::aboutToInvalidateLibrary,
@@ -145,6 +215,64 @@ void MediaPlayer::setLibraryManager(Mtoc::LibraryManager* manager)
                 qDebug() << "MediaPlayer: Virtual playlist safely cleared before library update";
             }
         });
+
+        // Incremental updates shift rows in the all-songs playlist; follow the
+        // playing track to its new row instead of tearing playback down
+        connect(m_libraryManager, &Mtoc::LibraryManager::libraryUpdated,
+                this, [this](const QVariantMap &changes) {
+            if (!m_isVirtualPlaylist || !m_virtualPlaylist) {
+                return;
+            }
+            QVariantList added = changes.value("addedTracks").toList();
+            QVariantList removed = changes.value("removedTracks").toList();
+            if (added.isEmpty() && removed.isEmpty()) {
+                return;
+            }
+
+            int currentId = m_currentTrack ? m_currentTrack->id() : -1;
+            if (currentId > 0 && removed.contains(currentId)) {
+                qDebug() << "MediaPlayer: Current track was removed from the library, clearing virtual playlist";
+                stop();
+                clearQueue();
+                clearVirtualPlaylist();
+                return;
+            }
+            if (m_virtualPlaylist->isFavoritesOnly() || currentId <= 0) {
+                return;
+            }
+
+            int newRow = m_virtualPlaylist->rowOfTrack(currentId);
+            if (newRow < 0) {
+                return;
+            }
+            m_virtualCurrentIndex = newRow;
+            m_currentTrack->setProperty("virtualIndex", newRow);
+
+            if (m_pendingVirtualIndex >= 0) {
+                m_pendingVirtualIndex = m_pendingTrack ? m_virtualPlaylist->rowOfTrack(m_pendingTrack->id()) : -1;
+                if (m_pendingVirtualIndex < 0) {
+                    m_pendingTrack = nullptr;
+                    m_pendingShuffleIndex = -1;
+                } else if (m_shuffleEnabled) {
+                    m_pendingShuffleIndex = m_virtualPlaylist->getLinearIndex(m_pendingVirtualIndex);
+                }
+            }
+
+            // Buffered tracks carry their old rows; they are rebuilt around the new one
+            m_virtualBufferTracks.clear();
+
+            if (m_shuffleEnabled) {
+                // The shuffle order was rebuilt over the new size with the same seed
+                m_virtualShuffleIndex = m_virtualPlaylist->getLinearIndex(newRow);
+                if (m_virtualShuffleIndex < 0) {
+                    m_virtualPlaylist->generateShuffleOrder(newRow);
+                    m_virtualShuffleIndex = 0;
+                }
+            }
+
+            preloadVirtualTracks(newRow);
+            emit playbackQueueChanged();
+        });
     }
 
     // Once we have a library manager, we're ready
@@ -178,6 +306,20 @@ void MediaPlayer::setSettingsManager(SettingsManager* settingsManager)
                 this, &MediaPlayer::applyReplayGainSettings);
         connect(m_settingsManager, &SettingsManager::replayGainFallbackGainChanged,
                 this, &MediaPlayer::applyReplayGainSettings);
+        
+        applyEqualizerSettings();
+        connect(m_settingsManager, &SettingsManager::equalizerEnabledChanged,
+                this, &MediaPlayer::applyEqualizerSettings);
+        connect(m_settingsManager, &SettingsManager::equalizerGainsChanged,
+                this, &MediaPlayer::applyEqualizerSettings);
+        
+        applyReadAheadSettings();
+        connect(m_settingsManager, &SettingsManager::readAheadBudgetChanged,
+                this, &MediaPlayer::applyReadAheadSettings);
+        connect(m_settingsManager, &SettingsManager::readAheadPriorityChanged,
+                this, &MediaPlayer::applyReadAheadSettings);
+        connect(m_settingsManager, &SettingsManager::warmStandbyChanged,
+                this, &MediaPlayer::applyReadAheadSettings);
     }
 }
 
@@ -186,8 +328,16 @@ void MediaPlayer::setupConnections()
     connect(m_audioEngine.get(), &AudioEngine::stateChanged,
             this, &MediaPlayer::onEngineStateChanged);
     
+    // Engine readings only come on discontinuities (and on the poll interval
+    // when precision is requested); position() interpolates in between
     connect(m_audioEngine.get(), &AudioEngine::positionChanged,
-            this, &MediaPlayer::positionChanged);
+            this, [this](qint64 enginePosition) {
+                syncClock(enginePosition);
+                emit positionChanged(enginePosition);
+            });
+    
+    connect(m_clock, &Mtoc::PlaybackClock::precisionRequestedChanged,
+            this, &MediaPlayer::updatePositionPolling);
     
     connect(m_audioEngine.get(), &AudioEngine::positionChanged,
             this, &MediaPlayer::checkPositionSync);
@@ -228,6 +378,17 @@ void MediaPlayer::setupConnections()
     
     connect(m_audioEngine.get(), &AudioEngine::error,
             this, &MediaPlayer::error);
+    
+    // Closes the skip-to-audio measurement started in loadTrack
+    connect(m_audioEngine.get(), &AudioEngine::playbackStarted, this, [this]() {
+        if (m_startLatencyTimer.isValid()) {
+            const qint64 latency = m_startLatencyTimer.elapsed();
+            m_prefetcher->recordStartLatency(latency, m_startKind);
+            m_audioEngine->diagnostics()->record(Mtoc::PlaybackDiagnostics::SkipToAudio,
+                                                 latency, m_audioEngine->currentTrack());
+            m_startLatencyTimer.invalidate();
+        }
+    });
 }
 
 void MediaPlayer::applyReplayGainSettings()
@@ -260,6 +421,54 @@ void MediaPlayer::applyReplayGainSettings()
     }
 }
 
+void MediaPlayer::applyEqualizerSettings()
+{
+    if (!m_settingsManager || !m_audioEngine) {
+        return;
+    }
+    
+    // Gains first, so enabling doesn't briefly run the previous curve
+    m_audioEngine->setEqualizerGains(m_settingsManager->equalizerBandGains());
+    m_audioEngine->setEqualizerEnabled(m_settingsManager->equalizerEnabled());
+}
+
+void MediaPlayer::loadAnalysedGain(const QString &filePath)
+{
+    if (filePath.isEmpty() || !m_libraryManager || !m_libraryManager->databaseManager()) {
+        return;
+    }
+    
+    // Only tracks the loudness analyser measured have one; tagged and
+    // unmeasured tracks keep the tags or the fallback gain
+    double trackGain = 0.0;
+    double albumGain = 0.0;
+    if (m_libraryManager->databaseManager()->getAnalysedReplayGain(filePath, &trackGain, &albumGain)) {
+        m_audioEngine->setAnalysedGain(filePath, trackGain, albumGain);
+    }
+}
+
+void MediaPlayer::applyReadAheadSettings()
+{
+    if (!m_settingsManager) {
+        return;
+    }
+    
+    switch (m_settingsManager->readAheadPriority()) {
+    case SettingsManager::IdlePriority:
+        m_prefetcher->setIoPriority(Mtoc::TrackPrefetcher::IdleIo);
+        break;
+    case SettingsManager::LowPriority:
+        m_prefetcher->setIoPriority(Mtoc::TrackPrefetcher::LowIo);
+        break;
+    case SettingsManager::NormalPriority:
+        m_prefetcher->setIoPriority(Mtoc::TrackPrefetcher::NormalIo);
+        break;
+    }
+    m_prefetcher->setBudget(qint64(m_settingsManager->readAheadBudget()) * 1024 * 1024);
+    m_audioEngine->setStandbyEnabled(m_settingsManager->warmStandby());
+    updatePrefetch();
+}
+
 MediaPlayer::State MediaPlayer::state() const
 {
     return m_state;
@@ -267,7 +476,7 @@ MediaPlayer::State MediaPlayer::state() const
 
 qint64 MediaPlayer::position() const
 {
-    return m_audioEngine->position();
+    return m_clock->position();
 }
 
 qint64 MediaPlayer::duration() const
@@ -341,7 +550,7 @@ bool MediaPlayer::hasNext() const
     }
     
     // Regular queue handling
-    if (m_playbackQueue.isEmpty()) {
+    if (m_queueModel->isEmpty()) {
         return false;
     }
     
@@ -353,7 +562,7 @@ bool MediaPlayer::hasNext() const
         return m_shuffleIndex >= 0 && m_shuffleIndex < m_shuffleOrder.size() - 1;
     }
     
-    return m_currentQueueIndex >= 0 && m_currentQueueIndex < m_playbackQueue.size() - 1;
+    return m_currentQueueIndex >= 0 && m_currentQueueIndex < m_queueModel->size() - 1;
 }
 
 bool MediaPlayer::hasPrevious() const
@@ -366,7 +575,7 @@ bool MediaPlayer::hasPrevious() const
     // Regular queue handling
     // Only return true if we can actually go to a previous track
     // (i.e., we're not on the first track)
-    return m_currentQueueIndex > 0 && m_playbackQueue.size() > 0;
+    return m_currentQueueIndex > 0 && m_queueModel->size() > 0;
 }
 
 QVariantList MediaPlayer::queue() const
@@ -378,17 +587,16 @@ QVariantList MediaPlayer::queue() const
     
     // Regular queue handling
     QVariantList queueList;
-    for (Mtoc::Track* track : m_playbackQueue) {
-        if (track) {
-            QVariantMap trackMap;
-            trackMap["title"] = track->title();
-            trackMap["artist"] = track->artist();
-            trackMap["album"] = track->album();
-            trackMap["albumArtist"] = track->albumArtist();
-            trackMap["duration"] = track->duration() * 1000; // Convert seconds to milliseconds
-            trackMap["filePath"] = track->filePath();
-            queueList.append(trackMap);
-        }
+    queueList.reserve(m_queueModel->size());
+    for (const Mtoc::QueueEntry& entry : m_queueModel->entries()) {
+        QVariantMap trackMap;
+        trackMap["title"] = entry.title;
+        trackMap["artist"] = entry.artist;
+        trackMap["album"] = entry.album;
+        trackMap["albumArtist"] = entry.albumArtist;
+        trackMap["duration"] = entry.duration * 1000; // Convert seconds to milliseconds
+        trackMap["filePath"] = entry.filePath;
+        queueList.append(trackMap);
     }
     return queueList;
 }
@@ -398,7 +606,7 @@ int MediaPlayer::queueLength() const
     if (m_isVirtualPlaylist && m_virtualPlaylist) {
         return m_virtualPlaylist->trackCount();
     }
-    return m_playbackQueue.size();
+    return m_queueModel->size();
 }
 
 int MediaPlayer::currentQueueIndex() const
@@ -425,13 +633,7 @@ int MediaPlayer::totalQueueDuration() const
         return m_virtualPlaylist->totalDuration();
     }
     
-    int totalSeconds = 0;
-    for (Mtoc::Track* track : m_playbackQueue) {
-        if (track) {
-            totalSeconds += track->duration();
-        }
-    }
-    return totalSeconds;
+    return m_queueModel->totalDuration();
 }
 
 void MediaPlayer::play()
@@ -439,6 +641,7 @@ void MediaPlayer::play()
     if (m_state == PausedState) {
         m_audioEngine->play();
     } else if (m_currentTrack && m_state == StoppedState) {
+        loadAnalysedGain(m_currentTrack->filePath());
         m_audioEngine->loadTrack(m_currentTrack->filePath());
         m_audioEngine->play();
     } else if (m_isVirtualPlaylist && m_virtualPlaylist && m_virtualCurrentIndex < 0) {
@@ -462,9 +665,7 @@ void MediaPlayer::stop()
     clearQueue();
     
     // Clear the saved playback state when stopping
-    if (m_libraryManager) {
-        m_libraryManager->clearPlaybackState();
-    }
+    m_stateJournal->clear();
 }
 
 void MediaPlayer::togglePlayPause()
@@ -577,7 +778,7 @@ void MediaPlayer::next()
             }
         } else {
             // Sequential playback
-            if (m_currentQueueIndex >= m_playbackQueue.size() - 1) {
+            if (m_currentQueueIndex >= m_queueModel->size() - 1) {
                 if (m_repeatEnabled) {
                     m_currentQueueIndex = 0; // Loop to beginning
                 } else {
@@ -588,8 +789,8 @@ void MediaPlayer::next()
             }
         }
         
-        if (m_currentQueueIndex >= 0 && m_currentQueueIndex < m_playbackQueue.size()) {
-            Mtoc::Track* nextTrack = m_playbackQueue[m_currentQueueIndex];
+        if (m_currentQueueIndex >= 0 && m_currentQueueIndex < m_queueModel->size()) {
+            Mtoc::Track* nextTrack = materializeQueueTrack(m_currentQueueIndex);
             playTrack(nextTrack);
             emit playbackQueueChanged();
         }
@@ -659,9 +860,9 @@ void MediaPlayer::previous()
             // Add bounds checking before accessing m_shuffleOrder
             if (m_shuffleIndex >= 0 && m_shuffleIndex < m_shuffleOrder.size()) {
                 m_currentQueueIndex = m_shuffleOrder[m_shuffleIndex];
-                // Add bounds checking before accessing m_playbackQueue
-                if (m_currentQueueIndex >= 0 && m_currentQueueIndex < m_playbackQueue.size()) {
-                    Mtoc::Track* prevTrack = m_playbackQueue[m_currentQueueIndex];
+                // Add bounds checking before accessing the queue
+                if (m_currentQueueIndex >= 0 && m_currentQueueIndex < m_queueModel->size()) {
+                    Mtoc::Track* prevTrack = materializeQueueTrack(m_currentQueueIndex);
                     playTrack(prevTrack);
                     emit playbackQueueChanged();
                 } else {
@@ -677,7 +878,7 @@ void MediaPlayer::previous()
         }
     } else if (hasPrevious()) {
         m_currentQueueIndex--;
-        Mtoc::Track* prevTrack = m_playbackQueue[m_currentQueueIndex];
+        Mtoc::Track* prevTrack = materializeQueueTrack(m_currentQueueIndex);
         playTrack(prevTrack);
         emit playbackQueueChanged();
     } else {
@@ -688,6 +889,7 @@ void MediaPlayer::previous()
 void MediaPlayer::seek(qint64 position)
 {
     m_audioEngine->seek(position);
+    emit seeked(qMax<qint64>(0, position));
 }
 
 void MediaPlayer::playTrack(Mtoc::Track* track)
@@ -704,10 +906,7 @@ void MediaPlayer::loadTrack(Mtoc::Track* track, bool autoPlay)
 
     // Clear pending track state when loading a new track manually
     // This prevents dangling pointers when gapless transition is interrupted
-    m_pendingTrack = nullptr;
-    m_pendingQueueIndex = -1;
-    m_pendingVirtualIndex = -1;
-    m_pendingShuffleIndex = -1;
+    clearPendingTrack(track);
 
     // If this is a virtual playlist track, preload neighboring tracks for gapless playback
     if (m_isVirtualPlaylist && m_virtualPlaylist) {
@@ -776,7 +975,22 @@ void MediaPlayer::loadTrack(Mtoc::Track* track, bool autoPlay)
         return;
     }
     
+    // Measured until the pipeline reports audio running
+    if (autoPlay) {
+        if (m_audioEngine->hasStandby(filePath)) {
+            m_startKind = Mtoc::TrackPrefetcher::StandbyStart;
+        } else if (m_prefetcher->isWarm(filePath)) {
+            m_startKind = Mtoc::TrackPrefetcher::ReadAheadStart;
+        } else {
+            m_startKind = Mtoc::TrackPrefetcher::ColdStart;
+        }
+        m_startLatencyTimer.start();
+    } else {
+        m_startLatencyTimer.invalidate();
+    }
+    
     // qDebug() << "Loading track into audio engine:" << filePath;
+    loadAnalysedGain(filePath);
     m_audioEngine->loadTrack(filePath);
     if (autoPlay) {
         m_audioEngine->play();
@@ -820,8 +1034,14 @@ void MediaPlayer::playAlbum(Mtoc::Album* album, int startIndex)
         emit queueSourceAlbumArtistChanged(m_queueSourceAlbumArtist);
     }
     
-    m_playbackQueue = album->tracks();
-    m_currentQueueIndex = qBound(0, startIndex, m_playbackQueue.size() - 1);
+    const QList<Mtoc::Track*> albumTracks = album->tracks();
+    QList<Mtoc::QueueEntry> entries;
+    entries.reserve(albumTracks.size());
+    for (Mtoc::Track* track : albumTracks) {
+        entries.append(Mtoc::QueueEntry::fromTrack(track));
+    }
+    m_queueModel->append(entries);
+    m_currentQueueIndex = qBound(0, startIndex, m_queueModel->size() - 1);
     
     // Clear the queue modified flag when playing a full album
     setQueueModified(false);
@@ -842,26 +1062,25 @@ void MediaPlayer::playAlbum(Mtoc::Album* album, int startIndex)
     
     emit playbackQueueChanged();
     
-    if (!m_playbackQueue.isEmpty()) {
-        playTrack(m_playbackQueue[m_currentQueueIndex]);
+    if (!m_queueModel->isEmpty()) {
+        playTrack(materializeQueueTrack(m_currentQueueIndex));
     }
 }
 
 void MediaPlayer::removeTrackAt(int index)
 {
-    if (index < 0 || index >= m_playbackQueue.size()) {
+    if (index < 0 || index >= m_queueModel->size()) {
         qWarning() << "removeTrackAt: Invalid index" << index;
         return;
     }
     
     qDebug() << "MediaPlayer::removeTrackAt called with index:" << index;
     
+    recordQueueChange();
+    
     // Mark queue as modified when removing tracks
     setQueueModified(true);
     
-    // Get the track to remove
-    Mtoc::Track* trackToRemove = m_playbackQueue[index];
-    
     // Handle removal based on position relative to current track
     if (index == m_currentQueueIndex) {
         // Removing the currently playing track
@@ -870,10 +1089,7 @@ void MediaPlayer::removeTrackAt(int index)
         
         if (hasNext()) {
             // Play next track (index stays the same after removal)
-            m_playbackQueue.removeAt(index);
-            if (trackToRemove && trackToRemove->parent() == this) {
-                trackToRemove->deleteLater();
-            }
+            m_queueModel->removeAt(index);
             emit playbackQueueChanged();
             
             // Update shuffle order if enabled
@@ -882,13 +1098,10 @@ void MediaPlayer::removeTrackAt(int index)
             }
             
             // Load the track but don't auto-play if we were paused
-            loadTrack(m_playbackQueue[m_currentQueueIndex], !wasPaused);
+            loadTrack(materializeQueueTrack(m_currentQueueIndex), !wasPaused);
         } else if (m_currentQueueIndex > 0) {
             // No next track, play previous
-            m_playbackQueue.removeAt(index);
-            if (trackToRemove && trackToRemove->parent() == this) {
-                trackToRemove->deleteLater();
-            }
+            m_queueModel->removeAt(index);
             m_currentQueueIndex--;
             emit playbackQueueChanged();
             
@@ -898,31 +1111,22 @@ void MediaPlayer::removeTrackAt(int index)
             }
             
             // Load the track but don't auto-play if we were paused
-            loadTrack(m_playbackQueue[m_currentQueueIndex], !wasPaused);
+            loadTrack(materializeQueueTrack(m_currentQueueIndex), !wasPaused);
         } else {
             // No other tracks, stop playback
-            m_playbackQueue.removeAt(index);
-            if (trackToRemove && trackToRemove->parent() == this) {
-                trackToRemove->deleteLater();
-            }
+            m_queueModel->removeAt(index);
             m_currentQueueIndex = -1;
             emit playbackQueueChanged();
             stop();
         }
     } else if (index < m_currentQueueIndex) {
         // Removing a track before the current one
-        m_playbackQueue.removeAt(index);
-        if (trackToRemove && trackToRemove->parent() == this) {
-            trackToRemove->deleteLater();
-        }
+        m_queueModel->removeAt(index);
         m_currentQueueIndex--;
         emit playbackQueueChanged();
     } else {
         // Removing a track after the current one
-        m_playbackQueue.removeAt(index);
-        if (trackToRemove && trackToRemove->parent() == this) {
-            trackToRemove->deleteLater();
-        }
+        m_queueModel->removeAt(index);
         emit playbackQueueChanged();
     }
     
@@ -936,6 +1140,8 @@ void MediaPlayer::removeTracks(const QList<int>& indices)
 {
     if (indices.isEmpty()) return;
     
+    recordQueueChange();
+    
     // Sort indices in descending order to remove from end to beginning
     QList<int> sortedIndices = indices;
     std::sort(sortedIndices.begin(), sortedIndices.end(), std::greater<int>());
@@ -953,24 +1159,35 @@ void MediaPlayer::removeTracks(const QList<int>& indices)
         }
     }
     
+    // Position of a surviving index once the removals have been applied
+    auto indexAfterRemoval = [&sortedIndices](int index) {
+        int removedBefore = 0;
+        for (int idx : sortedIndices) {
+            if (idx < index) {
+                removedBefore++;
+            }
+        }
+        return index - removedBefore;
+    };
+    
     // If removing current track, determine what to play next
-    Mtoc::Track* nextTrack = nullptr;
-    if (removingCurrent && m_playbackQueue.size() > sortedIndices.size()) {
+    bool hasReplacement = false;
+    if (removingCurrent && m_queueModel->size() > sortedIndices.size()) {
         // Find the first non-removed track after current
-        for (int i = m_currentQueueIndex + 1; i < m_playbackQueue.size(); i++) {
+        for (int i = m_currentQueueIndex + 1; i < m_queueModel->size(); i++) {
             if (!sortedIndices.contains(i)) {
-                nextTrack = m_playbackQueue[i];
-                newCurrentIndex = i - tracksBeforeCurrent - 1; // Adjust for removed tracks
+                hasReplacement = true;
+                newCurrentIndex = indexAfterRemoval(i);
                 break;
             }
         }
         
         // If no track after, find one before
-        if (!nextTrack) {
+        if (!hasReplacement) {
             for (int i = m_currentQueueIndex - 1; i >= 0; i--) {
                 if (!sortedIndices.contains(i)) {
-                    nextTrack = m_playbackQueue[i];
-                    newCurrentIndex = i - tracksBeforeCurrent;
+                    hasReplacement = true;
+                    newCurrentIndex = indexAfterRemoval(i);
                     break;
                 }
             }
@@ -980,18 +1197,8 @@ void MediaPlayer::removeTracks(const QList<int>& indices)
         newCurrentIndex = m_currentQueueIndex - tracksBeforeCurrent;
     }
     
-    // Remove tracks from queue (in descending order)
-    for (int idx : sortedIndices) {
-        if (idx >= 0 && idx < m_playbackQueue.size()) {
-            Mtoc::Track* track = m_playbackQueue[idx];
-            m_playbackQueue.removeAt(idx);
-            
-            // Clean up if we created this track
-            if (track && track->parent() == this) {
-                track->deleteLater();
-            }
-        }
-    }
+    // Remove tracks from queue in one pass over the model
+    m_queueModel->removeIndices(sortedIndices);
     
     // Update shuffle order if needed
     if (m_shuffleEnabled) {
@@ -999,11 +1206,11 @@ void MediaPlayer::removeTracks(const QList<int>& indices)
     }
     
     // Handle playback state
-    if (m_playbackQueue.isEmpty()) {
+    if (m_queueModel->isEmpty()) {
         stop();
-    } else if (removingCurrent && nextTrack) {
+    } else if (removingCurrent && hasReplacement) {
         m_currentQueueIndex = newCurrentIndex;
-        playTrack(nextTrack);
+        playTrack(materializeQueueTrack(m_currentQueueIndex));
     } else {
         m_currentQueueIndex = newCurrentIndex;
     }
@@ -1096,7 +1303,7 @@ void MediaPlayer::playTrackAt(int index)
         }
     } else {
         // Handle regular queue
-        if (index < 0 || index >= m_playbackQueue.size()) {
+        if (index < 0 || index >= m_queueModel->size()) {
             qWarning() << "playTrackAt: Invalid index" << index;
             return;
         }
@@ -1115,7 +1322,7 @@ void MediaPlayer::playTrackAt(int index)
         }
         
         emit playbackQueueChanged();
-        playTrack(m_playbackQueue[index]);
+        playTrack(materializeQueueTrack(index));
     }
 }
 
@@ -1128,14 +1335,13 @@ void MediaPlayer::moveTrack(int fromIndex, int toIndex)
     }
     
     // Validate indices
-    if (fromIndex < 0 || fromIndex >= m_playbackQueue.size() ||
-        toIndex < 0 || toIndex >= m_playbackQueue.size() ||
+    if (fromIndex < 0 || fromIndex >= m_queueModel->size() ||
+        toIndex < 0 || toIndex >= m_queueModel->size() ||
         fromIndex == toIndex) {
         return;
     }
     
-    // Store the track being moved
-    Mtoc::Track* track = m_playbackQueue[fromIndex];
+    recordQueueChange();
     
     // Update current queue index if needed
     int newCurrentIndex = m_currentQueueIndex;
@@ -1155,11 +1361,8 @@ void MediaPlayer::moveTrack(int fromIndex, int toIndex)
         }
     }
     
-    // Remove from old position
-    m_playbackQueue.removeAt(fromIndex);
-    
-    // Insert at new position
-    m_playbackQueue.insert(toIndex, track);
+    // Move to the new position
+    m_queueModel->move(fromIndex, toIndex);
     
     // Update current index
     m_currentQueueIndex = newCurrentIndex;
@@ -1230,13 +1433,7 @@ void MediaPlayer::clearQueue()
         emit queueSourceAlbumArtistChanged(m_queueSourceAlbumArtist);
     }
     
-    // Clean up any tracks we created
-    for (auto track : m_playbackQueue) {
-        if (track && track->parent() == this) {
-            track->deleteLater();
-        }
-    }
-    m_playbackQueue.clear();
+    m_queueModel->clear();
     m_currentQueueIndex = -1;
     
     // Clear shuffle state
@@ -1245,8 +1442,8 @@ void MediaPlayer::clearQueue()
     
     setQueueModified(false);
     
-    // Also clear undo queue
-    clearUndoQueue();
+    // A replaced queue starts a new history
+    clearQueueHistory();
     
     emit playbackQueueChanged();
 }
@@ -1254,19 +1451,13 @@ void MediaPlayer::clearQueue()
 void MediaPlayer::clearQueueForUndo()
 {
     // Save current queue state for undo
-    m_undoQueue = m_playbackQueue;
-    m_undoQueueIndex = m_currentQueueIndex;
-    m_undoCurrentTrack = m_currentTrack;
-    m_undoQueueModified = m_isQueueModified;
-    m_undoQueueSourceAlbumName = m_queueSourceAlbumName;
-    m_undoQueueSourceAlbumArtist = m_queueSourceAlbumArtist;
-    m_undoCurrentPlaylistName = m_currentPlaylistName;
+    recordQueueChange(true);
     
     // Stop audio playback without clearing the queue
     m_audioEngine->stop();
     
-    // Clear the current queue without deleting tracks
-    m_playbackQueue.clear();
+    // Clear the current queue; the entries live on in the undo history
+    m_queueModel->clear();
     m_currentQueueIndex = -1;
     updateCurrentTrack(nullptr);
     setQueueModified(false);
@@ -1286,58 +1477,155 @@ void MediaPlayer::clearQueueForUndo()
     }
     
     emit playbackQueueChanged();
-    emit canUndoClearChanged(true);
     
-    // Clear the saved playback state
-    if (m_libraryManager) {
-        m_libraryManager->clearPlaybackState();
+    // Clear the saved playback state. A restore clears the queue only to rebuild
+    // it under the saved track, which has to stay journaled until it is loaded.
+    if (!m_restoringState) {
+        m_stateJournal->clear();
     }
 }
 
 void MediaPlayer::undoClearQueue()
 {
-    if (m_undoQueue.isEmpty()) {
+    if (canUndoClear()) {
+        undoQueueChange();
+    }
+}
+
+void MediaPlayer::undoQueueChange()
+{
+    if (m_queueUndoStack.isEmpty()) {
+        return;
+    }
+    
+    QueueState previous = m_queueUndoStack.takeLast();
+    QueueState current = captureQueueState();
+    current.clearedQueue = previous.clearedQueue;
+    m_queueRedoStack.append(current);
+    
+    restoreQueueState(previous);
+    emitQueueHistoryChanged();
+}
+
+void MediaPlayer::redoQueueChange()
+{
+    if (m_queueRedoStack.isEmpty()) {
         return;
     }
     
-    // Restore the queue
-    m_playbackQueue = m_undoQueue;
-    m_currentQueueIndex = m_undoQueueIndex;
-    m_currentTrack = m_undoCurrentTrack;
-    setQueueModified(m_undoQueueModified);
+    QueueState next = m_queueRedoStack.takeLast();
+    QueueState current = captureQueueState();
+    current.clearedQueue = next.clearedQueue;
+    m_queueUndoStack.append(current);
+    
+    restoreQueueState(next);
+    emitQueueHistoryChanged();
+}
+
+MediaPlayer::QueueState MediaPlayer::captureQueueState() const
+{
+    QueueState state;
+    state.entries = m_queueModel->entries();
+    state.currentIndex = m_currentQueueIndex;
+    state.modified = m_isQueueModified;
+    state.sourceAlbumName = m_queueSourceAlbumName;
+    state.sourceAlbumArtist = m_queueSourceAlbumArtist;
+    state.playlistName = m_currentPlaylistName;
+    return state;
+}
+
+void MediaPlayer::restoreQueueState(const QueueState& state)
+{
+    m_queueModel->setEntries(state.entries);
+    setQueueModified(state.modified);
     
     // Restore the queue source info
-    if (!m_undoQueueSourceAlbumName.isEmpty()) {
-        m_queueSourceAlbumName = m_undoQueueSourceAlbumName;
+    if (m_queueSourceAlbumName != state.sourceAlbumName) {
+        m_queueSourceAlbumName = state.sourceAlbumName;
         emit queueSourceAlbumNameChanged(m_queueSourceAlbumName);
     }
-    if (!m_undoQueueSourceAlbumArtist.isEmpty()) {
-        m_queueSourceAlbumArtist = m_undoQueueSourceAlbumArtist;
+    if (m_queueSourceAlbumArtist != state.sourceAlbumArtist) {
+        m_queueSourceAlbumArtist = state.sourceAlbumArtist;
         emit queueSourceAlbumArtistChanged(m_queueSourceAlbumArtist);
     }
-    if (!m_undoCurrentPlaylistName.isEmpty()) {
-        m_currentPlaylistName = m_undoCurrentPlaylistName;
+    if (m_currentPlaylistName != state.playlistName) {
+        m_currentPlaylistName = state.playlistName;
         emit currentPlaylistNameChanged(m_currentPlaylistName);
     }
     
-    // Clear undo state
-    m_undoQueue.clear();
-    m_undoQueueIndex = -1;
-    m_undoCurrentTrack = nullptr;
-    m_undoQueueModified = false;
-    m_undoQueueSourceAlbumName.clear();
-    m_undoQueueSourceAlbumArtist.clear();
-    m_undoCurrentPlaylistName.clear();
+    // Keep the playing track if it is part of the restored queue. Playback may
+    // have moved on since the state was saved, so the saved index is only a hint.
+    int playingIndex = -1;
+    if (m_currentTrack) {
+        const QString playingPath = m_currentTrack->filePath();
+        if (state.currentIndex >= 0 && state.currentIndex < state.entries.size()
+            && state.entries.at(state.currentIndex).filePath == playingPath) {
+            playingIndex = state.currentIndex;
+        } else {
+            int index = 0;
+            for (const Mtoc::QueueEntry& entry : state.entries) {
+                if (entry.filePath == playingPath) {
+                    playingIndex = index;
+                    break;
+                }
+                ++index;
+            }
+        }
+    }
+    
+    if (playingIndex >= 0) {
+        m_currentQueueIndex = playingIndex;
+    } else if (state.currentIndex >= 0 && state.currentIndex < state.entries.size()) {
+        m_currentQueueIndex = state.currentIndex;
+    } else {
+        m_currentQueueIndex = state.entries.isEmpty() ? -1 : 0;
+    }
+    
+    if (m_shuffleEnabled) {
+        generateShuffleOrder(true);
+    }
     
-    // Emit signals
     emit playbackQueueChanged();
-    emit currentTrackChanged(m_currentTrack);
-    emit canUndoClearChanged(false);
     
-    // If we have a current track, ensure it's loaded but paused
-    if (m_currentTrack) {
-        loadTrack(m_currentTrack, false);
+    if (playingIndex >= 0) {
+        m_queueModel->setCurrentIndex(m_currentQueueIndex);
+        return;
+    }
+    
+    // The playing track is gone: load the restored current track paused, or
+    // stop if the restored queue is empty
+    Mtoc::Track* track = materializeQueueTrack(m_currentQueueIndex);
+    if (track) {
+        loadTrack(track, false);
+    } else {
+        m_audioEngine->stop();
+        updateCurrentTrack(nullptr);
+        m_stateJournal->clear();
+    }
+}
+
+void MediaPlayer::recordQueueChange(bool clearsQueue)
+{
+    // Virtual playlists are not part of the queue history
+    if (m_isVirtualPlaylist) {
+        clearQueueHistory();
+        return;
+    }
+    
+    QueueState state = captureQueueState();
+    state.clearedQueue = clearsQueue;
+    m_queueUndoStack.append(state);
+    while (m_queueUndoStack.size() > MAX_QUEUE_HISTORY) {
+        m_queueUndoStack.removeFirst();
     }
+    m_queueRedoStack.clear();
+    emitQueueHistoryChanged();
+}
+
+void MediaPlayer::emitQueueHistoryChanged()
+{
+    emit queueHistoryChanged();
+    emit canUndoClearChanged(canUndoClear());
 }
 
 void MediaPlayer::playAlbumByName(const QString& artist, const QString& title, int startIndex)
@@ -1377,10 +1665,7 @@ void MediaPlayer::playAlbumByName(const QString& artist, const QString& title, i
     if (!trackList.isEmpty()) {
         // Clear pending track state before clearing queue
         // This prevents dangling pointers when gapless transition is interrupted
-        m_pendingTrack = nullptr;
-        m_pendingQueueIndex = -1;
-        m_pendingVirtualIndex = -1;
-        m_pendingShuffleIndex = -1;
+        clearPendingTrack();
 
         // Clear current queue and set up new one
         clearQueue();
@@ -1399,25 +1684,11 @@ void MediaPlayer::playAlbumByName(const QString& artist, const QString& title, i
         }
         
         // Build the queue from track data
-        for (const auto& trackData : trackList) {
-            auto trackMap = trackData.toMap();
-            QString title = trackMap.value("title").toString();
-            QString filePath = trackMap.value("filePath").toString();
-            
-            if (filePath.isEmpty()) {
-                qWarning() << "Empty filePath for track:" << title;
-                continue;
-            }
-            
-            // Create a new Track object from the data
-            Mtoc::Track* track = Mtoc::Track::fromMetadata(trackMap, this);
-            
-            m_playbackQueue.append(track);
-        }
+        m_queueModel->append(Mtoc::QueueEntry::fromMetadataList(trackList));
         
-        qDebug() << "Built queue with" << m_playbackQueue.size() << "tracks";
+        qDebug() << "Built queue with" << m_queueModel->size() << "tracks";
         
-        if (!m_playbackQueue.isEmpty() && startIndex < m_playbackQueue.size()) {
+        if (!m_queueModel->isEmpty() && startIndex < m_queueModel->size()) {
             m_currentQueueIndex = startIndex;
             
             // Generate shuffle order if shuffle is enabled
@@ -1435,7 +1706,7 @@ void MediaPlayer::playAlbumByName(const QString& artist, const QString& title, i
             }
             
             emit playbackQueueChanged();
-            playTrack(m_playbackQueue[startIndex]);
+            playTrack(materializeQueueTrack(startIndex));
         }
     } else {
         qWarning() << "No tracks found for album:" << artist << "-" << title;
@@ -1474,10 +1745,7 @@ void MediaPlayer::playPlaylist(const QString& playlistName, int startIndex)
 
     // Clear pending track state before clearing queue
     // This prevents dangling pointers when gapless transition is interrupted
-    m_pendingTrack = nullptr;
-    m_pendingQueueIndex = -1;
-    m_pendingVirtualIndex = -1;
-    m_pendingShuffleIndex = -1;
+    clearPendingTrack();
 
     // Clear current queue
     clearQueue();
@@ -1489,29 +1757,15 @@ void MediaPlayer::playPlaylist(const QString& playlistName, int startIndex)
     }
     
     // Build tracks from data and add to queue
-    for (const auto& trackData : trackList) {
-        auto trackMap = trackData.toMap();
-        QString trackTitle = trackMap.value("title").toString();
-        QString filePath = trackMap.value("filePath").toString();
-        
-        if (filePath.isEmpty()) {
-            qWarning() << "Empty filePath for track:" << trackTitle;
-            continue;
-        }
-        
-        // Create a new Track object from the data
-        Mtoc::Track* track = Mtoc::Track::fromMetadata(trackMap, this);
-        
-        m_playbackQueue.append(track);
-    }
+    m_queueModel->append(Mtoc::QueueEntry::fromMetadataList(trackList));
     
     // Clear the queue modified flag since this is a fresh playlist load
     setQueueModified(false);
     
     // Ensure startIndex is within bounds
-    startIndex = qBound(0, startIndex, m_playbackQueue.size() - 1);
+    startIndex = qBound(0, startIndex, m_queueModel->size() - 1);
     
-    if (!m_playbackQueue.isEmpty()) {
+    if (!m_queueModel->isEmpty()) {
         m_currentQueueIndex = startIndex;
         
         // Generate shuffle order if shuffle is enabled
@@ -1528,7 +1782,7 @@ void MediaPlayer::playPlaylist(const QString& playlistName, int startIndex)
         }
         
         emit playbackQueueChanged();
-        playTrack(m_playbackQueue[startIndex]);
+        playTrack(materializeQueueTrack(startIndex));
     }
 }
 
@@ -1560,10 +1814,7 @@ void MediaPlayer::playTrackFromData(const QVariant& trackData)
     if (duration > 10000) { // Likely in milliseconds if > 10000
         trackMap["duration"] = duration / 1000;
     }
-    Mtoc::Track* track = Mtoc::Track::fromMetadata(trackMap, this);
-    
-    // Add to queue so it gets cleaned up properly
-    m_playbackQueue.append(track);
+    m_queueModel->append(Mtoc::QueueEntry::fromMetadata(trackMap));
     m_currentQueueIndex = 0;
     
     // Generate shuffle order if shuffle is enabled (even for single track)
@@ -1574,24 +1825,68 @@ void MediaPlayer::playTrackFromData(const QVariant& trackData)
     }
     
     // Play the single track
-    playTrack(track);
+    playTrack(materializeQueueTrack(0));
     
     emit playbackQueueChanged();
 }
 
-void MediaPlayer::clearUndoQueue()
+void MediaPlayer::clearQueueHistory()
 {
-    if (!m_undoQueue.isEmpty()) {
-        for (auto track : m_undoQueue) {
-            if (track && track->parent() == this) {
-                track->deleteLater();
-            }
+    if (!m_queueUndoStack.isEmpty() || !m_queueRedoStack.isEmpty()) {
+        m_queueUndoStack.clear();
+        m_queueRedoStack.clear();
+        emitQueueHistoryChanged();
+    }
+}
+
+Mtoc::Track* MediaPlayer::materializeQueueTrack(int index)
+{
+    if (index < 0 || index >= m_queueModel->size()) {
+        return nullptr;
+    }
+
+    const Mtoc::QueueEntry& entry = m_queueModel->at(index);
+
+    // Reuse the object if this entry is already the current or pending track
+    for (Mtoc::Track* existing : {m_currentTrack.data(), m_pendingTrack.data()}) {
+        if (existing && existing->parent() == this && existing->filePath() == entry.filePath) {
+            return existing;
+        }
+    }
+
+    Mtoc::Track* track = entry.createTrack(this);
+
+    // Lyrics and the current favorite state are not kept in the queue
+    if (entry.id > 0 && m_libraryManager && m_libraryManager->databaseManager()) {
+        QVariantMap trackData = m_libraryManager->databaseManager()->getTrack(entry.id);
+        if (!trackData.isEmpty()) {
+            track->setLyrics(trackData.value("lyrics").toString());
+            track->setIsFavorite(trackData.value("isFavorite").toBool());
         }
-        m_undoQueue.clear();
-        m_undoQueueIndex = -1;
-        m_undoCurrentTrack = nullptr;
-        m_undoQueueModified = false;
-        emit canUndoClearChanged(false);
+    }
+
+    return track;
+}
+
+void MediaPlayer::releaseTrack(Mtoc::Track* track)
+{
+    // Only objects materialized from queue entries belong to us; library and
+    // album tracks are owned elsewhere
+    if (track && track->parent() == this && track != m_currentTrack && track != m_pendingTrack) {
+        track->deleteLater();
+    }
+}
+
+void MediaPlayer::clearPendingTrack(Mtoc::Track* keep)
+{
+    Mtoc::Track* pendingTrack = m_pendingTrack;
+    m_pendingTrack = nullptr;
+    m_pendingQueueIndex = -1;
+    m_pendingVirtualIndex = -1;
+    m_pendingShuffleIndex = -1;
+
+    if (pendingTrack != keep) {
+        releaseTrack(pendingTrack);
     }
 }
 
@@ -1646,31 +1941,21 @@ void MediaPlayer::playTracksById(const QVariantList& trackIds)
     // Clear current queue
     clearQueue();
 
-    // Look up each track and add to queue
-    int loadedCount = 0;
+    // Look up all tracks at once; ids that no longer exist are skipped
+    QList<int> ids;
+    ids.reserve(trackIds.size());
     for (const QVariant& idVariant : trackIds) {
-        int trackId = idVariant.toInt();
-        QVariantMap trackData = m_libraryManager->databaseManager()->getTrack(trackId);
-
-        if (trackData.isEmpty()) {
-            qDebug() << "[MediaPlayer::playTracksById] Track not found, skipping:" << trackId;
-            continue;
-        }
-
-        QString filePath = trackData.value("filePath").toString();
-        if (filePath.isEmpty()) {
-            qDebug() << "[MediaPlayer::playTracksById] Empty filePath for track:" << trackId;
-            continue;
-        }
-
-        // Create a new Track object from the data
-        Mtoc::Track* track = Mtoc::Track::fromMetadata(trackData, this);
-
-        m_playbackQueue.append(track);
-        loadedCount++;
+        ids.append(idVariant.toInt());
+    }
+    QList<Mtoc::QueueEntry> entries = Mtoc::QueueEntry::fromResolvedTracks(
+        m_libraryManager->databaseManager()->resolveTracksById(ids));
+    int loadedCount = entries.size();
+    if (loadedCount < ids.size()) {
+        qDebug() << "[MediaPlayer::playTracksById] Skipped" << ids.size() - loadedCount << "missing tracks";
     }
+    m_queueModel->append(entries);
 
-    if (m_playbackQueue.isEmpty()) {
+    if (m_queueModel->isEmpty()) {
         qWarning() << "[MediaPlayer::playTracksById] No valid tracks found";
         return;
     }
@@ -1701,14 +1986,11 @@ void MediaPlayer::playTracksById(const QVariantList& trackIds)
     emit virtualPlaylistNameChanged(QString());
 
     // Play the first track
-    playTrack(m_playbackQueue.first());
+    playTrack(materializeQueueTrack(0));
 }
 
 void MediaPlayer::playTrackNext(const QVariant& trackData)
 {
-    // Clear undo queue when adding new items
-    clearUndoQueue();
-    
     auto trackMap = trackData.toMap();
     QString title = trackMap.value("title").toString();
     QString filePath = trackMap.value("filePath").toString();
@@ -1720,19 +2002,14 @@ void MediaPlayer::playTrackNext(const QVariant& trackData)
         return;
     }
     
-    // Create a new Track object from the data
-    Mtoc::Track* track = new Mtoc::Track(this);
-    track->setTitle(title);
-    track->setArtist(trackMap.value("artist").toString());
-    track->setAlbum(trackMap.value("album").toString());
-    track->setAlbumArtist(trackMap.value("albumArtist").toString());
-    track->setTrackNumber(trackMap.value("trackNumber").toInt());
-    track->setDuration(trackMap.value("duration").toInt());
-    track->setFileUrl(QUrl::fromLocalFile(filePath));
+    Mtoc::QueueEntry entry = Mtoc::QueueEntry::fromMetadata(trackMap);
+    
+    // Adding items is undoable; recorded only once there is something to add
+    recordQueueChange();
     
     // Insert after current track, or at beginning if nothing is playing
     int insertIndex = (m_currentQueueIndex >= 0) ? m_currentQueueIndex + 1 : 0;
-    m_playbackQueue.insert(insertIndex, track);
+    m_queueModel->insert(insertIndex, entry);
     
     // Mark queue as modified when adding individual tracks
     setQueueModified(true);
@@ -1745,17 +2022,14 @@ void MediaPlayer::playTrackNext(const QVariant& trackData)
     emit playbackQueueChanged();
     
     // If nothing is playing, start playback
-    if (m_currentQueueIndex < 0 && !m_playbackQueue.isEmpty()) {
+    if (m_currentQueueIndex < 0 && !m_queueModel->isEmpty()) {
         m_currentQueueIndex = 0;
-        playTrack(m_playbackQueue[0]);
+        playTrack(materializeQueueTrack(0));
     }
 }
 
 void MediaPlayer::playTrackLast(const QVariant& trackData)
 {
-    // Clear undo queue when adding new items
-    clearUndoQueue();
-    
     auto trackMap = trackData.toMap();
     QString title = trackMap.value("title").toString();
     QString filePath = trackMap.value("filePath").toString();
@@ -1767,18 +2041,13 @@ void MediaPlayer::playTrackLast(const QVariant& trackData)
         return;
     }
     
-    // Create a new Track object from the data
-    Mtoc::Track* track = new Mtoc::Track(this);
-    track->setTitle(title);
-    track->setArtist(trackMap.value("artist").toString());
-    track->setAlbum(trackMap.value("album").toString());
-    track->setAlbumArtist(trackMap.value("albumArtist").toString());
-    track->setTrackNumber(trackMap.value("trackNumber").toInt());
-    track->setDuration(trackMap.value("duration").toInt());
-    track->setFileUrl(QUrl::fromLocalFile(filePath));
+    Mtoc::QueueEntry entry = Mtoc::QueueEntry::fromMetadata(trackMap);
+    
+    // Adding items is undoable; recorded only once there is something to add
+    recordQueueChange();
     
     // Append to end of queue
-    m_playbackQueue.append(track);
+    m_queueModel->append(entry);
     
     // Mark queue as modified when adding individual tracks
     setQueueModified(true);
@@ -1791,17 +2060,14 @@ void MediaPlayer::playTrackLast(const QVariant& trackData)
     emit playbackQueueChanged();
     
     // If nothing is playing, start playback
-    if (m_currentQueueIndex < 0 && !m_playbackQueue.isEmpty()) {
+    if (m_currentQueueIndex < 0 && !m_queueModel->isEmpty()) {
         m_currentQueueIndex = 0;
-        playTrack(m_playbackQueue[0]);
+        playTrack(materializeQueueTrack(0));
     }
 }
 
 void MediaPlayer::playAlbumNext(const QString& artist, const QString& title)
 {
-    // Clear undo queue when adding new items
-    clearUndoQueue();
-    
     qDebug() << "MediaPlayer::playAlbumNext called with artist:" << artist << "title:" << title;
     
     if (!m_libraryManager) {
@@ -1820,21 +2086,11 @@ void MediaPlayer::playAlbumNext(const QString& artist, const QString& title)
     // Insert position: after current track, or at beginning if nothing is playing
     int insertIndex = (m_currentQueueIndex >= 0) ? m_currentQueueIndex + 1 : 0;
     
+    // Adding items is undoable; recorded only once there is something to add
+    recordQueueChange();
+    
     // Build tracks from data and insert into queue
-    for (const auto& trackData : trackList) {
-        auto trackMap = trackData.toMap();
-        QString trackTitle = trackMap.value("title").toString();
-        QString filePath = trackMap.value("filePath").toString();
-        
-        if (filePath.isEmpty()) {
-            qWarning() << "Empty filePath for track:" << trackTitle;
-            continue;
-        }
-        
-        Mtoc::Track* track = Mtoc::Track::fromMetadata(trackMap, this);
-        
-        m_playbackQueue.insert(insertIndex++, track);
-    }
+    m_queueModel->insert(insertIndex, Mtoc::QueueEntry::fromMetadataList(trackList));
     
     // Mark queue as modified when adding albums to existing queue
     setQueueModified(true);
@@ -1847,17 +2103,14 @@ void MediaPlayer::playAlbumNext(const QString& artist, const QString& title)
     emit playbackQueueChanged();
     
     // If nothing is playing, start playback
-    if (m_currentQueueIndex < 0 && !m_playbackQueue.isEmpty()) {
+    if (m_currentQueueIndex < 0 && !m_queueModel->isEmpty()) {
         m_currentQueueIndex = 0;
-        playTrack(m_playbackQueue[0]);
+        playTrack(materializeQueueTrack(0));
     }
 }
 
 void MediaPlayer::playAlbumLast(const QString& artist, const QString& title)
 {
-    // Clear undo queue when adding new items
-    clearUndoQueue();
-    
     qDebug() << "MediaPlayer::playAlbumLast called with artist:" << artist << "title:" << title;
     
     if (!m_libraryManager) {
@@ -1873,21 +2126,11 @@ void MediaPlayer::playAlbumLast(const QString& artist, const QString& title)
         return;
     }
     
+    // Adding items is undoable; recorded only once there is something to add
+    recordQueueChange();
+    
     // Build tracks from data and append to queue
-    for (const auto& trackData : trackList) {
-        auto trackMap = trackData.toMap();
-        QString trackTitle = trackMap.value("title").toString();
-        QString filePath = trackMap.value("filePath").toString();
-        
-        if (filePath.isEmpty()) {
-            qWarning() << "Empty filePath for track:" << trackTitle;
-            continue;
-        }
-        
-        Mtoc::Track* track = Mtoc::Track::fromMetadata(trackMap, this);
-        
-        m_playbackQueue.append(track);
-    }
+    m_queueModel->append(Mtoc::QueueEntry::fromMetadataList(trackList));
     
     // Mark queue as modified when adding albums to existing queue
     setQueueModified(true);
@@ -1900,17 +2143,14 @@ void MediaPlayer::playAlbumLast(const QString& artist, const QString& title)
     emit playbackQueueChanged();
     
     // If nothing is playing, start playback
-    if (m_currentQueueIndex < 0 && !m_playbackQueue.isEmpty()) {
+    if (m_currentQueueIndex < 0 && !m_queueModel->isEmpty()) {
         m_currentQueueIndex = 0;
-        playTrack(m_playbackQueue[0]);
+        playTrack(materializeQueueTrack(0));
     }
 }
 
 void MediaPlayer::playPlaylistNext(const QString& playlistName)
 {
-    // Clear undo queue when adding new items
-    clearUndoQueue();
-    
     qDebug() << "MediaPlayer::playPlaylistNext called with playlist:" << playlistName;
     
     // Get playlist tracks from PlaylistManager
@@ -1927,21 +2167,11 @@ void MediaPlayer::playPlaylistNext(const QString& playlistName)
     // Find insertion point (after current track)
     int insertIndex = m_currentQueueIndex + 1;
     
+    // Adding items is undoable; recorded only once there is something to add
+    recordQueueChange();
+    
     // Build tracks from data and insert into queue
-    for (const auto& trackData : trackList) {
-        auto trackMap = trackData.toMap();
-        QString trackTitle = trackMap.value("title").toString();
-        QString filePath = trackMap.value("filePath").toString();
-        
-        if (filePath.isEmpty()) {
-            qWarning() << "Empty filePath for track:" << trackTitle;
-            continue;
-        }
-        
-        Mtoc::Track* track = Mtoc::Track::fromMetadata(trackMap, this);
-        
-        m_playbackQueue.insert(insertIndex++, track);
-    }
+    m_queueModel->insert(insertIndex, Mtoc::QueueEntry::fromMetadataList(trackList));
     
     // Mark queue as modified when adding playlists to existing queue
     setQueueModified(true);
@@ -1954,17 +2184,14 @@ void MediaPlayer::playPlaylistNext(const QString& playlistName)
     emit playbackQueueChanged();
     
     // If nothing is playing, start playback
-    if (m_currentQueueIndex < 0 && !m_playbackQueue.isEmpty()) {
+    if (m_currentQueueIndex < 0 && !m_queueModel->isEmpty()) {
         m_currentQueueIndex = 0;
-        playTrack(m_playbackQueue[0]);
+        playTrack(materializeQueueTrack(0));
     }
 }
 
 void MediaPlayer::playPlaylistLast(const QString& playlistName)
 {
-    // Clear undo queue when adding new items
-    clearUndoQueue();
-    
     qDebug() << "MediaPlayer::playPlaylistLast called with playlist:" << playlistName;
     
     // Get playlist tracks from PlaylistManager
@@ -1978,21 +2205,11 @@ void MediaPlayer::playPlaylistLast(const QString& playlistName)
         return;
     }
     
+    // Adding items is undoable; recorded only once there is something to add
+    recordQueueChange();
+    
     // Build tracks from data and append to queue
-    for (const auto& trackData : trackList) {
-        auto trackMap = trackData.toMap();
-        QString trackTitle = trackMap.value("title").toString();
-        QString filePath = trackMap.value("filePath").toString();
-        
-        if (filePath.isEmpty()) {
-            qWarning() << "Empty filePath for track:" << trackTitle;
-            continue;
-        }
-        
-        Mtoc::Track* track = Mtoc::Track::fromMetadata(trackMap, this);
-        
-        m_playbackQueue.append(track);
-    }
+    m_queueModel->append(Mtoc::QueueEntry::fromMetadataList(trackList));
     
     // Mark queue as modified when adding playlists to existing queue
     setQueueModified(true);
@@ -2005,21 +2222,26 @@ void MediaPlayer::playPlaylistLast(const QString& playlistName)
     emit playbackQueueChanged();
     
     // If nothing is playing, start playback
-    if (m_currentQueueIndex < 0 && !m_playbackQueue.isEmpty()) {
+    if (m_currentQueueIndex < 0 && !m_queueModel->isEmpty()) {
         m_currentQueueIndex = 0;
-        playTrack(m_playbackQueue[0]);
+        playTrack(materializeQueueTrack(0));
     }
 }
 
 void MediaPlayer::updateCurrentTrack(Mtoc::Track* track)
 {
+    // Not every index change is followed by playbackQueueChanged, but every load ends up here
+    m_queueModel->setCurrentIndex(m_currentQueueIndex);
+
     // Validate the track pointer is still valid before using it
     if (!track) {
         // Handle null track case - clear current track
         if (m_currentTrack) {
+            Mtoc::Track* previousTrack = m_currentTrack;
             m_currentTrack = nullptr;
             emit currentTrackChanged(nullptr);
             emit currentTrackLyricsChanged();
+            releaseTrack(previousTrack);
         }
         if (m_currentAlbum) {
             m_currentAlbum = nullptr;
@@ -2029,12 +2251,16 @@ void MediaPlayer::updateCurrentTrack(Mtoc::Track* track)
     }
     
     if (m_currentTrack != track) {
+        Mtoc::Track* previousTrack = m_currentTrack;
         m_currentTrack = track;
         emit currentTrackChanged(track);
         emit currentTrackLyricsChanged();
+        releaseTrack(previousTrack);
         
         // If we're not playing from an album queue, clear the current album
-        if (m_playbackQueue.isEmpty() || !m_playbackQueue.contains(track)) {
+        bool inQueue = m_currentQueueIndex >= 0 && m_currentQueueIndex < m_queueModel->size()
+                       && m_queueModel->at(m_currentQueueIndex).filePath == track->filePath();
+        if (!inQueue) {
             if (m_currentAlbum) {
                 m_currentAlbum = nullptr;
                 emit currentAlbumChanged(nullptr);
@@ -2048,10 +2274,7 @@ void MediaPlayer::onAboutToFinish()
     qDebug() << "[MediaPlayer::onAboutToFinish] Called - preparing next track for gapless playback";
     
     // Clear any previous pending track
-    m_pendingTrack = nullptr;
-    m_pendingQueueIndex = -1;
-    m_pendingVirtualIndex = -1;
-    m_pendingShuffleIndex = -1;
+    clearPendingTrack();
     
     // Check if there's a next track to queue
     if (!hasNext()) {
@@ -2116,19 +2339,19 @@ void MediaPlayer::onAboutToFinish()
         m_pendingShuffleIndex = getNextShuffleIndex();
         if (m_pendingShuffleIndex >= 0 && m_pendingShuffleIndex < m_shuffleOrder.size()) {
             m_pendingQueueIndex = m_shuffleOrder[m_pendingShuffleIndex];
-            if (m_pendingQueueIndex >= 0 && m_pendingQueueIndex < m_playbackQueue.size()) {
-                nextTrack = m_playbackQueue[m_pendingQueueIndex];
+            if (m_pendingQueueIndex >= 0 && m_pendingQueueIndex < m_queueModel->size()) {
+                nextTrack = materializeQueueTrack(m_pendingQueueIndex);
             }
         }
     } else {
         // Normal sequential playback
         m_pendingQueueIndex = m_currentQueueIndex + 1;
-        if (m_pendingQueueIndex < m_playbackQueue.size()) {
-            nextTrack = m_playbackQueue[m_pendingQueueIndex];
-        } else if (m_repeatEnabled && !m_playbackQueue.isEmpty()) {
+        if (m_pendingQueueIndex < m_queueModel->size()) {
+            nextTrack = materializeQueueTrack(m_pendingQueueIndex);
+        } else if (m_repeatEnabled && !m_queueModel->isEmpty()) {
             // Loop back to start if repeat is on
             m_pendingQueueIndex = 0;
-            nextTrack = m_playbackQueue[0];
+            nextTrack = materializeQueueTrack(0);
         }
     }
     
@@ -2141,6 +2364,7 @@ void MediaPlayer::onAboutToFinish()
         m_pendingTrack = nextTrack;
         
         // Queue the track in GStreamer for gapless playback
+        loadAnalysedGain(nextTrack->filePath());
         m_audioEngine->queueNextTrack(nextTrack->filePath());
     } else {
         qDebug() << "[MediaPlayer::onAboutToFinish] Failed to determine next track";
@@ -2184,15 +2408,12 @@ void MediaPlayer::handleTrackFinished()
         loadTrack(m_pendingTrack, true);
         
         // Clear pending state
-        m_pendingTrack = nullptr;
-        m_pendingQueueIndex = -1;
-        m_pendingVirtualIndex = -1;
-        m_pendingShuffleIndex = -1;
+        clearPendingTrack();
         return;
     }
     
     // Check if we should restart the queue (repeat mode with no next track)
-    if (!hasNext() && m_repeatEnabled && !m_playbackQueue.isEmpty()) {
+    if (!hasNext() && m_repeatEnabled && !m_queueModel->isEmpty()) {
         // Restart from the beginning
         if (m_isVirtualPlaylist && m_virtualPlaylist) {
             if (m_shuffleEnabled) {
@@ -2211,7 +2432,7 @@ void MediaPlayer::handleTrackFinished()
             } else {
                 m_currentQueueIndex = 0;
             }
-            loadTrack(m_playbackQueue[0], true);
+            loadTrack(materializeQueueTrack(0), true);
         }
     } else {
         // No more tracks and repeat is off, or queue is empty
@@ -2232,12 +2453,11 @@ void MediaPlayer::onTrackTransitioned()
 
     // Verify the pending track is still in the current queue
     // This prevents crashes when manual track selection interrupts gapless transition
-    if (!m_isVirtualPlaylist && !m_playbackQueue.contains(m_pendingTrack)) {
+    bool pendingInQueue = m_pendingQueueIndex >= 0 && m_pendingQueueIndex < m_queueModel->size()
+                          && m_queueModel->at(m_pendingQueueIndex).filePath == m_pendingTrack->filePath();
+    if (!m_isVirtualPlaylist && !pendingInQueue) {
         qDebug() << "[MediaPlayer::onTrackTransitioned] Pending track no longer in queue, clearing and ignoring";
-        m_pendingTrack = nullptr;
-        m_pendingQueueIndex = -1;
-        m_pendingVirtualIndex = -1;
-        m_pendingShuffleIndex = -1;
+        clearPendingTrack();
         return;
     }
 
@@ -2267,10 +2487,7 @@ void MediaPlayer::onTrackTransitioned()
     }
     
     // Clear pending track info before updating (to avoid potential re-entrancy issues)
-    m_pendingTrack = nullptr;
-    m_pendingQueueIndex = -1;
-    m_pendingVirtualIndex = -1;
-    m_pendingShuffleIndex = -1;
+    clearPendingTrack(trackToUpdate);
     
     // Update the current track to trigger UI updates (only if track is still valid)
     if (trackToUpdate) {
@@ -2281,8 +2498,98 @@ void MediaPlayer::onTrackTransitioned()
     emit playbackQueueChanged();
 }
 
+void MediaPlayer::syncClock(qint64 enginePosition)
+{
+    m_clock->update(enginePosition, m_audioEngine->state() == AudioEngine::State::Playing);
+}
+
+void MediaPlayer::updatePositionPolling()
+{
+    // Without a precision request the clock is corrected by the periodic state save
+    m_audioEngine->setPositionPollInterval(m_clock->precisionRequested() ? 1000 : 0);
+}
+
+QStringList MediaPlayer::upcomingTrackPaths(int count) const
+{
+    QStringList paths;
+    
+    if (m_isVirtualPlaylist && m_virtualPlaylist) {
+        const int total = m_virtualPlaylist->trackCount();
+        QVector<int> indices;
+        if (m_shuffleEnabled) {
+            indices = m_virtualPlaylist->getNextShuffleIndices(m_virtualCurrentIndex, count);
+        } else {
+            for (int i = 1; i <= count && total > 0; ++i) {
+                int index = m_virtualCurrentIndex + i;
+                if (index >= total) {
+                    if (!m_repeatEnabled) {
+                        break;
+                    }
+                    index %= total;
+                }
+                indices.append(index);
+            }
+        }
+        // Pages around the playback cursor are preloaded; don't fault in others for this
+        for (int index : indices) {
+            if (m_virtualPlaylist->isTrackLoaded(index)) {
+                paths.append(m_virtualPlaylist->getTrack(index).filePath);
+            }
+        }
+        return paths;
+    }
+    
+    const int size = m_queueModel->size();
+    if (m_shuffleEnabled) {
+        // A repeat reshuffles at the end, so there is nothing to predict past it
+        for (int i = m_shuffleIndex + 1; i < m_shuffleOrder.size() && paths.size() < count; ++i) {
+            const int index = m_shuffleOrder[i];
+            if (index >= 0 && index < size) {
+                paths.append(m_queueModel->at(index).filePath);
+            }
+        }
+    } else {
+        for (int i = 1; i <= count && size > 0; ++i) {
+            int index = m_currentQueueIndex + i;
+            if (index >= size) {
+                if (!m_repeatEnabled) {
+                    break;
+                }
+                index %= size;
+            }
+            paths.append(m_queueModel->at(index).filePath);
+        }
+    }
+    return paths;
+}
+
+void MediaPlayer::updatePrefetch()
+{
+    const QStringList upcoming = m_currentTrack ? upcomingTrackPaths(PREFETCH_TRACK_COUNT) : QStringList();
+    
+    // The standby pipeline (if enabled) prerolls the most likely next track;
+    // a queue change that moves it elsewhere re-targets or clears it here
+    if (m_settingsManager && m_settingsManager->warmStandby()) {
+        loadAnalysedGain(upcoming.value(0));
+    }
+    m_audioEngine->prepareStandby(upcoming.value(0));
+    
+    // Their seek bar waveforms are decoded ahead of the library-wide pass
+    if (m_libraryManager && m_libraryManager->waveformService()) {
+        m_libraryManager->waveformService()->prefetch(upcoming);
+    }
+    
+    if (upcoming.isEmpty() || m_prefetcher->budget() == 0) {
+        m_prefetcher->cancel();
+        return;
+    }
+    m_prefetcher->prefetch(upcoming);
+}
+
 void MediaPlayer::onEngineStateChanged(AudioEngine::State state)
 {
+    syncClock(m_audioEngine->position());
+    
     State newState = StoppedState;
     
     switch (state) {
@@ -2325,8 +2632,8 @@ void MediaPlayer::onEngineStateChanged(AudioEngine::State state)
 
 void MediaPlayer::saveState()
 {
-    if (!m_libraryManager || !m_currentTrack) {
-        qDebug() << "MediaPlayer::saveState - no current track or library manager";
+    if (!m_currentTrack) {
+        qDebug() << "MediaPlayer::saveState - no current track";
         return;
     }
     
@@ -2341,6 +2648,11 @@ void MediaPlayer::saveState()
         virtualPlaylistInfo["virtualTrackIndex"] = m_virtualCurrentIndex;
         virtualPlaylistInfo["virtualShuffleIndex"] = m_virtualShuffleIndex;
         virtualPlaylistInfo["shuffleEnabled"] = m_shuffleEnabled;
+        if (m_shuffleEnabled && m_virtualPlaylist->hasShuffleOrder()) {
+            // The shuffle order is derived from the seed, so this is enough to restore it exactly
+            virtualPlaylistInfo["virtualShuffleSeed"] = QString::number(m_virtualPlaylist->shuffleSeed());
+            virtualPlaylistInfo["virtualShuffleFirst"] = m_virtualPlaylist->shuffleFirstIndex();
+        }
         
         // Save track metadata to avoid "Unknown Track" on restore
         virtualPlaylistInfo["trackTitle"] = m_currentTrack->title();
@@ -2358,7 +2670,7 @@ void MediaPlayer::saveState()
         if (m_currentAlbum) {
             albumArtist = m_currentAlbum->artist();
             albumTitle = m_currentAlbum->title();
-        } else if (!m_playbackQueue.isEmpty() && m_currentQueueIndex >= 0) {
+        } else if (!m_queueModel->isEmpty() && m_currentQueueIndex >= 0) {
             // We're playing from a queue but don't have album object
             // Try to get album info from the current track
             albumArtist = m_currentTrack->albumArtist();
@@ -2372,43 +2684,121 @@ void MediaPlayer::saveState()
     // Get the duration
     qint64 trackDuration = duration(); // This already handles both track and engine duration
     
-    // Prepare queue data if queue is modified or playing a playlist
-    QVariantList queueData;
-    if ((m_isQueueModified || !m_currentPlaylistName.isEmpty()) && !m_playbackQueue.isEmpty()) {
-        for (Mtoc::Track* track : m_playbackQueue) {
-            if (track) {
-                QVariantMap trackMap;
-                trackMap["id"] = track->id();
-                trackMap["filePath"] = track->filePath();
-                trackMap["title"] = track->title();
-                trackMap["artist"] = track->artist();
-                trackMap["album"] = track->album();
-                trackMap["albumArtist"] = track->albumArtist();
-                trackMap["trackNumber"] = track->trackNumber();
-                trackMap["duration"] = track->duration();
-                trackMap["lyrics"] = track->lyrics();
-                trackMap["isFavorite"] = track->isFavorite();
-                queueData.append(trackMap);
-            }
-        }
-    }
-    
-    // Add playlist info if playing a playlist
-    QVariantMap playlistInfo;
+    // The queue itself is already in the journal; only track and source info go here
+    QVariantMap info = virtualPlaylistInfo;
+    info["filePath"] = filePath;
+    info["duration"] = trackDuration;
+    info["albumArtist"] = albumArtist;
+    info["albumTitle"] = albumTitle;
+    info["trackIndex"] = trackIndex;
+    info["queueModified"] = m_isQueueModified || !m_currentPlaylistName.isEmpty();
     if (!m_currentPlaylistName.isEmpty()) {
-        playlistInfo["playlistName"] = m_currentPlaylistName;
+        info["playlistName"] = m_currentPlaylistName;
     }
     
-    // Save the state
-    m_libraryManager->savePlaybackState(filePath, currentPosition, 
-                                        albumArtist, albumTitle, trackIndex, trackDuration,
-                                        m_isQueueModified || !m_currentPlaylistName.isEmpty(), 
-                                        queueData, virtualPlaylistInfo, playlistInfo);
+    // Unchanged info is skipped, so while playing this is usually just a position record
+    m_stateJournal->setInfo(info);
+    m_stateJournal->setPosition(currentPosition);
+    
+    // Sync to disk whenever playback stops moving
+    if (m_state != PlayingState) {
+        m_stateJournal->checkpoint();
+    }
     
     // qDebug() << "MediaPlayer::saveState - saved state for track:" << m_currentTrack->title()
     //         << "position:" << currentPosition << "ms"
     //         << "queueModified:" << m_isQueueModified
-    //         << "queueSize:" << queueData.size();
+    //         << "queueSize:" << m_queueModel->size();
+}
+
+QVariantMap MediaPlayer::loadSavedState(QList<Mtoc::QueueEntry>* queue)
+{
+    Mtoc::PlaybackStateJournal::State saved;
+    if (!m_stateJournal->load(&saved)) {
+        // Carry over state saved to QSettings by versions before the journal
+        QVariantMap legacyState = m_libraryManager->loadPlaybackState();
+        if (!legacyState.isEmpty()) {
+            qDebug() << "MediaPlayer::loadSavedState - migrating playback state from settings";
+            m_libraryManager->clearPlaybackState();
+            *queue = Mtoc::QueueEntry::fromMetadataList(legacyState.value("queue").toList());
+        }
+        return legacyState;
+    }
+    
+    QVariantMap state = saved.info;
+    QString filePath = state.value("filePath").toString();
+    if (filePath.isEmpty()) {
+        return QVariantMap();
+    }
+    if (!QFileInfo::exists(filePath)) {
+        qDebug() << "MediaPlayer::loadSavedState - saved track no longer exists:" << filePath;
+        m_stateJournal->clear();
+        return QVariantMap();
+    }
+    
+    state["position"] = saved.position;
+    state["savedTime"] = saved.savedTime;
+    
+    auto db = m_libraryManager->databaseManager();
+    if (state.value("queueModified").toBool() && db) {
+        // Only ids and paths are journaled; the rest comes from the library in
+        // one lookup by id, then one by path for ids that went stale
+        QList<int> ids;
+        ids.reserve(saved.queue.size());
+        for (const Mtoc::PlaybackStateJournal::Entry& entry : saved.queue) {
+            ids.append(entry.id);
+        }
+        QList<Mtoc::ResolvedTrack> tracks = db->resolveTracksById(ids);
+        
+        QList<int> staleRows;
+        QStringList stalePaths;
+        for (int i = 0; i < tracks.size(); ++i) {
+            if (tracks.at(i).filePath != saved.queue.at(i).filePath) {
+                staleRows.append(i);
+                stalePaths.append(saved.queue.at(i).filePath);
+            }
+        }
+        if (!stalePaths.isEmpty()) {
+            QList<Mtoc::ResolvedTrack> byPath = db->resolveTracksByPath(stalePaths);
+            for (int i = 0; i < staleRows.size(); ++i) {
+                tracks[staleRows.at(i)] = byPath.at(i);
+            }
+        }
+        
+        // Files outside the library (e.g. from a playlist) come back with just
+        // their name. Only the current file is checked up front; on a network
+        // share statting every entry would hold up startup, and a file that
+        // has gone fails when it is played instead.
+        for (int i = 0; i < tracks.size(); ++i) {
+            Mtoc::ResolvedTrack &track = tracks[i];
+            if (!track.isValid()) {
+                track.filePath = saved.queue.at(i).filePath;
+                track.title = QFileInfo(track.filePath).completeBaseName();
+            }
+        }
+        
+        // Rows map one to one onto the saved queue, so trackIndex still holds;
+        // it only needs finding again if the journal disagrees with itself
+        int trackIndex = state.value("trackIndex").toInt();
+        if (trackIndex < 0 || trackIndex >= tracks.size() || tracks.at(trackIndex).filePath != filePath) {
+            trackIndex = -1;
+            for (int i = 0; i < tracks.size(); ++i) {
+                if (tracks.at(i).filePath == filePath) {
+                    trackIndex = i;
+                    break;
+                }
+            }
+            if (trackIndex < 0) {
+                qDebug() << "MediaPlayer::loadSavedState - saved track is not in the saved queue";
+                m_stateJournal->clear();
+                return QVariantMap();
+            }
+            state["trackIndex"] = trackIndex;
+        }
+        *queue = Mtoc::QueueEntry::fromResolvedTracks(tracks);
+    }
+    
+    return state;
 }
 
 void MediaPlayer::restoreState()
@@ -2442,7 +2832,8 @@ void MediaPlayer::restoreState()
         return;
     }
     
-    QVariantMap state = m_libraryManager->loadPlaybackState();
+    QList<Mtoc::QueueEntry> savedQueue;
+    QVariantMap state = loadSavedState(&savedQueue);
     if (state.isEmpty()) {
         qDebug() << "MediaPlayer::restoreState - no saved state found";
         clearRestorationState();
@@ -2456,7 +2847,6 @@ void MediaPlayer::restoreState()
     QString albumTitle = state["albumTitle"].toString();
     int trackIndex = state["trackIndex"].toInt();
     bool queueModified = state["queueModified"].toBool();
-    QVariantList queueData = state["queue"].toList();
     
     // Check for virtual playlist info
     bool isVirtualPlaylist = state["isVirtualPlaylist"].toBool();
@@ -2470,7 +2860,7 @@ void MediaPlayer::restoreState()
     //          << "album:" << albumArtist << "-" << albumTitle
     //          << "index:" << trackIndex
     //          << "queueModified:" << queueModified
-    //          << "queueSize:" << queueData.size();
+    //          << "queueSize:" << savedQueue.size();
     
     // Validate file exists before attempting restoration
     QFileInfo fileInfo(filePath);
@@ -2513,16 +2903,29 @@ void MediaPlayer::restoreState()
                         setShuffleEnabled(true);
                     }
                     
-                    // Generate shuffle order with the saved track first
-                    m_virtualPlaylist->generateShuffleOrder(virtualTrackIndex);
-                    m_virtualShuffleIndex = 0; // Saved track is now at position 0
+                    // Rebuild the saved shuffle order from its seed when available
+                    bool seedOk = false;
+                    quint64 shuffleSeed = state["virtualShuffleSeed"].toString().toULongLong(&seedOk);
+                    bool restored = false;
+                    if (seedOk) {
+                        m_virtualPlaylist->restoreShuffleOrder(shuffleSeed, state.value("virtualShuffleFirst", -1).toInt());
+                        restored = m_virtualPlaylist->getShuffledIndex(virtualShuffleIndex) == virtualTrackIndex;
+                        if (!restored) {
+                            qDebug() << "MediaPlayer::restoreState - Saved shuffle order no longer matches library, regenerating";
+                        }
+                    }
+                    
+                    if (restored) {
+                        m_virtualShuffleIndex = virtualShuffleIndex;
+                    } else {
+                        // Generate shuffle order with the saved track first
+                        m_virtualPlaylist->generateShuffleOrder(virtualTrackIndex);
+                        m_virtualShuffleIndex = 0; // Saved track is now at position 0
+                    }
                 }
                 
                 // Set the virtual indices
                 m_virtualCurrentIndex = virtualTrackIndex;
-                if (savedShuffleEnabled) {
-                    m_virtualShuffleIndex = 0; // Already set above
-                }
                 
                 // Create a proper track object with saved metadata
                 Mtoc::Track* track = m_libraryManager->trackByPath(filePath);
@@ -2565,7 +2968,7 @@ void MediaPlayer::restoreState()
         
         // Check if we have a modified queue first (even if from a playlist)
         QString playlistName = state["playlistName"].toString();
-        if (queueModified && !queueData.isEmpty()) {
+        if (queueModified && !savedQueue.isEmpty()) {
             qDebug() << "MediaPlayer::restoreState - Restoring modified queue";
             
             // Clear current queue and restore from saved data
@@ -2580,27 +2983,13 @@ void MediaPlayer::restoreState()
             }
             
             // Build the queue from saved data
-            for (const auto& trackData : queueData) {
-                auto trackMap = trackData.toMap();
-                QString title = trackMap.value("title").toString();
-                QString trackFilePath = trackMap.value("filePath").toString();
-                
-                if (trackFilePath.isEmpty()) {
-                    qWarning() << "Empty filePath for track:" << title;
-                    continue;
-                }
-                
-                // Create a new Track object from the data
-                Mtoc::Track* track = Mtoc::Track::fromMetadata(trackMap, this);
-                
-                m_playbackQueue.append(track);
-            }
+            m_queueModel->append(savedQueue);
             
             // Restore the modified flag
             setQueueModified(true);
             
             // Set the current queue index
-            if (trackIndex >= 0 && trackIndex < m_playbackQueue.size()) {
+            if (trackIndex >= 0 && trackIndex < m_queueModel->size()) {
                 m_currentQueueIndex = trackIndex;
                 
                 // Generate shuffle order if shuffle is enabled
@@ -2632,7 +3021,7 @@ void MediaPlayer::restoreState()
                 });
                 
                 // Load the track WITHOUT auto-playing (false parameter)
-                Mtoc::Track* trackToRestore = m_playbackQueue[m_currentQueueIndex];
+                Mtoc::Track* trackToRestore = materializeQueueTrack(m_currentQueueIndex);
                 loadTrack(trackToRestore, false);
             } else {
                 qWarning() << "MediaPlayer::restoreState - Invalid track index for modified queue";
@@ -2666,29 +3055,15 @@ void MediaPlayer::restoreState()
             }
             
             // Build tracks from data and add to queue
-            for (const auto& trackData : trackList) {
-                auto trackMap = trackData.toMap();
-                QString trackTitle = trackMap.value("title").toString();
-                QString trackFilePath = trackMap.value("filePath").toString();
-                
-                if (trackFilePath.isEmpty()) {
-                    qWarning() << "Empty filePath for track:" << trackTitle;
-                    continue;
-                }
-                
-                // Create a new Track object from the data
-                Mtoc::Track* track = Mtoc::Track::fromMetadata(trackMap, this);
-                
-                m_playbackQueue.append(track);
-            }
+            m_queueModel->append(Mtoc::QueueEntry::fromMetadataList(trackList));
             
             // Clear the queue modified flag since this is a restored playlist
             setQueueModified(false);
             
             // Ensure trackIndex is within bounds
-            trackIndex = qBound(0, trackIndex, m_playbackQueue.size() - 1);
+            trackIndex = qBound(0, trackIndex, m_queueModel->size() - 1);
             
-            if (!m_playbackQueue.isEmpty()) {
+            if (!m_queueModel->isEmpty()) {
                 m_currentQueueIndex = trackIndex;
                 
                 // Generate shuffle order if shuffle is enabled
@@ -2720,7 +3095,7 @@ void MediaPlayer::restoreState()
                 });
                 
                 // Load the track WITHOUT auto-playing (false parameter)
-                loadTrack(m_playbackQueue[trackIndex], false);
+                loadTrack(materializeQueueTrack(trackIndex), false);
             }
             
             return; // Don't continue to other restoration paths
@@ -2743,6 +3118,8 @@ void MediaPlayer::restoreState()
 void MediaPlayer::periodicStateSave()
 {
     if (m_state == PlayingState) {
+        // Also catches the clock drifting from the pipeline
+        syncClock(m_audioEngine->position());
         saveState();
     }
 }
@@ -2778,25 +3155,11 @@ void MediaPlayer::restoreAlbumByName(const QString& artist, const QString& title
         }
         
         // Build the queue from track data
-        for (const auto& trackData : trackList) {
-            auto trackMap = trackData.toMap();
-            QString title = trackMap.value("title").toString();
-            QString filePath = trackMap.value("filePath").toString();
-            
-            if (filePath.isEmpty()) {
-                qWarning() << "Empty filePath for track:" << title;
-                continue;
-            }
-            
-            // Create a new Track object from the data
-            Mtoc::Track* track = Mtoc::Track::fromMetadata(trackMap, this);
-
-            m_playbackQueue.append(track);
-        }
+        m_queueModel->append(Mtoc::QueueEntry::fromMetadataList(trackList));
         
-        qDebug() << "Built queue with" << m_playbackQueue.size() << "tracks";
+        qDebug() << "Built queue with" << m_queueModel->size() << "tracks";
         
-        if (!m_playbackQueue.isEmpty() && trackIndex < m_playbackQueue.size()) {
+        if (!m_queueModel->isEmpty() && trackIndex < m_queueModel->size()) {
             m_currentQueueIndex = trackIndex;
             
             // Generate shuffle order if shuffle is enabled
@@ -2830,7 +3193,7 @@ void MediaPlayer::restoreAlbumByName(const QString& artist, const QString& title
             });
             
             // Load track without auto-playing
-            loadTrack(m_playbackQueue[trackIndex], false);
+            loadTrack(materializeQueueTrack(trackIndex), false);
         }
     } else {
         qWarning() << "No tracks found for album:" << artist << "-" << title;
@@ -2856,10 +3219,7 @@ void MediaPlayer::restoreTrackFromData(const QString& filePath, qint64 position,
     trackMap["filePath"] = filePath;
     trackMap["title"] = QFileInfo(filePath).baseName(); // Fallback title
     trackMap["duration"] = duration / 1000; // Convert ms to seconds
-    Mtoc::Track* track = Mtoc::Track::fromMetadata(trackMap, this);
-    
-    // Add to queue so it gets cleaned up properly
-    m_playbackQueue.append(track);
+    m_queueModel->append(Mtoc::QueueEntry::fromMetadata(trackMap));
     m_currentQueueIndex = 0;
     
     // Generate shuffle order if shuffle is enabled (even for single track)
@@ -3000,7 +3360,7 @@ void MediaPlayer::updateShuffleOrder()
     
     // Regular queue handling
     // Only update if shuffle is enabled and we have tracks
-    if (m_shuffleEnabled && !m_playbackQueue.isEmpty()) {
+    if (m_shuffleEnabled && !m_queueModel->isEmpty()) {
         // Preserve the played portion of the shuffle order
         QList<int> playedTracks;
         QList<int> unplayedTracks;
@@ -3008,14 +3368,14 @@ void MediaPlayer::updateShuffleOrder()
         // Save already played tracks (up to current position)
         if (m_shuffleIndex >= 0 && m_shuffleIndex < m_shuffleOrder.size()) {
             for (int i = 0; i <= m_shuffleIndex; i++) {
-                if (m_shuffleOrder[i] < m_playbackQueue.size()) {
+                if (m_shuffleOrder[i] < m_queueModel->size()) {
                     playedTracks.append(m_shuffleOrder[i]);
                 }
             }
         }
         
         // Find all tracks that haven't been played yet
-        for (int i = 0; i < m_playbackQueue.size(); i++) {
+        for (int i = 0; i < m_queueModel->size(); i++) {
             if (!playedTracks.contains(i)) {
                 unplayedTracks.append(i);
             }
@@ -3063,13 +3423,13 @@ void MediaPlayer::generateShuffleOrder(bool putCurrentTrackFirst)
     }
     
     // Regular queue handling
-    if (m_playbackQueue.isEmpty()) {
+    if (m_queueModel->isEmpty()) {
         m_shuffleIndex = -1;
         return;
     }
     
     // Create list of all indices
-    for (int i = 0; i < m_playbackQueue.size(); ++i) {
+    for (int i = 0; i < m_queueModel->size(); ++i) {
         m_shuffleOrder.append(i);
     }
     
@@ -3079,7 +3439,7 @@ void MediaPlayer::generateShuffleOrder(bool putCurrentTrackFirst)
     std::shuffle(m_shuffleOrder.begin(), m_shuffleOrder.end(), gen);
     
     // If requested and we have a current track, move it to the beginning
-    if (putCurrentTrackFirst && m_currentQueueIndex >= 0 && m_currentQueueIndex < m_playbackQueue.size()) {
+    if (putCurrentTrackFirst && m_currentQueueIndex >= 0 && m_currentQueueIndex < m_queueModel->size()) {
         // Find and remove the current track from wherever it is in the shuffle
         int currentPos = m_shuffleOrder.indexOf(m_currentQueueIndex);
         if (currentPos > 0) {
@@ -3276,8 +3636,8 @@ void MediaPlayer::loadVirtualPlaylistNext(Mtoc::VirtualPlaylistModel* model)
         return;
     }
     
-    // Clear undo queue when adding new items
-    clearUndoQueue();
+    // Adding items is undoable
+    recordQueueChange();
     
     qDebug() << "MediaPlayer::loadVirtualPlaylistNext called";
     
@@ -3295,7 +3655,7 @@ void MediaPlayer::loadVirtualPlaylistNext(Mtoc::VirtualPlaylistModel* model)
         
         // Add current track to regular queue if it exists
         if (currentTrack) {
-            m_playbackQueue.append(currentTrack);
+            m_queueModel->append(Mtoc::QueueEntry::fromTrack(currentTrack));
             m_currentQueueIndex = 0;
         }
     }
@@ -3305,20 +3665,15 @@ void MediaPlayer::loadVirtualPlaylistNext(Mtoc::VirtualPlaylistModel* model)
     int insertIndex = m_currentQueueIndex + 1;
     int trackCount = vPlaylist->trackCount();
     
-    // We need to create Track objects from the virtual playlist data
+    QList<Mtoc::QueueEntry> entries;
+    entries.reserve(trackCount);
     for (int i = 0; i < trackCount; ++i) {
-        auto trackData = vPlaylist->getTrackVariant(i);
-        if (!trackData.isEmpty()) {
-            QString title = trackData.value("title").toString();
-            QString filePath = trackData.value("filePath").toString();
-            
-            if (!filePath.isEmpty()) {
-                Mtoc::Track* track = Mtoc::Track::fromMetadata(trackData, this);
-                
-                m_playbackQueue.insert(insertIndex++, track);
-            }
+        Mtoc::QueueEntry entry = Mtoc::QueueEntry::fromVirtualTrack(vPlaylist->getTrack(i));
+        if (entry.isValid()) {
+            entries.append(entry);
         }
     }
+    m_queueModel->insert(insertIndex, entries);
     
     // Mark queue as modified
     setQueueModified(true);
@@ -3326,9 +3681,9 @@ void MediaPlayer::loadVirtualPlaylistNext(Mtoc::VirtualPlaylistModel* model)
     emit playbackQueueChanged();
     
     // If nothing is playing, start playback
-    if (m_currentQueueIndex < 0 && !m_playbackQueue.isEmpty()) {
+    if (m_currentQueueIndex < 0 && !m_queueModel->isEmpty()) {
         m_currentQueueIndex = 0;
-        playTrack(m_playbackQueue[0]);
+        playTrack(materializeQueueTrack(0));
     }
 }
 
@@ -3339,8 +3694,8 @@ void MediaPlayer::loadVirtualPlaylistLast(Mtoc::VirtualPlaylistModel* model)
         return;
     }
     
-    // Clear undo queue when adding new items
-    clearUndoQueue();
+    // Adding items is undoable
+    recordQueueChange();
     
     qDebug() << "MediaPlayer::loadVirtualPlaylistLast called";
     
@@ -3358,7 +3713,7 @@ void MediaPlayer::loadVirtualPlaylistLast(Mtoc::VirtualPlaylistModel* model)
         
         // Add current track to regular queue if it exists
         if (currentTrack) {
-            m_playbackQueue.append(currentTrack);
+            m_queueModel->append(Mtoc::QueueEntry::fromTrack(currentTrack));
             m_currentQueueIndex = 0;
         }
     }
@@ -3367,20 +3722,15 @@ void MediaPlayer::loadVirtualPlaylistLast(Mtoc::VirtualPlaylistModel* model)
     Mtoc::VirtualPlaylist* vPlaylist = model->virtualPlaylist();
     int trackCount = vPlaylist->trackCount();
     
-    // We need to create Track objects from the virtual playlist data
+    QList<Mtoc::QueueEntry> entries;
+    entries.reserve(trackCount);
     for (int i = 0; i < trackCount; ++i) {
-        auto trackData = vPlaylist->getTrackVariant(i);
-        if (!trackData.isEmpty()) {
-            QString title = trackData.value("title").toString();
-            QString filePath = trackData.value("filePath").toString();
-            
-            if (!filePath.isEmpty()) {
-                Mtoc::Track* track = Mtoc::Track::fromMetadata(trackData, this);
-                
-                m_playbackQueue.append(track);
-            }
+        Mtoc::QueueEntry entry = Mtoc::QueueEntry::fromVirtualTrack(vPlaylist->getTrack(i));
+        if (entry.isValid()) {
+            entries.append(entry);
         }
     }
+    m_queueModel->append(entries);
     
     // Mark queue as modified
     setQueueModified(true);
@@ -3388,9 +3738,9 @@ void MediaPlayer::loadVirtualPlaylistLast(Mtoc::VirtualPlaylistModel* model)
     emit playbackQueueChanged();
     
     // If nothing is playing, start playback
-    if (m_currentQueueIndex < 0 && !m_playbackQueue.isEmpty()) {
+    if (m_currentQueueIndex < 0 && !m_queueModel->isEmpty()) {
         m_currentQueueIndex = 0;
-        playTrack(m_playbackQueue[0]);
+        playTrack(materializeQueueTrack(0));
     }
 }
 
@@ -3413,6 +3763,9 @@ void MediaPlayer::preloadVirtualTracks(int centerIndex)
     qDebug() << "[MediaPlayer::preloadVirtualTracks] Center index:" << centerIndex 
              << "shuffle enabled:" << m_shuffleEnabled;
     
+    // Keep the rows around the playing track resident in the page store
+    m_virtualPlaylist->setPlaybackCursor(centerIndex);
+    
     if (m_shuffleEnabled) {
         // For shuffle mode, preload the next/previous tracks in shuffle order
         QVector<int> nextTracks = m_virtualPlaylist->getNextShuffleIndices(centerIndex, 2);  // Reduced from 3
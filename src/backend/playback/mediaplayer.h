@@ -6,8 +6,15 @@
 #include <QUrl>
 #include <QTimer>
 #include <QPointer>
+#include <QElapsedTimer>
 #include <memory>
 #include "audioengine.h"
+#include "queueentry.h"
+#include "queuelistmodel.h"
+#include "playbackstatejournal.h"
+#include "playbackclock.h"
+#include "trackprefetcher.h"
+#include "playbackdiagnostics.h"
 
 namespace Mtoc {
 class Track;
@@ -32,11 +39,16 @@ class MediaPlayer : public QObject
     Q_PROPERTY(qint64 savedPosition READ savedPosition NOTIFY savedPositionChanged)
     Q_PROPERTY(bool isReady READ isReady NOTIFY readyChanged)
     Q_PROPERTY(QVariantList queue READ queue NOTIFY playbackQueueChanged)
+    Q_PROPERTY(Mtoc::QueueListModel* queueModel READ queueModel CONSTANT)
+    Q_PROPERTY(Mtoc::PlaybackClock* clock READ clock CONSTANT)
+    Q_PROPERTY(Mtoc::PlaybackDiagnostics* diagnostics READ diagnostics CONSTANT)
     Q_PROPERTY(int queueLength READ queueLength NOTIFY playbackQueueChanged)
     Q_PROPERTY(int currentQueueIndex READ currentQueueIndex NOTIFY playbackQueueChanged)
     Q_PROPERTY(int totalQueueDuration READ totalQueueDuration NOTIFY playbackQueueChanged)
     Q_PROPERTY(bool isQueueModified READ isQueueModified NOTIFY queueModifiedChanged)
     Q_PROPERTY(bool canUndoClear READ canUndoClear NOTIFY canUndoClearChanged)
+    Q_PROPERTY(bool canUndoQueueChange READ canUndoQueueChange NOTIFY queueHistoryChanged)
+    Q_PROPERTY(bool canRedoQueueChange READ canRedoQueueChange NOTIFY queueHistoryChanged)
     Q_PROPERTY(bool repeatEnabled READ repeatEnabled WRITE setRepeatEnabled NOTIFY repeatEnabledChanged)
     Q_PROPERTY(bool shuffleEnabled READ shuffleEnabled WRITE setShuffleEnabled NOTIFY shuffleEnabledChanged)
     Q_PROPERTY(bool isPlayingVirtualPlaylist READ isPlayingVirtualPlaylist NOTIFY playbackQueueChanged)
@@ -46,6 +58,7 @@ class MediaPlayer : public QObject
     Q_PROPERTY(QString queueSourceAlbumArtist READ queueSourceAlbumArtist NOTIFY queueSourceAlbumArtistChanged)
     Q_PROPERTY(QString currentTrackLyrics READ currentTrackLyrics NOTIFY currentTrackLyricsChanged)
     Q_PROPERTY(bool hasCurrentTrackLyrics READ hasCurrentTrackLyrics NOTIFY currentTrackLyricsChanged)
+    Q_PROPERTY(QVariantMap skipLatency READ skipLatency NOTIFY skipLatencyChanged)
 
 public:
     enum State {
@@ -73,11 +86,19 @@ public:
     qint64 savedPosition() const { return m_savedPosition; }
     bool isReady() const { return m_isReady; }
     QVariantList queue() const;
+    Mtoc::QueueListModel* queueModel() const { return m_queueModel; }
+    Mtoc::PlaybackClock* clock() const { return m_clock; }
+    Mtoc::PlaybackDiagnostics* diagnostics() const { return m_audioEngine->diagnostics(); }
+    // Load-to-audio times, split by cold, read-ahead and standby starts
+    QVariantMap skipLatency() const { return m_prefetcher->latencyStats(); }
     int queueLength() const;
     int currentQueueIndex() const;
     int totalQueueDuration() const;
     bool isQueueModified() const { return m_isQueueModified; }
-    bool canUndoClear() const { return !m_undoQueue.isEmpty(); }
+    // True when the most recent undoable queue change was a clear
+    bool canUndoClear() const { return !m_queueUndoStack.isEmpty() && m_queueUndoStack.last().clearedQueue; }
+    bool canUndoQueueChange() const { return !m_queueUndoStack.isEmpty(); }
+    bool canRedoQueueChange() const { return !m_queueRedoStack.isEmpty(); }
     bool repeatEnabled() const { return m_repeatEnabled; }
     bool shuffleEnabled() const { return m_shuffleEnabled; }
     bool isPlayingVirtualPlaylist() const { return m_isVirtualPlaylist; }
@@ -120,6 +141,8 @@ public slots:
     void clearQueue();
     Q_INVOKABLE void clearQueueForUndo();
     Q_INVOKABLE void undoClearQueue();
+    Q_INVOKABLE void undoQueueChange();
+    Q_INVOKABLE void redoQueueChange();
     
     // Virtual playlist support
     Q_INVOKABLE void loadVirtualPlaylist(Mtoc::VirtualPlaylistModel* model);
@@ -138,6 +161,7 @@ public slots:
 signals:
     void stateChanged(MediaPlayer::State state);
     void positionChanged(qint64 position);
+    void seeked(qint64 position);  // Only for seeks, not for the jump to a new track
     void durationChanged(qint64 duration);
     void volumeChanged(float volume);
     void currentTrackChanged(Mtoc::Track* track);
@@ -149,6 +173,7 @@ signals:
     void readyChanged(bool ready);
     void queueModifiedChanged(bool modified);
     void canUndoClearChanged(bool canUndo);
+    void queueHistoryChanged();
     void repeatEnabledChanged(bool enabled);
     void shuffleEnabledChanged(bool enabled);
     void virtualPlaylistNameChanged(const QString& name);
@@ -156,6 +181,7 @@ signals:
     void queueSourceAlbumNameChanged(const QString& name);
     void queueSourceAlbumArtistChanged(const QString& artist);
     void currentTrackLyricsChanged();
+    void skipLatencyChanged();
 
 private slots:
     void periodicStateSave();
@@ -167,10 +193,18 @@ private slots:
 private:
     void setupConnections();
     void applyReplayGainSettings();
+    void applyEqualizerSettings();
+    void loadAnalysedGain(const QString &filePath);
+    void applyReadAheadSettings();
     void updateCurrentTrack(Mtoc::Track* track);
     void playNextInQueue();
     void handleTrackFinished();
     void onEngineStateChanged(AudioEngine::State state);
+    void syncClock(qint64 enginePosition);
+    void updatePositionPolling();
+    // The next tracks in play order, without loading anything from the database
+    QStringList upcomingTrackPaths(int count) const;
+    void updatePrefetch();
     static QString getDebugLogPath();
     void loadTrack(Mtoc::Track* track, bool autoPlay = true);
     void restoreAlbumByName(const QString& artist, const QString& title, int trackIndex, qint64 position);
@@ -180,17 +214,31 @@ private:
     void checkPositionSync();
     void setReady(bool ready);
     void setQueueModified(bool modified);
-    void clearUndoQueue();
+    void clearQueueHistory();
+    // Queue entries only get a Track object while they are current or pending
+    Mtoc::Track* materializeQueueTrack(int index);
+    void releaseTrack(Mtoc::Track* track);
+    void clearPendingTrack(Mtoc::Track* keep = nullptr);
+    // Reads the journal, or the QSettings state written by older versions; the
+    // saved queue, if any, is resolved against the library into queue
+    QVariantMap loadSavedState(QList<Mtoc::QueueEntry>* queue);
     
     std::unique_ptr<AudioEngine> m_audioEngine;
     QPointer<Mtoc::Track> m_currentTrack;
     Mtoc::Album* m_currentAlbum = nullptr;
-    QList<Mtoc::Track*> m_playbackQueue;
+    Mtoc::QueueListModel* m_queueModel = nullptr;
+    Mtoc::PlaybackClock* m_clock = nullptr;
     int m_currentQueueIndex = -1;
     State m_state = StoppedState;
     Mtoc::LibraryManager* m_libraryManager = nullptr;
     SettingsManager* m_settingsManager = nullptr;
     QTimer* m_saveStateTimer = nullptr;
+    std::unique_ptr<Mtoc::PlaybackStateJournal> m_stateJournal;
+    Mtoc::TrackPrefetcher* m_prefetcher = nullptr;
+    QTimer* m_prefetchTimer = nullptr;
+    QElapsedTimer m_startLatencyTimer;
+    Mtoc::TrackPrefetcher::StartKind m_startKind = Mtoc::TrackPrefetcher::ColdStart;
+    static const int PREFETCH_TRACK_COUNT = 3;
     QTimer* m_loadTimeoutTimer = nullptr;
     bool m_restoringState = false;
     qint64 m_savedPosition = 0;
@@ -199,14 +247,25 @@ private:
     QMetaObject::Connection m_restoreConnection;
     bool m_isQueueModified = false;
     
-    // Undo functionality
-    QList<Mtoc::Track*> m_undoQueue;
-    int m_undoQueueIndex = -1;
-    Mtoc::Track* m_undoCurrentTrack = nullptr;
-    bool m_undoQueueModified = false;
-    QString m_undoQueueSourceAlbumName;
-    QString m_undoQueueSourceAlbumArtist;
-    QString m_undoCurrentPlaylistName;
+    // Undo/redo of queue edits. Each step keeps the whole queue as it was, which
+    // is cheap because QueueSequence copies share all unchanged chunks.
+    struct QueueState {
+        Mtoc::QueueSequence entries;
+        int currentIndex = -1;
+        bool modified = false;
+        QString sourceAlbumName;
+        QString sourceAlbumArtist;
+        QString playlistName;
+        bool clearedQueue = false;  // The step this state undoes was a clear
+    };
+    QueueState captureQueueState() const;
+    void restoreQueueState(const QueueState& state);
+    // Call before an undoable edit; drops the redo history
+    void recordQueueChange(bool clearsQueue = false);
+    void emitQueueHistoryChanged();
+    QList<QueueState> m_queueUndoStack;
+    QList<QueueState> m_queueRedoStack;
+    static const int MAX_QUEUE_HISTORY = 50;
     
     // Repeat and shuffle
     bool m_repeatEnabled = false;
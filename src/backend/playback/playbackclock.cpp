@@ -0,0 +1,73 @@
+#include "playbackclock.h"
+
+#include <QDebug>
+
+namespace Mtoc {
+
+namespace {
+
+// Readings this close to the interpolated position are jitter, not drift
+const qint64 DRIFT_TOLERANCE_MS = 40;
+const qint64 JUMP_THRESHOLD_MS = 1000;
+
+} // namespace
+
+PlaybackClock::PlaybackClock(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.start();
+}
+
+qint64 PlaybackClock::now() const
+{
+    return m_timer.elapsed();
+}
+
+qint64 PlaybackClock::position() const
+{
+    if (!m_running) {
+        return m_basePosition;
+    }
+    return m_basePosition + qint64((now() - m_baseTime) * m_rate);
+}
+
+bool PlaybackClock::update(qint64 position, bool running, double rate)
+{
+    position = qMax<qint64>(0, position);
+    qint64 expected = this->position();
+
+    if (running == m_running && rate == m_rate && qAbs(position - expected) <= DRIFT_TOLERANCE_MS) {
+        return false;
+    }
+
+    m_basePosition = position;
+    m_baseTime = now();
+    m_rate = rate;
+    m_running = running;
+    emit changed();
+
+    if (qAbs(position - expected) > JUMP_THRESHOLD_MS) {
+        emit jumped(position);
+    }
+    return true;
+}
+
+void PlaybackClock::requestPrecision()
+{
+    if (++m_precisionRequests == 1) {
+        emit precisionRequestedChanged();
+    }
+}
+
+void PlaybackClock::releasePrecision()
+{
+    if (m_precisionRequests == 0) {
+        qWarning() << "[PlaybackClock::releasePrecision] No precision request to release";
+        return;
+    }
+    if (--m_precisionRequests == 0) {
+        emit precisionRequestedChanged();
+    }
+}
+
+} // namespace Mtoc
@@ -0,0 +1,66 @@
+#ifndef PLAYBACKCLOCK_H
+#define PLAYBACKCLOCK_H
+
+#include <QObject>
+#include <QElapsedTimer>
+
+namespace Mtoc {
+
+// The playback position as a reference point: the position at a monotonic
+// time, the rate it advances at and whether it is advancing. MediaPlayer
+// updates it from the pipeline, but changed() is only emitted on a
+// discontinuity (play, pause, seek, track change, or drift past a small
+// tolerance). Consumers work out the current position themselves, so nothing
+// has to wake up just to report that time has passed.
+class PlaybackClock : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(qint64 basePosition READ basePosition NOTIFY changed)
+    Q_PROPERTY(qint64 baseTime READ baseTime NOTIFY changed)
+    Q_PROPERTY(double rate READ rate NOTIFY changed)
+    Q_PROPERTY(bool running READ isRunning NOTIFY changed)
+    Q_PROPERTY(bool precisionRequested READ precisionRequested NOTIFY precisionRequestedChanged)
+
+public:
+    explicit PlaybackClock(QObject *parent = nullptr);
+
+    // Milliseconds; baseTime is on the now() scale
+    qint64 basePosition() const { return m_basePosition; }
+    qint64 baseTime() const { return m_baseTime; }
+    double rate() const { return m_rate; }
+    bool isRunning() const { return m_running; }
+
+    // Monotonic milliseconds since the clock was created
+    Q_INVOKABLE qint64 now() const;
+    // The interpolated position in milliseconds
+    Q_INVOKABLE qint64 position() const;
+
+    // Takes a position read from the pipeline. Returns true and emits changed()
+    // if it starts a new reference point; a reading within the drift tolerance
+    // of the interpolated position is dropped.
+    bool update(qint64 position, bool running, double rate = 1.0);
+
+    // Consumers that need the position corrected more often than the default
+    // hold a request while they are active (e.g. synced lyrics on screen)
+    Q_INVOKABLE void requestPrecision();
+    Q_INVOKABLE void releasePrecision();
+    bool precisionRequested() const { return m_precisionRequests > 0; }
+
+signals:
+    void changed();
+    // The position moved by more than a second against the interpolation
+    void jumped(qint64 position);
+    void precisionRequestedChanged();
+
+private:
+    QElapsedTimer m_timer;
+    qint64 m_basePosition = 0;
+    qint64 m_baseTime = 0;
+    double m_rate = 1.0;
+    bool m_running = false;
+    int m_precisionRequests = 0;
+};
+
+} // namespace Mtoc
+
+#endif // PLAYBACKCLOCK_H
@@ -0,0 +1,252 @@
+#include "playbackdiagnostics.h"
+
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QStandardPaths>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+namespace Mtoc {
+
+namespace {
+
+const int CHANGED_INTERVAL_MS = 500;
+
+const char *const METRIC_NAMES[] = {
+    "fileOpen", "decodeStart", "skipToAudio", "gaplessLag", "seekLatency"
+};
+
+// Nearest rank on an ascending list
+qint64 percentile(const QVector<qint64> &sorted, double p)
+{
+    const int rank = int(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[qBound(0, rank - 1, int(sorted.size()) - 1)];
+}
+
+QString isoTime(qint64 msecsSinceEpoch)
+{
+    return QDateTime::fromMSecsSinceEpoch(msecsSinceEpoch).toString(Qt::ISODateWithMs);
+}
+
+} // namespace
+
+PlaybackDiagnostics::PlaybackDiagnostics(QObject *parent)
+    : QObject(parent)
+    , m_since(QDateTime::currentDateTime())
+{
+    m_changedTimer.setSingleShot(true);
+    m_changedTimer.setInterval(CHANGED_INTERVAL_MS);
+    connect(&m_changedTimer, &QTimer::timeout, this, &PlaybackDiagnostics::changed);
+}
+
+void PlaybackDiagnostics::record(Metric metric, qint64 msec, const QString &filePath)
+{
+    if (metric < 0 || metric >= MetricCount || msec < 0) {
+        return;
+    }
+
+    Series &series = m_series[metric];
+    Sample sample;
+    sample.msec = msec;
+    sample.at = QDateTime::currentMSecsSinceEpoch();
+    sample.filePath = filePath;
+    if (series.ring.size() < SAMPLES) {
+        series.ring.append(sample);
+    } else {
+        series.ring[series.next] = sample;
+    }
+    series.next = (series.next + 1) % SAMPLES;
+    ++series.count;
+
+    notifyChanged();
+}
+
+void PlaybackDiagnostics::recordBuffering(int percent)
+{
+    // An episode starts when the level drops from full and ends back at 100
+    if (percent < 100 && m_bufferingPercent >= 100) {
+        ++m_bufferingEpisodes;
+        addEvent("buffering", QString("Buffering started at %1%").arg(percent));
+    } else if (percent >= 100 && m_bufferingPercent < 100) {
+        addEvent("buffering", "Buffering finished");
+    }
+    m_bufferingLowest = qMin(m_bufferingLowest, percent);
+    m_bufferingPercent = percent;
+    notifyChanged();
+}
+
+void PlaybackDiagnostics::recordQos(const QString &source, qint64 jitterMs, quint64 processed, quint64 dropped)
+{
+    ++m_qosMessages;
+    m_qosMaxJitterMs = qMax(m_qosMaxJitterMs, jitterMs);
+    addEvent("qos", QString("%1: jitter %2 ms, %3 processed, %4 dropped")
+                        .arg(source).arg(jitterMs).arg(processed).arg(dropped));
+    notifyChanged();
+}
+
+void PlaybackDiagnostics::recordEvent(const QString &kind, const QString &detail)
+{
+    addEvent(kind, detail);
+    notifyChanged();
+}
+
+void PlaybackDiagnostics::addEvent(const QString &kind, const QString &detail)
+{
+    Event event;
+    event.at = QDateTime::currentMSecsSinceEpoch();
+    event.kind = kind;
+    event.detail = detail;
+    if (m_events.size() < EVENTS) {
+        m_events.append(event);
+    } else {
+        m_events[m_nextEvent] = event;
+    }
+    m_nextEvent = (m_nextEvent + 1) % EVENTS;
+    ++m_eventCounts[kind];
+}
+
+void PlaybackDiagnostics::notifyChanged()
+{
+    if (!m_changedTimer.isActive()) {
+        m_changedTimer.start();
+    }
+}
+
+QVariantMap PlaybackDiagnostics::seriesSummary(const Series &series)
+{
+    QVariantMap map;
+    map["count"] = series.count;
+    if (series.ring.isEmpty()) {
+        return map;
+    }
+
+    QVector<qint64> sorted;
+    sorted.reserve(series.ring.size());
+    for (const Sample &sample : series.ring) {
+        sorted.append(sample.msec);
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    const int last = (series.next + series.ring.size() - 1) % series.ring.size();
+    map["lastMs"] = series.ring[last].msec;
+    map["p50Ms"] = percentile(sorted, 50);
+    map["p90Ms"] = percentile(sorted, 90);
+    map["p99Ms"] = percentile(sorted, 99);
+    map["maxMs"] = sorted.last();
+    return map;
+}
+
+QVariantMap PlaybackDiagnostics::summary() const
+{
+    QVariantMap map;
+    for (int metric = 0; metric < MetricCount; ++metric) {
+        map[METRIC_NAMES[metric]] = seriesSummary(m_series[metric]);
+    }
+
+    QVariantMap buffering;
+    buffering["percent"] = m_bufferingPercent;
+    buffering["episodes"] = m_bufferingEpisodes;
+    buffering["lowestPercent"] = m_bufferingLowest;
+    map["buffering"] = buffering;
+
+    QVariantMap qos;
+    qos["messages"] = m_qosMessages;
+    qos["maxJitterMs"] = m_qosMaxJitterMs;
+    map["qos"] = qos;
+
+    QVariantMap events;
+    for (auto it = m_eventCounts.constBegin(); it != m_eventCounts.constEnd(); ++it) {
+        events[it.key()] = it.value();
+    }
+    map["events"] = events;
+    map["since"] = m_since.toString(Qt::ISODate);
+    return map;
+}
+
+QJsonObject PlaybackDiagnostics::toJsonObject() const
+{
+    QJsonObject root = QJsonObject::fromVariantMap(summary());
+    root["generatedAt"] = QDateTime::currentDateTime().toString(Qt::ISODateWithMs);
+
+    // The raw readings, oldest first, so one slow file or folder stands out
+    QJsonObject samples;
+    for (int metric = 0; metric < MetricCount; ++metric) {
+        const Series &series = m_series[metric];
+        const int start = series.ring.size() < SAMPLES ? 0 : series.next;
+        QJsonArray readings;
+        for (int i = 0; i < series.ring.size(); ++i) {
+            const Sample &sample = series.ring[(start + i) % series.ring.size()];
+            QJsonObject reading;
+            reading["at"] = isoTime(sample.at);
+            reading["ms"] = sample.msec;
+            if (!sample.filePath.isEmpty()) {
+                reading["file"] = sample.filePath;
+            }
+            readings.append(reading);
+        }
+        samples[METRIC_NAMES[metric]] = readings;
+    }
+    root["samples"] = samples;
+
+    const int start = m_events.size() < EVENTS ? 0 : m_nextEvent;
+    QJsonArray log;
+    for (int i = 0; i < m_events.size(); ++i) {
+        const Event &event = m_events[(start + i) % m_events.size()];
+        QJsonObject entry;
+        entry["at"] = isoTime(event.at);
+        entry["kind"] = event.kind;
+        entry["detail"] = event.detail;
+        log.append(entry);
+    }
+    root["eventLog"] = log;
+    return root;
+}
+
+QString PlaybackDiagnostics::toJson() const
+{
+    return QString::fromUtf8(QJsonDocument(toJsonObject()).toJson(QJsonDocument::Indented));
+}
+
+QString PlaybackDiagnostics::dump() const
+{
+    QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir dir(QDir(dataPath).filePath("diagnostics"));
+    if (!dir.mkpath(".")) {
+        qWarning() << "[PlaybackDiagnostics::dump] Cannot create" << dir.path();
+        return QString();
+    }
+
+    const QString path = dir.filePath(QString("playback-%1.json")
+        .arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss")));
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "[PlaybackDiagnostics::dump] Cannot write" << path << "-" << file.errorString();
+        return QString();
+    }
+    file.write(QJsonDocument(toJsonObject()).toJson(QJsonDocument::Indented));
+    qDebug() << "[PlaybackDiagnostics::dump] Wrote" << path;
+    return path;
+}
+
+void PlaybackDiagnostics::reset()
+{
+    for (Series &series : m_series) {
+        series = Series();
+    }
+    m_events.clear();
+    m_nextEvent = 0;
+    m_eventCounts.clear();
+    m_bufferingPercent = 100;
+    m_bufferingLowest = 100;
+    m_bufferingEpisodes = 0;
+    m_qosMessages = 0;
+    m_qosMaxJitterMs = 0;
+    m_since = QDateTime::currentDateTime();
+    m_changedTimer.stop();
+    emit changed();
+}
+
+} // namespace Mtoc
@@ -0,0 +1,100 @@
+#ifndef PLAYBACKDIAGNOSTICS_H
+#define PLAYBACKDIAGNOSTICS_H
+
+#include <QObject>
+#include <QDateTime>
+#include <QHash>
+#include <QJsonObject>
+#include <QTimer>
+#include <QVariantMap>
+#include <QVector>
+
+namespace Mtoc {
+
+// Playback health figures for comparing storage setups and catching
+// regressions: how long files take to open and start, how late gapless
+// switches and seeks land, and what the pipeline reported about buffering,
+// QoS and warnings. Each timing keeps its last SAMPLES readings in a ring
+// that is summarised as percentiles; notable bus messages go to a ring of
+// their own. Main thread only; AudioEngine queues streaming thread readings.
+class PlaybackDiagnostics : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QVariantMap summary READ summary NOTIFY changed)
+
+public:
+    enum Metric {
+        FileOpen,       // Source element created to its first buffer
+        DecodeStart,    // play() on a loaded track to the pipeline reaching PLAYING
+        SkipToAudio,    // Track requested to audio running, as MediaPlayer sees it
+        GaplessLag,     // How far into the next track its switch was reported
+        SeekLatency,    // Flushing seek to ASYNC_DONE
+        MetricCount
+    };
+    Q_ENUM(Metric)
+
+    static const int SAMPLES = 256;
+    static const int EVENTS = 64;
+
+    explicit PlaybackDiagnostics(QObject *parent = nullptr);
+
+    void record(Metric metric, qint64 msec, const QString &filePath = QString());
+    void recordBuffering(int percent);
+    void recordQos(const QString &source, qint64 jitterMs, quint64 processed, quint64 dropped);
+    // Warnings, errors and the like; counted by kind and kept in the event ring
+    void recordEvent(const QString &kind, const QString &detail);
+
+    QVariantMap summary() const;
+    Q_INVOKABLE QString toJson() const;
+    // Writes toJson() to a new file under the app data directory and returns
+    // its path, or an empty string if it could not be written
+    Q_INVOKABLE QString dump() const;
+    Q_INVOKABLE void reset();
+
+signals:
+    void changed();
+
+private:
+    struct Sample {
+        qint64 msec = 0;
+        qint64 at = 0;      // ms since the epoch
+        QString filePath;
+    };
+
+    struct Series {
+        QVector<Sample> ring;
+        int next = 0;
+        qint64 count = 0;   // Including readings the ring has dropped
+    };
+
+    struct Event {
+        qint64 at = 0;
+        QString kind;
+        QString detail;
+    };
+
+    static QVariantMap seriesSummary(const Series &series);
+    QJsonObject toJsonObject() const;
+    void addEvent(const QString &kind, const QString &detail);
+    void notifyChanged();
+
+    Series m_series[MetricCount];
+    QVector<Event> m_events;
+    int m_nextEvent = 0;
+    QHash<QString, int> m_eventCounts;
+
+    int m_bufferingPercent = 100;
+    int m_bufferingLowest = 100;
+    int m_bufferingEpisodes = 0;
+
+    int m_qosMessages = 0;
+    qint64 m_qosMaxJitterMs = 0;
+
+    QDateTime m_since;
+    // Bus messages can come in bursts; QML hears about them at most this often
+    QTimer m_changedTimer;
+};
+
+} // namespace Mtoc
+
+#endif // PLAYBACKDIAGNOSTICS_H
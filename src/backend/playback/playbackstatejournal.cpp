@@ -0,0 +1,414 @@
+#include "playbackstatejournal.h"
+
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QtEndian>
+#include <QDebug>
+
+namespace Mtoc {
+
+namespace {
+
+const quint32 MAGIC = 0x4a50544d;  // "MTPJ"
+const QDataStream::Version STREAM_VERSION = QDataStream::Qt_6_0;
+
+// type + payload length before the payload, checksum after it
+const int RECORD_HEADER_SIZE = 5;
+const int RECORD_TRAILER_SIZE = 2;
+
+// Appended records are folded into a new checkpoint once the file is past this
+// size and more than twice the size of its checkpoint
+const qint64 COMPACT_MIN_SIZE = 64 * 1024;
+
+} // namespace
+
+PlaybackStateJournal::PlaybackStateJournal(const QString &path)
+    : m_path(path)
+{
+}
+
+PlaybackStateJournal::~PlaybackStateJournal()
+{
+    m_file.close();
+}
+
+QString PlaybackStateJournal::defaultPath()
+{
+    QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return QDir(dataPath).filePath("playback_state.journal");
+}
+
+bool PlaybackStateJournal::exists() const
+{
+    return QFileInfo::exists(m_path);
+}
+
+bool PlaybackStateJournal::load(State *state)
+{
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QByteArray data = file.readAll();
+    file.close();
+
+    if (data.size() < 8
+        || qFromBigEndian<quint32>(data.constData()) != MAGIC
+        || qFromBigEndian<quint32>(data.constData() + 4) != FORMAT_VERSION) {
+        qDebug() << "[PlaybackStateJournal::load] Ignoring journal with unknown format:" << m_path;
+        return false;
+    }
+
+    State replayed;
+    int records = 0;
+    qint64 offset = 8;
+    while (offset + RECORD_HEADER_SIZE + RECORD_TRAILER_SIZE <= data.size()) {
+        const char *record = data.constData() + offset;
+        const quint8 type = quint8(record[0]);
+        const qint64 length = qFromBigEndian<quint32>(record + 1);
+        const qint64 recordSize = RECORD_HEADER_SIZE + length + RECORD_TRAILER_SIZE;
+        if (offset + recordSize > data.size()) {
+            break;
+        }
+
+        const quint16 checksum = qFromBigEndian<quint16>(record + RECORD_HEADER_SIZE + length);
+        if (qChecksum(QByteArrayView(record, RECORD_HEADER_SIZE + length)) != checksum) {
+            break;
+        }
+
+        // Everything is replayed on top of the first checkpoint
+        if (records == 0 && type != CheckpointRecord) {
+            break;
+        }
+
+        const QByteArray payload = QByteArray::fromRawData(record + RECORD_HEADER_SIZE, int(length));
+        QDataStream in(payload);
+        in.setVersion(STREAM_VERSION);
+        if (!applyRecord(replayed, type, in)) {
+            break;
+        }
+
+        ++records;
+        offset += recordSize;
+    }
+
+    if (records == 0) {
+        qWarning() << "[PlaybackStateJournal::load] No valid checkpoint in" << m_path;
+        return false;
+    }
+    if (offset != data.size()) {
+        qWarning() << "[PlaybackStateJournal::load] Dropped" << data.size() - offset
+                   << "bytes of incomplete records after" << records << "records";
+    }
+
+    replayed.savedTime = QFileInfo(m_path).lastModified();
+    *state = replayed;
+
+    // The queue is left alone: it mirrors the live queue, which the restore rebuilds
+    if (!m_file.isOpen() && !m_dirty) {
+        m_state.info = replayed.info;
+        m_state.position = replayed.position;
+    }
+    return true;
+}
+
+bool PlaybackStateJournal::applyRecord(State &state, quint8 type, QDataStream &in)
+{
+    switch (type) {
+    case CheckpointRecord: {
+        State checkpoint;
+        in >> checkpoint.info >> checkpoint.position;
+        if (!readEntries(in, checkpoint.queue)) {
+            return false;
+        }
+        state = checkpoint;
+        return true;
+    }
+    case InfoRecord: {
+        QVariantMap info;
+        in >> info;
+        if (in.status() != QDataStream::Ok) {
+            return false;
+        }
+        state.info = info;
+        return true;
+    }
+    case PositionRecord: {
+        qint64 position = 0;
+        in >> position;
+        if (in.status() != QDataStream::Ok) {
+            return false;
+        }
+        state.position = position;
+        return true;
+    }
+    case InsertRecord: {
+        qint32 index = 0;
+        QList<Entry> entries;
+        in >> index;
+        if (!readEntries(in, entries) || index < 0 || index > state.queue.size()) {
+            return false;
+        }
+        if (index == state.queue.size()) {
+            state.queue.append(entries);
+        } else {
+            state.queue = state.queue.mid(0, index) + entries + state.queue.mid(index);
+        }
+        return true;
+    }
+    case RemoveRecord: {
+        qint32 index = 0;
+        qint32 count = 0;
+        in >> index >> count;
+        if (in.status() != QDataStream::Ok || index < 0 || count < 0 || index + count > state.queue.size()) {
+            return false;
+        }
+        state.queue.remove(index, count);
+        return true;
+    }
+    case MoveRecord: {
+        qint32 from = 0;
+        qint32 to = 0;
+        in >> from >> to;
+        if (in.status() != QDataStream::Ok || from < 0 || from >= state.queue.size()
+            || to < 0 || to >= state.queue.size()) {
+            return false;
+        }
+        state.queue.move(from, to);
+        return true;
+    }
+    case ResetRecord: {
+        QList<Entry> entries;
+        if (!readEntries(in, entries)) {
+            return false;
+        }
+        state.queue = entries;
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+void PlaybackStateJournal::writeEntries(QDataStream &out, const QList<Entry> &entries)
+{
+    out << qint32(entries.size());
+    for (const Entry &entry : entries) {
+        out << qint32(entry.id) << entry.filePath.toUtf8();
+    }
+}
+
+bool PlaybackStateJournal::readEntries(QDataStream &in, QList<Entry> &entries)
+{
+    qint32 count = 0;
+    in >> count;
+    if (in.status() != QDataStream::Ok || count < 0) {
+        return false;
+    }
+
+    entries.reserve(count);
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        qint32 id = 0;
+        QByteArray path;
+        in >> id >> path;
+        entries.append({id, QString::fromUtf8(path)});
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+QByteArray PlaybackStateJournal::encodeRecord(RecordType type, const QByteArray &payload)
+{
+    QByteArray record;
+    record.reserve(RECORD_HEADER_SIZE + payload.size() + RECORD_TRAILER_SIZE);
+    {
+        QDataStream out(&record, QIODevice::WriteOnly);
+        out << quint8(type) << quint32(payload.size());
+        out.writeRawData(payload.constData(), int(payload.size()));
+    }
+    quint16 checksum = qToBigEndian(qChecksum(QByteArrayView(record)));
+    record.append(reinterpret_cast<const char *>(&checksum), sizeof(checksum));
+    return record;
+}
+
+void PlaybackStateJournal::setInfo(const QVariantMap &info)
+{
+    if (info == m_state.info && m_file.isOpen()) {
+        return;
+    }
+    m_state.info = info;
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(STREAM_VERSION);
+    out << info;
+    append(InfoRecord, payload);
+}
+
+void PlaybackStateJournal::setPosition(qint64 position)
+{
+    if (position == m_state.position && m_file.isOpen()) {
+        return;
+    }
+    m_state.position = position;
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(STREAM_VERSION);
+    out << position;
+    append(PositionRecord, payload);
+}
+
+void PlaybackStateJournal::insertEntries(int index, const QList<Entry> &entries)
+{
+    if (index < 0 || index > m_state.queue.size()) {
+        qWarning() << "[PlaybackStateJournal::insertEntries] Index out of range:" << index;
+        return;
+    }
+    if (entries.isEmpty()) {
+        return;
+    }
+    if (index == m_state.queue.size()) {
+        m_state.queue.append(entries);
+    } else {
+        m_state.queue = m_state.queue.mid(0, index) + entries + m_state.queue.mid(index);
+    }
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(STREAM_VERSION);
+    out << qint32(index);
+    writeEntries(out, entries);
+    append(InsertRecord, payload);
+}
+
+void PlaybackStateJournal::removeEntries(int index, int count)
+{
+    if (index < 0 || count <= 0 || index + count > m_state.queue.size()) {
+        qWarning() << "[PlaybackStateJournal::removeEntries] Range out of bounds:" << index << count;
+        return;
+    }
+    m_state.queue.remove(index, count);
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(STREAM_VERSION);
+    out << qint32(index) << qint32(count);
+    append(RemoveRecord, payload);
+}
+
+void PlaybackStateJournal::moveEntry(int from, int to)
+{
+    if (from < 0 || from >= m_state.queue.size() || to < 0 || to >= m_state.queue.size()) {
+        qWarning() << "[PlaybackStateJournal::moveEntry] Index out of range:" << from << to;
+        return;
+    }
+    if (from == to) {
+        return;
+    }
+    m_state.queue.move(from, to);
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(STREAM_VERSION);
+    out << qint32(from) << qint32(to);
+    append(MoveRecord, payload);
+}
+
+void PlaybackStateJournal::resetEntries(const QList<Entry> &entries)
+{
+    if (entries == m_state.queue) {
+        return;
+    }
+    m_state.queue = entries;
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(STREAM_VERSION);
+    writeEntries(out, entries);
+    append(ResetRecord, payload);
+}
+
+void PlaybackStateJournal::append(RecordType type, const QByteArray &payload)
+{
+    m_dirty = true;
+
+    // Nothing to append to yet: the checkpoint already includes this change
+    if (!m_file.isOpen()) {
+        writeCheckpoint();
+        return;
+    }
+
+    const QByteArray record = encodeRecord(type, payload);
+    if (m_file.write(record) != record.size() || !m_file.flush()) {
+        qWarning() << "[PlaybackStateJournal::append] Failed to write" << m_path << "-" << m_file.errorString();
+        // Start over with a checkpoint on the next write
+        m_file.close();
+        return;
+    }
+
+    if (m_file.size() > COMPACT_MIN_SIZE && m_file.size() > 2 * m_checkpointSize) {
+        writeCheckpoint();
+    }
+}
+
+bool PlaybackStateJournal::checkpoint()
+{
+    if (!m_dirty) {
+        return true;
+    }
+    return writeCheckpoint();
+}
+
+bool PlaybackStateJournal::writeCheckpoint()
+{
+    m_file.close();
+
+    QByteArray payload;
+    {
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out.setVersion(STREAM_VERSION);
+        out << m_state.info << m_state.position;
+        writeEntries(out, m_state.queue);
+    }
+
+    QByteArray data;
+    {
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out << MAGIC << FORMAT_VERSION;
+    }
+    data.append(encodeRecord(CheckpointRecord, payload));
+
+    // QSaveFile syncs the new file to disk before it replaces the old one
+    QDir().mkpath(QFileInfo(m_path).absolutePath());
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qWarning() << "[PlaybackStateJournal::writeCheckpoint] Failed to write" << m_path << "-" << file.errorString();
+        return false;
+    }
+
+    m_checkpointSize = data.size();
+    m_dirty = false;
+
+    m_file.setFileName(m_path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "[PlaybackStateJournal::writeCheckpoint] Failed to reopen" << m_path << "-" << m_file.errorString();
+        return false;
+    }
+    return true;
+}
+
+void PlaybackStateJournal::clear()
+{
+    m_file.close();
+    QFile::remove(m_path);
+
+    m_state.info.clear();
+    m_state.position = 0;
+    m_checkpointSize = 0;
+    m_dirty = false;
+}
+
+} // namespace Mtoc
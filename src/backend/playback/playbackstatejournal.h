@@ -0,0 +1,100 @@
+#ifndef PLAYBACKSTATEJOURNAL_H
+#define PLAYBACKSTATEJOURNAL_H
+
+#include <QString>
+#include <QList>
+#include <QVariantMap>
+#include <QDateTime>
+#include <QFile>
+
+class QDataStream;
+
+namespace Mtoc {
+
+// Saved playback state as an append-only log. The file starts with a
+// checkpoint holding the whole state; after that every change is appended as
+// a small record (a position tick, a queue insert/remove/move, new track info)
+// and flushed, so a save while playing writes tens of bytes instead of the
+// whole queue. Once the appended records outgrow the checkpoint the file is
+// compacted back into a single checkpoint through QSaveFile, which also syncs
+// it to disk. Queue entries are stored as track id and path only.
+//
+// Record layout: quint8 type | quint32 payload length | payload | quint16 checksum.
+// Loading replays records up to the first incomplete or corrupt one, so a torn
+// write at the tail only loses that record.
+class PlaybackStateJournal
+{
+public:
+    static const quint32 FORMAT_VERSION = 1;
+
+    struct Entry {
+        int id = 0;
+        QString filePath;
+
+        bool operator==(const Entry &other) const { return id == other.id && filePath == other.filePath; }
+    };
+
+    struct State {
+        QVariantMap info;  // Current track, queue source and virtual playlist fields
+        qint64 position = 0;
+        QList<Entry> queue;
+        QDateTime savedTime;
+    };
+
+    explicit PlaybackStateJournal(const QString &path = defaultPath());
+    ~PlaybackStateJournal();
+    PlaybackStateJournal(const PlaybackStateJournal &) = delete;
+    PlaybackStateJournal &operator=(const PlaybackStateJournal &) = delete;
+
+    static QString defaultPath();
+    bool exists() const;
+
+    // Replays the file into state; false if it is missing or has no valid checkpoint.
+    // If nothing was written yet, the saved track info and position become the
+    // journal's own, so the first checkpoint after a restore keeps them.
+    bool load(State *state);
+
+    // Each of these updates the in-memory state and appends one record. The
+    // first write after construction or clear() starts a new checkpoint instead.
+    void setInfo(const QVariantMap &info);
+    void setPosition(qint64 position);
+    void insertEntries(int index, const QList<Entry> &entries);
+    void removeEntries(int index, int count);
+    void moveEntry(int from, int to);
+    void resetEntries(const QList<Entry> &entries);
+
+    // Rewrites the file as one checkpoint of the current state and syncs it to
+    // disk. Does nothing if no record was appended since the last checkpoint.
+    bool checkpoint();
+    // Forgets the saved track and removes the file; the queue mirror is kept
+    void clear();
+
+private:
+    enum RecordType : quint8 {
+        CheckpointRecord = 1,
+        InfoRecord,
+        PositionRecord,
+        InsertRecord,
+        RemoveRecord,
+        MoveRecord,
+        ResetRecord
+    };
+
+    static bool applyRecord(State &state, quint8 type, QDataStream &in);
+    static void writeEntries(QDataStream &out, const QList<Entry> &entries);
+    static bool readEntries(QDataStream &in, QList<Entry> &entries);
+    static QByteArray encodeRecord(RecordType type, const QByteArray &payload);
+
+    void append(RecordType type, const QByteArray &payload);
+    bool writeCheckpoint();
+
+    QString m_path;
+    QFile m_file;
+    State m_state;
+    qint64 m_checkpointSize = 0;
+    bool m_dirty = false;
+};
+
+} // namespace Mtoc
+
+#endif // PLAYBACKSTATEJOURNAL_H
@@ -0,0 +1,175 @@
+#include "queueentry.h"
+#include "backend/library/track.h"
+#include "backend/database/databasemanager.h"
+
+#include <QSet>
+#include <QUrl>
+#include <QDebug>
+
+namespace Mtoc {
+
+namespace {
+
+// Artist and album strings repeat across album-sized runs; keep one copy each
+class SharedStrings
+{
+public:
+    void share(QueueEntry &entry)
+    {
+        share(entry.artist);
+        share(entry.albumArtist);
+        share(entry.album);
+    }
+
+private:
+    void share(QString &value)
+    {
+        auto it = m_strings.constFind(value);
+        if (it != m_strings.constEnd()) {
+            value = *it;
+        } else {
+            m_strings.insert(value);
+        }
+    }
+
+    QSet<QString> m_strings;
+};
+
+} // namespace
+
+QueueEntry QueueEntry::fromMetadata(const QVariantMap &metadata)
+{
+    QueueEntry entry;
+    entry.id = metadata.value("id").toInt();
+    entry.filePath = metadata.value("filePath").toString();
+    entry.title = metadata.value("title").toString();
+    entry.artist = metadata.value("artist").toString();
+    // Same fallback as Track::fromMetadata
+    entry.albumArtist = metadata.contains("albumArtist") ? metadata.value("albumArtist").toString()
+                                                         : entry.artist;
+    entry.album = metadata.value("album").toString();
+    entry.trackNumber = metadata.value("trackNumber").toInt();
+    entry.discNumber = metadata.value("discNumber").toInt();
+    entry.year = metadata.value("year").toInt();
+    entry.duration = metadata.value("duration").toInt();
+    entry.isFavorite = metadata.value("isFavorite").toBool();
+    return entry;
+}
+
+QueueEntry QueueEntry::fromTrack(const Track *track)
+{
+    QueueEntry entry;
+    if (!track) {
+        return entry;
+    }
+    entry.id = track->id();
+    entry.filePath = track->filePath();
+    entry.title = track->title();
+    entry.artist = track->artist();
+    entry.albumArtist = track->albumArtist();
+    entry.album = track->album();
+    entry.trackNumber = track->trackNumber();
+    entry.discNumber = track->discNumber();
+    entry.year = track->year();
+    entry.duration = track->duration();
+    entry.isFavorite = track->isFavorite();
+    return entry;
+}
+
+QueueEntry QueueEntry::fromVirtualTrack(const VirtualTrackData &data)
+{
+    QueueEntry entry;
+    entry.id = data.id;
+    entry.filePath = data.filePath;
+    entry.title = data.title;
+    entry.artist = data.artist;
+    entry.albumArtist = data.albumArtist;
+    entry.album = data.album;
+    entry.trackNumber = data.trackNumber;
+    entry.discNumber = data.discNumber;
+    entry.year = data.year;
+    entry.duration = data.duration;
+    return entry;
+}
+
+QList<QueueEntry> QueueEntry::fromMetadataList(const QVariantList &tracks)
+{
+    QList<QueueEntry> entries;
+    entries.reserve(tracks.size());
+
+    SharedStrings strings;
+    for (const QVariant &value : tracks) {
+        QueueEntry entry = fromMetadata(value.toMap());
+        if (!entry.isValid()) {
+            qWarning() << "[QueueEntry::fromMetadataList] Empty filePath for track:" << entry.title;
+            continue;
+        }
+        strings.share(entry);
+        entries.append(entry);
+    }
+    return entries;
+}
+
+QList<QueueEntry> QueueEntry::fromResolvedTracks(const QList<ResolvedTrack> &tracks)
+{
+    QList<QueueEntry> entries;
+    entries.reserve(tracks.size());
+
+    SharedStrings strings;
+    for (const ResolvedTrack &track : tracks) {
+        if (track.filePath.isEmpty()) {
+            continue;
+        }
+        QueueEntry entry;
+        entry.id = track.id;
+        entry.filePath = track.filePath;
+        entry.title = track.title;
+        entry.artist = track.artist;
+        entry.albumArtist = track.albumArtist;
+        entry.album = track.album;
+        entry.trackNumber = track.trackNumber;
+        entry.discNumber = track.discNumber;
+        entry.year = track.year;
+        entry.duration = track.duration;
+        entry.isFavorite = track.isFavorite;
+        strings.share(entry);
+        entries.append(entry);
+    }
+    return entries;
+}
+
+QVariantMap QueueEntry::toVariantMap() const
+{
+    QVariantMap map;
+    map["id"] = id;
+    map["filePath"] = filePath;
+    map["title"] = title;
+    map["artist"] = artist;
+    map["albumArtist"] = albumArtist;
+    map["album"] = album;
+    map["trackNumber"] = trackNumber;
+    map["discNumber"] = discNumber;
+    map["year"] = year;
+    map["duration"] = duration;
+    map["isFavorite"] = isFavorite;
+    return map;
+}
+
+Track *QueueEntry::createTrack(QObject *parent) const
+{
+    Track *track = new Track(parent);
+    track->setFileUrl(QUrl::fromLocalFile(filePath));
+    track->setId(id);
+    track->setTitle(title);
+    track->setArtist(artist);
+    track->setAlbumArtist(albumArtist);
+    track->setAlbum(album);
+    track->setTrackNumber(trackNumber);
+    track->setDiscNumber(discNumber);
+    track->setYear(year);
+    track->setDuration(duration);
+    track->setIsFavorite(isFavorite);
+    return track;
+}
+
+} // namespace Mtoc
@@ -0,0 +1,64 @@
+#ifndef QUEUEENTRY_H
+#define QUEUEENTRY_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QVariant>
+#include "backend/playlist/VirtualTrackData.h"
+
+namespace Mtoc {
+
+class Track;
+struct ResolvedTrack;
+
+// Value-type queue element. Holds only what the queue view and state save need;
+// a Track QObject is created from it when the entry becomes the current or
+// pending track. Lyrics are deliberately not stored here.
+struct QueueEntry
+{
+    Q_GADGET
+    Q_PROPERTY(int id MEMBER id)
+    Q_PROPERTY(QString filePath MEMBER filePath)
+    Q_PROPERTY(QString title MEMBER title)
+    Q_PROPERTY(QString artist MEMBER artist)
+    Q_PROPERTY(QString albumArtist MEMBER albumArtist)
+    Q_PROPERTY(QString album MEMBER album)
+    Q_PROPERTY(int trackNumber MEMBER trackNumber)
+    Q_PROPERTY(int discNumber MEMBER discNumber)
+    Q_PROPERTY(int year MEMBER year)
+    Q_PROPERTY(int duration MEMBER duration)
+    Q_PROPERTY(bool isFavorite MEMBER isFavorite)
+
+public:
+    int id = 0;
+    QString filePath;
+    QString title;
+    QString artist;
+    QString albumArtist;
+    QString album;
+    int trackNumber = 0;
+    int discNumber = 0;
+    int year = 0;
+    int duration = 0;  // in seconds
+    bool isFavorite = false;
+
+    bool isValid() const { return !filePath.isEmpty(); }
+
+    static QueueEntry fromMetadata(const QVariantMap &metadata);
+    static QueueEntry fromTrack(const Track *track);
+    static QueueEntry fromVirtualTrack(const VirtualTrackData &data);
+    // Converts a track list, skipping rows without a file path. Artist and album
+    // strings are shared between entries so album-sized runs store them once.
+    static QList<QueueEntry> fromMetadataList(const QVariantList &tracks);
+    // Same for batch lookup results; rows without a file path (keys that did
+    // not resolve) are skipped
+    static QList<QueueEntry> fromResolvedTracks(const QList<ResolvedTrack> &tracks);
+
+    QVariantMap toVariantMap() const;
+    Track *createTrack(QObject *parent) const;
+};
+
+} // namespace Mtoc
+
+#endif // QUEUEENTRY_H
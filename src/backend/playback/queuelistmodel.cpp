@@ -0,0 +1,254 @@
+#include "queuelistmodel.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace Mtoc {
+
+QueueListModel::QueueListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int QueueListModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_entries.size();
+}
+
+QVariant QueueListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || !isValidRow(index.row()))
+        return QVariant();
+
+    const QueueEntry &entry = m_entries.at(index.row());
+    switch (role) {
+    case TrackIdRole:
+        return entry.id;
+    case Qt::DisplayRole:
+    case TitleRole:
+        return entry.title;
+    case ArtistRole:
+        return entry.artist;
+    case AlbumRole:
+        return entry.album;
+    case AlbumArtistRole:
+        return entry.albumArtist;
+    case DurationRole:
+        return entry.duration * 1000;
+    case FilePathRole:
+        return entry.filePath;
+    case IsCurrentRole:
+        return index.row() == m_currentIndex;
+    }
+
+    return QVariant();
+}
+
+QHash<int, QByteArray> QueueListModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[TrackIdRole] = "trackId";
+    roles[TitleRole] = "title";
+    roles[ArtistRole] = "artist";
+    roles[AlbumRole] = "album";
+    roles[AlbumArtistRole] = "albumArtist";
+    roles[DurationRole] = "duration";
+    roles[FilePathRole] = "filePath";
+    roles[IsCurrentRole] = "isCurrent";
+    return roles;
+}
+
+QVariantMap QueueListModel::get(int row) const
+{
+    QVariantMap track;
+    if (!isValidRow(row))
+        return track;
+
+    const QueueEntry &entry = m_entries.at(row);
+    track["id"] = entry.id;
+    track["title"] = entry.title;
+    track["artist"] = entry.artist;
+    track["album"] = entry.album;
+    track["albumArtist"] = entry.albumArtist;
+    track["duration"] = entry.duration * 1000;
+    track["filePath"] = entry.filePath;
+    return track;
+}
+
+void QueueListModel::setCurrentIndex(int row)
+{
+    if (!isValidRow(row))
+        row = -1;
+    if (row == m_currentIndex)
+        return;
+
+    int previous = m_currentIndex;
+    m_currentIndex = row;
+
+    const QList<int> roles = {IsCurrentRole};
+    if (isValidRow(previous)) {
+        QModelIndex previousIndex = index(previous);
+        emit dataChanged(previousIndex, previousIndex, roles);
+    }
+    if (row >= 0) {
+        QModelIndex newIndex = index(row);
+        emit dataChanged(newIndex, newIndex, roles);
+    }
+    emit currentIndexChanged();
+}
+
+void QueueListModel::addDuration(int delta)
+{
+    if (delta == 0)
+        return;
+    m_totalDuration += delta;
+    emit totalDurationChanged();
+}
+
+void QueueListModel::setEntries(const QueueSequence &entries)
+{
+    beginResetModel();
+    m_entries = entries;
+    m_currentIndex = -1;
+    int total = 0;
+    for (const QueueEntry &entry : m_entries)
+        total += entry.duration;
+    endResetModel();
+
+    emit countChanged();
+    emit currentIndexChanged();
+    addDuration(total - m_totalDuration);
+}
+
+void QueueListModel::append(const QueueEntry &entry)
+{
+    insert(m_entries.size(), QList<QueueEntry>{entry});
+}
+
+void QueueListModel::append(const QList<QueueEntry> &entries)
+{
+    insert(m_entries.size(), entries);
+}
+
+void QueueListModel::insert(int row, const QueueEntry &entry)
+{
+    insert(row, QList<QueueEntry>{entry});
+}
+
+void QueueListModel::insert(int row, const QList<QueueEntry> &entries)
+{
+    if (entries.isEmpty())
+        return;
+
+    row = qBound(0, row, int(m_entries.size()));
+    int added = 0;
+    bool shiftsCurrent = m_currentIndex >= row;
+
+    beginInsertRows(QModelIndex(), row, row + int(entries.size()) - 1);
+    m_entries.insert(row, entries);
+    for (const QueueEntry &entry : entries)
+        added += entry.duration;
+    if (shiftsCurrent)
+        m_currentIndex += int(entries.size());
+    endInsertRows();
+
+    emit countChanged();
+    if (shiftsCurrent)
+        emit currentIndexChanged();
+    addDuration(added);
+}
+
+void QueueListModel::removeAt(int row)
+{
+    if (isValidRow(row))
+        removeIndices({row});
+}
+
+void QueueListModel::removeIndices(const QList<int> &rows)
+{
+    QList<int> sorted = rows;
+    std::sort(sorted.begin(), sorted.end(), std::greater<int>());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    int removedDuration = 0;
+    int previousCurrentIndex = m_currentIndex;
+    bool removedAny = false;
+    int i = 0;
+    while (i < sorted.size()) {
+        int last = sorted[i];
+        if (!isValidRow(last)) {
+            ++i;
+            continue;
+        }
+        // Extend the run downwards while the rows are adjacent
+        int first = last;
+        while (i + 1 < sorted.size() && sorted[i + 1] == first - 1) {
+            ++i;
+            first = sorted[i];
+        }
+        ++i;
+
+        beginRemoveRows(QModelIndex(), first, last);
+        for (int row = first; row <= last; ++row)
+            removedDuration += m_entries.at(row).duration;
+        m_entries.remove(first, last - first + 1);
+        if (m_currentIndex >= first && m_currentIndex <= last)
+            m_currentIndex = -1;
+        else if (m_currentIndex > last)
+            m_currentIndex -= last - first + 1;
+        endRemoveRows();
+        removedAny = true;
+    }
+
+    if (!removedAny)
+        return;
+
+    emit countChanged();
+    if (m_currentIndex != previousCurrentIndex)
+        emit currentIndexChanged();
+    addDuration(-removedDuration);
+}
+
+void QueueListModel::move(int fromRow, int toRow)
+{
+    if (!isValidRow(fromRow) || !isValidRow(toRow) || fromRow == toRow)
+        return;
+
+    // beginMoveRows takes the row the item is inserted before, in pre-move terms
+    int destination = toRow > fromRow ? toRow + 1 : toRow;
+    int current = m_currentIndex;
+    if (current == fromRow)
+        current = toRow;
+    else if (current >= 0 && fromRow < current && toRow >= current)
+        current--;
+    else if (current >= 0 && fromRow > current && toRow <= current)
+        current++;
+
+    beginMoveRows(QModelIndex(), fromRow, fromRow, QModelIndex(), destination);
+    m_entries.move(fromRow, toRow);
+    bool currentMoved = current != m_currentIndex;
+    m_currentIndex = current;
+    endMoveRows();
+
+    if (currentMoved)
+        emit currentIndexChanged();
+}
+
+void QueueListModel::clear()
+{
+    if (m_entries.isEmpty())
+        return;
+
+    beginResetModel();
+    m_entries.clear();
+    m_currentIndex = -1;
+    endResetModel();
+
+    emit countChanged();
+    emit currentIndexChanged();
+    addDuration(-m_totalDuration);
+}
+
+} // namespace Mtoc
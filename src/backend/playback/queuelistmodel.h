@@ -0,0 +1,87 @@
+#ifndef QUEUELISTMODEL_H
+#define QUEUELISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QList>
+#include <QVariantMap>
+#include "queuesequence.h"
+
+namespace Mtoc {
+
+// The playback queue as a list model. MediaPlayer owns the queue through this
+// class; the rows are a QueueSequence, so taking a snapshot for undo is cheap.
+// Every mutation is reported with the matching insert/remove/move
+// notification so queue views only touch the rows that changed. The total
+// duration and the current row are kept up to date as rows change rather than
+// recomputed from the whole queue.
+class QueueListModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(int totalDuration READ totalDuration NOTIFY totalDurationChanged)
+    Q_PROPERTY(int currentIndex READ currentIndex NOTIFY currentIndexChanged)
+
+public:
+    enum QueueRoles {
+        TrackIdRole = Qt::UserRole + 1,
+        TitleRole,
+        ArtistRole,
+        AlbumRole,
+        AlbumArtistRole,
+        DurationRole,
+        FilePathRole,
+        IsCurrentRole
+    };
+    Q_ENUM(QueueRoles)
+
+    explicit QueueListModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const { return m_entries.size(); }
+    int size() const { return m_entries.size(); }
+    bool isEmpty() const { return m_entries.isEmpty(); }
+    const QueueEntry &at(int row) const { return m_entries.at(row); }
+    const QueueSequence &entries() const { return m_entries; }
+
+    // Seconds, summed over all rows
+    int totalDuration() const { return m_totalDuration; }
+    // Inserts, removes and moves keep the current row on the same entry; a
+    // removed current row leaves no current row until the next setCurrentIndex()
+    int currentIndex() const { return m_currentIndex; }
+    void setCurrentIndex(int row);
+
+    // Same keys as MediaPlayer::queue(); duration is in milliseconds
+    Q_INVOKABLE QVariantMap get(int row) const;
+
+    void setEntries(const QueueSequence &entries);
+    void append(const QueueEntry &entry);
+    void append(const QList<QueueEntry> &entries);
+    void insert(int row, const QueueEntry &entry);
+    void insert(int row, const QList<QueueEntry> &entries);
+    void removeAt(int row);
+    // Removes any set of rows; each contiguous run is one remove notification
+    void removeIndices(const QList<int> &rows);
+    // Moves one row so that it ends up at toRow, like QList::move()
+    void move(int fromRow, int toRow);
+    void clear();
+
+signals:
+    void countChanged();
+    void totalDurationChanged();
+    void currentIndexChanged();
+
+private:
+    bool isValidRow(int row) const { return row >= 0 && row < m_entries.size(); }
+    void addDuration(int delta);
+
+    QueueSequence m_entries;
+    int m_totalDuration = 0;
+    int m_currentIndex = -1;
+};
+
+} // namespace Mtoc
+
+#endif // QUEUELISTMODEL_H
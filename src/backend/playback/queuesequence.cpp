@@ -0,0 +1,158 @@
+#include "queuesequence.h"
+
+#include <algorithm>
+
+namespace Mtoc {
+
+QueueSequence::const_iterator &QueueSequence::const_iterator::operator++()
+{
+    if (++m_offset >= m_sequence->m_chunks.at(m_chunk)->size()) {
+        ++m_chunk;
+        m_offset = 0;
+    }
+    return *this;
+}
+
+QueueSequence::QueueSequence(const QList<QueueEntry> &entries)
+{
+    insert(0, entries);
+}
+
+const QueueEntry &QueueSequence::at(int index) const
+{
+    int offset = 0;
+    int chunk = chunkFor(index, &offset);
+    return m_chunks.at(chunk)->at(offset);
+}
+
+int QueueSequence::chunkFor(int index, int *offset) const
+{
+    auto it = std::upper_bound(m_chunkEnds.cbegin(), m_chunkEnds.cend(), index);
+    int chunk = int(it - m_chunkEnds.cbegin());
+    *offset = index - (chunk > 0 ? m_chunkEnds.at(chunk - 1) : 0);
+    return chunk;
+}
+
+QList<QueueSequence::ChunkPointer> QueueSequence::split(const Chunk &entries)
+{
+    QList<ChunkPointer> chunks;
+    if (entries.size() <= MAX_CHUNK_SIZE) {
+        chunks.append(std::make_shared<const Chunk>(entries));
+        return chunks;
+    }
+
+    chunks.reserve(entries.size() / CHUNK_SIZE + 1);
+    for (int start = 0; start < entries.size(); start += CHUNK_SIZE) {
+        chunks.append(std::make_shared<const Chunk>(entries.mid(start, CHUNK_SIZE)));
+    }
+    return chunks;
+}
+
+void QueueSequence::updateChunkEnds(int fromChunk)
+{
+    m_chunkEnds.resize(m_chunks.size());
+    int total = fromChunk > 0 ? m_chunkEnds.at(fromChunk - 1) : 0;
+    for (int i = fromChunk; i < m_chunks.size(); ++i) {
+        total += m_chunks.at(i)->size();
+        m_chunkEnds[i] = total;
+    }
+}
+
+void QueueSequence::insert(int index, const QList<QueueEntry> &entries)
+{
+    if (entries.isEmpty()) {
+        return;
+    }
+
+    if (m_chunks.isEmpty()) {
+        m_chunks = split(entries);
+        updateChunkEnds(0);
+        return;
+    }
+
+    index = qBound(0, index, size());
+    int offset = 0;
+    int chunk = 0;
+    if (index == size()) {
+        chunk = int(m_chunks.size()) - 1;
+        offset = int(m_chunks.last()->size());
+    } else {
+        chunk = chunkFor(index, &offset);
+    }
+
+    // Only the chunk receiving the entries is rebuilt
+    const Chunk &target = *m_chunks.at(chunk);
+    Chunk merged;
+    merged.reserve(target.size() + entries.size());
+    merged.append(target.mid(0, offset));
+    merged.append(entries);
+    merged.append(target.mid(offset));
+
+    QList<ChunkPointer> chunks;
+    chunks.reserve(m_chunks.size() + merged.size() / CHUNK_SIZE + 1);
+    chunks.append(m_chunks.mid(0, chunk));
+    chunks.append(split(merged));
+    chunks.append(m_chunks.mid(chunk + 1));
+    m_chunks = std::move(chunks);
+    updateChunkEnds(chunk);
+}
+
+void QueueSequence::remove(int index, int count)
+{
+    if (index < 0 || index >= size() || count <= 0) {
+        return;
+    }
+    count = qMin(count, size() - index);
+
+    while (count > 0) {
+        int offset = 0;
+        int chunk = chunkFor(index, &offset);
+        const Chunk &target = *m_chunks.at(chunk);
+        int removed = qMin(count, int(target.size()) - offset);
+
+        if (removed == target.size()) {
+            m_chunks.removeAt(chunk);
+        } else {
+            Chunk remaining = target;
+            remaining.remove(offset, removed);
+            // Fold small leftovers into the next chunk so edits don't fragment the sequence
+            if (chunk + 1 < m_chunks.size() && remaining.size() + m_chunks.at(chunk + 1)->size() <= CHUNK_SIZE) {
+                remaining.append(*m_chunks.at(chunk + 1));
+                m_chunks.removeAt(chunk + 1);
+            }
+            m_chunks[chunk] = std::make_shared<const Chunk>(remaining);
+        }
+
+        updateChunkEnds(chunk);
+        count -= removed;
+    }
+}
+
+void QueueSequence::move(int from, int to)
+{
+    if (from == to || from < 0 || from >= size() || to < 0 || to >= size()) {
+        return;
+    }
+
+    QueueEntry entry = at(from);
+    remove(from);
+    insert(to, {entry});
+}
+
+void QueueSequence::clear()
+{
+    m_chunks.clear();
+    m_chunkEnds.clear();
+}
+
+QList<QueueEntry> QueueSequence::toList() const
+{
+    QList<QueueEntry> entries;
+    entries.reserve(size());
+    for (const ChunkPointer &chunk : m_chunks) {
+        entries.append(*chunk);
+    }
+    return entries;
+}
+
+} // namespace Mtoc
@@ -0,0 +1,78 @@
+#ifndef QUEUESEQUENCE_H
+#define QUEUESEQUENCE_H
+
+#include <QList>
+#include <memory>
+#include "queueentry.h"
+
+namespace Mtoc {
+
+// Persistent sequence of queue entries. The entries are stored in fixed-size
+// chunks that are shared between copies and never modified in place: an edit
+// replaces only the chunks it touches. Copying a sequence copies the chunk
+// pointer list (about one pointer per CHUNK_SIZE entries), so keeping many
+// versions of a large queue costs little more than one copy of it.
+class QueueSequence
+{
+public:
+    class const_iterator
+    {
+    public:
+        const QueueEntry &operator*() const { return m_sequence->m_chunks.at(m_chunk)->at(m_offset); }
+        const QueueEntry *operator->() const { return &operator*(); }
+        const_iterator &operator++();
+        bool operator==(const const_iterator &other) const
+        {
+            return m_chunk == other.m_chunk && m_offset == other.m_offset;
+        }
+        bool operator!=(const const_iterator &other) const { return !(*this == other); }
+
+    private:
+        friend class QueueSequence;
+        const_iterator(const QueueSequence *sequence, int chunk, int offset)
+            : m_sequence(sequence), m_chunk(chunk), m_offset(offset) {}
+
+        const QueueSequence *m_sequence;
+        int m_chunk;
+        int m_offset;
+    };
+
+    QueueSequence() = default;
+    explicit QueueSequence(const QList<QueueEntry> &entries);
+
+    int size() const { return m_chunkEnds.isEmpty() ? 0 : m_chunkEnds.last(); }
+    bool isEmpty() const { return m_chunks.isEmpty(); }
+    const QueueEntry &at(int index) const;
+
+    const_iterator begin() const { return const_iterator(this, 0, 0); }
+    const_iterator end() const { return const_iterator(this, int(m_chunks.size()), 0); }
+
+    void insert(int index, const QList<QueueEntry> &entries);
+    void append(const QList<QueueEntry> &entries) { insert(size(), entries); }
+    void remove(int index, int count = 1);
+    void move(int from, int to);
+    void clear();
+
+    QList<QueueEntry> toList() const;
+
+private:
+    using Chunk = QList<QueueEntry>;
+    using ChunkPointer = std::shared_ptr<const Chunk>;
+
+    // New chunks are cut at CHUNK_SIZE; an edited chunk may grow to
+    // MAX_CHUNK_SIZE before it is split again
+    static const int CHUNK_SIZE = 64;
+    static const int MAX_CHUNK_SIZE = 2 * CHUNK_SIZE;
+
+    // Chunk holding index and the index's offset within it
+    int chunkFor(int index, int *offset) const;
+    static QList<ChunkPointer> split(const Chunk &entries);
+    void updateChunkEnds(int fromChunk);
+
+    QList<ChunkPointer> m_chunks;
+    QList<int> m_chunkEnds;  // Running entry count at the end of each chunk
+};
+
+} // namespace Mtoc
+
+#endif // QUEUESEQUENCE_H
@@ -0,0 +1,221 @@
+#include "trackprefetcher.h"
+
+#include <QFile>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QDebug>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+namespace Mtoc {
+
+namespace {
+
+// Enough for tags and embedded art plus several seconds of hi-res FLAC
+const qint64 HEAD_BYTES = 4 * 1024 * 1024;
+const qint64 READ_CHUNK = 256 * 1024;
+
+#ifdef Q_OS_LINUX
+// From linux/ioprio.h, which is not always installed
+const int IOPRIO_CLASS_SHIFT = 13;
+const int IOPRIO_CLASS_BE = 2;
+const int IOPRIO_CLASS_IDLE = 3;
+const int IOPRIO_WHO_PROCESS = 1;
+#endif
+
+void applyIoPriority(TrackPrefetcher::IoPriority priority)
+{
+#ifdef Q_OS_LINUX
+    int value = 0;
+    switch (priority) {
+    case TrackPrefetcher::IdleIo:
+        value = IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT;
+        break;
+    case TrackPrefetcher::LowIo:
+        value = (IOPRIO_CLASS_BE << IOPRIO_CLASS_SHIFT) | 7;
+        break;
+    case TrackPrefetcher::NormalIo:
+        value = (IOPRIO_CLASS_BE << IOPRIO_CLASS_SHIFT) | 4;
+        break;
+    }
+    // Who 0 with IOPRIO_WHO_PROCESS is the calling thread
+    if (syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, value) != 0) {
+        qDebug() << "[TrackPrefetcher::applyIoPriority] ioprio_set failed, reading at default priority";
+    }
+#else
+    Q_UNUSED(priority)
+#endif
+}
+
+} // namespace
+
+TrackPrefetcher::TrackPrefetcher(QObject *parent)
+    : QObject(parent)
+{
+    // One thread: reads for the next track should not compete with the one after it
+    m_pool.setMaxThreadCount(1);
+    m_pool.setThreadPriority(QThread::LowestPriority);
+}
+
+TrackPrefetcher::~TrackPrefetcher()
+{
+    // Workers read m_generation, so they must be done before it goes away
+    cancel();
+    m_pool.waitForDone();
+}
+
+void TrackPrefetcher::setBudget(qint64 bytes)
+{
+    m_budget = qMax<qint64>(0, bytes);
+    if (m_budget == 0) {
+        cancel();
+    }
+}
+
+void TrackPrefetcher::setIoPriority(IoPriority priority)
+{
+    m_ioPriority = priority;
+}
+
+void TrackPrefetcher::prefetch(const QStringList &paths)
+{
+    // Anything still being read belongs to the previous window
+    const quint64 generation = ++m_generation;
+
+    QHash<QString, Window> window;
+    qint64 used = 0;
+    for (const QString &path : paths) {
+        if (used >= m_budget) {
+            break;
+        }
+        if (path.isEmpty() || window.contains(path)) {
+            continue;
+        }
+
+        auto it = m_window.constFind(path);
+        if (it != m_window.constEnd() && it->done) {
+            window.insert(path, *it);
+            used += it->bytes;
+            continue;
+        }
+
+        const qint64 bytes = qMin(HEAD_BYTES, m_budget - used);
+        window.insert(path, {bytes, false});
+        used += bytes;
+
+        const IoPriority priority = m_ioPriority;
+        m_pool.start([this, path, bytes, priority, generation]() {
+            const qint64 bytesRead = warmFile(path, bytes, priority, m_generation, generation);
+            QMetaObject::invokeMethod(this, [this, path, generation, bytesRead]() {
+                onFileWarmed(path, generation, bytesRead);
+            }, Qt::QueuedConnection);
+        });
+    }
+
+    m_window = window;
+}
+
+void TrackPrefetcher::cancel()
+{
+    ++m_generation;
+    m_window.clear();
+}
+
+bool TrackPrefetcher::isWarm(const QString &path) const
+{
+    auto it = m_window.constFind(path);
+    return it != m_window.constEnd() && it->done;
+}
+
+qint64 TrackPrefetcher::warmFile(const QString &path, qint64 bytes, IoPriority priority,
+                                 const std::atomic<quint64> &generation, quint64 jobGeneration)
+{
+    if (generation.load(std::memory_order_relaxed) != jobGeneration) {
+        return -1;
+    }
+
+    applyIoPriority(priority);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        qDebug() << "[TrackPrefetcher::warmFile] Cannot open" << path << "-" << file.errorString();
+        return -1;
+    }
+    bytes = qMin(bytes, file.size());
+
+#ifdef Q_OS_LINUX
+    // Lets the kernel queue the whole range at once, so the reads below mostly
+    // wait on I/O that is already in flight
+    posix_fadvise(file.handle(), 0, bytes, POSIX_FADV_WILLNEED);
+#endif
+
+    // Network filesystems may ignore the advice, so read the range for real
+    QByteArray buffer(int(qMin(READ_CHUNK, qMax<qint64>(bytes, 1))), Qt::Uninitialized);
+    qint64 total = 0;
+    while (total < bytes) {
+        if (generation.load(std::memory_order_relaxed) != jobGeneration) {
+            return -1;
+        }
+        const qint64 n = file.read(buffer.data(), qMin<qint64>(buffer.size(), bytes - total));
+        if (n <= 0) {
+            break;
+        }
+        total += n;
+    }
+
+    qDebug() << "[TrackPrefetcher::warmFile] Read ahead" << total / 1024 << "KB of" << path
+             << "in" << timer.elapsed() << "ms";
+    return total;
+}
+
+void TrackPrefetcher::onFileWarmed(const QString &path, quint64 jobGeneration, qint64 bytesRead)
+{
+    // A newer window has re-requested the file if it still needs it
+    if (jobGeneration != m_generation || bytesRead < 0) {
+        return;
+    }
+    auto it = m_window.find(path);
+    if (it != m_window.end()) {
+        it->done = true;
+    }
+}
+
+void TrackPrefetcher::recordStartLatency(qint64 msec, StartKind kind)
+{
+    LatencyStats &stats = m_latency[kind];
+    ++stats.count;
+    stats.totalMs += msec;
+    stats.maxMs = qMax(stats.maxMs, msec);
+    m_lastLatencyMs = msec;
+    m_lastStartKind = kind;
+
+    qDebug() << "[TrackPrefetcher::recordStartLatency] Skip-to-audio latency:" << msec << "ms"
+             << (kind == StandbyStart ? "(standby)" : kind == ReadAheadStart ? "(read ahead)" : "(cold)");
+    emit latencyStatsChanged();
+}
+
+QVariantMap TrackPrefetcher::latencyStats() const
+{
+    static const char *const prefixes[] = { "cold", "warm", "standby" };
+
+    QVariantMap map;
+    map["lastMs"] = m_lastLatencyMs;
+    map["lastKind"] = QString::fromLatin1(prefixes[m_lastStartKind]);
+    for (int kind = ColdStart; kind <= StandbyStart; ++kind) {
+        const LatencyStats &stats = m_latency[kind];
+        const QString prefix = QString::fromLatin1(prefixes[kind]);
+        map[prefix + "Count"] = stats.count;
+        map[prefix + "MeanMs"] = stats.count > 0 ? double(stats.totalMs) / stats.count : 0.0;
+        map[prefix + "MaxMs"] = stats.maxMs;
+    }
+    return map;
+}
+
+} // namespace Mtoc
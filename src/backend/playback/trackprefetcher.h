@@ -0,0 +1,91 @@
+#ifndef TRACKPREFETCHER_H
+#define TRACKPREFETCHER_H
+
+#include <QObject>
+#include <QHash>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVariantMap>
+#include <atomic>
+
+namespace Mtoc {
+
+// Warms the page cache for the tracks that are about to play, so skipping to
+// one on a NAS or a spun-down disk does not stall on a cold open. For each
+// upcoming file it advises the kernel to read ahead and then reads the head
+// of the file (tags, embedded art and the first seconds of audio) on a single
+// low priority worker thread. The tracks warmed at any time are capped by a
+// byte budget; a new window cancels whatever is still in flight.
+//
+// It also keeps skip-to-audio latency, split by how the track was prepared,
+// so the effect can be measured against cold caches.
+class TrackPrefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum IoPriority {
+        IdleIo,       // Only when the disk is otherwise idle
+        LowIo,        // Best effort, lowest level
+        NormalIo      // Best effort, default level
+    };
+
+    // How a track that started playing had been prepared
+    enum StartKind {
+        ColdStart,
+        ReadAheadStart,   // Its head was in the page cache
+        StandbyStart      // A prerolled standby pipeline was swapped in
+    };
+
+    explicit TrackPrefetcher(QObject *parent = nullptr);
+    ~TrackPrefetcher();
+
+    void setBudget(qint64 bytes);
+    qint64 budget() const { return m_budget; }
+    void setIoPriority(IoPriority priority);
+
+    // Upcoming tracks in play order. Files already warmed stay warm, the rest
+    // are read in order until the budget runs out.
+    void prefetch(const QStringList &paths);
+    void cancel();
+
+    // True once the head of the file has been read ahead
+    bool isWarm(const QString &path) const;
+
+    // Time from loading a track to audio running
+    void recordStartLatency(qint64 msec, StartKind kind);
+    QVariantMap latencyStats() const;
+
+signals:
+    void latencyStatsChanged();
+
+private:
+    struct Window {
+        qint64 bytes = 0;
+        bool done = false;
+    };
+
+    struct LatencyStats {
+        int count = 0;
+        qint64 totalMs = 0;
+        qint64 maxMs = 0;
+    };
+
+    static qint64 warmFile(const QString &path, qint64 bytes, IoPriority priority,
+                           const std::atomic<quint64> &generation, quint64 jobGeneration);
+    void onFileWarmed(const QString &path, quint64 jobGeneration, qint64 bytesRead);
+
+    QThreadPool m_pool;
+    std::atomic<quint64> m_generation{0};
+    QHash<QString, Window> m_window;
+    qint64 m_budget = 0;
+    IoPriority m_ioPriority = IdleIo;
+
+    LatencyStats m_latency[StandbyStart + 1];
+    qint64 m_lastLatencyMs = -1;
+    StartKind m_lastStartKind = ColdStart;
+};
+
+} // namespace Mtoc
+
+#endif // TRACKPREFETCHER_H
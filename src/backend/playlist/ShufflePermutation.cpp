@@ -0,0 +1,143 @@
+#include "ShufflePermutation.h"
+
+namespace Mtoc {
+
+namespace {
+
+// splitmix64 finaliser, used both to derive round keys and as the round function
+quint64 mix64(quint64 x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+} // namespace
+
+void ShufflePermutation::reset(int size, quint64 seed, int pinnedFirst)
+{
+    clear();
+    if (size <= 0) {
+        return;
+    }
+
+    m_size = size;
+    m_seed = seed;
+
+    // Smallest even bit width whose domain covers size (at most 4x size)
+    int bits = 2;
+    while ((quint64(1) << bits) < quint64(size)) {
+        ++bits;
+    }
+    if (bits % 2) {
+        ++bits;
+    }
+    m_halfBits = bits / 2;
+    m_halfMask = (quint32(1) << m_halfBits) - 1;
+
+    quint64 state = seed;
+    for (int i = 0; i < ROUNDS; ++i) {
+        state = mix64(state);
+        m_keys[i] = state;
+    }
+
+    if (pinnedFirst >= 0 && pinnedFirst < size) {
+        m_pinnedFirst = pinnedFirst;
+        m_swapPosition = unpermute(pinnedFirst);
+    }
+}
+
+void ShufflePermutation::clear()
+{
+    m_size = 0;
+    m_seed = 0;
+    m_pinnedFirst = -1;
+    m_swapPosition = -1;
+    m_halfBits = 0;
+    m_halfMask = 0;
+}
+
+int ShufflePermutation::indexAt(int position) const
+{
+    if (position < 0 || position >= m_size) {
+        return -1;
+    }
+
+    // Pinning swaps position 0 with wherever the pinned item would naturally be
+    if (m_pinnedFirst >= 0) {
+        if (position == 0) {
+            return m_pinnedFirst;
+        }
+        if (position == m_swapPosition) {
+            return permute(0);
+        }
+    }
+    return permute(position);
+}
+
+int ShufflePermutation::positionOf(int index) const
+{
+    if (index < 0 || index >= m_size) {
+        return -1;
+    }
+
+    if (m_pinnedFirst >= 0) {
+        if (index == m_pinnedFirst) {
+            return 0;
+        }
+        int position = unpermute(index);
+        return position == 0 ? m_swapPosition : position;
+    }
+    return unpermute(index);
+}
+
+quint32 ShufflePermutation::round(quint32 half, int roundIndex) const
+{
+    return quint32(mix64(half ^ m_keys[roundIndex])) & m_halfMask;
+}
+
+quint32 ShufflePermutation::encrypt(quint32 value) const
+{
+    quint32 left = value >> m_halfBits;
+    quint32 right = value & m_halfMask;
+    for (int i = 0; i < ROUNDS; ++i) {
+        quint32 next = left ^ round(right, i);
+        left = right;
+        right = next;
+    }
+    return (left << m_halfBits) | right;
+}
+
+quint32 ShufflePermutation::decrypt(quint32 value) const
+{
+    quint32 left = value >> m_halfBits;
+    quint32 right = value & m_halfMask;
+    for (int i = ROUNDS - 1; i >= 0; --i) {
+        quint32 previous = right ^ round(left, i);
+        right = left;
+        left = previous;
+    }
+    return (left << m_halfBits) | right;
+}
+
+int ShufflePermutation::permute(int position) const
+{
+    // Cycle walking: re-encrypt until the value falls back inside [0, size)
+    quint32 value = encrypt(quint32(position));
+    while (value >= quint32(m_size)) {
+        value = encrypt(value);
+    }
+    return int(value);
+}
+
+int ShufflePermutation::unpermute(int index) const
+{
+    quint32 value = decrypt(quint32(index));
+    while (value >= quint32(m_size)) {
+        value = decrypt(value);
+    }
+    return int(value);
+}
+
+} // namespace Mtoc
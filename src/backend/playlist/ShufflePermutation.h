@@ -0,0 +1,50 @@
+#ifndef SHUFFLEPERMUTATION_H
+#define SHUFFLEPERMUTATION_H
+
+#include <QtGlobal>
+
+namespace Mtoc {
+
+// Seeded bijection over [0, size) with O(1) memory and O(1) expected forward and
+// inverse lookups. Built from a 4-round Feistel network over the smallest even
+// power-of-two domain covering size, with cycle walking to stay inside the range.
+// The same (size, seed, pinnedFirst) always yields the same order, so only the
+// seed has to be persisted to restore a shuffle exactly.
+class ShufflePermutation
+{
+public:
+    ShufflePermutation() = default;
+
+    // pinnedFirst, when in range, is placed at position 0
+    void reset(int size, quint64 seed, int pinnedFirst = -1);
+    void clear();
+
+    bool isValid() const { return m_size > 0; }
+    int size() const { return m_size; }
+    quint64 seed() const { return m_seed; }
+    int pinnedFirst() const { return m_pinnedFirst; }
+
+    int indexAt(int position) const;     // position in shuffle order -> item index
+    int positionOf(int index) const;     // item index -> position in shuffle order
+
+private:
+    quint32 encrypt(quint32 value) const;
+    quint32 decrypt(quint32 value) const;
+    quint32 round(quint32 half, int roundIndex) const;
+    int permute(int position) const;
+    int unpermute(int index) const;
+
+    static const int ROUNDS = 4;
+
+    int m_size = 0;
+    quint64 m_seed = 0;
+    int m_pinnedFirst = -1;
+    int m_swapPosition = -1;  // Where pinnedFirst would have landed without pinning
+    int m_halfBits = 0;
+    quint32 m_halfMask = 0;
+    quint64 m_keys[ROUNDS] = {};
+};
+
+} // namespace Mtoc
+
+#endif // SHUFFLEPERMUTATION_H
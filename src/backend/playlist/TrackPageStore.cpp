@@ -0,0 +1,312 @@
+#include "TrackPageStore.h"
+#include <QDebug>
+#include <QDateTime>
+#include <limits>
+
+namespace Mtoc {
+
+StringPool::StringPool()
+{
+    clear();
+}
+
+quint32 StringPool::intern(const QString& value)
+{
+    if (value.isEmpty()) {
+        return 0;
+    }
+
+    auto it = m_index.constFind(value);
+    if (it != m_index.constEnd()) {
+        return it.value();
+    }
+
+    quint32 handle = quint32(m_strings.size());
+    m_strings.append(value);
+    m_index.insert(value, handle);
+    // String payload is shared between the vector and the hash key
+    m_bytes += qint64(value.size()) * qint64(sizeof(QChar)) + qint64(sizeof(QString)) * 2 + 16;
+    return handle;
+}
+
+const QString& StringPool::at(quint32 handle) const
+{
+    if (handle >= quint32(m_strings.size())) {
+        return m_strings.first();
+    }
+    return m_strings[handle];
+}
+
+void StringPool::clear()
+{
+    m_strings.clear();
+    m_index.clear();
+    // Handle 0 is always the empty string
+    m_strings.append(QString());
+    m_bytes = 0;
+}
+
+TrackPageStore::TrackPageStore()
+{
+}
+
+TrackPageStore::~TrackPageStore()
+{
+    clear();
+}
+
+void TrackPageStore::reset(int rowCount)
+{
+    clear();
+    int pages = rowCount > 0 ? (rowCount + TrackPage::ROWS - 1) / TrackPage::ROWS : 0;
+    m_pages.resize(pages, nullptr);
+}
+
+void TrackPageStore::clear()
+{
+    qDeleteAll(m_pages);
+    qDeleteAll(m_freePages);
+    m_pages.clear();
+    m_freePages.clear();
+    m_residentPages.clear();
+    m_strings.clear();
+    m_pageBytes = 0;
+    m_residentRows = 0;
+    m_tick = 0;
+    for (PinWindow& pin : m_pins) {
+        pin = PinWindow();
+    }
+}
+
+void TrackPageStore::resize(int rowCount, int keepRows)
+{
+    const int firstStalePage = qMax(0, keepRows) / TrackPage::ROWS;
+    for (int page = firstStalePage; page < m_pages.size(); ++page) {
+        releasePage(page);
+    }
+
+    int pages = rowCount > 0 ? (rowCount + TrackPage::ROWS - 1) / TrackPage::ROWS : 0;
+    m_pages.resize(pages, nullptr);
+}
+
+bool TrackPageStore::isPageResident(int page) const
+{
+    return page >= 0 && page < m_pages.size() && m_pages[page] != nullptr;
+}
+
+bool TrackPageStore::isRowResident(int row) const
+{
+    if (row < 0) {
+        return false;
+    }
+    int page = pageOf(row);
+    return isPageResident(page) && row - pageStart(page) < m_pages[page]->rowCount;
+}
+
+bool TrackPageStore::isRangeResident(int firstRow, int lastRow) const
+{
+    if (firstRow < 0 || lastRow < firstRow) {
+        return false;
+    }
+    // Interior pages are full, so only the last page needs a row-count check
+    for (int page = pageOf(firstRow); page < pageOf(lastRow); ++page) {
+        if (!isPageResident(page)) {
+            return false;
+        }
+    }
+    return isRowResident(lastRow);
+}
+
+QVector<int> TrackPageStore::storePage(int page, const QVariantList& tracks)
+{
+    if (page < 0 || page >= m_pages.size()) {
+        return QVector<int>();
+    }
+
+    if (m_pages[page]) {
+        releasePage(page);
+    }
+
+    TrackPage* block = allocatePage();
+    int count = qMin(int(tracks.size()), int(TrackPage::ROWS));
+
+    // Reserve the arena once for the whole page
+    int textLength = 0;
+    for (int i = 0; i < count; ++i) {
+        const QVariantMap map = tracks[i].toMap();
+        textLength += map.value("filePath").toString().size() + map.value("title").toString().size();
+    }
+    block->text.reserve(textLength);
+
+    for (int i = 0; i < count; ++i) {
+        const QVariantMap map = tracks[i].toMap();
+        TrackPage::Row& row = block->rows[i];
+        row.id = map.value("id").toInt();
+        row.year = map.value("year").toInt();
+        row.trackNumber = map.value("trackNumber").toInt();
+        row.discNumber = map.value("discNumber").toInt();
+        row.duration = map.value("duration").toInt();
+        row.playCount = map.value("playCount").toInt();
+        row.rating = map.value("rating").toInt();
+        row.fileSize = map.value("fileSize").toLongLong();
+        QDateTime lastPlayed = map.value("lastPlayed").toDateTime();
+        row.lastPlayedMs = lastPlayed.isValid() ? lastPlayed.toMSecsSinceEpoch() : 0;
+        row.artist = m_strings.intern(map.value("artist").toString());
+        row.album = m_strings.intern(map.value("album").toString());
+        row.albumArtist = m_strings.intern(map.value("albumArtist").toString());
+        row.genre = m_strings.intern(map.value("genre").toString());
+        appendText(block, map.value("filePath").toString(), row.filePathOffset, row.filePathLength);
+        appendText(block, map.value("title").toString(), row.titleOffset, row.titleLength);
+    }
+
+    block->rowCount = count;
+    block->lastUsed = ++m_tick;
+    m_pages[page] = block;
+    m_residentPages.append(page);
+    m_pageBytes += block->bytes();
+    m_residentRows += count;
+
+    return evictToBudget();
+}
+
+VirtualTrackData TrackPageStore::row(int row) const
+{
+    VirtualTrackData data;
+    if (!isRowResident(row)) {
+        return data;
+    }
+
+    TrackPage* page = m_pages[pageOf(row)];
+    page->lastUsed = ++m_tick;
+
+    const TrackPage::Row& r = page->rows[row - pageStart(pageOf(row))];
+    data.id = r.id;
+    data.filePath = textAt(page, r.filePathOffset, r.filePathLength);
+    data.title = textAt(page, r.titleOffset, r.titleLength);
+    data.artist = m_strings.at(r.artist);
+    data.album = m_strings.at(r.album);
+    data.albumArtist = m_strings.at(r.albumArtist);
+    data.genre = m_strings.at(r.genre);
+    data.year = r.year;
+    data.trackNumber = r.trackNumber;
+    data.discNumber = r.discNumber;
+    data.duration = r.duration;
+    data.fileSize = r.fileSize;
+    data.playCount = r.playCount;
+    data.rating = r.rating;
+    if (r.lastPlayedMs > 0) {
+        data.lastPlayed = QDateTime::fromMSecsSinceEpoch(r.lastPlayedMs);
+    }
+    return data;
+}
+
+void TrackPageStore::setPinnedWindow(int slot, int firstRow, int lastRow)
+{
+    if (slot < 0 || slot >= PinSlotCount) {
+        return;
+    }
+
+    if (firstRow < 0 || lastRow < firstRow) {
+        m_pins[slot] = PinWindow();
+        return;
+    }
+
+    m_pins[slot].firstPage = pageOf(firstRow);
+    m_pins[slot].lastPage = pageOf(lastRow);
+}
+
+QVector<int> TrackPageStore::evictToBudget()
+{
+    QVector<int> evicted;
+
+    while (residentBytes() > m_budgetBytes) {
+        // Resident set is bounded by the budget, so a linear scan for the oldest page is cheap
+        int victimSlot = -1;
+        quint64 oldest = std::numeric_limits<quint64>::max();
+        for (int i = 0; i < m_residentPages.size(); ++i) {
+            int page = m_residentPages[i];
+            if (isPinned(page)) {
+                continue;
+            }
+            if (m_pages[page]->lastUsed < oldest) {
+                oldest = m_pages[page]->lastUsed;
+                victimSlot = i;
+            }
+        }
+
+        if (victimSlot < 0) {
+            // Everything left is pinned; allow the overshoot
+            break;
+        }
+
+        int page = m_residentPages[victimSlot];
+        releasePage(page);
+        evicted.append(page);
+    }
+
+    return evicted;
+}
+
+qint64 TrackPageStore::residentBytes() const
+{
+    return m_pageBytes + m_strings.bytes()
+           + qint64(m_pages.size()) * qint64(sizeof(TrackPage*));
+}
+
+TrackPage* TrackPageStore::allocatePage()
+{
+    if (!m_freePages.isEmpty()) {
+        TrackPage* block = m_freePages.takeLast();
+        block->text.resize(0);
+        block->rowCount = 0;
+        return block;
+    }
+    return new TrackPage;
+}
+
+void TrackPageStore::releasePage(int page)
+{
+    TrackPage* block = m_pages[page];
+    if (!block) {
+        return;
+    }
+
+    m_pageBytes -= block->bytes();
+    m_residentRows -= block->rowCount;
+    m_pages[page] = nullptr;
+    m_residentPages.removeOne(page);
+
+    // Keep a few blocks around so a scrolling window recycles instead of reallocating
+    if (m_freePages.size() < MAX_FREE_PAGES) {
+        m_freePages.append(block);
+    } else {
+        delete block;
+    }
+}
+
+bool TrackPageStore::isPinned(int page) const
+{
+    for (const PinWindow& pin : m_pins) {
+        if (pin.firstPage >= 0 && page >= pin.firstPage && page <= pin.lastPage) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TrackPageStore::appendText(TrackPage* page, const QString& value, quint32& offset, quint16& length)
+{
+    offset = quint32(page->text.size());
+    length = quint16(qMin(int(value.size()), 0xFFFF));
+    page->text.append(value.constData(), length);
+}
+
+QString TrackPageStore::textAt(const TrackPage* page, quint32 offset, quint16 length) const
+{
+    if (length == 0) {
+        return QString();
+    }
+    return QString(page->text.constData() + offset, length);
+}
+
+} // namespace Mtoc
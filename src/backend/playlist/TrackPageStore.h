@@ -0,0 +1,139 @@
+#ifndef TRACKPAGESTORE_H
+#define TRACKPAGESTORE_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QVariantMap>
+#include "VirtualTrackData.h"
+
+namespace Mtoc {
+
+// Deduplicating string table. Artist, album and genre names repeat across thousands
+// of rows, so rows store a 32-bit handle instead of their own QString copy.
+class StringPool
+{
+public:
+    StringPool();
+
+    quint32 intern(const QString& value);
+    const QString& at(quint32 handle) const;
+    int size() const { return m_strings.size(); }
+    qint64 bytes() const { return m_bytes; }
+    void clear();
+
+private:
+    QVector<QString> m_strings;
+    QHash<QString, quint32> m_index;
+    qint64 m_bytes = 0;
+};
+
+// Fixed-size block of rows for VirtualPlaylist. Per-row unique strings (file path,
+// title) are packed into one arena buffer per page rather than one heap string each.
+struct TrackPage {
+    static const int ROWS = 64;
+
+    struct Row {
+        int id = 0;
+        int year = 0;
+        int trackNumber = 0;
+        int discNumber = 0;
+        int duration = 0;
+        int playCount = 0;
+        int rating = 0;
+        qint64 fileSize = 0;
+        qint64 lastPlayedMs = 0;
+        quint32 artist = 0;
+        quint32 album = 0;
+        quint32 albumArtist = 0;
+        quint32 genre = 0;
+        quint32 filePathOffset = 0;
+        quint32 titleOffset = 0;
+        quint16 filePathLength = 0;
+        quint16 titleLength = 0;
+    };
+
+    Row rows[ROWS];
+    QString text;          // Arena for file paths and titles
+    int rowCount = 0;
+    quint64 lastUsed = 0;  // LRU tick
+
+    qint64 bytes() const { return qint64(sizeof(TrackPage)) + qint64(text.capacity()) * qint64(sizeof(QChar)); }
+};
+
+// Paged row storage with a resident-bytes budget. Pages that fall outside the
+// pinned windows (playback cursor, visible rows) are evicted least-recently-used
+// first once the budget is exceeded. Not thread-safe; VirtualPlaylist serialises access.
+class TrackPageStore
+{
+public:
+    TrackPageStore();
+    ~TrackPageStore();
+
+    void reset(int rowCount);
+    void clear();
+    // Resizes the page table to rowCount, keeping only pages that lie entirely
+    // before keepRows (rows from keepRows on have shifted or changed)
+    void resize(int rowCount, int keepRows);
+
+    int pageCount() const { return m_pages.size(); }
+    static int pageOf(int row) { return row / TrackPage::ROWS; }
+    static int pageStart(int page) { return page * TrackPage::ROWS; }
+
+    // O(1): the page table doubles as the residency map
+    bool isPageResident(int page) const;
+    bool isRowResident(int row) const;
+    bool isRangeResident(int firstRow, int lastRow) const;
+    int residentRowCount() const { return m_residentRows; }
+
+    // Stores rows [pageStart(page), pageStart(page) + tracks.size()). Returns the
+    // pages evicted to stay within budget so the caller can update its bookkeeping.
+    QVector<int> storePage(int page, const QVariantList& tracks);
+
+    VirtualTrackData row(int row) const;  // Touches the page for LRU
+
+    // Residency control
+    void setBudgetBytes(qint64 bytes) { m_budgetBytes = bytes; }
+    qint64 budgetBytes() const { return m_budgetBytes; }
+    void setPinnedWindow(int slot, int firstRow, int lastRow);
+    QVector<int> evictToBudget();
+
+    // Metrics
+    qint64 residentBytes() const;
+    int residentPageCount() const { return m_residentPages.size(); }
+    int internedStringCount() const { return m_strings.size(); }
+
+    enum PinSlot {
+        PlaybackPin = 0,
+        VisiblePin,
+        PinSlotCount
+    };
+
+private:
+    TrackPage* allocatePage();
+    void releasePage(int page);
+    bool isPinned(int page) const;
+    void appendText(TrackPage* page, const QString& value, quint32& offset, quint16& length);
+    QString textAt(const TrackPage* page, quint32 offset, quint16 length) const;
+
+    QVector<TrackPage*> m_pages;          // nullptr when not resident
+    QVector<int> m_residentPages;         // Indices of non-null pages
+    QVector<TrackPage*> m_freePages;      // Recycled page blocks
+    StringPool m_strings;
+    qint64 m_pageBytes = 0;
+    int m_residentRows = 0;
+    qint64 m_budgetBytes = 16 * 1024 * 1024;
+    mutable quint64 m_tick = 0;
+
+    struct PinWindow {
+        int firstPage = -1;
+        int lastPage = -1;
+    };
+    PinWindow m_pins[PinSlotCount];
+
+    static const int MAX_FREE_PAGES = 8;
+};
+
+} // namespace Mtoc
+
+#endif // TRACKPAGESTORE_H
@@ -3,7 +3,8 @@
 #include <QDebug>
 #include <QtConcurrent>
 #include <algorithm>
-#include <random>
+#include <limits>
+#include <QRandomGenerator>
 #include <QThread>
 #include <QSqlDatabase>
 
@@ -17,23 +18,25 @@ VirtualPlaylist::VirtualPlaylist(DatabaseManager* dbManager, QObject *parent)
 
 VirtualPlaylist::~VirtualPlaylist()
 {
-    if (m_loadFuture.isRunning()) {
-        m_loadFuture.cancel();
-        m_loadFuture.waitForFinished();
-    }
-    
-    // Clean up all allocated tracks
+    // Clean up all allocated tracks (also stops the loader)
     clear();
 }
 
 void VirtualPlaylist::loadAllTracks()
 {
-    if (m_isLoading) {
-        qDebug() << "[VirtualPlaylist] Already loading, skipping request";
-        return;
-    }
+    {
+        QMutexLocker locker(&m_requestMutex);
+        if (m_isLoading) {
+            qDebug() << "[VirtualPlaylist] Already loading, skipping request";
+            return;
+        }
 
-    m_isLoading = true;
+        // Invalidate anything still queued or in flight for the previous contents.
+        // Bumped together with the flag so a loader draining stale work can't clear it.
+        m_isLoading = true;
+        m_pendingPages.clear();
+        ++m_generation;
+    }
     emit loadingStarted();
 
     // Get total count first (favorites or all tracks)
@@ -45,17 +48,17 @@ void VirtualPlaylist::loadAllTracks()
         return;
     }
     
-    // Pre-allocate vector with nullptrs
+    // Rows may be evicted and reloaded, so take the duration from the database
+    // rather than summing loaded rows
+    int totalDuration = int(m_favoritesOnly ? m_dbManager->getFavoritesTotalDuration()
+                                            : m_dbManager->getTotalDuration());
+    
+    // Reset page table (no rows resident yet)
     {
         QMutexLocker locker(&m_trackMutex);
-        // Delete existing tracks
-        for (auto* track : m_tracks) {
-            delete track;
-        }
-        m_tracks.clear();
-        m_tracks.resize(m_totalTrackCount, nullptr);
-        m_loadedRanges.clear();
-        m_totalDuration = 0;
+        m_store.reset(m_totalTrackCount);
+        m_keyAnchors.clear();
+        m_totalDuration = totalDuration;
     }
     
     // Start loading the first chunk immediately
@@ -64,24 +67,77 @@ void VirtualPlaylist::loadAllTracks()
 
 void VirtualPlaylist::clear()
 {
-    if (m_loadFuture.isRunning()) {
-        m_loadFuture.cancel();
-        m_loadFuture.waitForFinished();
+    stopLoader();
+    
+    {
+        QMutexLocker locker(&m_trackMutex);
+        m_store.clear();
+        m_keyAnchors.clear();
+        m_totalTrackCount = 0;
+        m_totalDuration = 0;
     }
     
-    QMutexLocker locker(&m_trackMutex);
-    // Delete all allocated tracks
-    for (auto* track : m_tracks) {
-        delete track;
+    {
+        QMutexLocker shuffleLocker(&m_shuffleMutex);
+        m_shuffle.clear();
     }
-    m_tracks.clear();
-    m_loadedRanges.clear();
-    m_totalTrackCount = 0;
-    m_totalDuration = 0;
-    m_isLoading = false;
     
-    QMutexLocker shuffleLocker(&m_shuffleMutex);
-    m_shuffleOrder.clear();
+    // A load cancelled part way still ends
+    if (m_isLoading.exchange(false)) {
+        emit loadingFinished();
+    }
+}
+
+void VirtualPlaylist::applyTrackChanges(const QString& firstSortKey)
+{
+    if (m_favoritesOnly) {
+        // Favorites are ordered by favorited_at, not sort_key; those reload as a whole
+        qWarning() << "[VirtualPlaylist::applyTrackChanges] Not supported for favorites playlists";
+        return;
+    }
+
+    const int oldCount = m_totalTrackCount;
+    const int newCount = m_dbManager->getTrackCount();
+    // Rows sorting before the first changed key are identical before and after
+    int firstRow = firstSortKey.isEmpty() ? qMin(oldCount, newCount)
+                                          : m_dbManager->countTracksBefore(firstSortKey);
+    firstRow = qBound(0, firstRow, qMin(oldCount, newCount));
+    const int totalDuration = int(m_dbManager->getTotalDuration());
+
+    qDebug() << "[VirtualPlaylist::applyTrackChanges] Rows from" << firstRow << "changed, count"
+             << oldCount << "->" << newCount;
+
+    // Anything queued or in flight may describe shifted rows
+    {
+        QMutexLocker locker(&m_requestMutex);
+        m_pendingPages.clear();
+        ++m_generation;
+    }
+
+    emit rowsAboutToChange(firstRow, oldCount, newCount);
+
+    {
+        QMutexLocker locker(&m_trackMutex);
+        m_store.resize(newCount, firstRow);
+        // Anchor i sits on row i * ANCHOR_INTERVAL; later ones are resampled lazily
+        int validAnchors = (firstRow + ANCHOR_INTERVAL - 1) / ANCHOR_INTERVAL;
+        if (m_keyAnchors.size() > validAnchors) {
+            m_keyAnchors.resize(validAnchors);
+        }
+        m_totalTrackCount = newCount;
+        m_totalDuration = totalDuration;
+    }
+
+    {
+        // Same seed over the new size; the caller re-pins the playing track if needed
+        QMutexLocker locker(&m_shuffleMutex);
+        if (m_shuffle.isValid() && newCount != oldCount) {
+            int pinned = m_shuffle.pinnedFirst() < firstRow ? m_shuffle.pinnedFirst() : -1;
+            m_shuffle.reset(newCount, m_shuffle.seed(), pinned);
+        }
+    }
+
+    emit rowsChanged(firstRow, oldCount, newCount);
 }
 
 VirtualTrackData VirtualPlaylist::getTrack(int index) const
@@ -96,8 +152,8 @@ VirtualTrackData VirtualPlaylist::getTrack(int index) const
     
     QMutexLocker locker(&m_trackMutex);
     
-    if (index < m_tracks.size() && m_tracks[index]) {
-        VirtualTrackData trackData = *m_tracks[index];
+    if (m_store.isRowResident(index)) {
+        VirtualTrackData trackData = m_store.row(index);
         if (!trackData.isValid()) {
             qWarning() << "[VirtualPlaylist::getTrack] Track data at index" << index << "is invalid";
         }
@@ -128,8 +184,8 @@ QVector<VirtualTrackData> VirtualPlaylist::getTracks(int startIndex, int count)
     QMutexLocker locker(&m_trackMutex);
     
     for (int i = startIndex; i < endIndex; ++i) {
-        if (i < m_tracks.size() && m_tracks[i]) {
-            result.append(*m_tracks[i]);
+        if (m_store.isRowResident(i)) {
+            result.append(m_store.row(i));
         } else {
             // Return partial results and trigger loading
             const_cast<VirtualPlaylist*>(this)->ensureLoaded(i);
@@ -140,6 +196,15 @@ QVector<VirtualTrackData> VirtualPlaylist::getTracks(int startIndex, int count)
     return result;
 }
 
+int VirtualPlaylist::rowOfTrack(int trackId) const
+{
+    if (m_favoritesOnly) {
+        return -1;
+    }
+    int row = m_dbManager->getTrackRow(trackId);
+    return row < m_totalTrackCount ? row : -1;
+}
+
 int VirtualPlaylist::trackCount() const
 {
     return m_totalTrackCount;
@@ -148,11 +213,7 @@ int VirtualPlaylist::trackCount() const
 int VirtualPlaylist::loadedTrackCount() const
 {
     QMutexLocker locker(&m_trackMutex);
-    int count = 0;
-    for (const auto& range : m_loadedRanges) {
-        count += (range.end - range.start + 1);
-    }
-    return count;
+    return m_store.residentRowCount();
 }
 
 bool VirtualPlaylist::isFullyLoaded() const
@@ -184,16 +245,11 @@ void VirtualPlaylist::preloadRange(int centerIndex, int radius)
     int endIndex = qMin(m_totalTrackCount - 1, centerIndex + radius);
     int count = endIndex - startIndex + 1;
     
-    // Check if range is already loaded
+    // Check if range is already loaded (one probe per page, not per row)
     bool needsLoading = false;
     {
         QMutexLocker locker(&m_trackMutex);
-        for (int i = startIndex; i <= endIndex; ++i) {
-            if (!isInLoadedRange(i)) {
-                needsLoading = true;
-                break;
-            }
-        }
+        needsLoading = !m_store.isRangeResident(startIndex, endIndex);
     }
     
     if (needsLoading) {
@@ -209,7 +265,7 @@ void VirtualPlaylist::ensureLoaded(int index)
     
     {
         QMutexLocker locker(&m_trackMutex);
-        if (isInLoadedRange(index)) {
+        if (m_store.isRowResident(index)) {
             return;
         }
     }
@@ -227,60 +283,118 @@ bool VirtualPlaylist::isTrackLoaded(int index) const
     }
     
     QMutexLocker locker(&m_trackMutex);
-    return isInLoadedRange(index);
+    return m_store.isRowResident(index);
 }
 
-void VirtualPlaylist::generateShuffleOrder(int currentIndex)
+void VirtualPlaylist::setPlaybackCursor(int index)
 {
-    QMutexLocker locker(&m_shuffleMutex);
-    
-    m_shuffleOrder.clear();
-    m_shuffleOrder.reserve(m_totalTrackCount);
-    
-    // Create sequential indices
-    for (int i = 0; i < m_totalTrackCount; ++i) {
-        m_shuffleOrder.append(i);
+    {
+        QMutexLocker requestLocker(&m_requestMutex);
+        m_playbackPage = index >= 0 ? TrackPageStore::pageOf(index) : -1;
     }
     
-    // Shuffle using random device
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    
-    if (currentIndex >= 0 && currentIndex < m_totalTrackCount) {
-        // Keep current track at the beginning
-        auto it = std::find(m_shuffleOrder.begin(), m_shuffleOrder.end(), currentIndex);
-        if (it != m_shuffleOrder.end()) {
-            std::iter_swap(m_shuffleOrder.begin(), it);
+    QMutexLocker locker(&m_trackMutex);
+    if (index < 0 || index >= m_totalTrackCount) {
+        m_store.setPinnedWindow(TrackPageStore::PlaybackPin, -1, -1);
+        return;
+    }
+    m_store.setPinnedWindow(TrackPageStore::PlaybackPin,
+                            qMax(0, index - PLAYBACK_PIN_RADIUS),
+                            qMin(m_totalTrackCount - 1, index + PLAYBACK_PIN_RADIUS));
+}
+
+void VirtualPlaylist::setVisibleRange(int firstIndex, int lastIndex)
+{
+    {
+        QMutexLocker requestLocker(&m_requestMutex);
+        if (firstIndex < 0 || lastIndex < firstIndex) {
+            m_visiblePages = qMakePair(-1, -1);
+        } else {
+            m_visiblePages = qMakePair(TrackPageStore::pageOf(firstIndex), TrackPageStore::pageOf(lastIndex));
         }
-        // Shuffle the rest
-        std::shuffle(m_shuffleOrder.begin() + 1, m_shuffleOrder.end(), gen);
-    } else {
-        // Shuffle everything
-        std::shuffle(m_shuffleOrder.begin(), m_shuffleOrder.end(), gen);
     }
+    
+    QMutexLocker locker(&m_trackMutex);
+    if (firstIndex < 0 || lastIndex < firstIndex) {
+        m_store.setPinnedWindow(TrackPageStore::VisiblePin, -1, -1);
+        return;
+    }
+    m_store.setPinnedWindow(TrackPageStore::VisiblePin, firstIndex,
+                            qMin(m_totalTrackCount - 1, lastIndex));
+}
+
+void VirtualPlaylist::setResidencyBudget(qint64 bytes)
+{
+    QMutexLocker locker(&m_trackMutex);
+    m_store.setBudgetBytes(bytes);
+    m_store.evictToBudget();
+}
+
+qint64 VirtualPlaylist::residentBytes() const
+{
+    QMutexLocker locker(&m_trackMutex);
+    return m_store.residentBytes();
+}
+
+int VirtualPlaylist::residentPageCount() const
+{
+    QMutexLocker locker(&m_trackMutex);
+    return m_store.residentPageCount();
+}
+
+void VirtualPlaylist::generateShuffleOrder(int currentIndex)
+{
+    restoreShuffleOrder(QRandomGenerator::global()->generate64(), currentIndex);
+}
+
+void VirtualPlaylist::restoreShuffleOrder(quint64 seed, int firstIndex)
+{
+    QMutexLocker locker(&m_shuffleMutex);
+    
+    // Nothing is materialised; the order is a pure function of (count, seed, first)
+    m_shuffle.reset(m_totalTrackCount, seed,
+                    firstIndex >= 0 && firstIndex < m_totalTrackCount ? firstIndex : -1);
+}
+
+quint64 VirtualPlaylist::shuffleSeed() const
+{
+    QMutexLocker locker(&m_shuffleMutex);
+    return m_shuffle.seed();
+}
+
+int VirtualPlaylist::shuffleFirstIndex() const
+{
+    QMutexLocker locker(&m_shuffleMutex);
+    return m_shuffle.pinnedFirst();
+}
+
+bool VirtualPlaylist::hasShuffleOrder() const
+{
+    QMutexLocker locker(&m_shuffleMutex);
+    return m_shuffle.isValid();
 }
 
 int VirtualPlaylist::getShuffledIndex(int linearIndex) const
 {
     QMutexLocker locker(&m_shuffleMutex);
     
-    if (m_shuffleOrder.isEmpty() || linearIndex < 0 || linearIndex >= m_shuffleOrder.size()) {
+    if (!m_shuffle.isValid() || linearIndex < 0 || linearIndex >= m_shuffle.size()) {
         return linearIndex;
     }
     
-    return m_shuffleOrder[linearIndex];
+    return m_shuffle.indexAt(linearIndex);
 }
 
 int VirtualPlaylist::getLinearIndex(int shuffledIndex) const
 {
     QMutexLocker locker(&m_shuffleMutex);
     
-    if (m_shuffleOrder.isEmpty()) {
+    if (!m_shuffle.isValid()) {
         qWarning() << "[VirtualPlaylist::getLinearIndex] Shuffle order is empty";
         return -1;
     }
     
-    int index = m_shuffleOrder.indexOf(shuffledIndex);
+    int index = m_shuffle.positionOf(shuffledIndex);
     if (index < 0) {
         qWarning() << "[VirtualPlaylist::getLinearIndex] Track index" << shuffledIndex 
                    << "not found in shuffle order";
@@ -293,24 +407,23 @@ QVector<int> VirtualPlaylist::getNextShuffleIndices(int currentShuffledIndex, in
     QMutexLocker locker(&m_shuffleMutex);
     
     QVector<int> indices;
-    if (m_shuffleOrder.isEmpty() || count <= 0) {
+    if (!m_shuffle.isValid() || count <= 0) {
         qDebug() << "[VirtualPlaylist::getNextShuffleIndices] Empty shuffle order or invalid count";
         return indices;
     }
     
     // Find where the current index is in the shuffle order
-    int linearIndex = m_shuffleOrder.indexOf(currentShuffledIndex);
+    int linearIndex = m_shuffle.positionOf(currentShuffledIndex);
     
     if (linearIndex < 0) {
         qDebug() << "[VirtualPlaylist::getNextShuffleIndices] Current index" << currentShuffledIndex 
-                 << "not found in shuffle order. Shuffle order size:" << m_shuffleOrder.size()
-                 << "First few items:" << m_shuffleOrder.mid(0, 5);
+                 << "not found in shuffle order. Shuffle order size:" << m_shuffle.size();
         return indices;
     }
     
     indices.reserve(count);
-    for (int i = 1; i <= count && linearIndex + i < m_shuffleOrder.size(); ++i) {
-        indices.append(m_shuffleOrder[linearIndex + i]);
+    for (int i = 1; i <= count && linearIndex + i < m_shuffle.size(); ++i) {
+        indices.append(m_shuffle.indexAt(linearIndex + i));
     }
     
     return indices;
@@ -320,12 +433,12 @@ int VirtualPlaylist::getPreviousShuffleIndex(int currentShuffledIndex) const
 {
     QMutexLocker locker(&m_shuffleMutex);
     
-    if (m_shuffleOrder.isEmpty()) {
+    if (!m_shuffle.isValid()) {
         return -1;
     }
     
     // Find current position in shuffle order
-    int linearIndex = m_shuffleOrder.indexOf(currentShuffledIndex);
+    int linearIndex = m_shuffle.positionOf(currentShuffledIndex);
     if (linearIndex < 0) {
         return -1;
     }
@@ -337,144 +450,240 @@ int VirtualPlaylist::getPreviousShuffleIndex(int currentShuffledIndex) const
         return -1;
     }
     
-    return m_shuffleOrder[prevLinearIndex];
+    return m_shuffle.indexAt(prevLinearIndex);
 }
 
 void VirtualPlaylist::loadRange(int startIndex, int count)
 {
-    if (m_loadFuture.isRunning()) {
-        // Cancel previous load if still running
-        m_loadFuture.cancel();
-        m_loadFuture.waitForFinished();
+    // Never blocks: the pages are queued and picked up by the loader thread
+    int firstPage = TrackPageStore::pageOf(qMax(0, startIndex));
+    int lastPage = TrackPageStore::pageOf(qMin(m_totalTrackCount - 1, startIndex + count - 1));
+    if (m_totalTrackCount <= 0 || lastPage < firstPage) {
+        return;
     }
-    
-    // Load tracks in background
-    bool favoritesOnly = m_favoritesOnly;  // Capture for lambda
-    m_loadFuture = QtConcurrent::run([this, startIndex, count, favoritesOnly]() {
-        // Store thread ID for cleanup
-        QString connectionName = QString("MtocThread_%1").arg(quintptr(QThread::currentThreadId()));
 
-        try {
-            // Get tracks based on mode (favorites or all)
-            QVariantList tracks;
-            if (favoritesOnly) {
-                // For favorites, we load all at once since count is expected to be manageable
-                // The getFavoriteTracks() returns them in favorited order
-                QVariantList allFavorites = m_dbManager->getFavoriteTracks();
-                // Extract the requested range
-                int endIndex = qMin(startIndex + count, allFavorites.size());
-                for (int i = startIndex; i < endIndex; ++i) {
-                    tracks.append(allFavorites[i]);
+    QMutexLocker locker(&m_requestMutex);
+    for (int page = firstPage; page <= lastPage; ++page) {
+        m_pendingPages.insert(page);
+    }
+    m_requestFocusPage = firstPage;
+
+    // Drop the requests furthest from what the user is looking at; a fling
+    // queues far more pages than are worth loading
+    while (m_pendingPages.size() > MAX_PENDING_PAGES) {
+        int farthest = -1;
+        int farthestDistance = -1;
+        for (int page : std::as_const(m_pendingPages)) {
+            int distance = pagePriority(page);
+            if (distance > farthestDistance) {
+                farthestDistance = distance;
+                farthest = page;
+            }
+        }
+        m_pendingPages.remove(farthest);
+    }
+
+    if (!m_loaderRunning) {
+        m_loaderRunning = true;
+        m_loadFuture = QtConcurrent::run([this]() { runLoader(); });
+    }
+}
+
+int VirtualPlaylist::pagePriority(int page) const
+{
+    // This method assumes m_requestMutex is already locked. Lower is more urgent:
+    // distance in pages to the visible window, then to the playback cursor,
+    // falling back to the most recent request.
+    auto distanceTo = [page](int first, int last) {
+        if (page < first) return first - page;
+        if (page > last) return page - last;
+        return 0;
+    };
+
+    int best = std::numeric_limits<int>::max();
+    if (m_visiblePages.first >= 0) {
+        best = qMin(best, distanceTo(m_visiblePages.first, m_visiblePages.second));
+    }
+    if (m_playbackPage >= 0) {
+        best = qMin(best, distanceTo(m_playbackPage, m_playbackPage));
+    }
+    if (best == std::numeric_limits<int>::max() && m_requestFocusPage >= 0) {
+        best = distanceTo(m_requestFocusPage, m_requestFocusPage);
+    }
+    return best == std::numeric_limits<int>::max() ? 0 : best;
+}
+
+bool VirtualPlaylist::takeNextLoad(int& firstPage, int& lastPage)
+{
+    // This method assumes m_requestMutex is already locked
+    if (m_pendingPages.isEmpty()) {
+        return false;
+    }
+
+    int seed = -1;
+    int seedPriority = std::numeric_limits<int>::max();
+    for (int page : std::as_const(m_pendingPages)) {
+        int priority = pagePriority(page);
+        if (priority < seedPriority || (priority == seedPriority && page < seed)) {
+            seedPriority = priority;
+            seed = page;
+        }
+    }
+
+    // Coalesce the contiguous run of pending pages around the most urgent one
+    firstPage = lastPage = seed;
+    m_pendingPages.remove(seed);
+    while (lastPage - firstPage + 1 < MAX_PAGES_PER_FETCH && m_pendingPages.remove(lastPage + 1)) {
+        ++lastPage;
+    }
+    while (lastPage - firstPage + 1 < MAX_PAGES_PER_FETCH && m_pendingPages.remove(firstPage - 1)) {
+        --firstPage;
+    }
+    return true;
+}
+
+void VirtualPlaylist::runLoader()
+{
+    // Store thread ID for cleanup
+    QString connectionName = QString("MtocThread_%1").arg(quintptr(QThread::currentThreadId()));
+
+    // Loading ends when the queue drains after a fetch of the current contents,
+    // whether it stored, failed or was evicted since. Waiting for every row to be
+    // resident would never end once the budget evicts pages.
+    bool fetchedCurrent = false;
+    quint64 lastGeneration = 0;
+    bool finished = false;
+
+    forever {
+        int firstPage = 0;
+        int lastPage = 0;
+        quint64 generation = 0;
+        {
+            QMutexLocker locker(&m_requestMutex);
+            if (m_stopLoader || !takeNextLoad(firstPage, lastPage)) {
+                if (!m_stopLoader && fetchedCurrent && lastGeneration == m_generation) {
+                    finished = m_isLoading.exchange(false);
                 }
-            } else {
-                tracks = m_dbManager->getAllTracks(count, startIndex);
+                m_loaderRunning = false;
+                break;
             }
+            generation = m_generation;
+            fetchedCurrent = true;
+            lastGeneration = generation;
+        }
+
+        int startIndex = TrackPageStore::pageStart(firstPage);
+        int count = qMin(m_totalTrackCount, TrackPageStore::pageStart(lastPage + 1)) - startIndex;
+        if (count <= 0) {
+            continue;
+        }
+
+        try {
+            // Get tracks based on mode (favorites or all)
+            QVariantList tracks = fetchRange(startIndex, count, m_favoritesOnly, generation);
 
             if (tracks.isEmpty()) {
                 qWarning() << "[VirtualPlaylist] Failed to load tracks at range" << startIndex << "count" << count;
-                // Clean up thread connection before returning
-                if (QSqlDatabase::contains(connectionName)) {
-                    QSqlDatabase::removeDatabase(connectionName);
-                }
-                return;
+                continue;
             }
 
             {
                 QMutexLocker locker(&m_trackMutex);
-
-                int index = startIndex;
-                for (const QVariant& trackVariant : tracks) {
-                    if (index >= m_tracks.size()) {
-                        break;
-                    }
-
-                    QVariantMap trackMap = trackVariant.toMap();
-                    auto* trackData = new VirtualTrackData(VirtualTrackData::fromVariantMap(trackMap));
-
-                    // Delete existing track if any
-                    delete m_tracks[index];
-                    m_tracks[index] = trackData;
-                    m_totalDuration += trackData->duration;
-
-                    ++index;
+                if (generation != m_generation) {
+                    // Playlist was cleared or reloaded while this chunk was in flight
+                    continue;
                 }
 
-                updateLoadedRanges(startIndex, startIndex + tracks.size() - 1);
+                int page = firstPage;
+                for (int offset = 0; offset < tracks.size() && page < m_store.pageCount();
+                     offset += TrackPage::ROWS, ++page) {
+                    m_store.storePage(page, tracks.mid(offset, TrackPage::ROWS));
+                }
             }
 
             emit rangeLoaded(startIndex, startIndex + tracks.size() - 1);
             emit loadingProgress(loadedTrackCount(), m_totalTrackCount);
 
-            if (isFullyLoaded()) {
-                m_isLoading = false;
+            if (isFullyLoaded() && m_isLoading.exchange(false)) {
                 emit loadingFinished();
             }
         } catch (const std::exception& e) {
-            qCritical() << "[VirtualPlaylist::loadRange] Exception:" << e.what();
+            qCritical() << "[VirtualPlaylist::runLoader] Exception:" << e.what();
         } catch (...) {
-            qCritical() << "[VirtualPlaylist::loadRange] Unknown exception";
+            qCritical() << "[VirtualPlaylist::runLoader] Unknown exception";
         }
+    }
 
-        // Clean up thread connection (always executed)
-        if (QSqlDatabase::contains(connectionName)) {
-            QSqlDatabase::removeDatabase(connectionName);
-        }
-    });
+    if (finished) {
+        emit loadingFinished();
+    }
+
+    // Clean up thread connection (always executed)
+    if (QSqlDatabase::contains(connectionName)) {
+        QSqlDatabase::removeDatabase(connectionName);
+    }
 }
 
-void VirtualPlaylist::updateLoadedRanges(int startIndex, int endIndex)
+void VirtualPlaylist::stopLoader()
 {
-    // This method assumes m_trackMutex is already locked
-    
-    // Try to merge with existing ranges
-    bool merged = false;
-    
-    for (auto& range : m_loadedRanges) {
-        // Check if new range overlaps or is adjacent
-        if ((startIndex >= range.start - 1 && startIndex <= range.end + 1) ||
-            (endIndex >= range.start - 1 && endIndex <= range.end + 1) ||
-            (startIndex <= range.start && endIndex >= range.end)) {
-            // Merge ranges
-            range.start = qMin(range.start, startIndex);
-            range.end = qMax(range.end, endIndex);
-            merged = true;
-            break;
-        }
-    }
-    
-    if (!merged) {
-        // Add new range
-        m_loadedRanges.append({startIndex, endIndex});
-    }
-    
-    // Merge any overlapping ranges
-    std::sort(m_loadedRanges.begin(), m_loadedRanges.end(),
-              [](const LoadedRange& a, const LoadedRange& b) {
-                  return a.start < b.start;
-              });
-    
-    QVector<LoadedRange> mergedRanges;
-    for (const auto& range : m_loadedRanges) {
-        if (mergedRanges.isEmpty() || mergedRanges.last().end + 1 < range.start) {
-            mergedRanges.append(range);
-        } else {
-            mergedRanges.last().end = qMax(mergedRanges.last().end, range.end);
-        }
+    {
+        QMutexLocker locker(&m_requestMutex);
+        m_stopLoader = true;
+        m_pendingPages.clear();
+        ++m_generation;
     }
-    
-    m_loadedRanges = mergedRanges;
+
+    // Only waits for the chunk currently being fetched
+    m_loadFuture.waitForFinished();
+
+    QMutexLocker locker(&m_requestMutex);
+    m_stopLoader = false;
 }
 
-bool VirtualPlaylist::isInLoadedRange(int index) const
+QVariantList VirtualPlaylist::fetchRange(int startIndex, int count, bool favoritesOnly, quint64 generation)
 {
-    // This method assumes m_trackMutex is already locked
-    
-    for (const auto& range : m_loadedRanges) {
-        if (index >= range.start && index <= range.end) {
-            return true;
+    // Runs on the loader thread. Anchors are sampled once per load, after which any
+    // page is a seek to the nearest anchor plus at most ANCHOR_INTERVAL skipped rows.
+    QVector<TrackKeyAnchor> anchors;
+    {
+        QMutexLocker locker(&m_trackMutex);
+        anchors = m_keyAnchors;
+    }
+
+    if (anchors.isEmpty()) {
+        anchors = m_dbManager->getTrackKeyAnchors(ANCHOR_INTERVAL, favoritesOnly);
+        QMutexLocker locker(&m_trackMutex);
+        if (generation == m_generation) {
+            m_keyAnchors = anchors;
+        }
+    } else if (!favoritesOnly && qint64(anchors.size()) * ANCHOR_INTERVAL < m_totalTrackCount) {
+        // Tail was invalidated by applyTrackChanges(); resample from the last valid anchor
+        QVector<TrackKeyAnchor> tail = m_dbManager->getTrackKeyAnchors(ANCHOR_INTERVAL, false,
+                                                                       anchors.last().sortKey);
+        if (!tail.isEmpty()) {
+            anchors.removeLast();
+            anchors += tail;
         }
+        QMutexLocker locker(&m_trackMutex);
+        if (generation == m_generation) {
+            m_keyAnchors = anchors;
+        }
+    }
+
+    int anchorIndex = startIndex / ANCHOR_INTERVAL;
+    if (anchorIndex < anchors.size()) {
+        const TrackKeyAnchor& anchor = anchors[anchorIndex];
+        return m_dbManager->getTracksFromAnchor(anchor, startIndex - anchorIndex * ANCHOR_INTERVAL,
+                                                count, favoritesOnly);
+    }
+
+    // No anchor for this position (library changed underneath us); fall back to OFFSET paging
+    qDebug() << "[VirtualPlaylist] No key anchor for index" << startIndex << ", using offset paging";
+    if (favoritesOnly) {
+        QVariantList allFavorites = m_dbManager->getFavoriteTracks();
+        return allFavorites.mid(startIndex, count);
     }
-    return false;
+    return m_dbManager->getAllTracks(count, startIndex);
 }
 
 } // namespace Mtoc
\ No newline at end of file
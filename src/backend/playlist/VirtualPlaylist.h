@@ -4,15 +4,18 @@
 #include <QObject>
 #include <QVector>
 #include <QMutex>
+#include <QSet>
+#include <QPair>
 #include <QFuture>
 #include <QPromise>
 #include <memory>
 #include "VirtualTrackData.h"
+#include "TrackPageStore.h"
+#include "ShufflePermutation.h"
+#include "../database/databasemanager.h"
 
 namespace Mtoc {
 
-class DatabaseManager;
-
 class VirtualPlaylist : public QObject
 {
     Q_OBJECT
@@ -30,11 +33,15 @@ public:
     // Playlist operations
     void loadAllTracks();
     void clear();
+    // Applies added/removed tracks without a reload. Rows before firstSortKey are
+    // untouched and stay resident; rows from there on are dropped and refetched on demand.
+    void applyTrackChanges(const QString& firstSortKey);
     
     // Track access
     VirtualTrackData getTrack(int index) const;
     QVariantMap getTrackVariant(int index) const;
     QVector<VirtualTrackData> getTracks(int startIndex, int count) const;
+    int rowOfTrack(int trackId) const;  // Database lookup; -1 if not in this playlist
     
     // Playlist info
     int trackCount() const;
@@ -48,8 +55,20 @@ public:
     void ensureLoaded(int index);
     bool isTrackLoaded(int index) const;
     
+    // Residency management. Pages around the playback cursor and the visible
+    // rows are pinned; everything else is evicted LRU once over budget.
+    void setPlaybackCursor(int index);
+    void setVisibleRange(int firstIndex, int lastIndex);
+    void setResidencyBudget(qint64 bytes);
+    qint64 residentBytes() const;
+    int residentPageCount() const;
+    
     // Shuffle support
     void generateShuffleOrder(int currentIndex = -1);
+    void restoreShuffleOrder(quint64 seed, int firstIndex);
+    quint64 shuffleSeed() const;
+    int shuffleFirstIndex() const;
+    bool hasShuffleOrder() const;
     int getShuffledIndex(int linearIndex) const;
     int getLinearIndex(int shuffledIndex) const;
     QVector<int> getNextShuffleIndices(int currentShuffledIndex, int count) const;
@@ -61,40 +80,59 @@ signals:
     void loadingFinished();
     void trackLoaded(int index);
     void rangeLoaded(int startIndex, int endIndex);
+    void rowsAboutToChange(int firstRow, int oldCount, int newCount);
+    void rowsChanged(int firstRow, int oldCount, int newCount);
     void error(const QString& message);
     
     
 private:
     void loadRange(int startIndex, int count);
-    void updateLoadedRanges(int startIndex, int endIndex);
-    bool isInLoadedRange(int index) const;
+    QVariantList fetchRange(int startIndex, int count, bool favoritesOnly, quint64 generation);
+    
+    // Background loader
+    int pagePriority(int page) const;
+    bool takeNextLoad(int& firstPage, int& lastPage);
+    void runLoader();
+    void stopLoader();
     
     DatabaseManager* m_dbManager;
     
     // Track storage
     mutable QMutex m_trackMutex;
-    QVector<VirtualTrackData*> m_tracks;  // Using raw pointers, managed manually
+    TrackPageStore m_store;
     int m_totalTrackCount = 0;
     int m_totalDuration = 0;
     
+    static const int PLAYBACK_PIN_RADIUS = 32;  // Rows kept resident either side of the cursor
+    
     // Loading state
     std::atomic<bool> m_isLoading{false};
     QFuture<void> m_loadFuture;
     
+    // Request queue, guarded by m_requestMutex. Pending pages are coalesced into
+    // contiguous runs and served nearest-to-focus first by a single loader thread.
+    mutable QMutex m_requestMutex;
+    QSet<int> m_pendingPages;
+    bool m_loaderRunning = false;
+    bool m_stopLoader = false;
+    std::atomic<quint64> m_generation{0};  // Bumped on clear/reload to drop stale results
+    QPair<int, int> m_visiblePages{-1, -1};
+    int m_playbackPage = -1;
+    int m_requestFocusPage = -1;
+    static const int MAX_PAGES_PER_FETCH = 8;
+    static const int MAX_PENDING_PAGES = 64;
+    
     // Buffer configuration
     int m_bufferSize = 50;  // Number of tracks to load at once
     int m_preloadRadius = 10; // Number of tracks to preload around current
     bool m_favoritesOnly = false;  // If true, only load favorite tracks
     
-    // Loaded ranges tracking
-    struct LoadedRange {
-        int start;
-        int end;
-    };
-    QVector<LoadedRange> m_loadedRanges;
+    // Keyset pagination anchors, one sort key every ANCHOR_INTERVAL rows
+    static const int ANCHOR_INTERVAL = 256;
+    QVector<TrackKeyAnchor> m_keyAnchors;
     
     // Shuffle support
-    QVector<int> m_shuffleOrder;
+    ShufflePermutation m_shuffle;
     mutable QMutex m_shuffleMutex;
 };
 
@@ -195,6 +195,11 @@ int VirtualPlaylistModel::totalDuration() const
     return m_playlist ? m_playlist->totalDuration() : 0;
 }
 
+qint64 VirtualPlaylistModel::residentBytes() const
+{
+    return m_playlist ? m_playlist->residentBytes() : 0;
+}
+
 QVariantMap VirtualPlaylistModel::getTrack(int index) const
 {
     if (!m_playlist || index < 0 || index >= m_playlist->trackCount()) {
@@ -222,6 +227,15 @@ bool VirtualPlaylistModel::isTrackLoaded(int index) const
     return m_playlist->isTrackLoaded(index);
 }
 
+void VirtualPlaylistModel::setVisibleRange(int firstIndex, int lastIndex)
+{
+    if (!m_playlist) {
+        return;
+    }
+    
+    m_playlist->setVisibleRange(firstIndex, lastIndex);
+}
+
 QVariantList VirtualPlaylistModel::getTracksForPlayback(int startIndex, int count) const
 {
     QVariantList result;
@@ -271,6 +285,41 @@ void VirtualPlaylistModel::onLoadingProgress(int loaded, int total)
     emit loadedCountChanged();
 }
 
+void VirtualPlaylistModel::onRowsAboutToChange(int firstRow, int oldCount, int newCount)
+{
+    Q_UNUSED(firstRow)
+
+    // Rows shift from firstRow on; the count difference is reported at the tail
+    // and the shifted rows as changed, so the view keeps everything above firstRow
+    if (newCount > oldCount) {
+        beginInsertRows(QModelIndex(), oldCount, newCount - 1);
+    } else if (newCount < oldCount) {
+        beginRemoveRows(QModelIndex(), newCount, oldCount - 1);
+    }
+}
+
+void VirtualPlaylistModel::onRowsChanged(int firstRow, int oldCount, int newCount)
+{
+    if (newCount > oldCount) {
+        endInsertRows();
+    } else if (newCount < oldCount) {
+        endRemoveRows();
+    }
+
+    int lastShared = qMin(oldCount, newCount) - 1;
+    if (firstRow <= lastShared) {
+        emit dataChanged(index(firstRow), index(lastShared));
+    }
+
+    if (m_lastFetchIndex >= newCount) {
+        m_lastFetchIndex = 0;
+    }
+
+    emit countChanged();
+    emit loadedCountChanged();
+    emit totalDurationChanged();
+}
+
 void VirtualPlaylistModel::connectPlaylistSignals()
 {
     if (!m_playlist) {
@@ -285,6 +334,10 @@ void VirtualPlaylistModel::connectPlaylistSignals()
             this, &VirtualPlaylistModel::onRangeLoaded);
     connect(m_playlist, &VirtualPlaylist::loadingProgress,
             this, &VirtualPlaylistModel::onLoadingProgress);
+    connect(m_playlist, &VirtualPlaylist::rowsAboutToChange,
+            this, &VirtualPlaylistModel::onRowsAboutToChange);
+    connect(m_playlist, &VirtualPlaylist::rowsChanged,
+            this, &VirtualPlaylistModel::onRowsChanged);
 }
 
 void VirtualPlaylistModel::disconnectPlaylistSignals()
@@ -15,6 +15,7 @@ class VirtualPlaylistModel : public QAbstractListModel
     Q_PROPERTY(bool loading READ isLoading NOTIFY loadingChanged)
     Q_PROPERTY(int loadedCount READ loadedCount NOTIFY loadedCountChanged)
     Q_PROPERTY(int totalDuration READ totalDuration NOTIFY totalDurationChanged)
+    Q_PROPERTY(qint64 residentBytes READ residentBytes NOTIFY loadedCountChanged)
     
 public:
     enum TrackRoles {
@@ -57,11 +58,13 @@ public:
     bool isLoading() const;
     int loadedCount() const;
     int totalDuration() const;
+    qint64 residentBytes() const;
     
     // Track access
     Q_INVOKABLE QVariantMap getTrack(int index) const;
     Q_INVOKABLE void preloadAround(int index, int radius = -1);
     Q_INVOKABLE bool isTrackLoaded(int index) const;
+    Q_INVOKABLE void setVisibleRange(int firstIndex, int lastIndex);
     
     // Playback support
     Q_INVOKABLE QVariantList getTracksForPlayback(int startIndex, int count) const;
@@ -85,6 +88,8 @@ private slots:
     void onLoadingFinished();
     void onRangeLoaded(int startIndex, int endIndex);
     void onLoadingProgress(int loaded, int total);
+    void onRowsAboutToChange(int firstRow, int oldCount, int newCount);
+    void onRowsChanged(int firstRow, int oldCount, int newCount);
     
 private:
     void connectPlaylistSignals();
@@ -1,6 +1,7 @@
 #include "playlistmanager.h"
 #include "backend/library/librarymanager.h"
 #include "backend/library/track.h"
+#include "backend/database/databasemanager.h"
 #include "backend/playback/mediaplayer.h"
 #include "backend/settings/settingsmanager.h"
 #include <QDir>
@@ -48,7 +49,7 @@ PlaylistManager* PlaylistManager::instance()
 void PlaylistManager::setLibraryManager(Mtoc::LibraryManager* manager)
 {
     m_libraryManager = manager;
-    initialize();
+    // initialize() scans the playlist folders; main() runs it after the first frame
 }
 
 void PlaylistManager::initialize()
@@ -440,11 +441,19 @@ QVariantList PlaylistManager::readM3UFile(const QString& filepath)
     QTextStream stream(&file);
     stream.setEncoding(QStringConverter::Utf8);
     
+    // Collect the entries first so the library lookup is one batch for the
+    // whole playlist rather than one per line
+    struct PlaylistLine {
+        QString filePath;
+        QString title;
+        QString artist;
+        int duration = 0;
+    };
+    QList<PlaylistLine> entries;
+    
     QString line;
     QString currentTitle;
     QString currentArtist;
-    QString currentAlbum;
-    QString currentAlbumArtist;
     int currentDuration = 0;
     
     while (!stream.atEnd()) {
@@ -477,119 +486,112 @@ QVariantList PlaylistManager::readM3UFile(const QString& filepath)
             QString resolvedPath = resolvePlaylistPath(line, filepath);
             
             if (!resolvedPath.isEmpty()) {
-                // Check if file exists first
-                if (!QFile::exists(resolvedPath)) {
+                if (QFile::exists(resolvedPath)) {
+                    entries.append({resolvedPath, currentTitle, currentArtist, currentDuration});
+                } else {
                     qDebug() << "PlaylistManager: File does not exist:" << resolvedPath;
                     qDebug() << "  - Original line from playlist:" << line;
-                    
-                    // Reset for next track
-                    currentTitle.clear();
-                    currentArtist.clear();
-                    currentAlbum.clear();
-                    currentAlbumArtist.clear();
-                    currentDuration = 0;
-                    continue;
-                }
-                // Try to get track info from library
-                if (m_libraryManager) {
-                    // First try with the resolved path as-is
-                    Mtoc::Track* track = m_libraryManager->trackByPath(resolvedPath);
-                    
-                    // If not found, try with canonical path (important for flatpak)
-                    if (!track) {
-                        QString canonicalPath = QFileInfo(resolvedPath).canonicalFilePath();
-                        if (canonicalPath != resolvedPath) {
-                            qDebug() << "PlaylistManager: Trying canonical path:" << canonicalPath;
-                            track = m_libraryManager->trackByPath(canonicalPath);
-                        }
-                    }
-                    
-                    // If still not found and we're in flatpak, the database might have portal paths
-                    // Try to find a matching file in the music folders
-                    if (!track && (resolvedPath.startsWith("/home/") || resolvedPath.startsWith("/"))) {
-                        QStringList musicFolders = m_libraryManager->musicFolders();
-                        for (const QString& musicFolder : musicFolders) {
-                            // Check if this music folder is a portal path
-                            if (musicFolder.startsWith("/run/flatpak/doc/") || musicFolder.startsWith("/run/user/")) {
-                                // Try to match the file based on relative path within music folder
-                                QString musicFolderCanonical = QFileInfo(musicFolder).canonicalFilePath();
-                                
-                                // Extract the relative part of the resolved path
-                                // For example: /home/user/Music/artist/song.mp3 -> artist/song.mp3
-                                QString homeMusicPath = QStandardPaths::writableLocation(QStandardPaths::MusicLocation);
-                                if (resolvedPath.startsWith(homeMusicPath)) {
-                                    QString relativePart = QDir(homeMusicPath).relativeFilePath(resolvedPath);
-                                    QString portalPath = QDir(musicFolderCanonical).absoluteFilePath(relativePart);
-                                    
-                                    qDebug() << "PlaylistManager: Trying portal path:" << portalPath;
-                                    track = m_libraryManager->trackByPath(portalPath);
-                                    if (track) {
-                                        qDebug() << "PlaylistManager: Found track using portal path mapping";
-                                        break;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                    
-                    if (track) {
-                        QVariantMap trackMap;
-                        trackMap["id"] = track->id();
-                        trackMap["filePath"] = track->filePath();
-                        trackMap["title"] = track->title();
-                        trackMap["artist"] = track->artist();
-                        trackMap["album"] = track->album();
-                        trackMap["albumArtist"] = track->albumArtist();
-                        trackMap["genre"] = track->genre();
-                        trackMap["trackNumber"] = track->trackNumber();
-                        trackMap["duration"] = track->duration();
-                        trackMap["year"] = track->year();
-                        trackMap["lyrics"] = track->lyrics();
-                        trackMap["isFavorite"] = track->isFavorite();
-
-                        // Get fileSize from database since Track class doesn't have it
-                        if (m_libraryManager->databaseManager()) {
-                            int trackId = m_libraryManager->databaseManager()->getTrackIdByPath(track->filePath());
-                            if (trackId > 0) {
-                                QVariantMap dbTrackData = m_libraryManager->databaseManager()->getTrack(trackId);
-                                if (dbTrackData.contains("fileSize")) {
-                                    trackMap["fileSize"] = dbTrackData["fileSize"];
-                                }
-                            }
-                        }
-
-                        qDebug() << "PlaylistManager: Found track in library:" << track->title()
-                                 << "Album:" << track->album() << "AlbumArtist:" << track->albumArtist();
-                        tracks.append(trackMap);
-                        continue;
-                    } else {
-                        qDebug() << "PlaylistManager: Track not found in library:" << resolvedPath;
-                        qDebug() << "  - Original line from playlist:" << line;
-                        qDebug() << "  - Music folders:" << m_libraryManager->musicFolders();
-                    }
                 }
-                
-                // Fallback: create basic track info
-                QVariantMap trackMap;
-                trackMap["filePath"] = resolvedPath;
-                trackMap["title"] = currentTitle.isEmpty() ? QFileInfo(resolvedPath).baseName() : currentTitle;
-                trackMap["artist"] = currentArtist;
-                trackMap["album"] = currentAlbum;
-                trackMap["albumArtist"] = currentAlbumArtist.isEmpty() ? currentArtist : currentAlbumArtist;
-                trackMap["duration"] = currentDuration;
-                tracks.append(trackMap);
             }
             
             // Reset for next track
             currentTitle.clear();
             currentArtist.clear();
-            currentAlbum.clear();
-            currentAlbumArtist.clear();
             currentDuration = 0;
         }
     }
     
     file.close();
+    
+    QStringList paths;
+    paths.reserve(entries.size());
+    for (const PlaylistLine& entry : entries) {
+        paths.append(entry.filePath);
+    }
+    QList<Mtoc::ResolvedTrack> libraryTracks = resolveLibraryTracks(paths);
+    
+    tracks.reserve(entries.size());
+    for (int i = 0; i < entries.size(); ++i) {
+        const PlaylistLine& entry = entries.at(i);
+        if (i < libraryTracks.size() && libraryTracks.at(i).isValid()) {
+            tracks.append(libraryTracks.at(i).toVariantMap());
+            continue;
+        }
+        
+        if (m_libraryManager) {
+            qDebug() << "PlaylistManager: Track not found in library:" << entry.filePath;
+        }
+        
+        // Fallback: create basic track info
+        QVariantMap trackMap;
+        trackMap["filePath"] = entry.filePath;
+        trackMap["title"] = entry.title.isEmpty() ? QFileInfo(entry.filePath).baseName() : entry.title;
+        trackMap["artist"] = entry.artist;
+        trackMap["album"] = QString();
+        trackMap["albumArtist"] = entry.artist;
+        trackMap["duration"] = entry.duration;
+        tracks.append(trackMap);
+    }
+    
+    return tracks;
+}
+
+QList<Mtoc::ResolvedTrack> PlaylistManager::resolveLibraryTracks(const QStringList& filePaths) const
+{
+    if (!m_libraryManager || !m_libraryManager->databaseManager() || filePaths.isEmpty()) {
+        return QList<Mtoc::ResolvedTrack>();
+    }
+    Mtoc::DatabaseManager* db = m_libraryManager->databaseManager();
+    
+    QList<Mtoc::ResolvedTrack> tracks = db->resolveTracksByPath(filePaths);
+    
+    // Paths that did not match may still be in the library under their canonical
+    // path (important for flatpak), or under a portal path if the music folder
+    // was added through the document portal. Candidates are listed in order of
+    // preference and looked up together.
+    QList<int> candidateRows;
+    QStringList candidatePaths;
+    QStringList musicFolders;
+    QString homeMusicPath;
+    for (int i = 0; i < tracks.size(); ++i) {
+        if (tracks.at(i).isValid()) {
+            continue;
+        }
+        const QString& path = filePaths.at(i);
+        
+        QString canonicalPath = QFileInfo(path).canonicalFilePath();
+        if (!canonicalPath.isEmpty() && canonicalPath != path) {
+            candidateRows.append(i);
+            candidatePaths.append(canonicalPath);
+        }
+        
+        if (musicFolders.isEmpty()) {
+            musicFolders = m_libraryManager->musicFolders();
+            homeMusicPath = QStandardPaths::writableLocation(QStandardPaths::MusicLocation);
+        }
+        // e.g. /home/user/Music/artist/song.mp3 -> <portal folder>/artist/song.mp3
+        if (!homeMusicPath.isEmpty() && path.startsWith(homeMusicPath)) {
+            QString relativePart = QDir(homeMusicPath).relativeFilePath(path);
+            for (const QString& musicFolder : musicFolders) {
+                if (musicFolder.startsWith("/run/flatpak/doc/") || musicFolder.startsWith("/run/user/")) {
+                    QString musicFolderCanonical = QFileInfo(musicFolder).canonicalFilePath();
+                    candidateRows.append(i);
+                    candidatePaths.append(QDir(musicFolderCanonical).absoluteFilePath(relativePart));
+                }
+            }
+        }
+    }
+    
+    if (!candidatePaths.isEmpty()) {
+        QList<Mtoc::ResolvedTrack> candidates = db->resolveTracksByPath(candidatePaths);
+        for (int i = 0; i < candidates.size(); ++i) {
+            Mtoc::ResolvedTrack& track = tracks[candidateRows.at(i)];
+            if (!track.isValid() && candidates.at(i).isValid()) {
+                track = candidates.at(i);
+            }
+        }
+    }
+    
     return tracks;
 }
 
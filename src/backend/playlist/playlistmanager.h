@@ -10,6 +10,7 @@
 namespace Mtoc {
 class Track;
 class LibraryManager;
+struct ResolvedTrack;
 }
 
 class MediaPlayer;
@@ -87,6 +88,9 @@ private:
     QVariantList readM3UFile(const QString& filepath);
     QString makeRelativePath(const QString& filePath) const;
     QString resolvePlaylistPath(const QString& playlistPath, const QString& playlistFile) const;
+    // Looks up the library rows for playlist paths in one batch, retrying misses
+    // under their canonical and flatpak portal paths
+    QList<Mtoc::ResolvedTrack> resolveLibraryTracks(const QStringList& filePaths) const;
     void setReady(bool ready);
     void savePlaylistFoldersConfig();
     void loadPlaylistFoldersConfig();
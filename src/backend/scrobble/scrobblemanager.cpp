@@ -44,6 +44,11 @@ void ScrobbleManager::setMediaPlayer(MediaPlayer* player)
 void ScrobbleManager::setDatabaseManager(DatabaseManager* dbManager)
 {
     m_dbManager = dbManager;
+
+    // Wired after startup, so QML may already have read a count of 0
+    if (m_dbManager) {
+        emit totalListensChanged(totalListens());
+    }
 }
 
 void ScrobbleManager::setSettingsManager(SettingsManager* settingsManager)
@@ -3,9 +3,31 @@
 #include <QGuiApplication>
 #include <QPalette>
 #include <QEvent>
+#include <QMediaDevices>
+#include <QAudioDevice>
 
 SettingsManager* SettingsManager::s_instance = nullptr;
 
+namespace {
+
+struct EqualizerPreset {
+    const char *name;
+    double gains[SettingsManager::EQUALIZER_BANDS];  // 31 Hz to 16 kHz
+};
+
+const EqualizerPreset EQUALIZER_PRESETS[] = {
+    { "Flat",         {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0 } },
+    { "Bass Boost",   {  6,  5,  4,  2,  0,  0,  0,  0,  0,  0 } },
+    { "Treble Boost", {  0,  0,  0,  0,  0,  1,  2,  4,  5,  6 } },
+    { "Loudness",     {  5,  4,  2,  0, -1,  0,  0,  1,  3,  4 } },
+    { "Vocal",        { -2, -2, -1,  1,  3,  3,  2,  1,  0, -1 } },
+    { "Rock",         {  4,  3,  1, -1, -2, -1,  1,  3,  4,  4 } },
+};
+
+const char *CUSTOM_PRESET = "Custom";
+
+} // namespace
+
 SettingsManager::SettingsManager(QObject *parent)
     : QObject(parent)
     , m_settings("mtoc", "mtoc")
@@ -32,9 +54,25 @@ SettingsManager::SettingsManager(QObject *parent)
     , m_nowPlayingHistoryVisible(false)
     , m_playlistsEnabled(true)  // Default to enabled for backward compatibility
     , m_scrobblingEnabled(true)  // Default to enabled
+    , m_readAheadBudget(32)
+    , m_readAheadPriority(IdlePriority)
+    , m_warmStandby(false)  // Holds a second audio stream open, so opt-in
+    , m_equalizerEnabled(false)
+    , m_equalizerGains(EQUALIZER_BANDS, 0.0)
+    , m_equalizerPreset(EQUALIZER_PRESETS[0].name)
 {
     loadSettings();
     setupSystemThemeDetection();
+    
+    // GStreamer's sink follows the system default, so that is the device the
+    // equalizer curve is kept for
+    m_mediaDevices = new QMediaDevices(this);
+    connect(m_mediaDevices, &QMediaDevices::audioOutputsChanged,
+            this, &SettingsManager::onAudioOutputsChanged);
+    const QAudioDevice device = QMediaDevices::defaultAudioOutput();
+    m_outputDeviceId = device.id();
+    m_outputDeviceName = device.description();
+    loadEqualizerForDevice();
 }
 
 SettingsManager::~SettingsManager()
@@ -417,6 +455,133 @@ void SettingsManager::setScrobblingEnabled(bool enabled)
     }
 }
 
+void SettingsManager::setReadAheadBudget(int megabytes)
+{
+    // Clamp to reasonable range
+    megabytes = qBound(0, megabytes, 512);
+    if (m_readAheadBudget != megabytes) {
+        m_readAheadBudget = megabytes;
+        emit readAheadBudgetChanged(megabytes);
+        saveSettings();
+    }
+}
+
+void SettingsManager::setReadAheadPriority(ReadAheadPriority priority)
+{
+    if (m_readAheadPriority != priority) {
+        m_readAheadPriority = priority;
+        emit readAheadPriorityChanged(priority);
+        saveSettings();
+    }
+}
+
+void SettingsManager::setWarmStandby(bool enabled)
+{
+    if (m_warmStandby != enabled) {
+        m_warmStandby = enabled;
+        emit warmStandbyChanged(enabled);
+        saveSettings();
+    }
+}
+
+void SettingsManager::setEqualizerEnabled(bool enabled)
+{
+    if (m_equalizerEnabled != enabled) {
+        m_equalizerEnabled = enabled;
+        emit equalizerEnabledChanged(enabled);
+        saveSettings();
+    }
+}
+
+QVariantList SettingsManager::equalizerGains() const
+{
+    QVariantList gains;
+    for (double gain : m_equalizerGains) {
+        gains.append(gain);
+    }
+    return gains;
+}
+
+QStringList SettingsManager::equalizerPresets() const
+{
+    QStringList presets;
+    for (const EqualizerPreset &preset : EQUALIZER_PRESETS) {
+        presets.append(preset.name);
+    }
+    presets.append(CUSTOM_PRESET);
+    return presets;
+}
+
+void SettingsManager::setEqualizerBandGain(int band, double gain)
+{
+    if (band < 0 || band >= EQUALIZER_BANDS) {
+        return;
+    }
+    gain = qBound(-12.0, gain, 12.0);
+    if (qFuzzyCompare(m_equalizerGains[band], gain) && m_equalizerPreset == CUSTOM_PRESET) {
+        return;
+    }
+    m_equalizerGains[band] = gain;
+    m_equalizerPreset = CUSTOM_PRESET;
+    emit equalizerGainsChanged();
+    saveEqualizerForDevice();
+}
+
+void SettingsManager::applyEqualizerPreset(const QString& preset)
+{
+    for (const EqualizerPreset &candidate : EQUALIZER_PRESETS) {
+        if (preset == candidate.name) {
+            m_equalizerGains = QVector<double>(std::begin(candidate.gains), std::end(candidate.gains));
+            m_equalizerPreset = preset;
+            emit equalizerGainsChanged();
+            saveEqualizerForDevice();
+            return;
+        }
+    }
+    // "Custom" keeps whatever the bands are
+}
+
+void SettingsManager::onAudioOutputsChanged()
+{
+    const QAudioDevice device = QMediaDevices::defaultAudioOutput();
+    if (device.id() == m_outputDeviceId) {
+        return;
+    }
+    qDebug() << "[SettingsManager::onAudioOutputsChanged] Output device is now" << device.description();
+    m_outputDeviceId = device.id();
+    m_outputDeviceName = device.description();
+    emit outputDeviceChanged();
+    loadEqualizerForDevice();
+    emit equalizerGainsChanged();
+}
+
+void SettingsManager::loadEqualizerForDevice()
+{
+    // Device ids can hold characters QSettings treats as separators
+    const QString key = m_outputDeviceId.isEmpty() ? QStringLiteral("default")
+                                                   : QString::fromLatin1(m_outputDeviceId.toHex());
+    m_settings.beginGroup("Equalizer/Devices/" + key);
+    const QVariantList gains = m_settings.value("gains").toList();
+    m_equalizerPreset = m_settings.value("preset", EQUALIZER_PRESETS[0].name).toString();
+    m_settings.endGroup();
+    
+    m_equalizerGains.fill(0.0, EQUALIZER_BANDS);
+    for (int i = 0; i < EQUALIZER_BANDS && i < gains.size(); ++i) {
+        m_equalizerGains[i] = qBound(-12.0, gains[i].toDouble(), 12.0);
+    }
+}
+
+void SettingsManager::saveEqualizerForDevice()
+{
+    const QString key = m_outputDeviceId.isEmpty() ? QStringLiteral("default")
+                                                   : QString::fromLatin1(m_outputDeviceId.toHex());
+    m_settings.beginGroup("Equalizer/Devices/" + key);
+    m_settings.setValue("gains", equalizerGains());
+    m_settings.setValue("preset", m_equalizerPreset);
+    m_settings.setValue("name", m_outputDeviceName);  // Only to make the file readable
+    m_settings.endGroup();
+}
+
 void SettingsManager::loadSettings()
 {
     m_settings.beginGroup("QueueBehavior");
@@ -439,6 +604,9 @@ void SettingsManager::loadSettings()
     m_repeatEnabled = m_settings.value("repeatEnabled", false).toBool();
     m_shuffleEnabled = m_settings.value("shuffleEnabled", false).toBool();
     m_autoDisableShuffle = m_settings.value("autoDisableShuffle", false).toBool();
+    m_readAheadBudget = qBound(0, m_settings.value("readAheadBudget", 32).toInt(), 512);
+    m_readAheadPriority = static_cast<ReadAheadPriority>(m_settings.value("readAheadPriority", IdlePriority).toInt());
+    m_warmStandby = m_settings.value("warmStandby", false).toBool();
     m_settings.endGroup();
     
     m_settings.beginGroup("ReplayGain");
@@ -448,6 +616,10 @@ void SettingsManager::loadSettings()
     m_replayGainFallbackGain = m_settings.value("fallbackGain", 0.0).toDouble();
     m_settings.endGroup();
     
+    m_settings.beginGroup("Equalizer");
+    m_equalizerEnabled = m_settings.value("enabled", false).toBool();
+    m_settings.endGroup();
+    
     m_settings.beginGroup("LibraryPane");
     m_libraryActiveTab = m_settings.value("activeTab", 0).toInt();
     m_lastSelectedAlbumId = m_settings.value("lastSelectedAlbumId", "").toString();
@@ -517,6 +689,9 @@ void SettingsManager::saveSettings()
     m_settings.setValue("repeatEnabled", m_repeatEnabled);
     m_settings.setValue("shuffleEnabled", m_shuffleEnabled);
     m_settings.setValue("autoDisableShuffle", m_autoDisableShuffle);
+    m_settings.setValue("readAheadBudget", m_readAheadBudget);
+    m_settings.setValue("readAheadPriority", static_cast<int>(m_readAheadPriority));
+    m_settings.setValue("warmStandby", m_warmStandby);
     m_settings.endGroup();
     
     m_settings.beginGroup("ReplayGain");
@@ -526,6 +701,10 @@ void SettingsManager::saveSettings()
     m_settings.setValue("fallbackGain", m_replayGainFallbackGain);
     m_settings.endGroup();
     
+    m_settings.beginGroup("Equalizer");
+    m_settings.setValue("enabled", m_equalizerEnabled);
+    m_settings.endGroup();
+    
     m_settings.beginGroup("LibraryPane");
     m_settings.setValue("activeTab", m_libraryActiveTab);
     m_settings.setValue("lastSelectedAlbumId", m_lastSelectedAlbumId);
@@ -6,6 +6,10 @@
 #include <QString>
 #include <QColor>
 #include <QStyleHints>
+#include <QVector>
+#include <QVariantList>
+
+class QMediaDevices;
 
 class SettingsManager : public QObject
 {
@@ -51,6 +55,14 @@ class SettingsManager : public QObject
     Q_PROPERTY(bool nowPlayingHistoryVisible READ nowPlayingHistoryVisible WRITE setNowPlayingHistoryVisible NOTIFY nowPlayingHistoryVisibleChanged)
     Q_PROPERTY(bool playlistsEnabled READ playlistsEnabled WRITE setPlaylistsEnabled NOTIFY playlistsEnabledChanged)
     Q_PROPERTY(bool scrobblingEnabled READ scrobblingEnabled WRITE setScrobblingEnabled NOTIFY scrobblingEnabledChanged)
+    Q_PROPERTY(int readAheadBudget READ readAheadBudget WRITE setReadAheadBudget NOTIFY readAheadBudgetChanged)
+    Q_PROPERTY(ReadAheadPriority readAheadPriority READ readAheadPriority WRITE setReadAheadPriority NOTIFY readAheadPriorityChanged)
+    Q_PROPERTY(bool warmStandby READ warmStandby WRITE setWarmStandby NOTIFY warmStandbyChanged)
+    Q_PROPERTY(bool equalizerEnabled READ equalizerEnabled WRITE setEqualizerEnabled NOTIFY equalizerEnabledChanged)
+    Q_PROPERTY(QVariantList equalizerGains READ equalizerGains NOTIFY equalizerGainsChanged)
+    Q_PROPERTY(QString equalizerPreset READ equalizerPreset NOTIFY equalizerGainsChanged)
+    Q_PROPERTY(QStringList equalizerPresets READ equalizerPresets CONSTANT)
+    Q_PROPERTY(QString outputDeviceName READ outputDeviceName NOTIFY outputDeviceChanged)
 
 public:
     enum QueueAction {
@@ -89,6 +101,14 @@ public:
     };
     Q_ENUM(MiniPlayerLayout)
 
+    // I/O priority for reading ahead upcoming queue tracks
+    enum ReadAheadPriority {
+        IdlePriority,
+        LowPriority,
+        NormalPriority
+    };
+    Q_ENUM(ReadAheadPriority)
+
     static SettingsManager* instance();
     ~SettingsManager();
     
@@ -134,6 +154,17 @@ public:
     bool nowPlayingHistoryVisible() const { return m_nowPlayingHistoryVisible; }
     bool playlistsEnabled() const { return m_playlistsEnabled; }
     bool scrobblingEnabled() const { return m_scrobblingEnabled; }
+    int readAheadBudget() const { return m_readAheadBudget; }  // MB, 0 disables read-ahead
+    ReadAheadPriority readAheadPriority() const { return m_readAheadPriority; }
+    bool warmStandby() const { return m_warmStandby; }  // Keep the next track prerolled for instant skips
+    // The equalizer curve belongs to the current output device; switching
+    // devices swaps it for the one saved with that device
+    bool equalizerEnabled() const { return m_equalizerEnabled; }
+    QVariantList equalizerGains() const;
+    QVector<double> equalizerBandGains() const { return m_equalizerGains; }  // dB, one per band
+    QString equalizerPreset() const { return m_equalizerPreset; }
+    QStringList equalizerPresets() const;
+    QString outputDeviceName() const { return m_outputDeviceName; }
 
     // Setters
     void setQueueActionDefault(QueueAction action);
@@ -175,6 +206,14 @@ public:
     void setNowPlayingHistoryVisible(bool visible);
     void setPlaylistsEnabled(bool enabled);
     void setScrobblingEnabled(bool enabled);
+    void setReadAheadBudget(int megabytes);
+    void setReadAheadPriority(ReadAheadPriority priority);
+    void setWarmStandby(bool enabled);
+    void setEqualizerEnabled(bool enabled);
+    Q_INVOKABLE void setEqualizerBandGain(int band, double gain);
+    Q_INVOKABLE void applyEqualizerPreset(const QString& preset);
+
+    static const int EQUALIZER_BANDS = 10;
 
 protected:
     bool event(QEvent *event) override;
@@ -221,9 +260,16 @@ signals:
     void nowPlayingHistoryVisibleChanged(bool visible);
     void playlistsEnabledChanged(bool enabled);
     void scrobblingEnabledChanged(bool enabled);
+    void readAheadBudgetChanged(int megabytes);
+    void readAheadPriorityChanged(ReadAheadPriority priority);
+    void warmStandbyChanged(bool enabled);
+    void equalizerEnabledChanged(bool enabled);
+    void equalizerGainsChanged();
+    void outputDeviceChanged();
 
 private slots:
     void onColorSchemeChanged(Qt::ColorScheme scheme);
+    void onAudioOutputsChanged();
 
 private:
     explicit SettingsManager(QObject *parent = nullptr);
@@ -231,6 +277,8 @@ private:
     void loadSettings();
     void saveSettings();
     void setupSystemThemeDetection();
+    void loadEqualizerForDevice();
+    void saveEqualizerForDevice();
     
     static SettingsManager* s_instance;
     QSettings m_settings;
@@ -275,6 +323,15 @@ private:
     bool m_nowPlayingHistoryVisible;
     bool m_playlistsEnabled;
     bool m_scrobblingEnabled;
+    int m_readAheadBudget;
+    ReadAheadPriority m_readAheadPriority;
+    bool m_warmStandby;
+    bool m_equalizerEnabled;
+    QVector<double> m_equalizerGains;
+    QString m_equalizerPreset;
+    QMediaDevices *m_mediaDevices = nullptr;
+    QByteArray m_outputDeviceId;
+    QString m_outputDeviceName;
 };
 
 #endif // SETTINGSMANAGER_H
\ No newline at end of file
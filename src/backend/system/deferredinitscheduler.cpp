@@ -0,0 +1,66 @@
+#include "deferredinitscheduler.h"
+#include "startuptracer.h"
+
+#include <QQuickWindow>
+#include <QTimer>
+#include <QDebug>
+
+namespace Mtoc {
+
+DeferredInitScheduler::DeferredInitScheduler(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void DeferredInitScheduler::add(const QString &name, std::function<void()> task)
+{
+    if (m_finished) {
+        qWarning() << "[DeferredInitScheduler::add] Already finished, running" << name << "now";
+        task();
+        return;
+    }
+    m_tasks.enqueue({name, std::move(task)});
+}
+
+void DeferredInitScheduler::startAfterFirstFrame(QQuickWindow *window)
+{
+    if (!window) {
+        QTimer::singleShot(0, this, &DeferredInitScheduler::start);
+        return;
+    }
+
+    // frameSwapped comes from the render thread with the threaded render loop
+    connect(window, &QQuickWindow::frameSwapped, this, [this]() {
+        StartupTracer::mark("first frame");
+        start();
+    }, static_cast<Qt::ConnectionType>(Qt::QueuedConnection | Qt::SingleShotConnection));
+}
+
+void DeferredInitScheduler::start()
+{
+    if (m_started) {
+        return;
+    }
+    m_started = true;
+    qDebug() << "[DeferredInitScheduler] Running" << m_tasks.size() << "deferred tasks";
+    runNext();
+}
+
+void DeferredInitScheduler::runNext()
+{
+    if (m_tasks.isEmpty()) {
+        m_finished = true;
+        StartupTracer::mark("deferred init complete");
+        StartupTracer::finish();
+        emit finished();
+        return;
+    }
+
+    Task task = m_tasks.dequeue();
+    task.run();
+    StartupTracer::mark(task.name);
+
+    QTimer::singleShot(0, this, &DeferredInitScheduler::runNext);
+}
+
+} // namespace Mtoc
@@ -0,0 +1,48 @@
+#ifndef DEFERREDINITSCHEDULER_H
+#define DEFERREDINITSCHEDULER_H
+
+#include <QObject>
+#include <QString>
+#include <QQueue>
+#include <functional>
+
+class QQuickWindow;
+
+namespace Mtoc {
+
+// Runs start-up work that the first frame does not depend on once that frame
+// has been presented. Tasks run in the order added, one per event-loop turn so
+// input stays responsive between them, and each is recorded by StartupTracer.
+class DeferredInitScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DeferredInitScheduler(QObject *parent = nullptr);
+
+    void add(const QString &name, std::function<void()> task);
+
+    // Starts after the window's first swapped frame; immediately if there is no window
+    void startAfterFirstFrame(QQuickWindow *window);
+    bool isFinished() const { return m_finished; }
+
+signals:
+    void finished();
+
+private:
+    struct Task {
+        QString name;
+        std::function<void()> run;
+    };
+
+    void start();
+    void runNext();
+
+    QQueue<Task> m_tasks;
+    bool m_started = false;
+    bool m_finished = false;
+};
+
+} // namespace Mtoc
+
+#endif // DEFERREDINITSCHEDULER_H
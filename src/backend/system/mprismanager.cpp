@@ -1,5 +1,6 @@
 #include "mprismanager.h"
 #include "../playback/mediaplayer.h"
+#include "../playback/playbackdiagnostics.h"
 #include "../library/track.h"
 #include "../library/librarymanager.h"
 #include <QDBusConnection>
@@ -279,6 +280,34 @@ void MediaPlayer2PlayerAdaptor::SetPosition(const QDBusObjectPath &trackId, qint
     }
 }
 
+// PlaybackDiagnosticsAdaptor implementation
+PlaybackDiagnosticsAdaptor::PlaybackDiagnosticsAdaptor(QObject *parent)
+    : QDBusAbstractAdaptor(parent)
+{
+}
+
+void PlaybackDiagnosticsAdaptor::setDiagnostics(Mtoc::PlaybackDiagnostics *diagnostics)
+{
+    m_diagnostics = diagnostics;
+}
+
+QString PlaybackDiagnosticsAdaptor::Json() const
+{
+    return m_diagnostics ? m_diagnostics->toJson() : QString();
+}
+
+QString PlaybackDiagnosticsAdaptor::Dump() const
+{
+    return m_diagnostics ? m_diagnostics->dump() : QString();
+}
+
+void PlaybackDiagnosticsAdaptor::Reset()
+{
+    if (m_diagnostics) {
+        m_diagnostics->reset();
+    }
+}
+
 // MprisManager implementation
 MprisManager::MprisManager(MediaPlayer *mediaPlayer, QObject *parent)
     : QObject(parent)
@@ -286,6 +315,7 @@ MprisManager::MprisManager(MediaPlayer *mediaPlayer, QObject *parent)
     , m_libraryManager(nullptr)
     , m_mprisAdaptor(nullptr)
     , m_playerAdaptor(nullptr)
+    , m_diagnosticsAdaptor(nullptr)
     , m_dbusConnection(QDBusConnection::sessionBus())
     , m_serviceName("org.mpris.MediaPlayer2.org._3fz.mtoc")
     , m_initialized(false)
@@ -329,6 +359,11 @@ bool MprisManager::initialize()
     
     // Set the MPRIS manager reference for album art access
     m_playerAdaptor->setMprisManager(this);
+    
+    m_diagnosticsAdaptor = new PlaybackDiagnosticsAdaptor(this);
+    if (m_mediaPlayer) {
+        m_diagnosticsAdaptor->setDiagnostics(m_mediaPlayer->diagnostics());
+    }
 
     // Register object path with both adaptors
     if (!m_dbusConnection.registerObject("/org/mpris/MediaPlayer2", this)) {
@@ -340,7 +375,9 @@ bool MprisManager::initialize()
     // Connect MediaPlayer signals to update MPRIS properties
     if (m_mediaPlayer) {
         connect(m_mediaPlayer, &MediaPlayer::stateChanged, this, &MprisManager::onStateChanged);
-        connect(m_mediaPlayer, &MediaPlayer::positionChanged, this, &MprisManager::onPositionChanged);
+        // Clients interpolate Position themselves and re-read it when the track
+        // changes; Seeked is only for seeks within the track
+        connect(m_mediaPlayer, &MediaPlayer::seeked, this, &MprisManager::onSeeked);
         connect(m_mediaPlayer, &MediaPlayer::volumeChanged, this, &MprisManager::onVolumeChanged);
         connect(m_mediaPlayer, &MediaPlayer::currentTrackChanged, this, &MprisManager::onCurrentTrackChanged);
         connect(m_mediaPlayer, &MediaPlayer::playbackQueueChanged, this, [this]() {
@@ -394,6 +431,11 @@ void MprisManager::cleanup()
         delete m_playerAdaptor;
         m_playerAdaptor = nullptr;
     }
+
+    if (m_diagnosticsAdaptor) {
+        delete m_diagnosticsAdaptor;
+        m_diagnosticsAdaptor = nullptr;
+    }
 }
 
 void MprisManager::onStateChanged()
@@ -404,20 +446,9 @@ void MprisManager::onStateChanged()
     emitPropertiesChanged("org.mpris.MediaPlayer2.Player", changedProperties);
 }
 
-void MprisManager::onPositionChanged(qint64 position)
+void MprisManager::onSeeked(qint64 position)
 {
-    Q_UNUSED(position)
-    // Position changes are too frequent to emit property changes for each one
-    // MPRIS clients typically poll the Position property instead
-    
-    // However, we can emit Seeked signal when position changes significantly
-    static qint64 lastEmittedPosition = 0;
-    qint64 currentPos = position * 1000; // Convert to microseconds
-    
-    if (qAbs(currentPos - lastEmittedPosition) > 1000000) { // > 1 second difference
-        emit m_playerAdaptor->Seeked(currentPos);
-        lastEmittedPosition = currentPos;
-    }
+    emit m_playerAdaptor->Seeked(position * 1000); // Convert to microseconds
 }
 
 void MprisManager::onVolumeChanged(float volume)
@@ -488,7 +519,7 @@ QString MprisManager::exportAlbumArt(Mtoc::Track *track) const
     }
     
     // Look up album ID from track info
-    int albumId = databaseManager->getAlbumIdByArtistAndTitle(track->albumArtist(), track->album());
+    int albumId = m_libraryManager->albumIdForArtistAndTitle(track->albumArtist(), track->album());
     if (albumId <= 0) {
         return QString();
     }
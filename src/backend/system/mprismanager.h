@@ -8,12 +8,14 @@
 #include <QVariantMap>
 #include <QString>
 #include <QStringList>
+#include <QPointer>
 
 class MediaPlayer;
 
 namespace Mtoc {
 class Track;
 class LibraryManager;
+class PlaybackDiagnostics;
 }
 
 // MPRIS MediaPlayer2 interface
@@ -113,6 +115,27 @@ private:
     MprisManager *m_mprisManager;
 };
 
+// Playback diagnostics on the same object, for scripts comparing setups:
+// gdbus call --session -d org.mpris.MediaPlayer2.org._3fz.mtoc
+//   -o /org/mpris/MediaPlayer2 -m org._3fz.mtoc.Diagnostics.Json
+class PlaybackDiagnosticsAdaptor : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org._3fz.mtoc.Diagnostics")
+
+public:
+    explicit PlaybackDiagnosticsAdaptor(QObject *parent);
+    void setDiagnostics(Mtoc::PlaybackDiagnostics *diagnostics);
+
+public slots:
+    QString Json() const;
+    QString Dump() const;  // Returns the path written
+    void Reset();
+
+private:
+    QPointer<Mtoc::PlaybackDiagnostics> m_diagnostics;
+};
+
 // Main MPRIS Manager class
 class MprisManager : public QObject
 {
@@ -128,7 +151,7 @@ public:
 
 private slots:
     void onStateChanged();
-    void onPositionChanged(qint64 position);
+    void onSeeked(qint64 position);
     void onVolumeChanged(float volume);
     void onCurrentTrackChanged(Mtoc::Track *track);
     void onRepeatEnabledChanged(bool enabled);
@@ -147,6 +170,7 @@ private:
     Mtoc::LibraryManager *m_libraryManager;
     MediaPlayer2Adaptor *m_mprisAdaptor;
     MediaPlayer2PlayerAdaptor *m_playerAdaptor;
+    PlaybackDiagnosticsAdaptor *m_diagnosticsAdaptor;
     QDBusConnection m_dbusConnection;
     QString m_serviceName;
     bool m_initialized;
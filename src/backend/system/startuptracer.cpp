@@ -0,0 +1,105 @@
+#include "startuptracer.h"
+
+#include <QElapsedTimer>
+#include <QVector>
+#include <QFile>
+#include <QTextStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QStandardPaths>
+#include <QCoreApplication>
+#include <QDebug>
+
+namespace Mtoc {
+
+namespace {
+
+struct Phase {
+    QString name;
+    qint64 nsecs;
+};
+
+struct TraceState {
+    QElapsedTimer clock;
+    QVector<Phase> phases;
+    bool recording = false;
+};
+
+TraceState &state()
+{
+    static TraceState s;
+    return s;
+}
+
+// Older launches are dropped once the file grows past this
+const qint64 MAX_TRACE_FILE_SIZE = 256 * 1024;
+
+} // namespace
+
+void StartupTracer::start()
+{
+    TraceState &s = state();
+    s.phases.clear();
+    s.phases.reserve(32);
+    s.recording = true;
+    s.clock.start();
+}
+
+void StartupTracer::mark(const QString &phase)
+{
+    TraceState &s = state();
+    if (!s.recording) {
+        return;
+    }
+    s.phases.append({phase, s.clock.nsecsElapsed()});
+}
+
+qint64 StartupTracer::elapsedMs()
+{
+    const TraceState &s = state();
+    return s.clock.isValid() ? s.clock.elapsed() : 0;
+}
+
+QString StartupTracer::tracePath()
+{
+    QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return QDir(dataPath).filePath("startup_trace.log");
+}
+
+void StartupTracer::finish()
+{
+    TraceState &s = state();
+    if (!s.recording) {
+        return;
+    }
+    s.recording = false;
+
+    QString path = tracePath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QFile file(path);
+    QIODevice::OpenMode mode = QIODevice::WriteOnly | QIODevice::Text;
+    mode |= file.size() > MAX_TRACE_FILE_SIZE ? QIODevice::Truncate : QIODevice::Append;
+    if (!file.open(mode)) {
+        qWarning() << "[StartupTracer::finish] Failed to open" << path << "-" << file.errorString();
+        return;
+    }
+
+    QTextStream out(&file);
+    out << "# " << QDateTime::currentDateTime().toString(Qt::ISODate)
+        << " " << QCoreApplication::applicationVersion() << "\n";
+    qint64 previous = 0;
+    for (const Phase &phase : s.phases) {
+        out << QString("%1 ms  +%2 ms  %3\n")
+                   .arg(phase.nsecs / 1.0e6, 9, 'f', 1)
+                   .arg((phase.nsecs - previous) / 1.0e6, 8, 'f', 1)
+                   .arg(phase.name);
+        previous = phase.nsecs;
+    }
+    out << "\n";
+
+    qDebug() << "[StartupTracer] Startup finished in" << previous / 1000000 << "ms; trace written to" << path;
+}
+
+} // namespace Mtoc
@@ -0,0 +1,28 @@
+#ifndef STARTUPTRACER_H
+#define STARTUPTRACER_H
+
+#include <QString>
+
+namespace Mtoc {
+
+// Records how long after process start each startup phase completed and
+// appends the result to a trace file (one block per launch), so regressions
+// in time to first frame and first interaction show up as a diff between runs.
+// Main-thread only.
+class StartupTracer
+{
+public:
+    // Starts the clock; call first thing in main()
+    static void start();
+    // Records the end of a phase. Ignored before start() and after finish().
+    static void mark(const QString &phase);
+    static qint64 elapsedMs();
+
+    // Writes the collected phases to tracePath() and stops recording
+    static void finish();
+    static QString tracePath();
+};
+
+} // namespace Mtoc
+
+#endif // STARTUPTRACER_H
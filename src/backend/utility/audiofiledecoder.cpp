@@ -0,0 +1,141 @@
+#include "audiofiledecoder.h"
+
+#include <QUrl>
+#include <QFileInfo>
+#include <QDebug>
+#include <gst/gst.h>
+
+namespace Mtoc {
+
+namespace {
+
+const guint64 PULL_TIMEOUT = 100 * GST_MSECOND;
+// A decoder that has produced nothing for this long is not going to
+const int STALL_TIMEOUTS = 300;
+
+void onPadAdded(GstElement *decoder, GstPad *pad, gpointer data)
+{
+    Q_UNUSED(decoder)
+    // uridecodebin only exposes raw audio here; the first stream is decoded
+    GstElement *convert = static_cast<GstElement*>(data);
+    GstPad *sinkPad = gst_element_get_static_pad(convert, "sink");
+    if (!gst_pad_is_linked(sinkPad)) {
+        gst_pad_link(pad, sinkPad);
+    }
+    gst_object_unref(sinkPad);
+}
+
+bool ensureGStreamer()
+{
+    if (gst_is_initialized()) {
+        return true;
+    }
+    GError *error = nullptr;
+    if (!gst_init_check(nullptr, nullptr, &error)) {
+        qWarning() << "[AudioFileDecoder::decode] Failed to initialize GStreamer:"
+                   << (error ? error->message : "unknown error");
+        if (error) g_error_free(error);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool AudioFileDecoder::decode(const QString &filePath, const std::function<bool()> &cancelled, const Sink &sink)
+{
+    if (!ensureGStreamer()) {
+        return false;
+    }
+
+    GstElement *pipeline = gst_pipeline_new(nullptr);
+    GstElement *decoder = gst_element_factory_make("uridecodebin", nullptr);
+    GstElement *convert = gst_element_factory_make("audioconvert", nullptr);
+    GstElement *appSink = gst_element_factory_make("appsink", nullptr);
+    if (!pipeline || !decoder || !convert || !appSink) {
+        qWarning() << "[AudioFileDecoder::decode] Failed to create decoding pipeline";
+        for (GstElement *element : { pipeline, decoder, convert, appSink }) {
+            if (element) {
+                gst_object_unref(element);
+            }
+        }
+        return false;
+    }
+
+    const QByteArray uri = QUrl::fromLocalFile(filePath).toEncoded();
+    GstCaps *rawAudio = gst_caps_from_string("audio/x-raw");
+    g_object_set(decoder, "uri", uri.constData(), "caps", rawAudio, nullptr);
+    gst_caps_unref(rawAudio);
+
+    // Native-endian float at the file's own rate and channel count
+    GstCaps *sinkCaps = gst_caps_new_simple("audio/x-raw",
+        "format", G_TYPE_STRING, G_BYTE_ORDER == G_LITTLE_ENDIAN ? "F32LE" : "F32BE",
+        "layout", G_TYPE_STRING, "interleaved",
+        nullptr);
+    g_object_set(appSink, "caps", sinkCaps, "sync", FALSE, "max-buffers", 16u, nullptr);
+    gst_caps_unref(sinkCaps);
+
+    gst_bin_add_many(GST_BIN(pipeline), decoder, convert, appSink, nullptr);
+    gst_element_link(convert, appSink);
+    g_signal_connect(decoder, "pad-added", G_CALLBACK(onPadAdded), convert);
+
+    GstBus *bus = gst_element_get_bus(pipeline);
+    bool failed = gst_element_set_state(pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE;
+    int idlePulls = 0;
+
+    while (!failed) {
+        if (cancelled && cancelled()) {
+            failed = true;
+            break;
+        }
+
+        GstSample *sample = nullptr;
+        g_signal_emit_by_name(appSink, "try-pull-sample", PULL_TIMEOUT, &sample);
+        if (sample) {
+            idlePulls = 0;
+            int rate = 0;
+            int channels = 0;
+            if (GstCaps *caps = gst_sample_get_caps(sample)) {
+                const GstStructure *structure = gst_caps_get_structure(caps, 0);
+                gst_structure_get_int(structure, "rate", &rate);
+                gst_structure_get_int(structure, "channels", &channels);
+            }
+
+            GstBuffer *buffer = gst_sample_get_buffer(sample);
+            GstMapInfo map;
+            if (rate > 0 && channels > 0 && buffer && gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+                const int frames = int(map.size / (sizeof(float) * channels));
+                failed = !sink(reinterpret_cast<const float*>(map.data), frames, rate, channels);
+                gst_buffer_unmap(buffer, &map);
+            }
+            gst_sample_unref(sample);
+            continue;
+        }
+
+        GstMessage *message = gst_bus_pop_filtered(bus, GstMessageType(GST_MESSAGE_ERROR | GST_MESSAGE_EOS));
+        if (message) {
+            if (GST_MESSAGE_TYPE(message) == GST_MESSAGE_ERROR) {
+                GError *error = nullptr;
+                gst_message_parse_error(message, &error, nullptr);
+                qWarning() << "[AudioFileDecoder::decode] Cannot decode" << QFileInfo(filePath).fileName()
+                           << "-" << (error ? error->message : "unknown error");
+                if (error) g_error_free(error);
+                failed = true;
+            }
+            gst_message_unref(message);
+            break;
+        }
+
+        if (++idlePulls >= STALL_TIMEOUTS) {
+            qWarning() << "[AudioFileDecoder::decode] Decoder stalled on" << QFileInfo(filePath).fileName();
+            failed = true;
+        }
+    }
+
+    gst_element_set_state(pipeline, GST_STATE_NULL);
+    gst_object_unref(bus);
+    gst_object_unref(pipeline);
+    return !failed;
+}
+
+} // namespace Mtoc
@@ -0,0 +1,25 @@
+#ifndef AUDIOFILEDECODER_H
+#define AUDIOFILEDECODER_H
+
+#include <QString>
+#include <functional>
+
+namespace Mtoc {
+
+// Decodes a whole file to interleaved native-endian float on the calling
+// thread, as fast as GStreamer can (uridecodebin -> audioconvert -> appsink).
+// For background analysis; playback goes through AudioEngine.
+class AudioFileDecoder
+{
+public:
+    // Return false to stop decoding
+    using Sink = std::function<bool(const float *samples, int frames, int sampleRate, int channels)>;
+
+    // True if the whole file was decoded. False on errors, a stalled decoder,
+    // a sink that stopped, or once cancelled() returns true.
+    static bool decode(const QString &filePath, const std::function<bool()> &cancelled, const Sink &sink);
+};
+
+} // namespace Mtoc
+
+#endif // AUDIOFILEDECODER_H
@@ -0,0 +1,266 @@
+#include "loudnessmeter.h"
+
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Mtoc {
+
+namespace {
+
+const double ABSOLUTE_GATE_LUFS = -70.0;
+const double RELATIVE_GATE_LU = -10.0;
+const int STEPS_PER_BLOCK = 4;          // 400 ms blocks advanced 100 ms at a time
+const int CHUNK_FRAMES = 4096;
+const int TAPS_PER_PHASE = 12;
+
+// Filter state this small only costs time as denormals
+const double DENORMAL_FLOOR = 1e-30;
+
+double energyToLoudness(double energy)
+{
+    return -0.691 + 10.0 * std::log10(energy);
+}
+
+double loudnessToEnergy(double loudness)
+{
+    return std::pow(10.0, (loudness + 0.691) / 10.0);
+}
+
+double flushDenormal(double value)
+{
+    return std::fabs(value) < DENORMAL_FLOOR ? 0.0 : value;
+}
+
+} // namespace
+
+LoudnessMeter::LoudnessMeter(int sampleRate, int channels)
+    : m_sampleRate(qMax(1, sampleRate))
+    , m_channels(qMax(1, channels))
+    , m_state(m_channels)
+{
+    // K-weighting for any sample rate: the BS.1770 high shelf and high pass,
+    // derived from their analog prototypes with the bilinear transform
+    {
+        const double f0 = 1681.974450955533;
+        const double gain = 3.999843853973347;
+        const double q = 0.7071752369554196;
+        const double k = std::tan(M_PI * f0 / m_sampleRate);
+        const double vh = std::pow(10.0, gain / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+        Biquad &shelf = m_stages[0];
+        shelf.b0 = (vh + vb * k / q + k * k) / a0;
+        shelf.b1 = 2.0 * (k * k - vh) / a0;
+        shelf.b2 = (vh - vb * k / q + k * k) / a0;
+        shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+        shelf.a2 = (1.0 - k / q + k * k) / a0;
+    }
+    {
+        const double f0 = 38.13547087602444;
+        const double q = 0.5003270373238773;
+        const double k = std::tan(M_PI * f0 / m_sampleRate);
+        const double a0 = 1.0 + k / q + k * k;
+        Biquad &highPass = m_stages[1];
+        highPass.b0 = 1.0;
+        highPass.b1 = -2.0;
+        highPass.b2 = 1.0;
+        highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+        highPass.a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    // Surround channels count 1.41, LFE not at all. Mono is measured as dual
+    // mono so it plays as loud as the same material in stereo.
+    if (m_channels == 1) {
+        m_state[0].weight = 2.0;
+    } else if (m_channels == 5 || m_channels == 6) {
+        // GStreamer's default order: FL FR FC (LFE) RL RR
+        const int surround = m_channels == 6 ? 4 : 3;
+        if (m_channels == 6) {
+            m_state[3].weight = 0.0;
+        }
+        m_state[surround].weight = 1.41;
+        m_state[surround + 1].weight = 1.41;
+    }
+
+    m_stepFrames = qMax(1, qRound(m_sampleRate / 10.0));
+
+    // Windowed-sinc interpolator split into polyphase rows, one per output
+    // phase, each normalised to unity gain at DC
+    m_oversampling = m_sampleRate < 96000 ? 4 : m_sampleRate < 192000 ? 2 : 1;
+    m_phaseLength = m_oversampling > 1 ? TAPS_PER_PHASE : 1;
+    m_phases.resize(m_oversampling * m_phaseLength);
+    if (m_oversampling > 1) {
+        const int taps = m_oversampling * m_phaseLength;
+        const double centre = (taps - 1) / 2.0;
+        for (int phase = 0; phase < m_oversampling; ++phase) {
+            double row[TAPS_PER_PHASE];
+            double sum = 0.0;
+            for (int i = 0; i < m_phaseLength; ++i) {
+                const int n = i * m_oversampling + phase;
+                const double t = (n - centre) / m_oversampling;
+                const double sinc = qFuzzyIsNull(t) ? 1.0 : std::sin(M_PI * t) / (M_PI * t);
+                const double window = 0.5 * (1.0 - std::cos(2.0 * M_PI * (n + 1) / (taps + 1)));
+                row[i] = sinc * window;
+                sum += row[i];
+            }
+            // Reversed, so the dot product runs forward over the input
+            for (int i = 0; i < m_phaseLength; ++i) {
+                m_phases[phase * m_phaseLength + (m_phaseLength - 1 - i)] = float(row[i] / sum);
+            }
+        }
+    } else {
+        m_phases[0] = 1.0f;
+    }
+
+    for (ChannelState &state : m_state) {
+        state.history.fill(0.0f, m_phaseLength - 1);
+    }
+}
+
+void LoudnessMeter::process(const float *samples, int frames)
+{
+    while (frames > 0) {
+        const int n = qMin(qMin(frames, m_stepFrames - m_stepPosition), CHUNK_FRAMES);
+        for (int channel = 0; channel < m_channels; ++channel) {
+            filterChannel(channel, samples, n);
+            measurePeak(channel, samples, n);
+        }
+        samples += qsizetype(n) * m_channels;
+        frames -= n;
+        m_stepPosition += n;
+        if (m_stepPosition == m_stepFrames) {
+            finishStep();
+        }
+    }
+}
+
+void LoudnessMeter::filterChannel(int channel, const float *samples, int frames)
+{
+    ChannelState &state = m_state[channel];
+    if (state.weight == 0.0) {
+        return;
+    }
+
+    // The recursion is serial in time, so the state stays in registers and
+    // both stages run in one pass without an intermediate buffer
+    const Biquad s0 = m_stages[0];
+    const Biquad s1 = m_stages[1];
+    double z1a = state.z1[0], z2a = state.z2[0];
+    double z1b = state.z1[1], z2b = state.z2[1];
+    double sum = 0.0;
+
+    const float *x = samples + channel;
+    for (int i = 0; i < frames; ++i, x += m_channels) {
+        const double in = *x;
+        const double mid = s0.b0 * in + z1a;
+        z1a = s0.b1 * in - s0.a1 * mid + z2a;
+        z2a = s0.b2 * in - s0.a2 * mid;
+        const double out = s1.b0 * mid + z1b;
+        z1b = s1.b1 * mid - s1.a1 * out + z2b;
+        z2b = s1.b2 * mid - s1.a2 * out;
+        sum += out * out;
+    }
+
+    state.z1[0] = flushDenormal(z1a);
+    state.z2[0] = flushDenormal(z2a);
+    state.z1[1] = flushDenormal(z1b);
+    state.z2[1] = flushDenormal(z2b);
+    state.sum += state.weight * sum;
+}
+
+void LoudnessMeter::measurePeak(int channel, const float *samples, int frames)
+{
+    ChannelState &state = m_state[channel];
+    const int history = m_phaseLength - 1;
+
+    // Planar copy with the previous chunk's tail in front, so every output
+    // is a contiguous dot product the compiler can vectorise
+    m_planar.resize(history + frames);
+    float *planar = m_planar.data();
+    std::copy(state.history.constBegin(), state.history.constEnd(), planar);
+    const float *x = samples + channel;
+    for (int i = 0; i < frames; ++i, x += m_channels) {
+        planar[history + i] = *x;
+    }
+
+    float peak = 0.0f;
+    for (int i = 0; i < frames; ++i) {
+        peak = std::max(peak, std::fabs(planar[history + i]));
+    }
+    if (m_oversampling > 1) {
+        const float *phases = m_phases.constData();
+        for (int i = 0; i < frames; ++i) {
+            const float *window = planar + i;
+            for (int phase = 0; phase < m_oversampling; ++phase) {
+                const float *taps = phases + phase * m_phaseLength;
+                float y = 0.0f;
+                for (int k = 0; k < m_phaseLength; ++k) {
+                    y += taps[k] * window[k];
+                }
+                peak = std::max(peak, std::fabs(y));
+            }
+        }
+    }
+
+    std::copy(planar + frames, planar + frames + history, state.history.begin());
+    m_peak = std::max(m_peak, double(peak));
+}
+
+void LoudnessMeter::finishStep()
+{
+    double energy = 0.0;
+    for (ChannelState &state : m_state) {
+        energy += state.sum;
+        state.sum = 0.0;
+    }
+    energy /= m_stepFrames;
+
+    std::rotate(m_steps, m_steps + 1, m_steps + STEPS_PER_BLOCK);
+    m_steps[STEPS_PER_BLOCK - 1] = energy;
+    m_stepPosition = 0;
+
+    if (++m_stepCount >= STEPS_PER_BLOCK) {
+        double block = 0.0;
+        for (double step : m_steps) {
+            block += step;
+        }
+        m_blocks.append(block / STEPS_PER_BLOCK);
+    }
+}
+
+double LoudnessMeter::gatedLoudness(const QVector<double> &blocks)
+{
+    const double absoluteThreshold = loudnessToEnergy(ABSOLUTE_GATE_LUFS);
+
+    double sum = 0.0;
+    int count = 0;
+    for (double energy : blocks) {
+        if (energy > absoluteThreshold) {
+            sum += energy;
+            ++count;
+        }
+    }
+    if (count == 0) {
+        return -std::numeric_limits<double>::infinity();
+    }
+
+    // The relative gate sits 10 LU under the loudness of the blocks that passed
+    const double relativeThreshold = std::max(absoluteThreshold,
+                                              sum / count * std::pow(10.0, RELATIVE_GATE_LU / 10.0));
+    sum = 0.0;
+    count = 0;
+    for (double energy : blocks) {
+        if (energy > relativeThreshold) {
+            sum += energy;
+            ++count;
+        }
+    }
+    if (count == 0) {
+        return -std::numeric_limits<double>::infinity();
+    }
+    return energyToLoudness(sum / count);
+}
+
+} // namespace Mtoc
@@ -0,0 +1,69 @@
+#ifndef LOUDNESSMETER_H
+#define LOUDNESSMETER_H
+
+#include <QVector>
+
+namespace Mtoc {
+
+// Integrated loudness (ITU-R BS.1770-4 / EBU R128) and true peak of one
+// stream of interleaved float samples. Audio is K-weighted per channel,
+// cut into 400 ms blocks overlapping by 75%, and the block energies are
+// kept so several tracks can be gated together for an album value.
+class LoudnessMeter
+{
+public:
+    LoudnessMeter(int sampleRate, int channels);
+
+    int sampleRate() const { return m_sampleRate; }
+    int channels() const { return m_channels; }
+
+    void process(const float *samples, int frames);
+
+    // LUFS; -infinity if nothing passed the gates (silence or under 400 ms)
+    double integratedLoudness() const { return gatedLoudness(m_blocks); }
+    // Linear, from 4x oversampling below 96 kHz and 2x below 192 kHz
+    double truePeak() const { return m_peak; }
+
+    // Channel-weighted mean square of every complete block
+    const QVector<double> &blockEnergies() const { return m_blocks; }
+    static double gatedLoudness(const QVector<double> &blocks);
+
+private:
+    // Transposed direct form II
+    struct Biquad {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+    };
+
+    struct ChannelState {
+        double z1[2] = { 0.0, 0.0 };
+        double z2[2] = { 0.0, 0.0 };
+        double weight = 1.0;
+        double sum = 0.0;            // Weighted energy of the current 100 ms step
+        QVector<float> history;      // Last input samples, for the oversampler
+    };
+
+    void filterChannel(int channel, const float *samples, int frames);
+    void measurePeak(int channel, const float *samples, int frames);
+    void finishStep();
+
+    int m_sampleRate;
+    int m_channels;
+    Biquad m_stages[2];
+    QVector<ChannelState> m_state;
+
+    int m_stepFrames;
+    int m_stepPosition = 0;
+    double m_steps[4] = { 0.0, 0.0, 0.0, 0.0 };
+    int m_stepCount = 0;
+    QVector<double> m_blocks;
+
+    int m_oversampling;
+    int m_phaseLength;
+    QVector<float> m_phases;   // m_oversampling rows of m_phaseLength taps, reversed
+    QVector<float> m_planar;   // One channel's history followed by the current chunk
+    double m_peak = 0.0;
+};
+
+} // namespace Mtoc
+
+#endif // LOUDNESSMETER_H
@@ -0,0 +1,313 @@
+#include "parametricequalizer.h"
+
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MTOC_EQ_SSE 1
+#endif
+
+namespace Mtoc {
+
+namespace {
+
+// Coefficients move in RAMP_STEPS steps, one per RAMP_FRAMES
+const int RAMP_FRAMES = 64;
+const int RAMP_STEPS = 32;
+// Below this a band is left out rather than filtered for nothing
+const double FLAT_GAIN_DB = 0.01;
+// Filter state that decays below this is zeroed, so long silences don't
+// drop into denormals
+const float DENORMAL_LIMIT = 1e-20f;
+
+#ifdef MTOC_EQ_SSE
+inline __m128 loadLanes(const float *p, int lanes)
+{
+    switch (lanes) {
+    case 4:
+        return _mm_loadu_ps(p);
+    case 2:
+        return _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(p));
+    case 3:
+        return _mm_setr_ps(p[0], p[1], p[2], 0.0f);
+    default:
+        return _mm_set_ss(p[0]);
+    }
+}
+
+inline void storeLanes(float *p, __m128 v, int lanes)
+{
+    switch (lanes) {
+    case 4:
+        _mm_storeu_ps(p, v);
+        break;
+    case 2:
+        _mm_storel_pi(reinterpret_cast<__m64*>(p), v);
+        break;
+    default: {
+        alignas(16) float lane[4];
+        _mm_store_ps(lane, v);
+        std::memcpy(p, lane, sizeof(float) * lanes);
+        break;
+    }
+    }
+}
+#endif
+
+} // namespace
+
+QVector<ParametricEqualizer::Band> ParametricEqualizer::graphicBands(const QVector<double> &gains)
+{
+    QVector<Band> bands;
+    for (int i = 0; i < GRAPHIC_BANDS; ++i) {
+        Band band;
+        band.frequency = 31.25 * std::pow(2.0, i);
+        band.gain = gains.value(i, 0.0);
+        band.q = M_SQRT2;  // One octave wide
+        bands.append(band);
+    }
+    return bands;
+}
+
+ParametricEqualizer::ParametricEqualizer()
+{
+    reset();
+}
+
+void ParametricEqualizer::setBands(const QVector<Band> &bands)
+{
+    QMutexLocker locker(&m_mutex);
+    m_pendingBands = bands.mid(0, MAX_BANDS);
+    m_pending.store(true, std::memory_order_release);
+}
+
+void ParametricEqualizer::setFormat(int sampleRate, int channels)
+{
+    if (sampleRate == m_sampleRate && channels == m_channels) {
+        return;
+    }
+    m_sampleRate = sampleRate;
+    m_channels = channels;
+    reset();
+    retarget(false);
+}
+
+void ParametricEqualizer::reset()
+{
+    for (Stage &stage : m_stages) {
+        std::fill(std::begin(stage.z1), std::end(stage.z1), 0.0f);
+        std::fill(std::begin(stage.z2), std::end(stage.z2), 0.0f);
+    }
+}
+
+bool ParametricEqualizer::isActive()
+{
+    if (m_pending.load(std::memory_order_acquire)) {
+        QMutexLocker locker(&m_mutex);
+        m_bands = m_pendingBands;
+        m_pending.store(false, std::memory_order_relaxed);
+        locker.unlock();
+        retarget(true);
+    }
+    return m_activeCount > 0;
+}
+
+ParametricEqualizer::Coefficients ParametricEqualizer::design(const Band &band, int sampleRate, double outputGain)
+{
+    Coefficients c;
+    const bool flat = std::abs(band.gain) < FLAT_GAIN_DB;
+    if (flat && outputGain == 1.0) {
+        return c;
+    }
+
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0, a0 = 1.0, a1 = 0.0, a2 = 0.0;
+    if (!flat) {
+        const double A = std::pow(10.0, band.gain / 40.0);
+        // Bands above what the sample rate can carry are pulled down below Nyquist
+        const double w0 = 2.0 * M_PI * qMin(band.frequency, 0.45 * sampleRate) / sampleRate;
+        const double cosW0 = std::cos(w0);
+        const double alpha = std::sin(w0) / (2.0 * qMax(band.q, 0.1));
+        const double shelf = 2.0 * std::sqrt(A) * alpha;
+
+        switch (band.type) {
+        case Peaking:
+            b0 = 1.0 + alpha * A;
+            b1 = -2.0 * cosW0;
+            b2 = 1.0 - alpha * A;
+            a0 = 1.0 + alpha / A;
+            a1 = -2.0 * cosW0;
+            a2 = 1.0 - alpha / A;
+            break;
+        case LowShelf:
+            b0 = A * ((A + 1.0) - (A - 1.0) * cosW0 + shelf);
+            b1 = 2.0 * A * ((A - 1.0) - (A + 1.0) * cosW0);
+            b2 = A * ((A + 1.0) - (A - 1.0) * cosW0 - shelf);
+            a0 = (A + 1.0) + (A - 1.0) * cosW0 + shelf;
+            a1 = -2.0 * ((A - 1.0) + (A + 1.0) * cosW0);
+            a2 = (A + 1.0) + (A - 1.0) * cosW0 - shelf;
+            break;
+        case HighShelf:
+            b0 = A * ((A + 1.0) + (A - 1.0) * cosW0 + shelf);
+            b1 = -2.0 * A * ((A - 1.0) + (A + 1.0) * cosW0);
+            b2 = A * ((A + 1.0) + (A - 1.0) * cosW0 - shelf);
+            a0 = (A + 1.0) - (A - 1.0) * cosW0 + shelf;
+            a1 = 2.0 * ((A - 1.0) - (A + 1.0) * cosW0);
+            a2 = (A + 1.0) - (A - 1.0) * cosW0 - shelf;
+            break;
+        }
+    }
+
+    c.b0 = float(b0 / a0 * outputGain);
+    c.b1 = float(b1 / a0 * outputGain);
+    c.b2 = float(b2 / a0 * outputGain);
+    c.a1 = float(a1 / a0);
+    c.a2 = float(a2 / a0);
+    return c;
+}
+
+void ParametricEqualizer::retarget(bool ramp)
+{
+    if (m_sampleRate <= 0 || m_channels <= 0 || m_channels > MAX_CHANNELS) {
+        m_activeCount = 0;
+        m_rampSteps = 0;
+        return;
+    }
+
+    // Boosts would clip, so the output comes down by the largest one; it
+    // rides on the first band's numerator rather than costing its own pass
+    double maxBoost = 0.0;
+    for (const Band &band : m_bands) {
+        maxBoost = qMax(maxBoost, band.gain);
+    }
+    const double outputGain = maxBoost >= FLAT_GAIN_DB ? std::pow(10.0, -maxBoost / 20.0) : 1.0;
+
+    for (int i = 0; i < MAX_BANDS; ++i) {
+        Stage &stage = m_stages[i];
+        stage.target = i < m_bands.size()
+            ? design(m_bands[i], m_sampleRate, i == 0 ? outputGain : 1.0)
+            : Coefficients();
+        if (!ramp) {
+            stage.current = stage.target;
+            continue;
+        }
+        stage.step.b0 = (stage.target.b0 - stage.current.b0) / RAMP_STEPS;
+        stage.step.b1 = (stage.target.b1 - stage.current.b1) / RAMP_STEPS;
+        stage.step.b2 = (stage.target.b2 - stage.current.b2) / RAMP_STEPS;
+        stage.step.a1 = (stage.target.a1 - stage.current.a1) / RAMP_STEPS;
+        stage.step.a2 = (stage.target.a2 - stage.current.a2) / RAMP_STEPS;
+    }
+
+    // The (a1, a2) stability region is a triangle, so every point on the
+    // line between two stable filters is stable too
+    m_rampSteps = ramp ? RAMP_STEPS : 0;
+    updateActiveStages();
+}
+
+void ParametricEqualizer::advanceRamp()
+{
+    if (--m_rampSteps > 0) {
+        for (int i = 0; i < m_activeCount; ++i) {
+            Stage &stage = m_stages[m_activeStages[i]];
+            stage.current.b0 += stage.step.b0;
+            stage.current.b1 += stage.step.b1;
+            stage.current.b2 += stage.step.b2;
+            stage.current.a1 += stage.step.a1;
+            stage.current.a2 += stage.step.a2;
+        }
+        return;
+    }
+    // Land exactly, so bands ramped to flat drop out
+    for (Stage &stage : m_stages) {
+        stage.current = stage.target;
+    }
+    updateActiveStages();
+}
+
+void ParametricEqualizer::updateActiveStages()
+{
+    m_activeCount = 0;
+    for (int i = 0; i < MAX_BANDS; ++i) {
+        Stage &stage = m_stages[i];
+        if (!stage.current.isIdentity() || (m_rampSteps > 0 && !stage.target.isIdentity())) {
+            m_activeStages[m_activeCount++] = i;
+        } else {
+            std::fill(std::begin(stage.z1), std::end(stage.z1), 0.0f);
+            std::fill(std::begin(stage.z2), std::end(stage.z2), 0.0f);
+        }
+    }
+}
+
+void ParametricEqualizer::process(float *samples, int frames)
+{
+    while (frames > 0 && m_activeCount > 0) {
+        // Whole buffers go through each band in turn; while ramping they go
+        // in short runs with a coefficient step after each
+        const int run = m_rampSteps > 0 ? qMin(frames, RAMP_FRAMES) : frames;
+        for (int i = 0; i < m_activeCount; ++i) {
+            filter(m_stages[m_activeStages[i]], samples, run);
+        }
+        if (m_rampSteps > 0) {
+            advanceRamp();
+        }
+        samples += qsizetype(run) * m_channels;
+        frames -= run;
+    }
+
+    for (int i = 0; i < m_activeCount; ++i) {
+        Stage &stage = m_stages[m_activeStages[i]];
+        for (int ch = 0; ch < m_channels; ++ch) {
+            if (std::abs(stage.z1[ch]) < DENORMAL_LIMIT) stage.z1[ch] = 0.0f;
+            if (std::abs(stage.z2[ch]) < DENORMAL_LIMIT) stage.z2[ch] = 0.0f;
+        }
+    }
+}
+
+void ParametricEqualizer::filter(Stage &stage, float *samples, int frames) const
+{
+    const Coefficients &c = stage.current;
+    const int channels = m_channels;
+
+#ifdef MTOC_EQ_SSE
+    // Channels are independent, so one frame's channels share a register
+    const __m128 b0 = _mm_set1_ps(c.b0);
+    const __m128 b1 = _mm_set1_ps(c.b1);
+    const __m128 b2 = _mm_set1_ps(c.b2);
+    const __m128 a1 = _mm_set1_ps(c.a1);
+    const __m128 a2 = _mm_set1_ps(c.a2);
+    for (int first = 0; first < channels; first += 4) {
+        const int lanes = qMin(4, channels - first);
+        __m128 z1 = _mm_load_ps(stage.z1 + first);
+        __m128 z2 = _mm_load_ps(stage.z2 + first);
+        float *p = samples + first;
+        for (int f = 0; f < frames; ++f, p += channels) {
+            const __m128 x = loadLanes(p, lanes);
+            const __m128 y = _mm_add_ps(_mm_mul_ps(b0, x), z1);
+            z1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, x), _mm_mul_ps(a1, y)), z2);
+            z2 = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+            storeLanes(p, y, lanes);
+        }
+        _mm_store_ps(stage.z1 + first, z1);
+        _mm_store_ps(stage.z2 + first, z2);
+    }
+#else
+    for (int ch = 0; ch < channels; ++ch) {
+        float z1 = stage.z1[ch];
+        float z2 = stage.z2[ch];
+        float *p = samples + ch;
+        for (int f = 0; f < frames; ++f, p += channels) {
+            const float x = *p;
+            const float y = c.b0 * x + z1;
+            z1 = c.b1 * x - c.a1 * y + z2;
+            z2 = c.b2 * x - c.a2 * y;
+            *p = y;
+        }
+        stage.z1[ch] = z1;
+        stage.z2[ch] = z2;
+    }
+#endif
+}
+
+} // namespace Mtoc
@@ -0,0 +1,88 @@
+#ifndef PARAMETRICEQUALIZER_H
+#define PARAMETRICEQUALIZER_H
+
+#include <QVector>
+#include <QMutex>
+#include <atomic>
+
+namespace Mtoc {
+
+// A cascade of biquads (RBJ cookbook shapes) run in place over interleaved
+// float frames. Bands are set from any thread; the streaming thread picks
+// them up on its next buffer and ramps the coefficients over ~45 ms, so
+// dragging a slider does not click. Flat bands are skipped, and with every
+// band flat nothing runs at all. Each biquad filters up to four channels per
+// SSE instruction, with a scalar loop on other targets.
+class ParametricEqualizer
+{
+public:
+    enum BandType {
+        Peaking,
+        LowShelf,
+        HighShelf
+    };
+
+    struct Band {
+        BandType type = Peaking;
+        double frequency = 1000.0;  // Hz
+        double gain = 0.0;          // dB
+        double q = 1.0;
+    };
+
+    static const int MAX_BANDS = 16;
+    static const int MAX_CHANNELS = 8;
+
+    // Octave bands from 31 Hz to 16 kHz, as set by the ten-band settings
+    static const int GRAPHIC_BANDS = 10;
+    static QVector<Band> graphicBands(const QVector<double> &gains);
+
+    ParametricEqualizer();
+
+    // Any thread
+    void setBands(const QVector<Band> &bands);
+
+    // Streaming thread only
+    void setFormat(int sampleRate, int channels);
+    int channels() const { return m_channels; }
+    void reset();
+    // Applies pending band changes; false when process() would do nothing
+    bool isActive();
+    void process(float *samples, int frames);
+
+private:
+    // Transposed direct form II, normalised by a0
+    struct Coefficients {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+        bool isIdentity() const { return b0 == 1.0f && b1 == 0.0f && b2 == 0.0f && a1 == 0.0f && a2 == 0.0f; }
+    };
+
+    struct Stage {
+        Coefficients current;
+        Coefficients target;
+        Coefficients step;
+        alignas(16) float z1[MAX_CHANNELS];
+        alignas(16) float z2[MAX_CHANNELS];
+    };
+
+    static Coefficients design(const Band &band, int sampleRate, double outputGain);
+    void retarget(bool ramp);
+    void advanceRamp();
+    void updateActiveStages();
+    void filter(Stage &stage, float *samples, int frames) const;
+
+    QMutex m_mutex;
+    QVector<Band> m_pendingBands;
+    std::atomic<bool> m_pending{false};
+
+    QVector<Band> m_bands;
+    int m_sampleRate = 0;
+    int m_channels = 0;
+    Stage m_stages[MAX_BANDS];
+    int m_activeStages[MAX_BANDS];
+    int m_activeCount = 0;
+    int m_rampSteps = 0;  // Left in the current ramp
+};
+
+} // namespace Mtoc
+
+#endif // PARAMETRICEQUALIZER_H
@@ -25,9 +25,12 @@
 #include "backend/library/album.h"
 #include "backend/playback/mediaplayer.h"
 #include "backend/system/mprismanager.h"
+#include "backend/system/startuptracer.h"
+#include "backend/system/deferredinitscheduler.h"
 #include "backend/settings/settingsmanager.h"
 #include "backend/playlist/playlistmanager.h"
 #include "backend/library/favoritesmanager.h"
+#include "backend/library/waveformitem.h"
 #include "backend/scrobble/scrobblemanager.h"
 
 // Message handler to show only QML console.log messages
@@ -71,6 +74,8 @@ void messageHandler(QtMsgType type, const QMessageLogContext &context, const QSt
 
 int main(int argc, char *argv[])
 {
+    Mtoc::StartupTracer::start();
+    
     // First, ensure debug output is not disabled for our code but disable verbose Qt internals
     QLoggingCategory::setFilterRules("*.debug=true\n"
                                     "qt.qml.typeresolution.debug=false\n"
@@ -101,6 +106,7 @@ int main(int argc, char *argv[])
     // QSurfaceFormat::setDefaultFormat(format);
     
     QApplication app(argc, argv);
+    Mtoc::StartupTracer::mark("QApplication");
     
     // Set up locale for proper string comparison
     // Check if user has set a specific locale via environment variable
@@ -195,6 +201,8 @@ int main(int argc, char *argv[])
                  << newCacheSize / 1024 << "MB";
     });
 
+    Mtoc::StartupTracer::mark("settings and pixmap cache");
+
     QQmlApplicationEngine engine;
 
     // Register SystemInfo as a QML Singleton
@@ -210,6 +218,18 @@ int main(int argc, char *argv[])
     // Register types for QML
     qmlRegisterType<Mtoc::Track>("Mtoc.Backend", 1, 0, "Track");
     qmlRegisterType<Mtoc::Album>("Mtoc.Backend", 1, 0, "Album");
+    qmlRegisterUncreatableType<Mtoc::AlbumListModel>("Mtoc.Backend", 1, 0, "AlbumListModel",
+                                                     "AlbumListModel is provided by LibraryManager.albums");
+    qmlRegisterUncreatableType<Mtoc::ArtistListModel>("Mtoc.Backend", 1, 0, "ArtistListModel",
+                                                      "ArtistListModel is provided by LibraryManager.artists");
+    qmlRegisterUncreatableType<Mtoc::AlbumSortProxyModel>("Mtoc.Backend", 1, 0, "AlbumSortProxyModel",
+                                                          "AlbumSortProxyModel is provided by LibraryManager.sortedAlbums");
+    qmlRegisterUncreatableType<Mtoc::QueueListModel>("Mtoc.Backend", 1, 0, "QueueListModel",
+                                                     "QueueListModel is provided by MediaPlayer.queueModel");
+    qmlRegisterUncreatableType<Mtoc::PlaybackClock>("Mtoc.Backend", 1, 0, "PlaybackClock",
+                                                    "PlaybackClock is provided by MediaPlayer.clock");
+    qmlRegisterUncreatableType<Mtoc::PlaybackDiagnostics>("Mtoc.Backend", 1, 0, "PlaybackDiagnostics",
+                                                          "PlaybackDiagnostics is provided by MediaPlayer.diagnostics");
     
     // Create objects and parent them to the QML engine for automatic cleanup
     SystemInfo *systemInfo = new SystemInfo(&engine);
@@ -219,6 +239,7 @@ int main(int argc, char *argv[])
     qDebug() << "Main: Creating LibraryManager...";
     Mtoc::LibraryManager *libraryManager = new Mtoc::LibraryManager(&engine);
     qDebug() << "Main: LibraryManager created successfully";
+    Mtoc::StartupTracer::mark("LibraryManager");
     
     qDebug() << "Main: Registering LibraryManager with QML...";
     qmlRegisterSingletonInstance("Mtoc.Backend", 1, 0, "LibraryManager", libraryManager);
@@ -229,6 +250,13 @@ int main(int argc, char *argv[])
     qmlRegisterSingletonInstance("Mtoc.Backend", 1, 0, "FavoritesManager", libraryManager->favoritesManager());
     qDebug() << "Main: FavoritesManager registered";
 
+    // Register LoudnessAnalyzer singleton (owned by LibraryManager)
+    qmlRegisterSingletonInstance("Mtoc.Backend", 1, 0, "LoudnessAnalyzer", libraryManager->loudnessAnalyzer());
+
+    // Register WaveformService singleton (owned by LibraryManager) and the item that draws from it
+    qmlRegisterSingletonInstance("Mtoc.Backend", 1, 0, "WaveformService", libraryManager->waveformService());
+    qmlRegisterType<Mtoc::WaveformItem>("Mtoc.Backend", 1, 0, "Waveform");
+
     // MetadataExtractor might not need to be a singleton since it's used by LibraryManager
     Mtoc::MetadataExtractor *metadataExtractor = new Mtoc::MetadataExtractor(&engine);
     qmlRegisterSingletonInstance("Mtoc.Backend", 1, 0, "MetadataExtractor", metadataExtractor);
@@ -266,12 +294,13 @@ int main(int argc, char *argv[])
     mediaPlayer->setSettingsManager(settingsManager);
     qmlRegisterSingletonInstance("Mtoc.Backend", 1, 0, "MediaPlayer", mediaPlayer);
     qDebug() << "Main: MediaPlayer registered";
+    Mtoc::StartupTracer::mark("MediaPlayer");
     
     // Register PlaylistManager singleton
     qDebug() << "Main: Creating PlaylistManager...";
     PlaylistManager *playlistManager = PlaylistManager::instance();
     playlistManager->setParent(&engine);  // Parent to engine for cleanup
-    playlistManager->setSettingsManager(settingsManager);  // Must be set before setLibraryManager (which triggers initialize)
+    playlistManager->setSettingsManager(settingsManager);  // Must be set before initialize (deferred below)
     playlistManager->setLibraryManager(libraryManager);
     playlistManager->setMediaPlayer(mediaPlayer);
     qmlRegisterSingletonInstance("Mtoc.Backend", 1, 0, "PlaylistManager", playlistManager);
@@ -281,20 +310,13 @@ int main(int argc, char *argv[])
     qDebug() << "Main: Creating ScrobbleManager...";
     Mtoc::ScrobbleManager *scrobbleManager = new Mtoc::ScrobbleManager(&engine);
     scrobbleManager->setMediaPlayer(mediaPlayer);
-    scrobbleManager->setDatabaseManager(libraryManager->databaseManager());
     scrobbleManager->setSettingsManager(settingsManager);
     qmlRegisterSingletonInstance("Mtoc.Backend", 1, 0, "ScrobbleManager", scrobbleManager);
     qDebug() << "Main: ScrobbleManager registered";
 
-    // Create and initialize MPRIS manager for system media control integration
-    qDebug() << "Main: Creating MPRIS manager...";
-    MprisManager *mprisManager = new MprisManager(mediaPlayer);
-    mprisManager->setLibraryManager(libraryManager);
-    if (mprisManager->initialize()) {
-        qDebug() << "Main: MPRIS manager initialized successfully";
-    } else {
-        qWarning() << "Main: Failed to initialize MPRIS manager";
-    }
+    // Created once the first frame is up (see the deferred init below)
+    MprisManager *mprisManager = nullptr;
+    Mtoc::StartupTracer::mark("singletons registered");
     
     // Register album art image provider
     qDebug() << "Main: Registering album art image provider...";
@@ -316,6 +338,7 @@ int main(int argc, char *argv[])
         
     qDebug() << "Main: Loading QML from:" << url;
     engine.load(url);
+    Mtoc::StartupTracer::mark("QML loaded");
 
     // Set up system tray icon
     QSystemTrayIcon *trayIcon = nullptr;
@@ -517,6 +540,40 @@ int main(int argc, char *argv[])
         qWarning() << "Main: System tray is not available on this system";
     }
 
+    // Bring non-critical subsystems online after the first frame, in dependency
+    // order: playback restoration may reference a playlist, and the scrobbler
+    // should have its database before playback can resume.
+    QQuickWindow *rootWindow = engine.rootObjects().isEmpty()
+        ? nullptr : qobject_cast<QQuickWindow*>(engine.rootObjects().first());
+    Mtoc::DeferredInitScheduler *deferredInit = new Mtoc::DeferredInitScheduler(&app);
+    deferredInit->add("playlists", [playlistManager]() {
+        playlistManager->initialize();
+    });
+    deferredInit->add("scrobble history", [scrobbleManager, libraryManager]() {
+        scrobbleManager->setDatabaseManager(libraryManager->databaseManager());
+    });
+    deferredInit->add("playback state", [mediaPlayer]() {
+        mediaPlayer->restoreState();
+    });
+    deferredInit->add("MPRIS", [&mprisManager, mediaPlayer, libraryManager]() {
+        // Create and initialize MPRIS manager for system media control integration
+        mprisManager = new MprisManager(mediaPlayer);
+        mprisManager->setLibraryManager(libraryManager);
+        if (mprisManager->initialize()) {
+            qDebug() << "Main: MPRIS manager initialized successfully";
+        } else {
+            qWarning() << "Main: Failed to initialize MPRIS manager";
+        }
+    });
+    deferredInit->add("file watcher", [libraryManager]() {
+        libraryManager->startFileWatcher();
+    });
+    deferredInit->add("database integrity check", [libraryManager]() {
+        libraryManager->checkDatabaseIntegrity();
+    });
+    deferredInit->startAfterFirstFrame(rootWindow);
+    Mtoc::StartupTracer::mark("tray icon and deferred init scheduled");
+
     // Connect to application aboutToQuit signal for cleanup
     QObject::connect(&app, &QApplication::aboutToQuit, [&]() {
         qDebug() << "Main: Application about to quit, performing cleanup...";
@@ -389,11 +389,15 @@ Rectangle {
                 property real targetValue: 0
                 property bool isSeeking: false
                 
+                PlaybackPosition {
+                    id: playbackPosition
+                }
+
                 // Use Binding for cleaner logic
                 Binding {
                     target: progressSlider
                     property: "value"
-                    value: MediaPlayer.position
+                    value: playbackPosition.position
                     when: !progressSlider.isSeeking && MediaPlayer.savedPosition === 0
                 }
                 
@@ -453,35 +457,48 @@ Rectangle {
                     }
                 }
                 
-                background: Rectangle {
+                background: Item {
                     x: progressSlider.leftPadding + progressSlider.handle.width / 2
                     y: progressSlider.topPadding + progressSlider.availableHeight / 2 - height / 2
                     implicitWidth: 200
                     implicitHeight: 6
                     width: progressSlider.availableWidth - progressSlider.handle.width
                     height: implicitHeight
-                    radius: 3
-                    gradient: Gradient {
-                        orientation: Gradient.Vertical
-                        GradientStop { position: 0.0; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.15) : Qt.rgba(0, 0, 0, 0.19) }
-                        GradientStop { position: 0.5; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.17) : Qt.rgba(0, 0, 0, 0.17) }
-                        GradientStop { position: 1.0; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.19) : Qt.rgba(0, 0, 0, 0.15) }
-                    }
-                    opacity: 0.8
                     
                     Rectangle {
-                        width: progressSlider.visualPosition * parent.width
-                        height: parent.height
+                        anchors.fill: parent
+                        visible: !progressSliderWaveform.ready
                         radius: 3
-                        opacity: 0.6
-                        
                         gradient: Gradient {
                             orientation: Gradient.Vertical
-                            GradientStop { position: 0.0; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.8) : Qt.rgba(0, 0, 0, 0.25) }
-                            GradientStop { position: 0.5; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.6) : Qt.rgba(0, 0, 0, 0.35) }
-                            GradientStop { position: 1.0; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.35) : Qt.rgba(0, 0, 0, 0.4) }
+                            GradientStop { position: 0.0; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.15) : Qt.rgba(0, 0, 0, 0.19) }
+                            GradientStop { position: 0.5; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.17) : Qt.rgba(0, 0, 0, 0.17) }
+                            GradientStop { position: 1.0; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.19) : Qt.rgba(0, 0, 0, 0.15) }
+                        }
+                        opacity: 0.8
+                        
+                        Rectangle {
+                            width: progressSlider.visualPosition * parent.width
+                            height: parent.height
+                            radius: 3
+                            opacity: 0.6
+                            
+                            gradient: Gradient {
+                                orientation: Gradient.Vertical
+                                GradientStop { position: 0.0; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.8) : Qt.rgba(0, 0, 0, 0.25) }
+                                GradientStop { position: 0.5; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.6) : Qt.rgba(0, 0, 0, 0.35) }
+                                GradientStop { position: 1.0; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.35) : Qt.rgba(0, 0, 0, 0.4) }
+                            }
                         }
                     }
+                    
+                    SeekBarWaveform {
+                        id: progressSliderWaveform
+                        anchors.centerIn: parent
+                        width: parent.width
+                        height: 18
+                        progress: progressSlider.visualPosition
+                    }
                 }
                 
                 handle: Item {
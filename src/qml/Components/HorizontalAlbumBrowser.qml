@@ -9,8 +9,9 @@ Item {
     
     property var selectedAlbum: null
     property int currentIndex: -1
-    property var sortedAlbumIndices: []  // Array of indices into LibraryManager.albumModel
-    property var albumIdToSortedIndex: ({})  // Map album ID to sorted index for O(1) lookup
+    property var sortedAlbums: LibraryManager ? LibraryManager.sortedAlbums : null  // Sorted in C++
+    property int albumCount: sortedAlbums ? sortedAlbums.count : 0
+    property int sortRevision: 0  // Bumped whenever the sorted order changes
     
     // Touchpad scrolling properties
     property real scrollVelocity: 0
@@ -334,106 +335,66 @@ Item {
         enabled: !isDestroying
         function onLibraryChanged() {
             if (isDestroying) return
-            
-            // Save current position before updating
-            var currentAlbumId = selectedAlbum ? selectedAlbum.id : -1
-            updateSortedIndices()
-            
-            // Try to restore to the same album if it still exists
-            if (currentAlbumId > 0 && LibraryManager) {
-                var sourceAlbums = (LibraryManager.albumModel) ? LibraryManager.albumModel : []
-                for (var i = 0; i < sourceAlbums.length; i++) {
-                    if (sourceAlbums[i].id === currentAlbumId) {
-                        jumpToAlbum(sourceAlbums[i], true)  // Jump instantly to maintain position during library changes
-                        return
-                    }
-                }
+            keepSelectedAlbum()
+        }
+        function onLibraryUpdated(changes) {
+            if (isDestroying) return
+            // Only added or removed albums can shift the carousel
+            if (changes.addedAlbums.length > 0 || changes.removedAlbums.length > 0) {
+                keepSelectedAlbum()
             }
-            
-            // If album was removed, try to restore saved position
-            restoreCarouselPosition()
         }
     }
     
-    function updateSortedIndices() {
-        if (isDestroying || !LibraryManager) return
-        
-        var sourceAlbums = (LibraryManager.albumModel) ? LibraryManager.albumModel : []
-        // Create array of indices with album data for sorting
-        var indexedAlbums = []
-        for (var i = 0; i < sourceAlbums.length; i++) {
-            indexedAlbums.push({
-                index: i,
-                albumArtist: sourceAlbums[i].albumArtist || "",
-                year: sourceAlbums[i].year || 0
-            })
-        }
-        
-        // Sort by artist first, then by year (descending) within each artist
-        indexedAlbums.sort(function(a, b) {
-            // Get artist names for comparison, removing "The " prefix
-            var artistA = a.albumArtist.toLowerCase()
-            var artistB = b.albumArtist.toLowerCase()
-            
-            // Remove "The " prefix for sorting purposes
-            if (artistA.indexOf("the ") === 0) {
-                artistA = artistA.substring(4)
-            }
-            if (artistB.indexOf("the ") === 0) {
-                artistB = artistB.substring(4)
-            }
-            
-            // First, separate letters from non-letters (numbers/symbols go last, like artist list)
-            var aStartsWithLetter = artistA.length > 0 && /^[a-z]/i.test(artistA[0])
-            var bStartsWithLetter = artistB.length > 0 && /^[a-z]/i.test(artistB[0])
-            
-            if (aStartsWithLetter !== bStartsWithLetter) {
-                return aStartsWithLetter ? -1 : 1  // Letters come before non-letters
-            }
-            
-            // First compare by album artist (case-insensitive, without "The " prefix)
-            var artistCompare = artistA.localeCompare(artistB)
-            if (artistCompare !== 0) {
-                return artistCompare
-            }
-            // If same artist, sort by year descending (newest first)
-            return b.year - a.year
-        })
-        
-        // Extract just the sorted indices
-        sortedAlbumIndices = indexedAlbums.map(function(item) { return item.index })
+    function keepSelectedAlbum() {
+        // Save current position before updating
+        var currentAlbumId = selectedAlbum ? selectedAlbum.id : -1
+        updateSortedIndices()
         
-        // Build the album ID to sorted index mapping for O(1) lookup
-        var idToIndex = {}
-        for (var i = 0; i < sortedAlbumIndices.length; i++) {
-            var albumIndex = sortedAlbumIndices[i]
-            var album = sourceAlbums[albumIndex]
-            if (album && album.id) {
-                idToIndex[album.id] = i
+        // Try to restore to the same album if it still exists
+        if (currentAlbumId > 0 && LibraryManager && LibraryManager.albums) {
+            var row = LibraryManager.albums.indexOfId(currentAlbumId)
+            if (row >= 0) {
+                jumpToAlbum(LibraryManager.albums.get(row), true)  // Jump instantly to maintain position during library changes
+                return
             }
         }
-        albumIdToSortedIndex = idToIndex
         
-        if (sortedAlbumIndices.length > 0 && currentIndex === -1) {
+        // If album was removed, try to restore saved position
+        restoreCarouselPosition()
+    }
+    
+    function updateSortedIndices() {
+        if (isDestroying || !sortedAlbums) return
+        
+        if (sortedAlbums.count > 0 && currentIndex === -1) {
             currentIndex = 0
-            selectedAlbum = sourceAlbums[sortedAlbumIndices[0]]
+            selectedAlbum = sortedAlbums.get(0)
         }
     }
     
+    Connections {
+        target: root.sortedAlbums
+        enabled: !isDestroying
+        function onLayoutChanged() { root.sortRevision++ }
+        function onModelReset() { root.sortRevision++ }
+        function onRowsInserted() { root.sortRevision++ }
+        function onRowsRemoved() { root.sortRevision++ }
+    }
+    
     function restoreCarouselPosition() {
         if (isDestroying || !LibraryManager) return
         
         var savedAlbumId = LibraryManager.loadCarouselPosition()
         if (savedAlbumId > 0) {
             // Find the album with this ID and jump to it
-            var sourceAlbums = (LibraryManager.albumModel) ? LibraryManager.albumModel : []
-            for (var i = 0; i < sourceAlbums.length; i++) {
-                if (sourceAlbums[i].id === savedAlbumId) {
-                    console.log("HorizontalAlbumBrowser: Restoring carousel position to album:", sourceAlbums[i].title)
-                    // During initialization, jump without animation
-                    jumpToAlbum(sourceAlbums[i], isInitializing)
-                    return
-                }
+            var row = LibraryManager.albums ? LibraryManager.albums.indexOfId(savedAlbumId) : -1
+            if (row >= 0) {
+                var savedAlbum = LibraryManager.albums.get(row)
+                console.log("HorizontalAlbumBrowser: Restoring carousel position to album:", savedAlbum.title)
+                // During initialization, jump without animation
+                jumpToAlbum(savedAlbum, isInitializing)
+                return
             }
             console.log("HorizontalAlbumBrowser: Saved album not found, defaulting to first album")
         }
@@ -471,14 +432,14 @@ Item {
             }
             
             // Use O(1) lookup to find the sorted index
-            var sortedIndex = albumIdToSortedIndex[album.id]
-            if (sortedIndex !== undefined && sortedIndex >= 0 && sortedIndex < sortedAlbumIndices.length) {
+            var sortedIndex = sortedAlbums ? sortedAlbums.rowOfId(album.id) : -1
+            if (sortedIndex >= 0 && sortedIndex < albumCount) {
                 // Get the actual album to ensure it still exists
-                var albumIndex = sortedAlbumIndices[sortedIndex]
+                var albumIndex = sortedAlbums.sourceRowAt(sortedIndex)
                 if (LibraryManager) {
-                    var sourceAlbums = (LibraryManager.albumModel) ? LibraryManager.albumModel : []
-                        if (albumIndex < sourceAlbums.length) {
-                        var currentAlbum = sourceAlbums[albumIndex]
+                    var sourceAlbums = LibraryManager.albums
+                        if (sourceAlbums && albumIndex < sourceAlbums.count) {
+                        var currentAlbum = sourceAlbums.get(albumIndex)
                         if (currentAlbum && currentAlbum.id === album.id) {
                             // Check if we're already at this index to avoid unnecessary repositioning
                             if (listView.currentIndex === sortedIndex) {
@@ -540,9 +501,9 @@ Item {
     
     // Get the maximum allowed contentX value
     function maxContentX() {
-        if (sortedAlbumIndices.length === 0) return 0
+        if (albumCount === 0) return 0
         // The maximum contentX is when the last item is centered
-        return contentXForIndex(sortedAlbumIndices.length - 1)
+        return contentXForIndex(albumCount - 1)
     }
     
     // Find the index of the album closest to the center
@@ -551,7 +512,7 @@ Item {
         var centerOffset = listView.width / 2 - 110
         var centerX = snapToPixel(listView.contentX) + centerOffset
         var index = Math.round(centerX / itemWidth)
-        return Math.max(0, Math.min(sortedAlbumIndices.length - 1, index))
+        return Math.max(0, Math.min(albumCount - 1, index))
     }
     
     Rectangle {
@@ -564,7 +525,7 @@ Item {
             anchors.fill: parent
             anchors.topMargin: 27      // change to slide the carousel up or down
             anchors.bottomMargin: 30    // Bottom margin for reflection and info bar
-            model: sortedAlbumIndices.length  // Use length for delegate count
+            model: albumCount  // Use count for delegate count
             orientation: ListView.Horizontal
             spacing: -165
             // Calculate highlight range with pixel snapping to match contentXForIndex
@@ -802,11 +763,10 @@ Item {
             }
                     
             onCurrentIndexChanged: {
-                if (!isDestroying && currentIndex >= 0 && currentIndex < sortedAlbumIndices.length) {
+                if (!isDestroying && currentIndex >= 0 && currentIndex < albumCount) {
                     root.currentIndex = currentIndex
-                    var albumIndex = sortedAlbumIndices[currentIndex]
-                    if (LibraryManager && LibraryManager.albumModel) {
-                        root.selectedAlbum = LibraryManager.albumModel[albumIndex]
+                    if (root.sortedAlbums) {
+                        root.selectedAlbum = root.sortedAlbums.get(currentIndex)
                     }
                     
                     // Clear stable position as we're moving to a new index
@@ -985,10 +945,13 @@ Item {
                 // Get the actual album data from the model using sorted index
                 property int sortedIndex: index
                 property int albumIndex: {
-                    if (sortedIndex < 0 || sortedIndex >= sortedAlbumIndices.length) return -1
-                    return sortedAlbumIndices[sortedIndex]
+                    root.sortRevision  // Re-evaluate when the sorted order changes
+                    if (sortedIndex < 0 || sortedIndex >= root.albumCount || !root.sortedAlbums) return -1
+                    return root.sortedAlbums.sourceRowAt(sortedIndex)
                 }
+                property int dataRevision: 0  // Bumped when this row's data changes in place
                 property var albumData: {
+                    dataRevision  // Re-evaluate when the row changes, e.g. its art arrives
                     if (root.isDestroying || albumIndex < 0 || !LibraryManager) {
                         return null
                     }
@@ -996,13 +959,26 @@ Item {
                     if (delegateItem === null || typeof delegateItem === "undefined") {
                         return null
                     }
-                    // Check if albumModel exists before accessing it
-                    var model = LibraryManager.albumModel
-                    if (!model || typeof model === "undefined") {
+                    // Check if the album list exists before accessing it
+                    var albums = LibraryManager.albums
+                    if (!albums) {
                         return null
                     }
-                    // Safe array access with bounds checking
-                    return albumIndex < model.length ? model[albumIndex] : null
+                    // Safe access with bounds checking
+                    return albumIndex < albums.count ? albums.get(albumIndex) : null
+                }
+                
+                // get() returns a copy, so watch for in-place updates of this row
+                Connections {
+                    id: albumDataConnection
+                    target: LibraryManager ? LibraryManager.albums : null
+                    enabled: !root.isDestroying && !delegateItem.ListView.isPooled
+                    
+                    function onDataChanged(topLeft, bottomRight) {
+                        if (delegateItem.albumIndex >= topLeft.row && delegateItem.albumIndex <= bottomRight.row) {
+                            delegateItem.dataRevision++
+                        }
+                    }
                 }
                 
                 // Handle delegate recycling with proper state reset
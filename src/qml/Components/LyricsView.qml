@@ -10,22 +10,67 @@ Item {
     property var lyricsModel: []
     property int currentLineIndex: -1
 
-    // Timer to avoid spamming index updates
+    readonly property bool synchronized: lyricsModel.length > 0 && lyricsModel[0].time >= 0
+    // Following the playback position line by line
+    readonly property bool tracking: synchronized && visible
+                                     && Window.visibility !== Window.Hidden && Window.visibility !== Window.Minimized
+                                     && MediaPlayer.state === MediaPlayer.PlayingState
+    property bool holdingPrecision: false
+
+    // Fires when the next line is due instead of polling the position
     Timer {
-        id: updateTimer
-        interval: 100 // Check 10 times per second
-        running: root.lyricsModel.length > 0 && lyricsModel[0].time >= 0 && MediaPlayer.state === MediaPlayer.PlayingState
-        repeat: true
-        onTriggered: root.updateCurrentLineIndex(MediaPlayer.position)
+        id: nextLineTimer
+        repeat: false
+        onTriggered: root.scheduleNextLine()
     }
 
-    // Handle position changes when paused (timer only runs when playing)
+    // Play, pause, seek and drift corrections all move the clock's reference point
     Connections {
-        target: MediaPlayer
-        function onPositionChanged() {
-            // Only update when timer is not running (i.e., when paused or stopped)
-            if (!updateTimer.running && root.lyricsModel.length > 0 && root.lyricsModel[0].time >= 0) {
-                root.updateCurrentLineIndex(MediaPlayer.position)
+        target: MediaPlayer.clock
+        function onChanged() {
+            root.scheduleNextLine()
+        }
+    }
+
+    onTrackingChanged: {
+        // Line changes are only as accurate as the clock, so ask for
+        // corrections from the pipeline while lyrics are being followed
+        if (tracking !== holdingPrecision) {
+            if (tracking) {
+                MediaPlayer.clock.requestPrecision()
+            } else {
+                MediaPlayer.clock.releasePrecision()
+            }
+            holdingPrecision = tracking
+        }
+        scheduleNextLine()
+    }
+
+    onLyricsModelChanged: scheduleNextLine()
+
+    Component.onDestruction: {
+        if (holdingPrecision) {
+            MediaPlayer.clock.releasePrecision()
+        }
+    }
+
+    function scheduleNextLine() {
+        nextLineTimer.stop()
+        if (!synchronized) {
+            return
+        }
+
+        var position = MediaPlayer.clock.position()
+        updateCurrentLineIndex(position)
+        if (!tracking || MediaPlayer.clock.rate <= 0) {
+            return
+        }
+
+        for (var i = 0; i < lyricsModel.length; i++) {
+            if (lyricsModel[i].time > position) {
+                nextLineTimer.interval = Math.max(1, Math.ceil((lyricsModel[i].time - position) / MediaPlayer.clock.rate))
+                nextLineTimer.start()
+                return
             }
         }
     }
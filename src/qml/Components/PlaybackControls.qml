@@ -393,11 +393,15 @@ Item {
                 // Debug property to track what's happening
                 property bool debugEnabled: false
                 
+                PlaybackPosition {
+                    id: playbackPosition
+                }
+
                 // Use Binding for cleaner logic
                 Binding {
                     target: progressSlider
                     property: "value"
-                    value: MediaPlayer.position
+                    value: playbackPosition.position
                     when: !progressSlider.isSeeking && MediaPlayer.savedPosition === 0
                 }
                 
@@ -457,35 +461,48 @@ Item {
                     }
                 }
                 
-                background: Rectangle {
+                background: Item {
                     x: progressSlider.leftPadding + progressSlider.handle.width / 2
                     y: progressSlider.topPadding + progressSlider.availableHeight / 2 - height / 2
                     implicitWidth: 200
                     implicitHeight: 10
                     width: progressSlider.availableWidth - progressSlider.handle.width
                     height: implicitHeight
-                    radius: 5
-                    gradient: Gradient {
-                        orientation: Gradient.Vertical
-                        GradientStop { position: 0.0; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.15) : Qt.rgba(0, 0, 0, 0.19) }
-                        GradientStop { position: 0.5; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.17) : Qt.rgba(0, 0, 0, 0.17) }
-                        GradientStop { position: 1.0; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.19) : Qt.rgba(0, 0, 0, 0.15) }
-                    }
-                    opacity: 0.8
                     
                     Rectangle {
-                        width: progressSlider.visualPosition * parent.width
-                        height: parent.height
+                        anchors.fill: parent
+                        visible: !progressSliderWaveform.ready
                         radius: 5
-                        opacity: 0.6
-                        
                         gradient: Gradient {
                             orientation: Gradient.Vertical
-                            GradientStop { position: 0.0; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.8) : Qt.rgba(0, 0, 0, 0.25) }
-                            GradientStop { position: 0.5; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.6) : Qt.rgba(0, 0, 0, 0.35) }
-                            GradientStop { position: 1.0; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.35) : Qt.rgba(0, 0, 0, 0.4) }
+                            GradientStop { position: 0.0; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.15) : Qt.rgba(0, 0, 0, 0.19) }
+                            GradientStop { position: 0.5; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.17) : Qt.rgba(0, 0, 0, 0.17) }
+                            GradientStop { position: 1.0; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.19) : Qt.rgba(0, 0, 0, 0.15) }
+                        }
+                        opacity: 0.8
+                        
+                        Rectangle {
+                            width: progressSlider.visualPosition * parent.width
+                            height: parent.height
+                            radius: 5
+                            opacity: 0.6
+                            
+                            gradient: Gradient {
+                                orientation: Gradient.Vertical
+                                GradientStop { position: 0.0; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.8) : Qt.rgba(0, 0, 0, 0.25) }
+                                GradientStop { position: 0.5; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.6) : Qt.rgba(0, 0, 0, 0.35) }
+                                GradientStop { position: 1.0; color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.35) : Qt.rgba(0, 0, 0, 0.4) }
+                            }
                         }
                     }
+                    
+                    SeekBarWaveform {
+                        id: progressSliderWaveform
+                        anchors.centerIn: parent
+                        width: parent.width
+                        height: 28
+                        progress: progressSlider.visualPosition
+                    }
                 }
                 
                 handle: Item {
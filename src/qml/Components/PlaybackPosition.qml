@@ -0,0 +1,51 @@
+import QtQuick
+import Mtoc.Backend 1.0
+
+// The current playback position, advanced locally from MediaPlayer.clock.
+// The clock only publishes a new reference point when playback starts, stops
+// or jumps; in between an animation moves the position along with the
+// window's frames. It is stopped while the window is hidden or minimized so a
+// backgrounded player does not tick at all.
+Item {
+    id: root
+    visible: false
+
+    // Set to false to stop interpolating, e.g. while the consumer is off screen
+    property bool active: Window.visibility !== Window.Hidden && Window.visibility !== Window.Minimized
+    property real position: 0
+
+    readonly property var clock: MediaPlayer.clock
+    readonly property real duration: MediaPlayer.duration
+
+    function resync() {
+        advance.stop()
+        if (!clock) {
+            return
+        }
+        position = clock.position()
+        if (active && clock.running && clock.rate > 0 && duration > position) {
+            advance.from = position
+            advance.to = duration
+            advance.duration = (duration - position) / clock.rate
+            advance.start()
+        }
+    }
+
+    NumberAnimation {
+        id: advance
+        target: root
+        property: "position"
+        easing.type: Easing.Linear
+    }
+
+    Connections {
+        target: root.clock
+        function onChanged() {
+            root.resync()
+        }
+    }
+
+    onActiveChanged: resync()
+    onDurationChanged: resync()
+    Component.onCompleted: resync()
+}
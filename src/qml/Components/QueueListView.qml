@@ -9,7 +9,7 @@ ListView {
     id: root
     focus: true
     
-    property var queueModel: []
+    property var queueModel: null
     property int currentPlayingIndex: -1
     property bool isProgrammaticScrolling: false
     property bool isRapidSkipping: false
@@ -768,7 +768,7 @@ ListView {
             
             // Track title
             Label {
-                text: modelData.title || "Unknown Track"
+                text: model.title || "Unknown Track"
                 color: root.forceLightText ? Theme.overlayPrimaryText : Theme.primaryText
                 font.pixelSize: 13
                 elide: Text.ElideRight
@@ -792,7 +792,7 @@ ListView {
             
             // Duration (fixed width)
             Label {
-                text: modelData.duration ? formatDuration(modelData.duration) : "0:00"
+                text: model.duration ? formatDuration(model.duration) : "0:00"
                 color: root.forceLightText ? Theme.overlaySecondaryText : Theme.secondaryText
                 font.pixelSize: 12
                 Layout.preferredWidth: 45
@@ -0,0 +1,11 @@
+import QtQuick
+import Mtoc.Backend 1.0
+
+// The current track's waveform for a seek bar background. `ready` stays false
+// until the waveform exists, so the flat bar can be shown in the meantime.
+Waveform {
+    service: WaveformService
+    filePath: MediaPlayer.currentTrack ? MediaPlayer.currentTrack.filePath : ""
+    color: Theme.isDark ? Qt.rgba(1, 1, 1, 0.25) : Qt.rgba(0, 0, 0, 0.2)
+    playedColor: Theme.isDark ? Qt.rgba(1, 1, 1, 0.75) : Qt.rgba(0, 0, 0, 0.55)
+}
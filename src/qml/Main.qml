@@ -284,7 +284,7 @@ ApplicationWindow {
                     QueuePopup {
                         id: queuePopup
                         parent: parent
-                        queueModel: MediaPlayer.queue
+                        queueModel: MediaPlayer.queueModel
                         currentPlayingIndex: MediaPlayer.currentQueueIndex
                         isOpen: compactNowPlayingBar.queuePopupVisible
                         onClosed: compactNowPlayingBar.queuePopupVisible = false
@@ -472,7 +472,6 @@ ApplicationWindow {
         }
     }
     
-    // Restore playback state when application is fully loaded
     Component.onCompleted: {
         //console.log("Main.qml: Window loaded");
 
@@ -486,15 +485,7 @@ ApplicationWindow {
             libraryPaneCompact.forceActiveFocus();
         }
 
-        // Wait for MediaPlayer to be ready before restoring state
-        if (MediaPlayer.isReady) {
-            console.log("Main.qml: MediaPlayer is ready, restoring playback state");
-            MediaPlayer.restoreState();
-        } else {
-            console.log("Main.qml: MediaPlayer not ready yet, waiting...");
-            // MediaPlayer will handle restoration when it becomes ready
-            MediaPlayer.restoreState();
-        }
+        // Playback state is restored from main.cpp once the first frame is shown
 
         // Check if we should show the changelog popup
         var lastSeenVersion = SettingsManager.lastSeenChangelogVersion;
@@ -27,7 +27,7 @@ Item {
         z: -2  // Above background but below content
         onClicked: {
             // Enable keyboard navigation when clicking on empty space
-            if (navigationMode === "none" && LibraryManager.artistModel.length > 0) {
+            if (navigationMode === "none" && LibraryManager.artists.count > 0) {
                 root.forceActiveFocus()
                 startArtistNavigation()
             }
@@ -62,12 +62,10 @@ Item {
     property int stableFrameCount: 0  // Count consecutive frames with stable height
     property url thumbnailUrl: ""
     property url pendingThumbnailUrl: ""  // Buffer for thumbnail URL changes
-    property var artistNameToIndex: ({})  // Cache for artist name to index mapping
     property var artistAlbumCache: ({})  // Cache for artist's albums: { "artistName": { "albumTitle": albumObject } }
     property var artistAlbumIndexCache: ({})  // Cache for album indices: { "artistName": { "albumTitle": index } }
     property var currentTrackIndexMap: ({})  // Map for current album's tracks: { "title|artist": index }
     property var currentTrackFilePathMap: ({})  // Map for current album's tracks by file path: { "filePath": index }
-    property var albumIdToIndexMap: ({})  // Map for all albums by ID: { albumId: index }
     property var collapsedArtistCleanupTimers: ({})  // Timers for cleaning up collapsed artist data
     property int cleanupDelayMs: 30000  // Clean up artist data 30 seconds after collapse
     property var expandCollapseDebounceTimer: null  // Debounce timer for expansion/collapse
@@ -271,7 +269,7 @@ Item {
         running: false
         repeat: false
         onTriggered: {
-            if (LibraryManager.artistModel.length > 0) {
+            if (LibraryManager.artists.count > 0) {
                 root.forceActiveFocus()
                 startArtistNavigation()
             }
@@ -419,11 +417,11 @@ Item {
     
     // Function to expand all artists
     function expandAllArtists() {
-        if (currentTab !== 0 || !LibraryManager.artistModel) return
+        if (currentTab !== 0 || !LibraryManager.artists) return
         
         var updatedExpanded = {}
-        for (var i = 0; i < LibraryManager.artistModel.length; i++) {
-            var artist = LibraryManager.artistModel[i]
+        for (var i = 0; i < LibraryManager.artists.count; i++) {
+            var artist = LibraryManager.artists.get(i)
             if (artist && artist.name) {
                 updatedExpanded[artist.name] = true
                 // Cancel any pending cleanup for this artist
@@ -533,9 +531,6 @@ Item {
             var encodedAlbum = encodeURIComponent(MediaPlayer.currentTrack.album)
             thumbnailUrl = "image://albumart/" + encodedArtist + "/" + encodedAlbum + "/thumbnail"
         }
-        // Build initial index mappings
-        updateArtistIndexMapping()
-        updateAlbumIdMapping()
         // Initialize track info panel as hidden
         trackInfoPanelY = 184  // Start off-screen
         // Don't auto-select any track - start with no selection
@@ -556,7 +551,7 @@ Item {
         }
         
         // Restore scroll position after a delay to ensure the view is ready
-        if (LibraryManager.artistModel && LibraryManager.artistModel.length > 0) {
+        if (LibraryManager.artists && LibraryManager.artists.count > 0) {
             Qt.callLater(restoreScrollPosition)
         }
         
@@ -580,8 +575,6 @@ Item {
     Connections {
         target: LibraryManager
         function onLibraryChanged() {
-            updateArtistIndexMapping()
-            updateAlbumIdMapping()
             // Clear caches when library changes
             searchResultsCache = {}
             albumDurationCache = {}
@@ -592,13 +585,35 @@ Item {
 
             // Restore scroll position if this is the initial library load
             // Check if we haven't restored yet and have artists
-            if (LibraryManager.artistModel && LibraryManager.artistModel.length > 0) {
+            if (LibraryManager.artists && LibraryManager.artists.count > 0) {
                 var savedPosition = SettingsManager.artistsScrollPosition
                 if (savedPosition > 0 && artistsListView && artistsListView.contentY === 0) {
                     Qt.callLater(restoreScrollPosition)
                 }
             }
         }
+        function onLibraryUpdated(changes) {
+            // Only drop cache entries for the albums and artists the change touched
+            var artistNames = changes.changedArtists.concat(changes.addedArtists, changes.removedArtists)
+            for (var i = 0; i < artistNames.length; i++) {
+                delete artistAlbumCache[artistNames[i]]
+                delete artistAlbumIndexCache[artistNames[i]]
+            }
+
+            var albumIds = changes.changedAlbums.concat(changes.removedAlbums)
+            for (var j = 0; j < albumIds.length; j++) {
+                delete albumDurationCache[albumIds[j]]
+            }
+            if (root.selectedAlbum && !root.selectedAlbum.isVirtualPlaylist &&
+                albumIds.indexOf(root.selectedAlbum.id) !== -1) {
+                currentTrackIndexMap = {}
+                currentTrackFilePathMap = {}
+            }
+
+            if (changes.addedTracks.length > 0 || changes.removedTracks.length > 0) {
+                searchResultsCache = {}
+            }
+        }
         function onFavoriteCountChanged() {
             // If Favorites playlist is currently displayed, reload immediately
             // Otherwise, lazy reload is already set via markNeedsReload() in C++
@@ -649,32 +664,10 @@ Item {
         }
     }
 
-    // Function to build artist name to index mapping for O(1) lookups
-    function updateArtistIndexMapping() {
-        //console.log("updateArtistIndexMapping called")
-        var mapping = {}
-        var artists = LibraryManager.artistModel
-        //console.log("updateArtistIndexMapping: Total artists:", artists.length)
-        for (var i = 0; i < artists.length; i++) {
-            if (artists[i] && artists[i].name) {
-                mapping[artists[i].name] = i
-            }
-        }
-        artistNameToIndex = mapping
-        // console.log("updateArtistIndexMapping: Mapping complete, sample entries:", 
-        //            Object.keys(mapping).slice(0, 3).map(function(k) { return k + ":" + mapping[k] }).join(", "))
-    }
-    
-    // Function to build album ID to index mapping for O(1) lookups
-    function updateAlbumIdMapping() {
-        var mapping = {}
-        var albums = LibraryManager.albumModel
-        for (var i = 0; i < albums.length; i++) {
-            if (albums[i] && albums[i].id !== undefined) {
-                mapping[albums[i].id] = i
-            }
-        }
-        albumIdToIndexMap = mapping
+    // O(1) artist lookup backed by the C++ list model; undefined when not found
+    function artistIndexOf(name, caseSensitive) {
+        var index = LibraryManager.artists.indexOfName(name, caseSensitive !== false)
+        return index >= 0 ? index : undefined
     }
 
     onSelectedAlbumChanged: {
@@ -1372,7 +1365,7 @@ Item {
                             if (currentSearchTerm.length > 0 && searchResults.bestMatch) {
                                 // Start navigation from search result
                                 setupNavigationFromSearch()
-                            } else if (LibraryManager.artistModel.length > 0) {
+                            } else if (LibraryManager.artists.count > 0) {
                                 // Start navigation from beginning if no search
                                 startArtistNavigation()
                             }
@@ -1455,7 +1448,7 @@ Item {
                                                     resetNavigation()
                                                     // Start artist navigation when switching to Artists tab
                                                     root.forceActiveFocus()
-                                                    if (LibraryManager.artistModel.length > 0) {
+                                                    if (LibraryManager.artists.count > 0) {
                                                         startArtistNavigation()
                                                     }
                                                 } else if (mouse.button === Qt.RightButton) {
@@ -1557,7 +1550,7 @@ Item {
                                 width: viewContainer.width
                                 height: parent.height
                                 clip: true
-                            model: LibraryManager.artistModel
+                            model: LibraryManager.artists
                             spacing: 2
                             interactive: !root.isScrollBarDragging  // Disable ListView interaction during scroll bar drag
                             reuseItems: false  // Disabled to maintain consistent scroll positions
@@ -1608,7 +1601,8 @@ Item {
                         height: artistHeader.height + (albumsVisible ? albumsContainer.height + 2 : 0)
                         
                         // Store modelData for easier access in nested views/functions
-                        property var artistData: modelData
+                        property var artistData: ({ id: model.artistId, name: model.name,
+                                                    albumCount: model.albumCount, trackCount: model.trackCount })
                         property bool albumsVisible: false
                         property bool isHighlighted: root.highlightedArtist === artistData.name
                         property bool isKeyboardFocused: root.selectedArtistIndex === index && root.navigationMode === "artist"
@@ -2969,6 +2963,13 @@ Item {
                         property real autoScrollActivationDistance: 30  // Min distance from start before auto-scroll activates
 
                         onContentYChanged: {
+                            // Pin the visible rows of virtual playlists so they are never evicted
+                            if (root.selectedAlbum && root.selectedAlbum.isVirtualPlaylist && model && model.setVisibleRange) {
+                                var firstVisible = indexAt(0, contentY)
+                                var lastVisible = indexAt(0, contentY + height - 1)
+                                model.setVisibleRange(firstVisible, lastVisible >= 0 ? lastVisible : firstVisible + 50)
+                            }
+
                             if (isDragging && draggedTrackIndex >= 0) {
                                 var delta = contentY - lastDragContentY
                                 lastDragContentY = contentY
@@ -4852,10 +4853,10 @@ Item {
             var albumId = parseInt(albumIdStr)
             if (isNaN(albumId)) return
             
-            // Use O(1) lookup from album ID map
-            var albumIndex = albumIdToIndexMap[albumId]
-            if (albumIndex !== undefined) {
-                var album = LibraryManager.albumModel[albumIndex]
+            // O(1) lookup in the album list model
+            var albumIndex = LibraryManager.albums.indexOfId(albumId)
+            if (albumIndex >= 0) {
+                var album = LibraryManager.albums.get(albumIndex)
                 if (!album) return
                 
                 // If it's a playlist, switch to playlist tab
@@ -5170,7 +5171,7 @@ Item {
     
     function scrollToArtist(artistName) {
         // Use O(1) lookup instead of O(n) search
-        var artistIndex = artistNameToIndex[artistName]
+        var artistIndex = artistIndexOf(artistName)
         if (artistIndex !== undefined) {
             scrollToArtistIndex(artistIndex, true)
         }
@@ -5179,7 +5180,7 @@ Item {
     // Helper function to calculate artist position manually
     function calculateArtistPosition(index) {
         console.log("calculateArtistPosition called for index:", index)
-        if (index < 0 || index >= LibraryManager.artistModel.length) return -1
+        if (index < 0 || index >= LibraryManager.artists.count) return -1
         
         var position = 0
         var minCellWidth = 130  // Same as in GridView
@@ -5189,7 +5190,7 @@ Item {
         console.log("calculateArtistPosition: Grid columns:", gridColumns)
         
         for (var i = 0; i < index; i++) {
-            var artist = LibraryManager.artistModel[i]
+            var artist = LibraryManager.artists.get(i)
             if (artist) {
                 position += 40 // Artist header height
                 var isExpanded = expandedArtists[artist.name] === true
@@ -5221,7 +5222,7 @@ Item {
     // Helper function to scroll to an artist index with optional smooth animation
     function scrollToArtistIndex(index, smooth) {
         //console.log("scrollToArtistIndex called with index:", index, "smooth:", smooth)
-        if (index < 0 || index >= LibraryManager.artistModel.length) {
+        if (index < 0 || index >= LibraryManager.artists.count) {
             console.log("scrollToArtistIndex: Invalid index")
             return
         }
@@ -5363,7 +5364,7 @@ Item {
     
     // Helper function to ensure artist is visible with smooth scrolling (for arrow key navigation)
     function ensureArtistVisible(index) {
-        if (!artistsListView || index < 0 || index >= LibraryManager.artistModel.length) return
+        if (!artistsListView || index < 0 || index >= LibraryManager.artists.count) return
         
         // First, ensure currentIndex is set
         if (artistsListView.currentIndex !== index) {
@@ -5393,7 +5394,7 @@ Item {
             
             // Adjust idealPos to ensure item is visible in viewport
             var itemHeight = 40  // Base height
-            var selectedArtist = LibraryManager.artistModel[index]
+            var selectedArtist = LibraryManager.artists.get(index)
             if (selectedArtist && expandedArtists[selectedArtist.name]) {
                 // Add expanded height
                 var albumCount = 0
@@ -5459,16 +5460,16 @@ Item {
     
     function startArtistNavigation() {
         resetNavigation()
-        if (LibraryManager.artistModel.length > 0) {
+        if (LibraryManager.artists.count > 0) {
             navigationMode = "artist"
             // If ListView already has a currentIndex, use that
-            if (artistsListView.currentIndex >= 0 && artistsListView.currentIndex < LibraryManager.artistModel.length) {
+            if (artistsListView.currentIndex >= 0 && artistsListView.currentIndex < LibraryManager.artists.count) {
                 selectedArtistIndex = artistsListView.currentIndex
-                selectedArtistName = LibraryManager.artistModel[selectedArtistIndex].name
+                selectedArtistName = LibraryManager.artists.nameAt(selectedArtistIndex)
             } else {
                 // Otherwise start at the beginning
                 selectedArtistIndex = 0
-                selectedArtistName = LibraryManager.artistModel[0].name
+                selectedArtistName = LibraryManager.artists.nameAt(0)
                 artistsListView.currentIndex = 0
                 artistsListView.forceLayout()
                 artistsListView.positionViewAtIndex(0, ListView.Beginning)
@@ -5480,7 +5481,7 @@ Item {
         resetNavigation()
         if (searchResults.bestMatch && searchResults.bestMatchType === "artist") {
             // Use O(1) lookup instead of O(n) linear search
-            var artistIndex = artistNameToIndex[searchResults.bestMatch.name]
+            var artistIndex = artistIndexOf(searchResults.bestMatch.name)
             if (artistIndex !== undefined) {
                 selectedArtistIndex = artistIndex
                 selectedArtistName = searchResults.bestMatch.name
@@ -5508,7 +5509,7 @@ Item {
             // Start with the album's artist expanded and album selected
             var artistName = searchResults.bestMatch.albumArtist
             // Use O(1) lookup instead of O(n) linear search
-            var artistIndex = artistNameToIndex[artistName]
+            var artistIndex = artistIndexOf(artistName)
             if (artistIndex !== undefined) {
                 selectedArtistIndex = artistIndex
                 selectedArtistName = artistName
@@ -5542,7 +5543,7 @@ Item {
             if (trackMatch.artist && trackMatch.album) {
                 var artistName = trackMatch.artist
                 // Use O(1) lookup instead of O(n) linear search
-                var artistIndex = artistNameToIndex[artistName]
+                var artistIndex = artistIndexOf(artistName)
                 if (artistIndex !== undefined) {
                     selectedArtistIndex = artistIndex
                     selectedArtistName = artistName
@@ -5593,9 +5594,9 @@ Item {
     
     function handleNavigationDown() {
         if (navigationMode === "artist") {
-            if (selectedArtistIndex < LibraryManager.artistModel.length - 1) {
+            if (selectedArtistIndex < LibraryManager.artists.count - 1) {
                 selectedArtistIndex++
-                selectedArtistName = LibraryManager.artistModel[selectedArtistIndex].name
+                selectedArtistName = LibraryManager.artists.nameAt(selectedArtistIndex)
                 artistsListView.currentIndex = selectedArtistIndex  // Sync with ListView
                 ensureArtistVisible(selectedArtistIndex)
             }
@@ -5620,10 +5621,10 @@ Item {
                 selectedAlbumData = albums[selectedAlbumIndex]
             } else {
                 // We're at the bottom of this artist's albums, move to next artist
-                if (selectedArtistIndex < LibraryManager.artistModel.length - 1) {
+                if (selectedArtistIndex < LibraryManager.artists.count - 1) {
                     navigationMode = "artist"
                     selectedArtistIndex++
-                    selectedArtistName = LibraryManager.artistModel[selectedArtistIndex].name
+                    selectedArtistName = LibraryManager.artists.nameAt(selectedArtistIndex)
                     artistsListView.currentIndex = selectedArtistIndex  // Sync with ListView
                     selectedAlbumIndex = -1
                     selectedAlbumData = null
@@ -5725,7 +5726,7 @@ Item {
         if (navigationMode === "artist") {
             if (selectedArtistIndex > 0) {
                 selectedArtistIndex--
-                selectedArtistName = LibraryManager.artistModel[selectedArtistIndex].name
+                selectedArtistName = LibraryManager.artists.nameAt(selectedArtistIndex)
                 artistsListView.currentIndex = selectedArtistIndex  // Sync with ListView
                 ensureArtistVisible(selectedArtistIndex)
             }
@@ -5751,7 +5752,7 @@ Item {
                 if (selectedArtistIndex > 0) {
                     navigationMode = "artist"
                     selectedArtistIndex--
-                    selectedArtistName = LibraryManager.artistModel[selectedArtistIndex].name
+                    selectedArtistName = LibraryManager.artists.nameAt(selectedArtistIndex)
                     artistsListView.currentIndex = selectedArtistIndex  // Sync with ListView
                     selectedAlbumIndex = -1
                     selectedAlbumData = null
@@ -5873,7 +5874,7 @@ Item {
             var artistIndex = undefined
 
             // Strategy 1: Try exact match first (handles artists with delimiters in their name like "Invent, Animate")
-            artistIndex = artistNameToIndex[primaryArtist]
+            artistIndex = artistIndexOf(primaryArtist)
             if (artistIndex !== undefined) {
                 console.log("jumpToArtist: Found exact match:", primaryArtist)
             } else {
@@ -5886,7 +5887,7 @@ Item {
                     if (primaryArtist.indexOf(delimiter) !== -1) {
                         var splitArtist = primaryArtist.split(delimiter)[0].trim()
                         console.log("jumpToArtist: Multi-artist detected with delimiter '" + delimiter + "', using primary artist:", splitArtist)
-                        artistIndex = artistNameToIndex[splitArtist]
+                        artistIndex = artistIndexOf(splitArtist)
                         if (artistIndex !== undefined) {
                             primaryArtist = splitArtist
                             console.log("jumpToArtist: Found match after splitting:", primaryArtist)
@@ -5899,14 +5900,10 @@ Item {
             // Strategy 3: Try case-insensitive search if still not found
             if (artistIndex === undefined) {
                 console.log("jumpToArtist: Exact match not found, trying case-insensitive search")
-                var lowerArtist = primaryArtist.toLowerCase()
-                for (var key in artistNameToIndex) {
-                    if (key.toLowerCase() === lowerArtist) {
-                        artistIndex = artistNameToIndex[key]
-                        primaryArtist = key  // Use the exact name from the index
-                        console.log("jumpToArtist: Found case-insensitive match:", key)
-                        break
-                    }
+                artistIndex = artistIndexOf(primaryArtist, false)
+                if (artistIndex !== undefined) {
+                    primaryArtist = LibraryManager.artists.nameAt(artistIndex)  // Use the exact name from the model
+                    console.log("jumpToArtist: Found case-insensitive match:", primaryArtist)
                 }
             }
 
@@ -6009,7 +6006,7 @@ Item {
             var artistIndex = undefined
 
             // Strategy 1: Try exact match first (handles artists with delimiters in their name like "Invent, Animate")
-            artistIndex = artistNameToIndex[primaryArtist]
+            artistIndex = artistIndexOf(primaryArtist)
             if (artistIndex === undefined) {
                 // Strategy 2: Try splitting by user-configured delimiters
                 var delimiters = SettingsManager.albumArtistDelimiters
@@ -6018,7 +6015,7 @@ Item {
                     if (primaryArtist.indexOf(delimiter) !== -1) {
                         var splitArtist = primaryArtist.split(delimiter)[0].trim()
                         console.log("jumpToAlbum: Multi-artist detected with delimiter '" + delimiter + "', using primary artist:", splitArtist)
-                        artistIndex = artistNameToIndex[splitArtist]
+                        artistIndex = artistIndexOf(splitArtist)
                         if (artistIndex !== undefined) {
                             primaryArtist = splitArtist
                             break
@@ -38,6 +38,11 @@ ApplicationWindow {
     
     visible: false
     title: SystemInfo.appName + " mini player"
+
+    // Stops advancing while the mini player is hidden
+    PlaybackPosition {
+        id: playbackPosition
+    }
     flags: Qt.Window | Qt.WindowStaysOnTopHint | Qt.FramelessWindowHint
     
     property string currentAlbumId: ""
@@ -367,7 +372,7 @@ ApplicationWindow {
                     Binding {
                         target: progressSliderVertical
                         property: "value"
-                        value: MediaPlayer.position
+                        value: playbackPosition.position
                         when: !progressSliderVertical.isSeeking
                     }
                     
@@ -432,6 +437,7 @@ ApplicationWindow {
                         // Visual track (smaller than hit area)
                         Rectangle {
                             anchors.centerIn: parent
+                            visible: !progressSliderVerticalWaveform.ready
                             width: parent.width
                             height: 3  // Visual height is smaller
                             radius: 1.5
@@ -444,6 +450,16 @@ ApplicationWindow {
                                 color: Qt.rgba(1, 1, 1, 0.7)  // Semi-transparent white progress bar
                             }
                         }
+                        
+                        SeekBarWaveform {
+                            id: progressSliderVerticalWaveform
+                            anchors.centerIn: parent
+                            width: parent.width
+                            height: 14
+                            progress: progressSliderVertical.visualPosition
+                            color: Qt.rgba(1, 1, 1, 0.2)
+                            playedColor: Qt.rgba(1, 1, 1, 0.7)
+                        }
                     }
                     
                     handle: Rectangle {
@@ -466,7 +482,7 @@ ApplicationWindow {
                     Layout.topMargin: 2  // Small additional margin for visual balance
                     
                     Label {
-                        text: formatTime(MediaPlayer.position)
+                        text: formatTime(playbackPosition.position)
                         font.pixelSize: 10
                         color: Theme.tertiaryText
                     }
@@ -644,7 +660,7 @@ ApplicationWindow {
                         Binding {
                             target: progressSliderHorizontal
                             property: "value"
-                            value: MediaPlayer.position
+                            value: playbackPosition.position
                             when: !progressSliderHorizontal.isSeeking
                         }
                         
@@ -709,6 +725,7 @@ ApplicationWindow {
                             // Visual track (smaller than hit area)
                             Rectangle {
                                 anchors.centerIn: parent
+                                visible: !progressSliderHorizontalWaveform.ready
                                 width: parent.width
                                 height: 3  // Visual height is smaller
                                 radius: 1.5
@@ -721,6 +738,16 @@ ApplicationWindow {
                                     color: Qt.rgba(1, 1, 1, 0.7)  // Semi-transparent white progress bar
                                 }
                             }
+                            
+                            SeekBarWaveform {
+                                id: progressSliderHorizontalWaveform
+                                anchors.centerIn: parent
+                                width: parent.width
+                                height: 14
+                                progress: progressSliderHorizontal.visualPosition
+                                color: Qt.rgba(1, 1, 1, 0.2)
+                                playedColor: Qt.rgba(1, 1, 1, 0.7)
+                            }
                         }
                         
                         handle: Rectangle {
@@ -743,7 +770,7 @@ ApplicationWindow {
                         Layout.topMargin: 2  // Small additional margin for visual balance
                         
                         Label {
-                            text: formatTime(MediaPlayer.position)
+                            text: formatTime(playbackPosition.position)
                             font.pixelSize: 10
                             color: Theme.tertiaryText
                         }
@@ -873,7 +900,7 @@ ApplicationWindow {
                     spacing: 6
                     
                     Label {
-                        text: formatTime(MediaPlayer.position)
+                        text: formatTime(playbackPosition.position)
                         font.pixelSize: 9
                         color: Theme.tertiaryText
                     }
@@ -894,7 +921,7 @@ ApplicationWindow {
                         Binding {
                             target: progressSliderCompact
                             property: "value"
-                            value: MediaPlayer.position
+                            value: playbackPosition.position
                             when: !progressSliderCompact.isSeeking
                         }
                         
@@ -952,6 +979,7 @@ ApplicationWindow {
                             
                             Rectangle {
                                 anchors.centerIn: parent
+                                visible: !progressSliderCompactWaveform.ready
                                 width: parent.width
                                 height: 2
                                 radius: 1
@@ -964,6 +992,16 @@ ApplicationWindow {
                                     color: Qt.rgba(1, 1, 1, 0.7)
                                 }
                             }
+                            
+                            SeekBarWaveform {
+                                id: progressSliderCompactWaveform
+                                anchors.centerIn: parent
+                                width: parent.width
+                                height: 10
+                                progress: progressSliderCompact.visualPosition
+                                color: Qt.rgba(1, 1, 1, 0.2)
+                                playedColor: Qt.rgba(1, 1, 1, 0.7)
+                            }
                         }
                         
                         handle: Rectangle {
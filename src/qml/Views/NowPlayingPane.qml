@@ -59,11 +59,20 @@ Item {
         }
     }
 
-    // Keyboard shortcut for undo
+    // Keyboard shortcuts for queue undo/redo
     Keys.onPressed: function(event) {
-        if ((event.modifiers & Qt.ControlModifier) && event.key === Qt.Key_Z) {
-            if (MediaPlayer.canUndoClear) {
-                MediaPlayer.undoClearQueue()
+        if (!(event.modifiers & Qt.ControlModifier)) {
+            return
+        }
+        var redo = event.key === Qt.Key_Y || (event.key === Qt.Key_Z && (event.modifiers & Qt.ShiftModifier))
+        if (redo) {
+            if (MediaPlayer.canRedoQueueChange) {
+                MediaPlayer.redoQueueChange()
+                event.accepted = true
+            }
+        } else if (event.key === Qt.Key_Z) {
+            if (MediaPlayer.canUndoQueueChange) {
+                MediaPlayer.undoQueueChange()
                 event.accepted = true
             }
         }
@@ -130,12 +139,12 @@ Item {
         }
         
         // Then, go through the queue starting from current position to find upcoming unique albums
-        var queue = MediaPlayer.queue
+        var queue = MediaPlayer.queueModel
         var startIndex = Math.max(0, MediaPlayer.currentQueueIndex)
         
         // Look for unique albums from current position onwards
-        for (var i = startIndex; i < queue.length && covers.length < 3; i++) {
-            var track = queue[i]
+        for (var i = startIndex; i < queue.count && covers.length < 3; i++) {
+            var track = queue.get(i)
             if (track.albumArtist && track.album) {
                 var albumKey = track.albumArtist + "||" + track.album
                 if (!seenAlbums.has(albumKey)) {
@@ -605,7 +614,7 @@ Item {
                                 id: queueListView
                                 Layout.fillWidth: true
                                 Layout.fillHeight: true
-                                queueModel: MediaPlayer.queue
+                                queueModel: MediaPlayer.queueModel
                                 currentPlayingIndex: MediaPlayer.currentQueueIndex
                                 focus: root.queueVisible
                                 forceLightText: true // Always use light text on dark background
@@ -984,6 +984,98 @@ ApplicationWindow {
                         }
                     }
                     
+                    // Seek bar waveforms for the whole library
+                    RowLayout {
+                        Layout.fillWidth: true
+                        Layout.topMargin: 8
+                        spacing: 12
+                        
+                        Item { Layout.preferredWidth: 130 } // Align with label column
+                        
+                        Button {
+                            id: generateWaveformsButton
+                            text: WaveformService.generating ? "Cancel Waveforms" : "Generate Waveforms"
+                            Layout.preferredWidth: 150
+                            Layout.preferredHeight: 36
+                            enabled: WaveformService.generating || !LibraryManager.scanning
+                            
+                            onClicked: {
+                                if (WaveformService.generating) {
+                                    WaveformService.cancelGeneration()
+                                } else {
+                                    WaveformService.generateLibrary()
+                                }
+                            }
+                            
+                            background: Rectangle {
+                                color: parent.enabled ? (parent.hovered ? Theme.selectedBackground : Theme.inputBackground) : Theme.disabledBackground
+                                radius: 4
+                                border.width: 1
+                                border.color: parent.enabled ? Theme.borderColor : Theme.disabledBorderColor
+                            }
+                            
+                            contentItem: Text {
+                                text: parent.text
+                                color: parent.enabled ? Theme.primaryText : Theme.disabledText
+                                font.pixelSize: 14
+                                horizontalAlignment: Text.AlignHCenter
+                                verticalAlignment: Text.AlignVCenter
+                            }
+                        }
+                        
+                        // Progress section for generating waveforms
+                        ColumnLayout {
+                            Layout.fillWidth: true
+                            Layout.maximumWidth: 250
+                            spacing: 4
+                            visible: WaveformService.generating
+                            
+                            ProgressBar {
+                                Layout.fillWidth: true
+                                Layout.preferredHeight: 6
+                                value: WaveformService.progress / 100.0
+                                from: 0
+                                to: 1
+                                
+                                background: Rectangle {
+                                    color: Theme.inputBackground
+                                    radius: 3
+                                    border.color: Theme.borderColor
+                                    border.width: 1
+                                }
+                                
+                                contentItem: Item {
+                                    Rectangle {
+                                        width: parent.width * parent.parent.value
+                                        height: parent.height
+                                        radius: 3
+                                        color: Theme.linkColor
+                                        
+                                        Behavior on width {
+                                            NumberAnimation {
+                                                duration: 200
+                                                easing.type: Easing.OutCubic
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                            
+                            Label {
+                                Layout.fillWidth: true
+                                text: WaveformService.progressText
+                                font.pixelSize: 11
+                                color: Theme.secondaryText
+                                horizontalAlignment: Text.AlignHCenter
+                            }
+                        }
+                        
+                        Item { 
+                            Layout.fillWidth: true
+                            visible: !WaveformService.generating
+                        }
+                    }
+                    
                     CheckBox {
                         id: showTrackInfoCheck
                         text: "Show track info panel by default"
@@ -2212,6 +2304,401 @@ ApplicationWindow {
                             }
                         }
                     }
+                    
+                    // Loudness analysis for tracks without replay gain tags
+                    RowLayout {
+                        Layout.fillWidth: true
+                        Layout.topMargin: 8
+                        spacing: 12
+                        visible: replayGainEnabledCheck.checked
+                        
+                        Button {
+                            id: analyseLoudnessButton
+                            text: LoudnessAnalyzer.running ? "Cancel Analysis" : "Analyse Loudness"
+                            Layout.preferredWidth: 150
+                            Layout.preferredHeight: 36
+                            enabled: LoudnessAnalyzer.running || !LibraryManager.scanning
+                            
+                            onClicked: {
+                                if (LoudnessAnalyzer.running) {
+                                    LoudnessAnalyzer.cancel()
+                                } else {
+                                    LoudnessAnalyzer.start()
+                                }
+                            }
+                            
+                            background: Rectangle {
+                                color: parent.enabled ? (parent.hovered ? Theme.selectedBackground : Theme.inputBackground) : Theme.disabledBackground
+                                radius: 4
+                                border.width: 1
+                                border.color: parent.enabled ? Theme.borderColor : Theme.disabledBorderColor
+                            }
+                            
+                            contentItem: Text {
+                                text: parent.text
+                                color: parent.enabled ? Theme.primaryText : Theme.disabledText
+                                font.pixelSize: 14
+                                horizontalAlignment: Text.AlignHCenter
+                                verticalAlignment: Text.AlignVCenter
+                            }
+                        }
+                        
+                        // Progress section for loudness analysis
+                        ColumnLayout {
+                            Layout.fillWidth: true
+                            Layout.maximumWidth: 250
+                            spacing: 4
+                            visible: LoudnessAnalyzer.running
+                            
+                            ProgressBar {
+                                Layout.fillWidth: true
+                                Layout.preferredHeight: 6
+                                value: LoudnessAnalyzer.progress / 100.0
+                                from: 0
+                                to: 1
+                                
+                                background: Rectangle {
+                                    color: Theme.inputBackground
+                                    radius: 3
+                                    border.color: Theme.borderColor
+                                    border.width: 1
+                                }
+                                
+                                contentItem: Item {
+                                    Rectangle {
+                                        width: parent.width * parent.parent.value
+                                        height: parent.height
+                                        radius: 3
+                                        color: Theme.linkColor
+                                        
+                                        Behavior on width {
+                                            NumberAnimation {
+                                                duration: 200
+                                                easing.type: Easing.OutCubic
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                            
+                            Label {
+                                Layout.fillWidth: true
+                                text: LoudnessAnalyzer.progressText
+                                font.pixelSize: 11
+                                color: Theme.secondaryText
+                                horizontalAlignment: Text.AlignHCenter
+                            }
+                        }
+                        
+                        Item { 
+                            Layout.fillWidth: true
+                            visible: !LoudnessAnalyzer.running
+                        }
+                    }
+                    
+                    // Separator line
+                    Rectangle {
+                        Layout.fillWidth: true
+                        Layout.preferredHeight: 1
+                        color: Theme.borderColor
+                        opacity: 0.3
+                    }
+                    
+                    RowLayout {
+                        Layout.fillWidth: true
+                        spacing: 8
+                        
+                        Label {
+                            text: "Equalizer"
+                            font.pixelSize: 14
+                            font.bold: true
+                            color: Theme.primaryText
+                        }
+                        
+                        Image {
+                            source: Theme.isDark ? "qrc:/resources/icons/info.svg" : "qrc:/resources/icons/info-dark.svg"
+                            Layout.preferredWidth: 16
+                            Layout.preferredHeight: 16
+                            sourceSize.width: 16
+                            sourceSize.height: 16
+                            
+                            MouseArea {
+                                anchors.centerIn: parent
+                                width: 24
+                                height: 24
+                                hoverEnabled: true
+                                
+                                ToolTip {
+                                    id: equalizerTooltip
+                                    visible: parent.containsMouse
+                                    text: "Ten-band equalizer, remembered separately for each output device\nTurning it on or off takes effect from the next track"
+                                    delay: 200
+                                    timeout: 5000
+                                    background: Rectangle {
+                                        color: Theme.isDark ? "#2b2b2b" : "#f0f0f0"
+                                        border.color: Theme.borderColor
+                                        radius: 4
+                                    }
+                                    contentItem: Text {
+                                        text: equalizerTooltip.text
+                                        font.pixelSize: 12
+                                        color: Theme.primaryText
+                                    }
+                                }
+                            }
+                        }
+                        
+                        Item { Layout.fillWidth: true }
+                    }
+                    
+                    CheckBox {
+                        id: equalizerEnabledCheck
+                        text: "Enable Equalizer"
+                        checked: SettingsManager.equalizerEnabled
+                        
+                        onToggled: {
+                            SettingsManager.equalizerEnabled = checked
+                        }
+                        
+                        contentItem: Text {
+                            text: parent.text
+                            font.pixelSize: 14
+                            color: Theme.secondaryText
+                            verticalAlignment: Text.AlignVCenter
+                            leftPadding: parent.indicator.width + parent.spacing
+                        }
+                        
+                        indicator: Rectangle {
+                            implicitWidth: 20
+                            implicitHeight: 20
+                            x: parent.leftPadding
+                            y: parent.height / 2 - height / 2
+                            radius: 3
+                            color: parent.checked ? Theme.selectedBackground : Theme.inputBackground
+                            border.color: parent.checked ? Theme.linkColor : Theme.borderColor
+                            
+                            Canvas {
+                                anchors.fill: parent
+                                anchors.margins: 4
+                                visible: parent.parent.checked
+                                
+                                onPaint: {
+                                    var ctx = getContext("2d")
+                                    ctx.reset()
+                                    ctx.strokeStyle = "white"
+                                    ctx.lineWidth = 2
+                                    ctx.lineCap = "round"
+                                    ctx.lineJoin = "round"
+                                    ctx.beginPath()
+                                    ctx.moveTo(width * 0.2, height * 0.5)
+                                    ctx.lineTo(width * 0.45, height * 0.75)
+                                    ctx.lineTo(width * 0.8, height * 0.25)
+                                    ctx.stroke()
+                                }
+                            }
+                        }
+                    }
+                    
+                    // Output device and preset (only visible when enabled)
+                    RowLayout {
+                        Layout.fillWidth: true
+                        spacing: 12
+                        visible: equalizerEnabledCheck.checked
+                        
+                        Label {
+                            text: "Preset:"
+                            font.pixelSize: 14
+                            color: Theme.secondaryText
+                            Layout.preferredWidth: 130
+                        }
+                        
+                        ComboBox {
+                            id: equalizerPresetCombo
+                            Layout.preferredWidth: 150
+                            Layout.preferredHeight: 36
+                            model: SettingsManager.equalizerPresets
+                            currentIndex: model.indexOf(SettingsManager.equalizerPreset)
+                            
+                            onActivated: function(index) {
+                                SettingsManager.applyEqualizerPreset(model[index])
+                            }
+                            
+                            background: Rectangle {
+                                color: parent.hovered ? Theme.inputBackgroundHover : Theme.inputBackground
+                                radius: 4
+                                border.width: 1
+                                border.color: Theme.borderColor
+                            }
+                            
+                            contentItem: Text {
+                                text: parent.displayText
+                                color: Theme.primaryText
+                                font.pixelSize: 14
+                                verticalAlignment: Text.AlignVCenter
+                                leftPadding: 8
+                                rightPadding: 30
+                            }
+                            
+                            indicator: Canvas {
+                                x: parent.width - width - 8
+                                y: parent.height / 2 - height / 2
+                                width: 12
+                                height: 8
+                                contextType: "2d"
+                                
+                                onPaint: {
+                                    var ctx = getContext("2d")
+                                    ctx.reset()
+                                    ctx.moveTo(0, 0)
+                                    ctx.lineTo(width, 0)
+                                    ctx.lineTo(width / 2, height)
+                                    ctx.closePath()
+                                    ctx.fillStyle = "#cccccc"
+                                    ctx.fill()
+                                }
+                            }
+                            
+                            popup: Popup {
+                                y: parent.height + 2
+                                width: parent.width
+                                implicitHeight: contentItem.implicitHeight + 2
+                                padding: 1
+                                
+                                contentItem: ListView {
+                                    clip: true
+                                    implicitHeight: contentHeight
+                                    model: equalizerPresetCombo.popup.visible ? equalizerPresetCombo.model : null
+                                    currentIndex: equalizerPresetCombo.highlightedIndex
+                                    
+                                    delegate: ItemDelegate {
+                                        width: equalizerPresetCombo.width
+                                        height: 36
+                                        
+                                        contentItem: Text {
+                                            text: modelData
+                                            color: parent.hovered ? Theme.primaryText : Theme.secondaryText
+                                            font.pixelSize: 14
+                                            verticalAlignment: Text.AlignVCenter
+                                            leftPadding: 8
+                                        }
+                                        
+                                        background: Rectangle {
+                                            color: parent.hovered ? Theme.selectedBackground : "transparent"
+                                            radius: 2
+                                        }
+                                        
+                                        onClicked: {
+                                            equalizerPresetCombo.currentIndex = index
+                                            equalizerPresetCombo.activated(index)
+                                            equalizerPresetCombo.popup.close()
+                                        }
+                                    }
+                                    
+                                    ScrollIndicator.vertical: ScrollIndicator { }
+                                }
+                                
+                                background: Rectangle {
+                                    color: Theme.backgroundColor
+                                    border.color: Theme.borderColor
+                                    border.width: 1
+                                    radius: 4
+                                }
+                            }
+                        }
+                        
+                        Label {
+                            text: SettingsManager.outputDeviceName
+                            font.pixelSize: 12
+                            color: Theme.secondaryText
+                            elide: Text.ElideRight
+                            Layout.fillWidth: true
+                        }
+                    }
+                    
+                    // Band sliders, -12 to +12 dB
+                    RowLayout {
+                        Layout.fillWidth: true
+                        Layout.topMargin: 4
+                        spacing: 4
+                        visible: equalizerEnabledCheck.checked
+                        
+                        Repeater {
+                            model: ["31", "62", "125", "250", "500", "1k", "2k", "4k", "8k", "16k"]
+                            
+                            ColumnLayout {
+                                Layout.fillWidth: true
+                                spacing: 2
+                                
+                                Label {
+                                    text: {
+                                        var gain = SettingsManager.equalizerGains[index]
+                                        return (gain > 0 ? "+" : "") + gain.toFixed(1)
+                                    }
+                                    font.pixelSize: 11
+                                    color: Theme.secondaryText
+                                    Layout.alignment: Qt.AlignHCenter
+                                }
+                                
+                                Slider {
+                                    id: bandSlider
+                                    orientation: Qt.Vertical
+                                    Layout.alignment: Qt.AlignHCenter
+                                    Layout.preferredHeight: 120
+                                    Layout.preferredWidth: 28
+                                    from: -12.0
+                                    to: 12.0
+                                    stepSize: 0.5
+                                    value: SettingsManager.equalizerGains[index]
+                                    
+                                    onMoved: {
+                                        SettingsManager.setEqualizerBandGain(index, value)
+                                    }
+                                    
+                                    background: Rectangle {
+                                        x: bandSlider.leftPadding + bandSlider.availableWidth / 2 - width / 2
+                                        y: bandSlider.topPadding
+                                        implicitWidth: 4
+                                        implicitHeight: 120
+                                        width: implicitWidth
+                                        height: bandSlider.availableHeight
+                                        radius: 2
+                                        color: Theme.inputBackground
+                                        
+                                        // Filled from the 0 dB line towards the handle
+                                        Rectangle {
+                                            width: parent.width
+                                            y: Math.min(bandSlider.visualPosition, 0.5) * parent.height
+                                            height: Math.abs(bandSlider.visualPosition - 0.5) * parent.height
+                                            color: Theme.linkColor
+                                            radius: 2
+                                        }
+                                    }
+                                    
+                                    handle: Item {
+                                        x: bandSlider.leftPadding + bandSlider.availableWidth / 2 - width / 2
+                                        y: bandSlider.topPadding + bandSlider.visualPosition * bandSlider.availableHeight - height / 2
+                                        implicitWidth: 20
+                                        implicitHeight: 20
+                                        
+                                        Rectangle {
+                                            anchors.centerIn: parent
+                                            width: 14
+                                            height: 14
+                                            radius: 7
+                                            color: bandSlider.pressed ? Theme.selectedBackground : Theme.linkColor
+                                        }
+                                    }
+                                }
+                                
+                                Label {
+                                    text: modelData
+                                    font.pixelSize: 11
+                                    color: Theme.secondaryText
+                                    Layout.alignment: Qt.AlignHCenter
+                                }
+                            }
+                        }
+                    }
                 }
             }
             
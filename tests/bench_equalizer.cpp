@@ -0,0 +1,109 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "backend/utility/parametricequalizer.h"
+
+using namespace Mtoc;
+
+// ParametricEqualizer cost per frame, as the equalizer probe pays it: one
+// 1024-frame buffer at a time, each a fresh copy of the input. The flat row
+// is the idle bypass; the ramping row moves the bands on every buffer so the
+// coefficients never settle.
+
+namespace {
+
+const int BUFFER_FRAMES = 1024;
+
+struct Case {
+    const char *name;
+    int activeBands;
+    bool ramping;
+};
+
+double nsPerFrame(const Case &test, int sampleRate, int channels, int buffers)
+{
+    QVector<double> gains(ParametricEqualizer::GRAPHIC_BANDS, 0.0);
+    for (int i = 0; i < test.activeBands; ++i) {
+        gains[i] = i % 2 ? -3.0 : 4.0;
+    }
+
+    ParametricEqualizer equalizer;
+    equalizer.setFormat(sampleRate, channels);
+    equalizer.setBands(ParametricEqualizer::graphicBands(gains));
+    equalizer.isActive();
+
+    // Music-like level, well clear of denormals
+    std::vector<float> input(size_t(BUFFER_FRAMES) * channels);
+    for (int frame = 0; frame < BUFFER_FRAMES; ++frame) {
+        for (int channel = 0; channel < channels; ++channel) {
+            input[size_t(frame) * channels + channel] = 0.3f * std::sin(0.01f * frame + channel);
+        }
+    }
+    std::vector<float> work(input.size());
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int buffer = 0; buffer < buffers; ++buffer) {
+        if (test.ramping) {
+            gains[0] = buffer % 2 ? 6.0 : -6.0;
+            equalizer.setBands(ParametricEqualizer::graphicBands(gains));
+        }
+        std::copy(input.begin(), input.end(), work.begin());
+        if (equalizer.isActive()) {
+            equalizer.process(work.data(), BUFFER_FRAMES);
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    // Keeps the output alive so the loop can't be optimised away
+    volatile float sink = work[0];
+    Q_UNUSED(sink)
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / (double(buffers) * BUFFER_FRAMES);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Equalizer cost in ns per frame");
+    parser.addHelpOption();
+    QCommandLineOption buffersOption("buffers", "Buffers per case (default 20000).", "count", "20000");
+    parser.addOption(buffersOption);
+    parser.process(app);
+    const int buffers = qMax(1, parser.value(buffersOption).toInt());
+
+    const Case cases[] = {
+        {"flat", 0, false},
+        {"3 bands", 3, false},
+        {"10 bands", 10, false},
+        {"ramping", 10, true},
+    };
+    const struct {
+        int sampleRate;
+        int channels;
+    } formats[] = {
+        {44100, 2},
+        {48000, 6},
+    };
+
+    std::printf("%d buffers of %d frames per case\n", buffers, BUFFER_FRAMES);
+    std::printf("%-10s %-12s %10s %14s\n", "case", "format", "ns/frame", "% of a core");
+    for (const auto &format : formats) {
+        for (const Case &test : cases) {
+            const double ns = nsPerFrame(test, format.sampleRate, format.channels, buffers);
+            const QByteArray name = QString("%1 Hz %2ch").arg(format.sampleRate).arg(format.channels).toUtf8();
+            // The share of one core needed to keep up in real time
+            std::printf("%-10s %-12s %10.2f %13.4f%%\n", test.name, name.constData(), ns,
+                        ns * format.sampleRate / 1e9 * 100.0);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,342 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QRandomGenerator>
+#include <QRegularExpression>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <QVariantList>
+#include <QVector>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+
+#include "backend/library/librarysnapshot.h"
+
+using namespace Mtoc;
+
+// The hot library lookups served from LibrarySnapshot against the SQL queries
+// DatabaseManager ran for them before the snapshot existed. The database is a
+// generated library in a temporary file with the tables, indexes and
+// album_summary rows the app has, so the SQL side pays for the same plans.
+// Both sides look up the same random keys; the SQL side prepares each query
+// per call, as DatabaseManager does.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int TRACKS_PER_ALBUM = 12;
+const int ALBUMS_PER_ARTIST = 8;
+
+struct Library {
+    QStringList paths;
+    QStringList albumArtists;  // Per album
+    QStringList albumTitles;   // Per album
+};
+
+QString trackPath(int album, int track)
+{
+    return QString("/home/user/Music/Artist %1/Album %2/%3 - Track %3.flac")
+        .arg(album / ALBUMS_PER_ARTIST).arg(album).arg(track + 1, 2, 10, QChar('0'));
+}
+
+bool exec(QSqlQuery &query, const QString &sql)
+{
+    if (!query.exec(sql)) {
+        std::fprintf(stderr, "%s\n%s\n", qPrintable(sql), qPrintable(query.lastError().text()));
+        return false;
+    }
+    return true;
+}
+
+bool createLibrary(QSqlDatabase &db, int albums, Library &library)
+{
+    QSqlQuery query(db);
+    const char *const schema[] = {
+        "CREATE TABLE artists (id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT NOT NULL UNIQUE)",
+        "CREATE TABLE album_artists (id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT NOT NULL UNIQUE)",
+        "CREATE TABLE albums (id INTEGER PRIMARY KEY AUTOINCREMENT, title TEXT NOT NULL, "
+        "album_artist_id INTEGER, year INTEGER, UNIQUE(title, album_artist_id))",
+        "CREATE TABLE tracks (id INTEGER PRIMARY KEY AUTOINCREMENT, file_path TEXT NOT NULL UNIQUE, "
+        "title TEXT, artist_id INTEGER, album_id INTEGER, genre TEXT, year INTEGER, "
+        "track_number INTEGER, disc_number INTEGER, duration INTEGER)",
+        "CREATE TABLE album_art (id INTEGER PRIMARY KEY AUTOINCREMENT, album_id INTEGER NOT NULL UNIQUE, "
+        "full_path TEXT, thumbnail BLOB)",
+        "CREATE TABLE album_album_artists (album_id INTEGER NOT NULL, album_artist_id INTEGER NOT NULL, "
+        "position INTEGER NOT NULL, PRIMARY KEY (album_id, album_artist_id))",
+        "CREATE TABLE album_summary (album_id INTEGER PRIMARY KEY, title TEXT NOT NULL, "
+        "album_artist_name TEXT, year INTEGER, track_count INTEGER NOT NULL DEFAULT 0, "
+        "total_duration INTEGER NOT NULL DEFAULT 0, has_art INTEGER NOT NULL DEFAULT 0)",
+        "CREATE INDEX idx_album_album_artists_album ON album_album_artists(album_id)",
+        "CREATE INDEX idx_album_album_artists_artist ON album_album_artists(album_artist_id)",
+        "CREATE INDEX idx_tracks_artist ON tracks(artist_id)",
+        "CREATE INDEX idx_tracks_album ON tracks(album_id)",
+        "CREATE INDEX idx_albums_artist ON albums(album_artist_id)",
+        "CREATE INDEX idx_albums_title ON albums(title)",
+        "CREATE INDEX idx_album_artists_name ON album_artists(name)",
+    };
+    for (const char *sql : schema) {
+        if (!exec(query, sql)) {
+            return false;
+        }
+    }
+
+    db.transaction();
+    const int artists = (albums + ALBUMS_PER_ARTIST - 1) / ALBUMS_PER_ARTIST;
+    query.prepare("INSERT INTO album_artists (id, name) VALUES (?, ?)");
+    for (int artist = 0; artist < artists; ++artist) {
+        query.addBindValue(artist + 1);
+        query.addBindValue(QString("Artist %1").arg(artist));
+        query.exec();
+    }
+    query.prepare("INSERT INTO artists (id, name) VALUES (?, ?)");
+    for (int artist = 0; artist < artists; ++artist) {
+        query.addBindValue(artist + 1);
+        query.addBindValue(QString("Artist %1").arg(artist));
+        query.exec();
+    }
+
+    QSqlQuery album(db);
+    album.prepare("INSERT INTO albums (id, title, album_artist_id, year) VALUES (?, ?, ?, ?)");
+    QSqlQuery credit(db);
+    credit.prepare("INSERT INTO album_album_artists (album_id, album_artist_id, position) VALUES (?, ?, 0)");
+    QSqlQuery track(db);
+    track.prepare("INSERT INTO tracks (file_path, title, artist_id, album_id, genre, year, "
+                  "track_number, disc_number, duration) VALUES (?, ?, ?, ?, ?, ?, ?, 1, ?)");
+    for (int a = 0; a < albums; ++a) {
+        const int artistId = a / ALBUMS_PER_ARTIST + 1;
+        const int year = 1960 + a % 60;
+        album.addBindValue(a + 1);
+        album.addBindValue(QString("Album %1").arg(a));
+        album.addBindValue(artistId);
+        album.addBindValue(year);
+        album.exec();
+        credit.addBindValue(a + 1);
+        credit.addBindValue(artistId);
+        credit.exec();
+        library.albumArtists.append(QString("Artist %1").arg(a / ALBUMS_PER_ARTIST));
+        library.albumTitles.append(QString("Album %1").arg(a));
+
+        for (int t = 0; t < TRACKS_PER_ALBUM; ++t) {
+            const QString path = trackPath(a, t);
+            track.addBindValue(path);
+            track.addBindValue(QString("Track %1").arg(t + 1));
+            track.addBindValue(artistId);
+            track.addBindValue(a + 1);
+            track.addBindValue(QString("Genre %1").arg(a % 40));
+            track.addBindValue(year);
+            track.addBindValue(t + 1);
+            track.addBindValue(180 + (a + t) % 120);
+            track.exec();
+            library.paths.append(path);
+        }
+    }
+
+    if (!exec(query, "INSERT INTO album_art (album_id, full_path, thumbnail) "
+                     "SELECT id, '/tmp/art/' || id || '.jpg', zeroblob(2048) FROM albums WHERE id % 10 != 0")
+        || !exec(query, "INSERT INTO album_summary (album_id, title, album_artist_name, year, "
+                        "track_count, total_duration, has_art) "
+                        "SELECT al.id, al.title, aa.name, al.year, COUNT(t.id), COALESCE(SUM(t.duration), 0), "
+                        "EXISTS (SELECT 1 FROM album_art art WHERE art.album_id = al.id) "
+                        "FROM albums al JOIN album_artists aa ON aa.id = al.album_artist_id "
+                        "LEFT JOIN tracks t ON t.album_id = al.id GROUP BY al.id")) {
+        db.rollback();
+        return false;
+    }
+    db.commit();
+    exec(query, "ANALYZE");
+    return true;
+}
+
+// The SQL side, as DatabaseManager ran it
+
+int sqlTrackIdByPath(QSqlDatabase &db, const QString &filePath)
+{
+    QSqlQuery query(db);
+    query.prepare("SELECT id FROM tracks WHERE file_path = :path");
+    query.bindValue(":path", filePath);
+    if (query.exec() && query.next()) {
+        return query.value(0).toInt();
+    }
+    return 0;
+}
+
+int sqlAlbumIdByArtistAndTitle(QSqlDatabase &db, const QString &albumArtist, const QString &albumTitle)
+{
+    QSqlQuery checkQuery(db);
+    checkQuery.exec("SELECT name FROM sqlite_master WHERE type='table' AND name='album_album_artists'");
+    checkQuery.next();
+    checkQuery.finish();
+
+    QSqlQuery query(db);
+    query.prepare("SELECT DISTINCT al.id FROM albums al WHERE al.title = :title LIMIT 1");
+    query.bindValue(":title", albumTitle);
+    if (query.exec() && query.next()) {
+        const int candidateId = query.value(0).toInt();
+        const QStringList artistNames = albumArtist.split(QRegularExpression("[;,]\\s*"), Qt::SkipEmptyParts);
+        for (const QString &artistName : artistNames) {
+            QSqlQuery verifyQuery(db);
+            verifyQuery.prepare("SELECT 1 FROM album_album_artists aaa "
+                                "JOIN album_artists aa ON aaa.album_artist_id = aa.id "
+                                "WHERE aaa.album_id = :album_id AND LOWER(aa.name) = LOWER(:artist_name)");
+            verifyQuery.bindValue(":album_id", candidateId);
+            verifyQuery.bindValue(":artist_name", artistName.trimmed());
+            if (verifyQuery.exec() && verifyQuery.next()) {
+                return candidateId;
+            }
+        }
+    }
+    return 0;
+}
+
+QVariantList sqlAlbumsByAlbumArtist(QSqlDatabase &db, const QString &albumArtistName)
+{
+    QVariantList albums;
+    QSqlQuery checkQuery(db);
+    checkQuery.exec("SELECT name FROM sqlite_master WHERE type='table' AND name='album_album_artists'");
+    checkQuery.next();
+    checkQuery.finish();
+
+    QSqlQuery query(db);
+    query.prepare("SELECT al.*, "
+                  "(SELECT GROUP_CONCAT(aa_sub.name, '; ') "
+                  " FROM album_album_artists aaa_sub "
+                  " JOIN album_artists aa_sub ON aaa_sub.album_artist_id = aa_sub.id "
+                  " WHERE aaa_sub.album_id = al.id "
+                  " ORDER BY aaa_sub.position) as album_artist_names, "
+                  "COUNT(DISTINCT t.id) as track_count, SUM(t.duration) as total_duration, "
+                  "art.thumbnail as art_thumbnail, art.full_path as art_path "
+                  "FROM albums al "
+                  "INNER JOIN album_album_artists aaa ON al.id = aaa.album_id "
+                  "INNER JOIN album_artists aa ON aaa.album_artist_id = aa.id "
+                  "LEFT JOIN tracks t ON al.id = t.album_id "
+                  "LEFT JOIN album_art art ON al.id = art.album_id "
+                  "WHERE LOWER(aa.name) = LOWER(?) "
+                  "GROUP BY al.id "
+                  "ORDER BY al.year DESC, al.title COLLATE NOCASE");
+    query.addBindValue(albumArtistName);
+    if (query.exec()) {
+        while (query.next()) {
+            QVariantMap album;
+            album["id"] = query.value("id");
+            album["title"] = query.value("title");
+            album["albumArtist"] = query.value("album_artist_names");
+            album["year"] = query.value("year");
+            album["trackCount"] = query.value("track_count");
+            album["duration"] = query.value("total_duration");
+            album["hasArt"] = !query.value("art_thumbnail").isNull();
+            album["artThumbnail"] = query.value("art_thumbnail");
+            album["artPath"] = query.value("art_path");
+            albums.append(album);
+        }
+    }
+    return albums;
+}
+
+double nsPerCall(int calls, const std::function<qint64(int)> &call)
+{
+    volatile qint64 sink = 0;
+    const Clock::time_point start = Clock::now();
+    for (int i = 0; i < calls; ++i) {
+        sink = sink + call(i);
+    }
+    Q_UNUSED(sink)
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / qMax(1, calls);
+}
+
+void printRow(const char *lookup, double snapshotNs, double sqlNs)
+{
+    std::printf("%-22s %14.0f %14.0f %10.1fx\n", lookup, snapshotNs, sqlNs, sqlNs / qMax(1.0, snapshotNs));
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("LibrarySnapshot lookups against the SQL queries they replaced");
+    parser.addHelpOption();
+    QCommandLineOption albumsOption("albums", "Albums in the generated library (default 5000).", "count", "5000");
+    QCommandLineOption lookupsOption("lookups", "Lookups per measurement (default 20000).", "count", "20000");
+    parser.addOption(albumsOption);
+    parser.addOption(lookupsOption);
+    parser.process(app);
+    const int albums = qMax(1, parser.value(albumsOption).toInt());
+    const int lookups = qMax(1, parser.value(lookupsOption).toInt());
+
+    QTemporaryDir dir;
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "BenchLibraryLookup");
+    db.setDatabaseName(dir.filePath("library.db"));
+    if (!dir.isValid() || !db.open()) {
+        std::fprintf(stderr, "Could not open a temporary database\n");
+        return 1;
+    }
+    // Same connection settings as DatabaseManager
+    QSqlQuery pragma(db);
+    pragma.exec("PRAGMA foreign_keys = ON");
+    pragma.exec("PRAGMA journal_mode = WAL");
+    pragma.exec("PRAGMA synchronous = NORMAL");
+    pragma.exec("PRAGMA cache_size = -64000");
+    pragma.exec("PRAGMA temp_store = MEMORY");
+    pragma.exec("PRAGMA mmap_size = 268435456");
+
+    Library library;
+    if (!createLibrary(db, albums, library)) {
+        return 1;
+    }
+
+    LibrarySnapshot snapshot;
+    Clock::time_point start = Clock::now();
+    snapshot.rebuild(db);
+    const double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    if (!snapshot.isReady()) {
+        std::fprintf(stderr, "Snapshot failed to build\n");
+        return 1;
+    }
+
+    // The same random keys for both sides
+    QRandomGenerator random(1);
+    QVector<int> trackKeys(lookups);
+    QVector<int> albumKeys(lookups);
+    for (int i = 0; i < lookups; ++i) {
+        trackKeys[i] = random.bounded(library.paths.size());
+        albumKeys[i] = random.bounded(albums);
+    }
+    const int artistLookups = qMax(1, lookups / 10);  // Each returns ALBUMS_PER_ARTIST rows
+
+    std::printf("%d albums, %lld tracks, %d lookups; snapshot built in %.1f ms, %.1f MB\n",
+                albums, static_cast<long long>(library.paths.size()), lookups,
+                buildMs, snapshot.memoryUsage() / (1024.0 * 1024.0));
+    std::printf("%-22s %14s %14s %11s\n", "lookup", "snapshot ns", "SQL ns", "speedup");
+
+    printRow("track id by path",
+             nsPerCall(lookups, [&](int i) { return snapshot.trackIdByPath(library.paths.at(trackKeys.at(i))); }),
+             nsPerCall(lookups, [&](int i) { return sqlTrackIdByPath(db, library.paths.at(trackKeys.at(i))); }));
+
+    printRow("album id by artist",
+             nsPerCall(lookups, [&](int i) {
+                 const int a = albumKeys.at(i);
+                 return snapshot.albumIdByArtistAndTitle(library.albumArtists.at(a), library.albumTitles.at(a));
+             }),
+             nsPerCall(lookups, [&](int i) {
+                 const int a = albumKeys.at(i);
+                 return sqlAlbumIdByArtistAndTitle(db, library.albumArtists.at(a), library.albumTitles.at(a));
+             }));
+
+    printRow("albums of artist",
+             nsPerCall(artistLookups, [&](int i) {
+                 return qint64(snapshot.albumsByAlbumArtist(library.albumArtists.at(albumKeys.at(i))).size());
+             }),
+             nsPerCall(artistLookups, [&](int i) {
+                 return qint64(sqlAlbumsByAlbumArtist(db, library.albumArtists.at(albumKeys.at(i))).size());
+             }));
+
+    db.close();
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase("BenchLibraryLookup");
+    return 0;
+}
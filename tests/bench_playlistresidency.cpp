@@ -0,0 +1,218 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QMutex>
+#include <QRandomGenerator>
+#include <QVariantList>
+#include <QVector>
+#include <chrono>
+#include <cstdio>
+
+#include "backend/playlist/TrackPageStore.h"
+
+using namespace Mtoc;
+
+// Residency lookups on a 1M-row TrackPageStore under the access patterns
+// VirtualPlaylist sees. The model asks isTrackLoaded for every role of every
+// visible row, preloadRange checks the span around them, and loadedTrackCount
+// is read alongside. Each lookup takes a mutex, as VirtualPlaylist's do. Pages
+// that are missing get stored the way a fetch would store them, and that
+// loading is timed separately from the lookups.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int ROWS = 1000000;
+const int VISIBLE_ROWS = 40;
+const int ROLES = 12;             // Roles a playlist delegate reads per row
+const int PRELOAD_RADIUS = 50;
+const int PLAYBACK_PIN_RADIUS = 32;
+
+enum Pattern {
+    Scrolling,  // Small steps with the odd fling
+    Jumping,    // Anywhere, uniformly
+    HotSpots,   // Mostly around a few places, like search results and the playing album
+    PatternCount
+};
+
+const char *const PATTERN_NAMES[] = {"scrolling", "jumping", "hot spots"};
+
+struct Result {
+    qint64 steps = 0;
+    qint64 rowLookups = 0;
+    qint64 rowHits = 0;
+    double rowNs = 0.0;
+    double spanNs = 0.0;      // preloadRange's range check and the loaded count
+    qint64 pagesLoaded = 0;
+    double loadNs = 0.0;
+    int residentPages = 0;
+    qint64 residentBytes = 0;
+};
+
+QVariantList makePage(int page)
+{
+    QVariantList tracks;
+    const int first = TrackPageStore::pageStart(page);
+    const int count = qMin(int(TrackPage::ROWS), ROWS - first);
+    for (int i = 0; i < count; ++i) {
+        const int row = first + i;
+        const int album = row / 12;
+        QVariantMap track;
+        track["id"] = row + 1;
+        track["title"] = QString("Track %1").arg(row % 12 + 1);
+        track["artist"] = QString("Artist %1").arg(album / 8 % 5000);
+        track["albumArtist"] = QString("Artist %1").arg(album / 8 % 5000);
+        track["album"] = QString("Album %1").arg(album);
+        track["genre"] = QString("Genre %1").arg(album % 40);
+        track["year"] = 1960 + album % 60;
+        track["trackNumber"] = row % 12 + 1;
+        track["discNumber"] = 1;
+        track["duration"] = 180 + row % 120;
+        track["fileSize"] = qint64(8000000 + row % 4000000);
+        track["filePath"] = QString("/home/user/Music/Artist %1/Album %2/%3 - Track %3.flac")
+                                .arg(album / 8 % 5000).arg(album).arg(row % 12 + 1, 2, 10, QChar('0'));
+        tracks.append(track);
+    }
+    return tracks;
+}
+
+int nextTop(Pattern pattern, QRandomGenerator &random, int top)
+{
+    const int lastTop = ROWS - VISIBLE_ROWS;
+    switch (pattern) {
+    case Scrolling:
+        if (random.bounded(100) == 0) {
+            top += random.bounded(-5000, 5001);
+        } else {
+            top += random.bounded(-2, 9);
+        }
+        break;
+    case Jumping:
+        top = random.bounded(lastTop + 1);
+        break;
+    case HotSpots: {
+        static const int spots[] = {12000, 250000, 640000, 987000};
+        if (random.bounded(10) == 0) {
+            top = random.bounded(lastTop + 1);
+        } else {
+            top = spots[random.bounded(4)] + random.bounded(-2000, 2001);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return qBound(0, top, lastTop);
+}
+
+double nsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+Result run(Pattern pattern, int steps)
+{
+    Result result;
+    QRandomGenerator random(quint32(pattern) + 1);
+    QMutex mutex;
+    TrackPageStore store;
+    store.reset(ROWS);
+
+    int top = ROWS / 2;
+    int cursor = top;
+    volatile int sink = 0;
+
+    for (int step = 0; step < steps; ++step) {
+        top = nextTop(pattern, random, top);
+        // The playing track moves on now and then
+        if (step % 200 == 0) {
+            cursor = qMin(cursor + 1, ROWS - 1);
+        }
+        const int lastVisible = top + VISIBLE_ROWS - 1;
+        store.setPinnedWindow(TrackPageStore::VisiblePin, top, lastVisible);
+        store.setPinnedWindow(TrackPageStore::PlaybackPin,
+                              qMax(0, cursor - PLAYBACK_PIN_RADIUS), qMin(ROWS - 1, cursor + PLAYBACK_PIN_RADIUS));
+
+        Clock::time_point start = Clock::now();
+        int hits = 0;
+        for (int row = top; row <= lastVisible; ++row) {
+            for (int role = 0; role < ROLES; ++role) {
+                QMutexLocker locker(&mutex);
+                hits += store.isRowResident(row) ? 1 : 0;
+            }
+        }
+        result.rowNs += nsSince(start);
+        result.rowLookups += VISIBLE_ROWS * ROLES;
+        result.rowHits += hits;
+
+        const int first = qMax(0, top - PRELOAD_RADIUS);
+        const int last = qMin(ROWS - 1, lastVisible + PRELOAD_RADIUS);
+        start = Clock::now();
+        bool resident = false;
+        {
+            QMutexLocker locker(&mutex);
+            resident = store.isRangeResident(first, last);
+            sink = store.residentRowCount();
+        }
+        result.spanNs += nsSince(start);
+
+        QVector<int> missing;
+        if (!resident) {
+            for (int page = TrackPageStore::pageOf(first); page <= TrackPageStore::pageOf(last); ++page) {
+                if (!store.isPageResident(page)) {
+                    missing.append(page);
+                }
+            }
+        }
+        const int cursorPage = TrackPageStore::pageOf(cursor);
+        if (!store.isPageResident(cursorPage) && !missing.contains(cursorPage)) {
+            missing.append(cursorPage);
+        }
+        for (int page : missing) {
+            const QVariantList tracks = makePage(page);
+            start = Clock::now();
+            store.storePage(page, tracks);
+            result.loadNs += nsSince(start);
+            ++result.pagesLoaded;
+        }
+        ++result.steps;
+    }
+
+    Q_UNUSED(sink)
+    result.residentPages = store.residentPageCount();
+    result.residentBytes = store.residentBytes();
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("VirtualPlaylist residency lookups over a 1M-row playlist");
+    parser.addHelpOption();
+    QCommandLineOption stepsOption("steps", "View moves per pattern (default 20000).", "count", "20000");
+    parser.addOption(stepsOption);
+    parser.process(app);
+    const int steps = qMax(1, parser.value(stepsOption).toInt());
+
+    std::printf("%d rows, %d view moves per pattern, %d visible rows x %d roles\n",
+                ROWS, steps, VISIBLE_ROWS, ROLES);
+    std::printf("%-10s %8s %12s %12s %10s %12s %10s %10s\n",
+                "pattern", "hit %", "ns/lookup", "ns/preload", "pages", "us/page", "resident", "MB");
+    for (int pattern = 0; pattern < PatternCount; ++pattern) {
+        const Result result = run(Pattern(pattern), steps);
+        std::printf("%-10s %8.1f %12.2f %12.2f %10lld %12.2f %10d %10.1f\n",
+                    PATTERN_NAMES[pattern],
+                    100.0 * result.rowHits / qMax<qint64>(1, result.rowLookups),
+                    result.rowNs / qMax<qint64>(1, result.rowLookups),
+                    result.spanNs / qMax<qint64>(1, result.steps),
+                    static_cast<long long>(result.pagesLoaded),
+                    result.loadNs / qMax<qint64>(1, result.pagesLoaded) / 1000.0,
+                    result.residentPages,
+                    result.residentBytes / (1024.0 * 1024.0));
+    }
+    return 0;
+}
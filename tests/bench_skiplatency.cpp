@@ -0,0 +1,187 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "backend/playback/audioengine.h"
+#include "testaudio.h"
+
+using namespace Mtoc;
+
+// Manual skips through AudioEngine into a fakesink with sync=true, timed from
+// the loadTrack() call to the first rendered frame of the new track: loading
+// from scratch, loading with the file dropped from the page cache first, and
+// swapping in the warm standby pipeline.
+
+namespace {
+
+const int TRACKS = 8;
+const int TRACK_FRAMES = 3 * TestAudio::SAMPLE_RATE;
+const int LISTEN_MS = 400;  // Played before each skip; also lets the standby preroll
+
+struct Timings {
+    QVector<double> callMs;   // loadTrack() and play() returning
+    QVector<double> audioMs;  // To the first frame of the new track
+    int missed = 0;
+    int stillCached = 0;  // Skips whose file could not be dropped from the page cache
+};
+
+double percentile(QVector<double> values, double p)
+{
+    if (values.isEmpty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    const int rank = qBound(1, int(std::ceil(p / 100.0 * values.size())), int(values.size()));
+    return values[rank - 1];
+}
+
+// Drops the file from the page cache so the next load reads it from disk.
+// Returns false if its pages are still resident afterwards, as on tmpfs.
+bool dropFromPageCache(const QString &path)
+{
+    const int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    // Dirty pages are not dropped, and the tracks were only just written
+    ::fdatasync(fd);
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+
+    bool dropped = false;
+    const off_t size = ::lseek(fd, 0, SEEK_END);
+    void *map = size > 0 ? ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    if (map != MAP_FAILED) {
+        const long pageSize = ::sysconf(_SC_PAGESIZE);
+        QVector<unsigned char> pages((size + pageSize - 1) / pageSize);
+        if (::mincore(map, size, pages.data()) == 0) {
+            dropped = std::none_of(pages.begin(), pages.end(), [](unsigned char p) { return p & 1; });
+        }
+        ::munmap(map, size);
+    }
+    ::close(fd);
+    return dropped;
+}
+
+// First rendered frame of the track since `since`, or 0
+qint64 firstFrameOf(int track, qint64 since)
+{
+    const QVector<TestAudio::Run> runs = TestAudio::renderedRuns();
+    for (const TestAudio::Run &run : runs) {
+        if (run.marker == TestAudio::marker(track) && run.firstRenderedNs >= since) {
+            return run.firstRenderedNs;
+        }
+    }
+    return 0;
+}
+
+Timings runSkips(const QStringList &files, int skips, bool standby, bool dropCache)
+{
+    Timings timings;
+    TestAudio::resetSinks();
+
+    AudioEngine engine;
+    // Keeps the markers exact at the sink; see tst_gaplesstransition
+    engine.setReplayGainEnabled(false);
+    engine.setStandbyEnabled(standby);
+
+    engine.loadTrack(files.first());
+    engine.play();
+    QTest::qWait(LISTEN_MS);
+
+    for (int skip = 1; skip <= skips; ++skip) {
+        const int track = skip % TRACKS;
+        if (standby) {
+            engine.prepareStandby(files[track]);
+        }
+        QTest::qWait(LISTEN_MS);
+        if (dropCache && !dropFromPageCache(files[track])) {
+            ++timings.stillCached;
+        }
+
+        const qint64 start = TestAudio::steadyNs();
+        engine.loadTrack(files[track]);
+        engine.play();
+        timings.callMs.append((TestAudio::steadyNs() - start) / 1e6);
+
+        qint64 first = 0;
+        if (QTest::qWaitFor([&]() { return (first = firstFrameOf(track, start)) != 0; }, 5000)) {
+            timings.audioMs.append((first - start) / 1e6);
+        } else {
+            ++timings.missed;
+        }
+    }
+    return timings;
+}
+
+void printRow(const char *mode, const char *measure, const QVector<double> &values)
+{
+    std::printf("%-9s %-12s %8.2f %8.2f %8.2f\n", mode, measure,
+                percentile(values, 50), percentile(values, 90), percentile(values, 100));
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Skip latency, cold load against warm standby");
+    parser.addHelpOption();
+    QCommandLineOption skipsOption("skips", "Skips per mode (default 20).", "count", "20");
+    parser.addOption(skipsOption);
+    QCommandLineOption dirOption("dir", "Directory for the generated tracks. The uncached run needs "
+                                 "one on disk rather than tmpfs (default: the temporary directory).", "path");
+    parser.addOption(dirOption);
+    parser.process(app);
+    const int skips = qMax(1, parser.value(skipsOption).toInt());
+
+    const QString base = parser.isSet(dirOption) ? parser.value(dirOption) : QDir::tempPath();
+    QTemporaryDir dir(QDir(base).filePath("bench_skiplatency-XXXXXX"));
+    if (!dir.isValid()) {
+        std::fprintf(stderr, "Cannot create a temporary directory\n");
+        return 1;
+    }
+    QStringList files;
+    for (int i = 0; i < TRACKS; ++i) {
+        files.append(dir.filePath(QString("track%1.wav").arg(i)));
+        if (!TestAudio::writeWav(files.last(), TRACK_FRAMES, TestAudio::marker(i))) {
+            return 1;
+        }
+    }
+
+    AudioEngine::setAudioSinkFactory(TestAudio::makeSink);
+
+    const Timings cold = runSkips(files, skips, false, false);
+    const Timings uncached = runSkips(files, skips, false, true);
+    const Timings warm = runSkips(files, skips, true, false);
+
+    std::printf("%d skips per mode, ms\n", skips);
+    std::printf("%-9s %-12s %8s %8s %8s\n", "mode", "measure", "p50", "p90", "max");
+    printRow("cold", "call", cold.callMs);
+    printRow("cold", "first audio", cold.audioMs);
+    printRow("uncached", "call", uncached.callMs);
+    printRow("uncached", "first audio", uncached.audioMs);
+    printRow("standby", "call", warm.callMs);
+    printRow("standby", "first audio", warm.audioMs);
+
+    if (uncached.stillCached) {
+        std::fprintf(stderr, "%d of %d uncached skips read a file still in the page cache; "
+                     "use --dir on a disk-backed filesystem\n", uncached.stillCached, skips);
+    }
+    if (cold.missed || uncached.missed || warm.missed) {
+        std::fprintf(stderr, "No audio within 5 s after %d cold, %d uncached and %d standby skips\n",
+                     cold.missed, uncached.missed, warm.missed);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include "testaudio.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QMutex>
+#include <QDebug>
+#include <QtEndian>
+#include <chrono>
+
+namespace Mtoc {
+namespace TestAudio {
+
+namespace {
+
+struct SinkState {
+    QMutex mutex;
+    QVector<Run> runs;
+    qint64 renderedFrames = 0;
+    int largestBufferFrames = 0;
+};
+
+SinkState &sinkState()
+{
+    static SinkState state;
+    return state;
+}
+
+// Runs on the streaming thread of whichever pipeline the sink is in
+void onHandoff(GstElement *sink, GstBuffer *buffer, GstPad *pad, gpointer data)
+{
+    Q_UNUSED(sink)
+    Q_UNUSED(pad)
+    Q_UNUSED(data)
+
+    GstMapInfo map;
+    if (!gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+        return;
+    }
+    const qint64 now = steadyNs();
+    const int frames = int(map.size / (sizeof(qint16) * CHANNELS));
+    const qint16 *samples = reinterpret_cast<const qint16*>(map.data);
+
+    SinkState &state = sinkState();
+    QMutexLocker locker(&state.mutex);
+    for (int i = 0; i < frames; ++i) {
+        const qint16 value = qFromLittleEndian(samples[i * CHANNELS]);
+        if (state.runs.isEmpty() || state.runs.last().marker != value) {
+            Run run;
+            run.marker = value;
+            run.firstRenderedNs = now;
+            state.runs.append(run);
+        }
+        ++state.runs.last().frames;
+    }
+    state.renderedFrames += frames;
+    state.largestBufferFrames = qMax(state.largestBufferFrames, frames);
+    gst_buffer_unmap(buffer, &map);
+}
+
+} // namespace
+
+qint16 marker(int track)
+{
+    return qint16(1000 * (track + 1));
+}
+
+bool writeWav(const QString &path, int frames, qint16 value)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "[TestAudio::writeWav] Cannot write" << path << "-" << file.errorString();
+        return false;
+    }
+
+    const quint32 dataBytes = quint32(frames) * CHANNELS * sizeof(qint16);
+    QDataStream out(&file);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out.writeRawData("RIFF", 4);
+    out << quint32(36 + dataBytes);
+    out.writeRawData("WAVE", 4);
+    out.writeRawData("fmt ", 4);
+    out << quint32(16) << quint16(1) << quint16(CHANNELS) << quint32(SAMPLE_RATE)
+        << quint32(SAMPLE_RATE * CHANNELS * sizeof(qint16)) << quint16(CHANNELS * sizeof(qint16))
+        << quint16(16);
+    out.writeRawData("data", 4);
+    out << dataBytes;
+    for (int i = 0; i < frames * CHANNELS; ++i) {
+        out << value;
+    }
+    return out.status() == QDataStream::Ok;
+}
+
+GstElement *makeSink()
+{
+    GError *error = nullptr;
+    GstElement *bin = gst_parse_bin_from_description(
+        "capsfilter caps=audio/x-raw,format=S16LE,layout=interleaved,channels=2 "
+        "! fakesink name=sink sync=true signal-handoffs=true",
+        TRUE, &error);
+    if (!bin) {
+        qWarning() << "[TestAudio::makeSink] Cannot create sink:" << (error ? error->message : "Unknown error");
+        if (error) g_error_free(error);
+        return nullptr;
+    }
+
+    GstElement *sink = gst_bin_get_by_name(GST_BIN(bin), "sink");
+    g_signal_connect(sink, "handoff", G_CALLBACK(onHandoff), nullptr);
+    gst_object_unref(sink);
+    return bin;
+}
+
+void resetSinks()
+{
+    SinkState &state = sinkState();
+    QMutexLocker locker(&state.mutex);
+    state.runs.clear();
+    state.renderedFrames = 0;
+    state.largestBufferFrames = 0;
+}
+
+qint64 renderedFrames()
+{
+    SinkState &state = sinkState();
+    QMutexLocker locker(&state.mutex);
+    return state.renderedFrames;
+}
+
+int largestBufferFrames()
+{
+    SinkState &state = sinkState();
+    QMutexLocker locker(&state.mutex);
+    return state.largestBufferFrames;
+}
+
+QVector<Run> renderedRuns()
+{
+    SinkState &state = sinkState();
+    QMutexLocker locker(&state.mutex);
+    return state.runs;
+}
+
+qint64 steadyNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace TestAudio
+} // namespace Mtoc
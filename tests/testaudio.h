@@ -0,0 +1,44 @@
+#ifndef TESTAUDIO_H
+#define TESTAUDIO_H
+
+#include <QString>
+#include <QVector>
+#include <gst/gst.h>
+
+namespace Mtoc {
+namespace TestAudio {
+
+const int SAMPLE_RATE = 44100;
+const int CHANNELS = 2;
+
+// Every sample of generated track i holds marker(i), so what reaches the sink
+// can be traced back to its track frame by frame
+qint16 marker(int track);
+
+// Writes a 16-bit PCM WAV file of `frames` frames filled with `value`
+bool writeWav(const QString &path, int frames, qint16 value);
+
+// Consecutive rendered frames carrying the same marker
+struct Run {
+    qint16 marker = 0;
+    qint64 frames = 0;
+    qint64 firstRenderedNs = 0;  // steadyNs() when its first frame was rendered
+};
+
+// For AudioEngine::setAudioSinkFactory(): a fakesink with sync=true behind a
+// capsfilter that holds it to interleaved S16LE. Every sink it makes reports
+// what it renders below, whichever pipeline it ended up in.
+GstElement *makeSink();
+
+void resetSinks();
+qint64 renderedFrames();
+int largestBufferFrames();
+QVector<Run> renderedRuns();
+
+// The clock Run::firstRenderedNs is read from
+qint64 steadyNs();
+
+} // namespace TestAudio
+} // namespace Mtoc
+
+#endif // TESTAUDIO_H
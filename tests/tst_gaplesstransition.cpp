@@ -0,0 +1,103 @@
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include "backend/playback/audioengine.h"
+#include "testaudio.h"
+
+using namespace Mtoc;
+
+// Plays generated tracks back to back through AudioEngine into a fakesink and
+// checks the gapless switches: every frame arrives once and in order, and
+// trackTransitioned fires within one buffer of the sink crossing into the track.
+class TestGaplessTransition : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void transitionsAreSampleAccurate_data();
+    void transitionsAreSampleAccurate();
+};
+
+void TestGaplessTransition::initTestCase()
+{
+    AudioEngine::setAudioSinkFactory(TestAudio::makeSink);
+}
+
+void TestGaplessTransition::transitionsAreSampleAccurate_data()
+{
+    // Track lengths in frames at 44.1 kHz
+    QTest::addColumn<QVector<int>>("frames");
+
+    QTest::newRow("regular tracks") << QVector<int>{22050, 17640, 13230};
+    QTest::newRow("short middle track") << QVector<int>{17640, 2205, 13230};
+    // Queued before the track ahead of them has started
+    QTest::newRow("tracks shorter than a buffer") << QVector<int>{13230, 441, 300, 13230};
+}
+
+void TestGaplessTransition::transitionsAreSampleAccurate()
+{
+    QFETCH(QVector<int>, frames);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QStringList files;
+    for (int i = 0; i < frames.size(); ++i) {
+        files.append(dir.filePath(QString("track%1.wav").arg(i)));
+        QVERIFY(TestAudio::writeWav(files.last(), frames[i], TestAudio::marker(i)));
+    }
+
+    TestAudio::resetSinks();
+    AudioEngine engine;
+    // Without the filter bin the samples reach the sink bit for bit
+    // (rgvolume works in float and audioconvert dithers on the way back)
+    engine.setReplayGainEnabled(false);
+
+    int next = 1;
+    connect(&engine, &AudioEngine::requestNextTrack, &engine, [&]() {
+        if (next < files.size()) {
+            engine.queueNextTrack(files[next++]);
+        }
+    });
+
+    struct Transition {
+        QString track;
+        qint64 renderedFrames = 0;
+    };
+    QVector<Transition> transitions;
+    connect(&engine, &AudioEngine::trackTransitioned, &engine, [&]() {
+        transitions.append({engine.currentTrack(), TestAudio::renderedFrames()});
+    });
+
+    bool finished = false;
+    connect(&engine, &AudioEngine::trackFinished, &engine, [&]() { finished = true; });
+    QSignalSpy errors(&engine, &AudioEngine::error);
+
+    engine.loadTrack(files.first());
+    engine.play();
+    QTRY_VERIFY_WITH_TIMEOUT(finished, 10000);
+    QCOMPARE(errors.count(), 0);
+
+    // Every frame of every track rendered once, in order, with nothing in between
+    const QVector<TestAudio::Run> runs = TestAudio::renderedRuns();
+    QCOMPARE(runs.size(), frames.size());
+    for (int i = 0; i < frames.size(); ++i) {
+        QCOMPARE(runs[i].marker, TestAudio::marker(i));
+        QCOMPARE(runs[i].frames, qint64(frames[i]));
+    }
+
+    QCOMPARE(transitions.size(), frames.size() - 1);
+    const int tolerance = TestAudio::largestBufferFrames();
+    qint64 boundary = 0;
+    for (int i = 1; i < frames.size(); ++i) {
+        boundary += frames[i - 1];
+        const Transition &transition = transitions[i - 1];
+        QCOMPARE(transition.track, files[i]);
+        QVERIFY2(qAbs(transition.renderedFrames - boundary) <= tolerance,
+                 qPrintable(QString("Switch to track %1 reported at frame %2, the boundary is at %3 (buffers up to %4 frames)")
+                            .arg(i).arg(transition.renderedFrames).arg(boundary).arg(tolerance)));
+    }
+}
+
+QTEST_GUILESS_MAIN(TestGaplessTransition)
+#include "tst_gaplesstransition.moc"
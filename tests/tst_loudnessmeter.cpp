@@ -0,0 +1,147 @@
+#include <QtTest>
+#include <cmath>
+
+#include "backend/utility/loudnessmeter.h"
+
+using namespace Mtoc;
+
+namespace {
+
+// One stretch of the sine at a level in dBFS (peak amplitude)
+struct Segment {
+    double dbfs;
+    double seconds;
+};
+
+} // namespace
+
+Q_DECLARE_METATYPE(QList<Segment>)
+
+// The EBU Tech 3341 minimum requirements, with the test signals generated in
+// place rather than read from the EBU test set: integrated loudness within
+// ±0.1 LU, true peak within +0.2/-0.4 dB.
+class TestLoudnessMeter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void integratedLoudness_data();
+    void integratedLoudness();
+    void nothingToMeasure();
+    void truePeak_data();
+    void truePeak();
+
+private:
+    static LoudnessMeter measureSine(int sampleRate, int channels, double frequency,
+                                     const QList<Segment> &segments, double phase = 0.0);
+};
+
+LoudnessMeter TestLoudnessMeter::measureSine(int sampleRate, int channels, double frequency,
+                                             const QList<Segment> &segments, double phase)
+{
+    // Fed in odd-sized chunks so steps and blocks straddle process() calls
+    const int chunkFrames = 1009;
+    LoudnessMeter meter(sampleRate, channels);
+    QVector<float> chunk;
+    qint64 frame = 0;
+    for (const Segment &segment : segments) {
+        const double amplitude = std::pow(10.0, segment.dbfs / 20.0);
+        qint64 remaining = qRound64(segment.seconds * sampleRate);
+        while (remaining > 0) {
+            const int frames = int(qMin<qint64>(remaining, chunkFrames));
+            chunk.resize(frames * channels);
+            for (int i = 0; i < frames; ++i, ++frame) {
+                const float sample = float(amplitude * std::sin(2.0 * M_PI * frequency * frame / sampleRate + phase));
+                for (int channel = 0; channel < channels; ++channel) {
+                    chunk[i * channels + channel] = sample;
+                }
+            }
+            meter.process(chunk.constData(), frames);
+            remaining -= frames;
+        }
+    }
+    return meter;
+}
+
+void TestLoudnessMeter::integratedLoudness_data()
+{
+    QTest::addColumn<int>("sampleRate");
+    QTest::addColumn<int>("channels");
+    QTest::addColumn<QList<Segment>>("segments");
+    QTest::addColumn<double>("expected");
+
+    // Tech 3341 cases 1 to 4, stereo 1 kHz
+    QTest::newRow("case 1: -23 dBFS") << 48000 << 2 << QList<Segment>{ { -23.0, 20.0 } } << -23.0;
+    QTest::newRow("case 2: -33 dBFS") << 48000 << 2 << QList<Segment>{ { -33.0, 20.0 } } << -33.0;
+    QTest::newRow("case 3: relative gate")
+        << 48000 << 2 << QList<Segment>{ { -36.0, 10.0 }, { -23.0, 60.0 }, { -36.0, 10.0 } } << -23.0;
+    QTest::newRow("case 4: absolute gate")
+        << 48000 << 2
+        << QList<Segment>{ { -72.0, 10.0 }, { -36.0, 10.0 }, { -23.0, 60.0 }, { -36.0, 10.0 }, { -72.0, 10.0 } }
+        << -23.0;
+
+    // K-weighting is derived per rate, not only for 48 kHz
+    QTest::newRow("44.1 kHz") << 44100 << 2 << QList<Segment>{ { -23.0, 20.0 } } << -23.0;
+    QTest::newRow("96 kHz") << 96000 << 2 << QList<Segment>{ { -23.0, 20.0 } } << -23.0;
+    // Mono is measured as dual mono
+    QTest::newRow("mono") << 48000 << 1 << QList<Segment>{ { -23.0, 20.0 } } << -23.0;
+}
+
+void TestLoudnessMeter::integratedLoudness()
+{
+    QFETCH(int, sampleRate);
+    QFETCH(int, channels);
+    QFETCH(QList<Segment>, segments);
+    QFETCH(double, expected);
+
+    const LoudnessMeter meter = measureSine(sampleRate, channels, 1000.0, segments);
+    const double loudness = meter.integratedLoudness();
+    QVERIFY2(std::fabs(loudness - expected) <= 0.1,
+             qPrintable(QString("%1 LUFS, expected %2").arg(loudness, 0, 'f', 3).arg(expected)));
+}
+
+void TestLoudnessMeter::nothingToMeasure()
+{
+    // Silence never passes the absolute gate
+    const LoudnessMeter silence = measureSine(48000, 2, 1000.0, { { -120.0, 5.0 } });
+    QVERIFY(std::isinf(silence.integratedLoudness()));
+
+    // Too short for a single 400 ms block
+    const LoudnessMeter clip = measureSine(48000, 2, 1000.0, { { -23.0, 0.3 } });
+    QVERIFY(clip.blockEnergies().isEmpty());
+    QVERIFY(std::isinf(clip.integratedLoudness()));
+}
+
+void TestLoudnessMeter::truePeak_data()
+{
+    QTest::addColumn<int>("sampleRate");
+    QTest::addColumn<double>("frequency");
+    QTest::addColumn<double>("phase");
+    QTest::addColumn<double>("dbfs");
+
+    // A low sine peaks on the samples themselves
+    QTest::newRow("1 kHz") << 48000 << 1000.0 << 0.0 << -6.0;
+    // Tech 3341 cases 15 to 18: a quarter of the rate, peaks between samples
+    // as the phase moves, down to 3 dB under the true peak at 45 degrees
+    QTest::newRow("fs/4, 0 degrees") << 48000 << 12000.0 << 0.0 << -6.0;
+    QTest::newRow("fs/4, 45 degrees") << 48000 << 12000.0 << M_PI / 4.0 << -6.0;
+    QTest::newRow("fs/4, 60 degrees") << 48000 << 12000.0 << M_PI / 3.0 << -6.0;
+    QTest::newRow("fs/4, 67.5 degrees") << 48000 << 12000.0 << 3.0 * M_PI / 8.0 << -6.0;
+    QTest::newRow("fs/4, 44.1 kHz, 45 degrees") << 44100 << 11025.0 << M_PI / 4.0 << -6.0;
+}
+
+void TestLoudnessMeter::truePeak()
+{
+    QFETCH(int, sampleRate);
+    QFETCH(double, frequency);
+    QFETCH(double, phase);
+    QFETCH(double, dbfs);
+
+    const LoudnessMeter meter = measureSine(sampleRate, 2, frequency, { { dbfs, 2.0 } }, phase);
+    const double peak = 20.0 * std::log10(meter.truePeak());
+    QVERIFY2(peak >= dbfs - 0.4 && peak <= dbfs + 0.2,
+             qPrintable(QString("%1 dBTP, expected %2").arg(peak, 0, 'f', 3).arg(dbfs)));
+}
+
+QTEST_GUILESS_MAIN(TestLoudnessMeter)
+#include "tst_loudnessmeter.moc"
@@ -0,0 +1,140 @@
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include "backend/playback/playbackstatejournal.h"
+
+using namespace Mtoc;
+
+// Reopens the journal the way a restart does: each journal object is one
+// launch, destroyed without a final checkpoint as a crash would leave it.
+class TestPlaybackStateJournal : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void replaysAppendedRecords();
+    void restoreKeepsTrackAndPosition();
+    void tornTailLosesOnlyLastRecord();
+
+private:
+    static QList<PlaybackStateJournal::Entry> entries(int count);
+    static QVariantMap info(int trackIndex);
+};
+
+QList<PlaybackStateJournal::Entry> TestPlaybackStateJournal::entries(int count)
+{
+    QList<PlaybackStateJournal::Entry> result;
+    for (int i = 0; i < count; ++i) {
+        result.append({i + 1, QString("/music/track%1.flac").arg(i + 1)});
+    }
+    return result;
+}
+
+QVariantMap TestPlaybackStateJournal::info(int trackIndex)
+{
+    QVariantMap result;
+    result["filePath"] = QString("/music/track%1.flac").arg(trackIndex + 1);
+    result["trackIndex"] = trackIndex;
+    result["queueModified"] = true;
+    return result;
+}
+
+void TestPlaybackStateJournal::replaysAppendedRecords()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("playback_state.journal");
+
+    {
+        PlaybackStateJournal journal(path);
+        journal.insertEntries(0, entries(5));
+        journal.setInfo(info(2));
+        journal.setPosition(61000);
+        journal.moveEntry(4, 0);
+        journal.removeEntries(1, 1);
+    }
+
+    QList<PlaybackStateJournal::Entry> expected = entries(5);
+    expected.move(4, 0);
+    expected.remove(1, 1);
+
+    PlaybackStateJournal journal(path);
+    PlaybackStateJournal::State state;
+    QVERIFY(journal.load(&state));
+    QCOMPARE(state.info, info(2));
+    QCOMPARE(state.position, qint64(61000));
+    QVERIFY(state.queue == expected);
+}
+
+void TestPlaybackStateJournal::restoreKeepsTrackAndPosition()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("playback_state.journal");
+    const QList<PlaybackStateJournal::Entry> queue = entries(12);
+
+    // First launch: playing track 4 of the queue, 95 s in
+    {
+        PlaybackStateJournal journal(path);
+        journal.insertEntries(0, queue);
+        journal.setInfo(info(3));
+        journal.setPosition(95000);
+    }
+
+    // Second launch: the restore rebuilds the queue and loads the track paused,
+    // so nothing else is written before the app goes away
+    {
+        PlaybackStateJournal journal(path);
+        PlaybackStateJournal::State saved;
+        QVERIFY(journal.load(&saved));
+        QCOMPARE(saved.position, qint64(95000));
+        journal.insertEntries(0, saved.queue);
+    }
+
+    // Third launch still finds the track, the position and the queue once
+    PlaybackStateJournal journal(path);
+    PlaybackStateJournal::State state;
+    QVERIFY(journal.load(&state));
+    QCOMPARE(state.info, info(3));
+    QCOMPARE(state.position, qint64(95000));
+    QVERIFY(state.queue == queue);
+
+    // Stopping after a restore still forgets the track
+    journal.clear();
+    journal.insertEntries(0, queue);
+    PlaybackStateJournal reopened(path);
+    QVERIFY(reopened.load(&state));
+    QVERIFY(state.info.isEmpty());
+    QCOMPARE(state.position, qint64(0));
+}
+
+void TestPlaybackStateJournal::tornTailLosesOnlyLastRecord()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("playback_state.journal");
+
+    {
+        PlaybackStateJournal journal(path);
+        journal.insertEntries(0, entries(3));
+        journal.setInfo(info(0));
+        journal.setPosition(1000);
+        journal.setPosition(2000);
+    }
+
+    // Cut the last position record short
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() - 3));
+    file.close();
+
+    PlaybackStateJournal journal(path);
+    PlaybackStateJournal::State state;
+    QVERIFY(journal.load(&state));
+    QCOMPARE(state.info, info(0));
+    QCOMPARE(state.position, qint64(1000));
+    QVERIFY(state.queue == entries(3));
+}
+
+QTEST_GUILESS_MAIN(TestPlaybackStateJournal)
+#include "tst_playbackstatejournal.moc"
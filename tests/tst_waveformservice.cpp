@@ -0,0 +1,251 @@
+#include <QtTest>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QThread>
+
+#include "backend/library/waveformservice.h"
+
+using namespace Mtoc;
+
+namespace {
+
+// Stands in for the GStreamer decoder. A held path blocks its decode until it
+// is released or the job is cancelled, so jobs can be lined up against each
+// other.
+struct FakeDecoder {
+    QMutex mutex;
+    QSet<QString> held;
+    QHash<QString, int> started;
+    QHash<QString, int> returned;
+};
+
+FakeDecoder fake;
+
+QByteArray fakeDecode(const QString &filePath, const std::function<bool()> &cancelled)
+{
+    {
+        QMutexLocker locker(&fake.mutex);
+        ++fake.started[filePath];
+    }
+    for (;;) {
+        {
+            QMutexLocker locker(&fake.mutex);
+            if (!fake.held.contains(filePath)) {
+                break;
+            }
+        }
+        if (cancelled()) {
+            break;
+        }
+        QThread::msleep(2);
+    }
+    QMutexLocker locker(&fake.mutex);
+    ++fake.returned[filePath];
+    return cancelled() ? QByteArray() : QByteArray(WaveformService::BUCKETS * 2, 1);
+}
+
+int started(const QString &filePath)
+{
+    QMutexLocker locker(&fake.mutex);
+    return fake.started.value(filePath);
+}
+
+int returned(const QString &filePath)
+{
+    QMutexLocker locker(&fake.mutex);
+    return fake.returned.value(filePath);
+}
+
+void hold(const QStringList &filePaths)
+{
+    QMutexLocker locker(&fake.mutex);
+    for (const QString &filePath : filePaths) {
+        fake.held.insert(filePath);
+    }
+}
+
+void release(const QString &filePath)
+{
+    QMutexLocker locker(&fake.mutex);
+    fake.held.remove(filePath);
+}
+
+int readyCount(const QSignalSpy &spy, const QString &filePath)
+{
+    int count = 0;
+    for (const QList<QVariant> &arguments : spy) {
+        if (arguments.at(0).toString() == filePath) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+// The hand-off between library and playback jobs for the same path: a queued
+// library job stands down for playback (m_superseded), a playback job waits
+// for a library job already decoding (m_deferred), and a cancelled library
+// job gives the path back (m_started). Every path must end up decoded once,
+// or twice when a decode was cancelled, and reported once.
+class TestWaveformService : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+
+    void libraryRunDecodesEveryTrack();
+    void playbackSupersedesQueuedLibraryJob();
+    void playbackWaitsForRunningLibraryJob();
+    void cancelHandsWaitingPathToPlayback();
+    void cancelledPathIsDecodedLater();
+};
+
+void TestWaveformService::initTestCase()
+{
+    WaveformService::setPeakDecoder(fakeDecode);
+}
+
+void TestWaveformService::cleanupTestCase()
+{
+    WaveformService::setPeakDecoder(nullptr);
+}
+
+void TestWaveformService::init()
+{
+    QMutexLocker locker(&fake.mutex);
+    fake.held.clear();
+    fake.started.clear();
+    fake.returned.clear();
+}
+
+void TestWaveformService::libraryRunDecodesEveryTrack()
+{
+    WaveformService service(nullptr);
+    QSignalSpy ready(&service, &WaveformService::waveformReady);
+
+    QStringList filePaths;
+    for (int i = 0; i < 40; ++i) {
+        filePaths.append(QString("/music/library%1.flac").arg(i));
+    }
+    service.generateLibrary(filePaths);
+    QVERIFY(service.isGenerating());
+    QTRY_VERIFY_WITH_TIMEOUT(!service.isGenerating(), 10000);
+
+    QCOMPARE(service.progress(), 100);
+    QCOMPARE(ready.count(), filePaths.size());
+    for (const QString &filePath : filePaths) {
+        QCOMPARE(started(filePath), 1);
+    }
+}
+
+void TestWaveformService::playbackSupersedesQueuedLibraryJob()
+{
+    WaveformService service(nullptr);
+    QSignalSpy ready(&service, &WaveformService::waveformReady);
+    const QString path = "/music/next.flac";
+
+    // Every decoder thread busy with playback, so the library job stays queued
+    const int threads = qBound(1, QThread::idealThreadCount() / 2, 4);
+    QStringList busy;
+    for (int i = 0; i < threads; ++i) {
+        busy.append(QString("/music/busy%1.flac").arg(i));
+    }
+    hold(busy);
+    service.prefetch(busy);
+    QTRY_VERIFY([&]() {
+        for (const QString &filePath : busy) {
+            if (started(filePath) != 1) {
+                return false;
+            }
+        }
+        return true;
+    }());
+
+    service.generateLibrary({ path });
+    QVERIFY(service.peaks(path).isEmpty());
+    for (const QString &filePath : busy) {
+        release(filePath);
+    }
+
+    QTRY_COMPARE(readyCount(ready, path), 1);
+    QTRY_VERIFY(!service.isGenerating());
+    QTest::qWait(50);
+    QCOMPARE(started(path), 1);
+    QCOMPARE(readyCount(ready, path), 1);
+    QCOMPARE(service.peaks(path).size(), WaveformService::BUCKETS * 2);
+}
+
+void TestWaveformService::playbackWaitsForRunningLibraryJob()
+{
+    WaveformService service(nullptr);
+    QSignalSpy ready(&service, &WaveformService::waveformReady);
+    const QString path = "/music/now.flac";
+
+    hold({ path });
+    service.generateLibrary({ path });
+    QTRY_COMPARE(started(path), 1);
+
+    // The playback job finds the path taken and leaves it to the library job
+    QVERIFY(service.peaks(path).isEmpty());
+    QTest::qWait(50);
+    release(path);
+
+    QTRY_COMPARE(readyCount(ready, path), 1);
+    QTRY_VERIFY(!service.isGenerating());
+    QTest::qWait(50);
+    QCOMPARE(started(path), 1);
+    QCOMPARE(readyCount(ready, path), 1);
+}
+
+void TestWaveformService::cancelHandsWaitingPathToPlayback()
+{
+    WaveformService service(nullptr);
+    QSignalSpy ready(&service, &WaveformService::waveformReady);
+    const QString path = "/music/now.flac";
+
+    hold({ path });
+    service.generateLibrary({ path });
+    QTRY_COMPARE(started(path), 1);
+    QVERIFY(service.peaks(path).isEmpty());
+    QTest::qWait(50);
+
+    // The library decode stops, and playback still gets its waveform
+    service.cancelGeneration();
+    QVERIFY(!service.isGenerating());
+    QTRY_COMPARE(returned(path), 1);
+    release(path);
+
+    QTRY_COMPARE(readyCount(ready, path), 1);
+    QTest::qWait(50);
+    QCOMPARE(started(path), 2);
+    QCOMPARE(readyCount(ready, path), 1);
+}
+
+void TestWaveformService::cancelledPathIsDecodedLater()
+{
+    WaveformService service(nullptr);
+    QSignalSpy ready(&service, &WaveformService::waveformReady);
+    const QString path = "/music/later.flac";
+
+    hold({ path });
+    service.generateLibrary({ path });
+    QTRY_COMPARE(started(path), 1);
+    service.cancelGeneration();
+    QTRY_COMPARE(returned(path), 1);
+    QTest::qWait(50);
+    QCOMPARE(ready.count(), 0);
+
+    // Nothing of the cancelled job is left to block the path
+    release(path);
+    QVERIFY(service.peaks(path).isEmpty());
+    QTRY_COMPARE(readyCount(ready, path), 1);
+    QCOMPARE(started(path), 2);
+}
+
+QTEST_GUILESS_MAIN(TestWaveformService)
+#include "tst_waveformservice.moc"